@@ -0,0 +1,247 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisKraSaveBenchmark.h"
+
+#include <QTest>
+#include <QBuffer>
+
+#include <synthetic_image_utils.h>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_image.h>
+#include <kis_paint_device.h>
+#include <kis_paint_device_writer.h>
+#include <KisDocument.h>
+#include <KisPart.h>
+#include <KoStore.h>
+#include <kis_store_paintdevice_writer.h>
+
+namespace {
+
+/**
+ * Just counts the bytes, so that only the tile compression
+ * part of the saving is measured
+ */
+class CountingPaintDeviceWriter : public KisPaintDeviceWriter
+{
+public:
+    bool write(const QByteArray &data) override {
+        m_size += data.size();
+        return true;
+    }
+
+    bool write(const char* data, qint64 length) override {
+        Q_UNUSED(data);
+        m_size += length;
+        return true;
+    }
+
+    qint64 m_size = 0;
+};
+
+}
+
+void KisKraSaveBenchmark::benchmarkWriteDevice_data()
+{
+    QTest::addColumn<int>("deviceSize");
+
+    QTest::newRow("1024") << 1024;
+    QTest::newRow("4096") << 4096;
+    QTest::newRow("8192") << 8192;
+}
+
+void KisKraSaveBenchmark::benchmarkWriteDevice()
+{
+    QFETCH(int, deviceSize);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    TestUtil::fillSyntheticContent(dev, QRect(0, 0, deviceSize, deviceSize), 0);
+
+    QBENCHMARK {
+        CountingPaintDeviceWriter writer;
+        QVERIFY(dev->write(writer));
+        QVERIFY(writer.m_size > 0);
+    }
+}
+
+void KisKraSaveBenchmark::benchmarkStoreCompression_data()
+{
+    QTest::addColumn<int>("compression");
+
+    QTest::newRow("stored") << int(KoStore::CompressionStored);
+    QTest::newRow("fast") << int(KoStore::CompressionFast);
+    QTest::newRow("default") << int(KoStore::CompressionDefault);
+}
+
+void KisKraSaveBenchmark::benchmarkStoreCompression()
+{
+    QFETCH(int, compression);
+
+    const int numLayers = 4;
+    const QRect rc(0, 0, 4096, 4096);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    QVector<KisPaintDeviceSP> devices;
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintDeviceSP dev = new KisPaintDevice(cs);
+        TestUtil::fillSyntheticContent(dev, rc, i);
+        devices << dev;
+    }
+
+    qint64 storeSize = 0;
+
+    QBENCHMARK {
+        QBuffer buffer;
+        QScopedPointer<KoStore> store(
+            KoStore::createStore(&buffer, KoStore::Write, "application/x-krita", KoStore::Zip));
+        store->setCompression(KoStore::Compression(compression));
+
+        KisStorePaintDeviceWriter writer(store.data());
+
+        for (int i = 0; i < devices.size(); i++) {
+            QVERIFY(store->open(QString("layers/layer%1").arg(i)));
+            QVERIFY(devices[i]->write(writer));
+            store->close();
+        }
+
+        QVERIFY(store->finalize());
+        storeSize = buffer.size();
+    }
+
+    qDebug() << "Store size:" << storeSize / 1024 << "KiB";
+}
+
+void KisKraSaveBenchmark::benchmarkIncrementalSave_data()
+{
+    QTest::addColumn<int>("changedLayers");
+
+    QTest::newRow("0 of 8") << 0;
+    QTest::newRow("1 of 8") << 1;
+    QTest::newRow("2 of 8") << 2;
+    QTest::newRow("4 of 8") << 4;
+    QTest::newRow("8 of 8") << 8;
+}
+
+void KisKraSaveBenchmark::benchmarkIncrementalSave()
+{
+    QFETCH(int, changedLayers);
+
+    const int numLayers = 8;
+    const QRect rc(0, 0, 2048, 2048);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    QVector<KisPaintDeviceSP> devices;
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintDeviceSP dev = new KisPaintDevice(cs);
+        TestUtil::fillSyntheticContent(dev, rc, i);
+        devices << dev;
+    }
+
+    auto layerLocation = [] (int i) {
+        return QString("layers/layer%1").arg(i);
+    };
+
+    // the file written by the previous full save
+    QBuffer previousBuffer;
+    {
+        QScopedPointer<KoStore> store(
+            KoStore::createStore(&previousBuffer, KoStore::Write, "application/x-krita", KoStore::Zip));
+        store->setCompression(KoStore::CompressionStored);
+
+        KisStorePaintDeviceWriter writer(store.data());
+
+        for (int i = 0; i < numLayers; i++) {
+            QVERIFY(store->open(layerLocation(i)));
+            QVERIFY(devices[i]->write(writer));
+            store->close();
+        }
+
+        QVERIFY(store->finalize());
+    }
+
+    QByteArray savedData;
+
+    QBENCHMARK {
+        QScopedPointer<KoStore> previousStore(
+            KoStore::createStore(&previousBuffer, KoStore::Read, "", KoStore::Zip));
+
+        QBuffer buffer;
+        QScopedPointer<KoStore> store(
+            KoStore::createStore(&buffer, KoStore::Write, "application/x-krita", KoStore::Zip));
+        store->setCompression(KoStore::CompressionStored);
+
+        KisStorePaintDeviceWriter writer(store.data());
+
+        for (int i = 0; i < numLayers; i++) {
+            if (i < changedLayers) {
+                QVERIFY(store->open(layerLocation(i)));
+                QVERIFY(devices[i]->write(writer));
+                store->close();
+            } else {
+                QVERIFY(store->copyFileFrom(previousStore.data(), layerLocation(i), layerLocation(i)));
+            }
+        }
+
+        QVERIFY(store->finalize());
+        store.reset();
+        previousStore.reset();
+
+        savedData = buffer.data();
+    }
+
+    // the copied entries should be readable and identical to the original ones
+    QBuffer savedBuffer(&savedData);
+    QScopedPointer<KoStore> savedStore(KoStore::createStore(&savedBuffer, KoStore::Read, "", KoStore::Zip));
+    QScopedPointer<KoStore> previousStore(KoStore::createStore(&previousBuffer, KoStore::Read, "", KoStore::Zip));
+
+    for (int i = 0; i < numLayers; i++) {
+        QVERIFY(savedStore->open(layerLocation(i)));
+        QVERIFY(previousStore->open(layerLocation(i)));
+        QCOMPARE(savedStore->read(savedStore->size()), previousStore->read(previousStore->size()));
+        savedStore->close();
+        previousStore->close();
+    }
+}
+
+void KisKraSaveBenchmark::benchmarkSaveDocument()
+{
+    const int numLayers = 6;
+    const QRect imageRect(0, 0, 6000, 6000);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = TestUtil::createSyntheticImage(cs, imageRect, numLayers);
+
+    KisDocument *doc = KisPart::instance()->createDocument();
+    doc->setCurrentImage(image);
+
+    QBENCHMARK_ONCE {
+        QVERIFY(doc->exportDocumentSync(QUrl::fromLocalFile(QString(FILES_OUTPUT_DIR) + '/' + "save_benchmark.kra"),
+                                        doc->mimeType()));
+    }
+
+    delete doc;
+}
+
+QTEST_MAIN(KisKraSaveBenchmark)
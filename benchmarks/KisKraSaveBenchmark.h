@@ -0,0 +1,46 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_KRA_SAVE_BENCHMARK_H
+#define __KIS_KRA_SAVE_BENCHMARK_H
+
+#include <QtTest>
+
+/**
+ * Measures saving of a big synthetic document into a .kra file,
+ * the tile compression part of it separately, and the incremental
+ * save, which copies the unchanged layers from the previous file
+ */
+class KisKraSaveBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkWriteDevice_data();
+    void benchmarkWriteDevice();
+
+    void benchmarkStoreCompression_data();
+    void benchmarkStoreCompression();
+
+    void benchmarkIncrementalSave_data();
+    void benchmarkIncrementalSave();
+
+    void benchmarkSaveDocument();
+};
+
+#endif /* __KIS_KRA_SAVE_BENCHMARK_H */
@@ -0,0 +1,378 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisStrokeReplayBenchmark.h"
+
+#include <algorithm>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QThread>
+
+#include <testui.h>
+#include <KoCanvasResourceProvider.h>
+#include <KoCompositeOpRegistry.h>
+
+#include "stroke_testing_utils.h"
+#include "strokes/freehand_stroke.h"
+#include "strokes/KisFreehandStrokeInfo.h"
+#include "KisAsyncronousStrokeUpdateHelper.h"
+#include "KisStrokeRecording.h"
+#include "kis_resources_snapshot.h"
+#include "kis_image.h"
+#include "kis_image_config.h"
+#include "kis_distance_information.h"
+#include "kis_timing_information.h"
+#include <brushengine/kis_paint_information.h>
+#include <brushengine/kis_paintop_preset.h>
+#include <KisGlobalResourcesInterface.h>
+#include <KisLocalStrokeResources.h>
+
+
+namespace {
+
+// the same values KisToolFreehandHelper uses
+const qreal SPACING_UPDATE_INTERVAL = 50.0;
+const qreal TIMING_UPDATE_INTERVAL = 50.0;
+
+const QStringList DEFAULT_PRESETS = {
+    "autobrush_300px.kpp",
+    "softbrush_30px.kpp",
+    "colorsmudge.kpp",
+    "spray_21_textures1.kpp",
+    "hairy-70px.kpp",
+    "texture_masking_100px.kpp"
+};
+
+const QString DEFAULT_RECORDING = "stroke_replay_sample.kritastroke";
+
+struct ReplayStats
+{
+    QElapsedTimer timer;
+    QMutex mutex;
+
+    // all the values are in nanoseconds since the stroke start
+    QVector<qint64> paintJobsFinished;
+
+    qint64 initTime = 0;
+    qint64 paintTime = 0;
+    qint64 dabRenderingTime = 0;
+    qint64 updateTime = 0;
+    qint64 finishTime = 0;
+
+    int numDabs = 0;
+};
+
+/**
+ * A freehand stroke that measures how much time every stage of the
+ * stroke takes
+ */
+class ReplayStrokeStrategy : public FreehandStrokeStrategy
+{
+public:
+    ReplayStrokeStrategy(KisResourcesSnapshotSP resources,
+                         QVector<KisFreehandStrokeInfo*> strokeInfos,
+                         ReplayStats *stats)
+        : FreehandStrokeStrategy(resources, strokeInfos, kundo2_noi18n("Replay Stroke")),
+          m_strokeInfos(strokeInfos),
+          m_stats(stats)
+    {
+    }
+
+    void initStrokeCallback() override {
+        const qint64 start = m_stats->timer.nsecsElapsed();
+        FreehandStrokeStrategy::initStrokeCallback();
+        addTime(&m_stats->initTime, start);
+    }
+
+    void finishStrokeCallback() override {
+        Q_FOREACH (KisFreehandStrokeInfo *info, m_strokeInfos) {
+            m_stats->numDabs += info->dragDistance->currentDabSeqNo();
+        }
+
+        const qint64 start = m_stats->timer.nsecsElapsed();
+        FreehandStrokeStrategy::finishStrokeCallback();
+        addTime(&m_stats->finishTime, start);
+    }
+
+    void doStrokeCallback(KisStrokeJobData *data) override {
+        const bool isPaintJob = dynamic_cast<FreehandStrokeStrategy::Data*>(data);
+        const bool isUpdateJob = dynamic_cast<KisAsyncronousStrokeUpdateHelper::UpdateData*>(data);
+
+        const qint64 start = m_stats->timer.nsecsElapsed();
+        FreehandStrokeStrategy::doStrokeCallback(data);
+
+        /**
+         * The rest of the jobs are the runnable jobs of the paintop,
+         * e.g. the dabs rendering in the brush engine. They are run
+         * concurrently, so their time is the CPU time, not the wall time.
+         */
+        qint64 *stage =
+            isPaintJob ? &m_stats->paintTime :
+            isUpdateJob ? &m_stats->updateTime :
+            &m_stats->dabRenderingTime;
+
+        const qint64 end = addTime(stage, start);
+
+        if (isPaintJob) {
+            QMutexLocker l(&m_stats->mutex);
+            m_stats->paintJobsFinished.append(end);
+        }
+    }
+
+    KisStrokeStrategy* createLodClone(int levelOfDetail) override {
+        Q_UNUSED(levelOfDetail);
+        return 0;
+    }
+
+private:
+    qint64 addTime(qint64 *stage, qint64 start) {
+        const qint64 end = m_stats->timer.nsecsElapsed();
+
+        QMutexLocker l(&m_stats->mutex);
+        *stage += end - start;
+        return end;
+    }
+
+private:
+    QVector<KisFreehandStrokeInfo*> m_strokeInfos;
+    ReplayStats *m_stats;
+};
+
+KisStrokeJobData* createJobData(const KisStrokeRecording::Job &job)
+{
+    switch (job.type) {
+    case KisStrokeRecording::PaintAt:
+        return new FreehandStrokeStrategy::Data(job.strokeInfoId, job.pi1);
+    case KisStrokeRecording::PaintLine:
+        return new FreehandStrokeStrategy::Data(job.strokeInfoId, job.pi1, job.pi2);
+    case KisStrokeRecording::PaintBezierCurve:
+        return new FreehandStrokeStrategy::Data(job.strokeInfoId,
+                                                job.pi1, job.control1, job.control2, job.pi2);
+    }
+
+    return 0;
+}
+
+QRect recordingBounds(const KisStrokeRecording &recording)
+{
+    QRectF bounds(recording.startPos(), QSizeF(1, 1));
+
+    Q_FOREACH (const KisStrokeRecording::Job &job, recording.jobs()) {
+        bounds |= QRectF(job.pi1.pos(), QSizeF(1, 1));
+
+        if (job.type != KisStrokeRecording::PaintAt) {
+            bounds |= QRectF(job.pi2.pos(), QSizeF(1, 1));
+        }
+    }
+
+    return bounds.toAlignedRect();
+}
+
+qreal percentile(const QVector<qreal> &sortedValues, qreal portion)
+{
+    if (sortedValues.isEmpty()) return 0.0;
+
+    const int index = qBound(0, qRound(portion * (sortedValues.size() - 1)), sortedValues.size() - 1);
+    return sortedValues[index];
+}
+
+qreal toMs(qint64 nsecs)
+{
+    return qreal(nsecs) / 1000000.0;
+}
+
+QStringList findFiles(const QString &path, const QString &suffix)
+{
+    QFileInfo info(path);
+
+    if (info.isDir()) {
+        QDir dir(path);
+        QStringList result;
+        Q_FOREACH (const QString &fileName, dir.entryList(QStringList() << "*." + suffix, QDir::Files, QDir::Name)) {
+            result << dir.absoluteFilePath(fileName);
+        }
+        return result;
+    }
+
+    return {path};
+}
+
+KisPaintOpPresetSP loadPreset(const QString &fileName)
+{
+    KisPaintOpPresetSP preset(new KisPaintOpPreset(fileName));
+    if (!preset->load(KisGlobalResourcesInterface::instance())) {
+        return KisPaintOpPresetSP();
+    }
+
+    KisResourcesInterfaceSP localResources(
+        new KisLocalStrokeResources(preset->embeddedResources(KisGlobalResourcesInterface::instance())));
+    preset->setResourcesInterface(localResources);
+
+    return preset;
+}
+
+}
+
+void KisStrokeReplayBenchmark::testReplay_data()
+{
+    QTest::addColumn<QString>("recordingFile");
+    QTest::addColumn<QString>("presetFile");
+    QTest::addColumn<bool>("realtime");
+
+    const QString dataPath = QString(FILES_DATA_DIR) + '/';
+
+    QStringList recordings;
+    if (qEnvironmentVariableIsSet("KRITA_STROKE_RECORDING")) {
+        recordings = findFiles(QString::fromLocal8Bit(qgetenv("KRITA_STROKE_RECORDING")), "kritastroke");
+    } else {
+        recordings << dataPath + DEFAULT_RECORDING;
+    }
+
+    QStringList presets;
+    if (qEnvironmentVariableIsSet("KRITA_STROKE_PRESET")) {
+        presets = findFiles(QString::fromLocal8Bit(qgetenv("KRITA_STROKE_PRESET")), "kpp");
+    } else {
+        Q_FOREACH (const QString &preset, DEFAULT_PRESETS) {
+            presets << dataPath + preset;
+        }
+    }
+
+    Q_FOREACH (const QString &recording, recordings) {
+        Q_FOREACH (const QString &preset, presets) {
+            const QString name =
+                QString("%1 %2").arg(QFileInfo(recording).fileName()).arg(QFileInfo(preset).fileName());
+
+            QTest::newRow(qPrintable(name + " burst")) << recording << preset << false;
+            QTest::newRow(qPrintable(name + " realtime")) << recording << preset << true;
+        }
+    }
+}
+
+void KisStrokeReplayBenchmark::testReplay()
+{
+    QFETCH(QString, recordingFile);
+    QFETCH(QString, presetFile);
+    QFETCH(bool, realtime);
+
+    KisStrokeRecording recording;
+    QVERIFY(recording.load(recordingFile));
+    QVERIFY(!recording.isEmpty());
+
+    KisPaintOpPresetSP preset = loadPreset(presetFile);
+    QVERIFY(preset);
+
+    const QRect bounds = recordingBounds(recording);
+    const QSize imageSize(qMax(1000, bounds.right() + 200), qMax(1000, bounds.bottom() + 200));
+
+    KisImageSP image = utils::createImage(0, imageSize);
+    QScopedPointer<KoCanvasResourceProvider> manager(utils::createResourceManager(image, 0, ""));
+
+    QVariant v;
+    v.setValue(preset);
+    manager->setResource(KoCanvasResource::CurrentPaintOpPreset, v);
+
+    KisResourcesSnapshotSP resources =
+        new KisResourcesSnapshot(image, image->rootLayer()->firstChild(), manager.data());
+
+    const bool airbrushing = resources->needsAirbrushing();
+    const bool useSpacingUpdates = resources->needsSpacingUpdates();
+    const bool needsAsyncUpdates = resources->presetNeedsAsynchronousUpdates();
+
+    KisDistanceInitInfo startDistInfo(recording.startPos(),
+                                      recording.startAngle(),
+                                      useSpacingUpdates ? SPACING_UPDATE_INTERVAL : LONG_TIME,
+                                      airbrushing ? TIMING_UPDATE_INTERVAL : LONG_TIME,
+                                      0);
+
+    QVector<KisFreehandStrokeInfo*> strokeInfos;
+    for (int i = 0; i < recording.numStrokeInfos(); i++) {
+        strokeInfos << new KisFreehandStrokeInfo(startDistInfo.makeDistInfo());
+    }
+
+    const qint64 updateInterval = 1000000000LL / qMax(1, KisImageConfig(true).fpsLimit());
+
+    ReplayStats stats;
+    QVector<qint64> paintJobsStarted;
+    qint64 lastUpdateTime = 0;
+
+    stats.timer.start();
+    KisStrokeId strokeId =
+        image->startStroke(new ReplayStrokeStrategy(resources, strokeInfos, &stats));
+
+    Q_FOREACH (const KisStrokeRecording::Job &job, recording.jobs()) {
+        if (realtime) {
+            const qint64 timeLeft = job.time - stats.timer.elapsed();
+            if (timeLeft > 0) {
+                QThread::msleep(timeLeft);
+            }
+        }
+
+        const qint64 now = stats.timer.nsecsElapsed();
+        paintJobsStarted.append(now);
+        image->addJob(strokeId, createJobData(job));
+
+        if (realtime && needsAsyncUpdates && now - lastUpdateTime > updateInterval) {
+            image->addJob(strokeId, new KisAsyncronousStrokeUpdateHelper::UpdateData(false));
+            lastUpdateTime = now;
+        }
+    }
+
+    if (needsAsyncUpdates) {
+        image->addJob(strokeId, new KisAsyncronousStrokeUpdateHelper::UpdateData(true));
+    }
+
+    image->endStroke(strokeId);
+    image->waitForDone();
+
+    const qint64 wallTime = stats.timer.nsecsElapsed();
+
+    QCOMPARE(stats.paintJobsFinished.size(), paintJobsStarted.size());
+
+    QVector<qreal> latencies;
+    for (int i = 0; i < paintJobsStarted.size(); i++) {
+        latencies << toMs(stats.paintJobsFinished[i] - paintJobsStarted[i]);
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    const qint64 stagesTime =
+        stats.initTime + stats.paintTime + stats.updateTime + stats.finishTime;
+
+    qDebug() << qPrintable(QString("%1 (%2):")
+                           .arg(QFileInfo(presetFile).fileName())
+                           .arg(realtime ? "realtime" : "burst"));
+    qDebug() << qPrintable(QString("    dabs: %1, wall time: %2 ms, dabs/sec: %3")
+                           .arg(stats.numDabs)
+                           .arg(toMs(wallTime), 0, 'f', 1)
+                           .arg(stats.numDabs / qMax(0.001, toMs(wallTime) / 1000.0), 0, 'f', 1));
+    qDebug() << qPrintable(QString("    paint job latency (ms): p50 %1, p90 %2, p99 %3, max %4")
+                           .arg(percentile(latencies, 0.5), 0, 'f', 2)
+                           .arg(percentile(latencies, 0.9), 0, 'f', 2)
+                           .arg(percentile(latencies, 0.99), 0, 'f', 2)
+                           .arg(percentile(latencies, 1.0), 0, 'f', 2));
+    qDebug() << qPrintable(QString("    stages (ms): init %1, paint %2, dab rendering (cpu) %3, updates %4, finish %5, other %6")
+                           .arg(toMs(stats.initTime), 0, 'f', 1)
+                           .arg(toMs(stats.paintTime), 0, 'f', 1)
+                           .arg(toMs(stats.dabRenderingTime), 0, 'f', 1)
+                           .arg(toMs(stats.updateTime), 0, 'f', 1)
+                           .arg(toMs(stats.finishTime), 0, 'f', 1)
+                           .arg(toMs(qMax(0LL, wallTime - stagesTime)), 0, 'f', 1));
+}
+
+KISTEST_MAIN(KisStrokeReplayBenchmark)
@@ -0,0 +1,50 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KISSTROKEREPLAYBENCHMARK_H
+#define KISSTROKEREPLAYBENCHMARK_H
+
+#include <QtTest>
+
+/**
+ * Replays freehand strokes recorded by KisToolFreehandHelper (see
+ * KisStrokeRecording) through the full stroke pipeline, without
+ * any GUI.
+ *
+ * By default the sample recording from the data folder is replayed
+ * against a few presets from the same folder. Use the environment
+ * variables to replay your own strokes:
+ *
+ * KRITA_STROKE_RECORDING  a .kritastroke file or a folder with them
+ * KRITA_STROKE_PRESET     a .kpp preset or a folder with them
+ *
+ * Every stroke is replayed twice: in "burst" mode all the jobs are
+ * queued at once, which measures the throughput of the paintop, and
+ * in "realtime" mode the jobs are queued at the recorded time, which
+ * measures the latency the user would see.
+ */
+class KisStrokeReplayBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testReplay_data();
+    void testReplay();
+};
+
+#endif // KISSTROKEREPLAYBENCHMARK_H
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisTransactionCommitBenchmark.h"
+
+#include <QTest>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoCompositeOpRegistry.h>
+
+#include <kis_image.h>
+#include <kis_paint_device.h>
+#include <kis_paint_layer.h>
+#include <kis_transaction.h>
+#include <kis_undo_stores.h>
+#include <kis_post_execution_undo_adapter.h>
+#include <kundo2command.h>
+
+/**
+ * The number of undo steps kept alive while measuring, so that
+ * the devices have some history, like in a real document
+ */
+static const int HISTORY_SIZE = 30;
+
+/**
+ * The area covered by a single "stroke"
+ */
+static const QSize STROKE_SIZE(512, 512);
+
+void KisTransactionCommitBenchmark::benchmarkCommit_data()
+{
+    QTest::addColumn<int>("deviceSize");
+
+    QTest::newRow("1024") << 1024;
+    QTest::newRow("4096") << 4096;
+    QTest::newRow("8192") << 8192;
+    QTest::newRow("16384") << 16384;
+}
+
+void KisTransactionCommitBenchmark::benchmarkCommit()
+{
+    QFETCH(int, deviceSize);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    QList<KUndo2Command*> history;
+
+    /**
+     * The first transaction covers the whole device, so all the
+     * internal tables of the memento manager grow to the size of
+     * the device. The following transactions should not depend on
+     * that anymore.
+     */
+    {
+        KisTransaction transaction(dev);
+        dev->fill(QRect(0, 0, deviceSize, deviceSize), KoColor(Qt::white, cs));
+        history << transaction.endAndTake();
+    }
+
+    const QRect strokeRect(QPoint(deviceSize / 2, deviceSize / 2), STROKE_SIZE);
+    const KoColor colors[] = {KoColor(Qt::red, cs), KoColor(Qt::green, cs)};
+    int i = 0;
+
+    QBENCHMARK {
+        KisTransaction transaction(dev);
+        dev->fill(strokeRect, colors[i++ & 0x1]);
+        history << transaction.endAndTake();
+
+        if (history.size() > HISTORY_SIZE) {
+            delete history.takeFirst();
+        }
+    }
+
+    qDeleteAll(history);
+}
+
+void KisTransactionCommitBenchmark::benchmarkMergeToLayer_data()
+{
+    QTest::addColumn<int>("strokeSize");
+
+    QTest::newRow("512") << 512;
+    QTest::newRow("2048") << 2048;
+    QTest::newRow("8192") << 8192;
+}
+
+void KisTransactionCommitBenchmark::benchmarkMergeToLayer()
+{
+    QFETCH(int, strokeSize);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, strokeSize, strokeSize, cs, "merge benchmark");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "layer", OPACITY_OPAQUE_U8, cs);
+    image->addNode(layer);
+
+    layer->paintDevice()->fill(image->bounds(), KoColor(Qt::white, cs));
+
+    KisDumbUndoStore undoStore;
+    KisPostExecutionUndoAdapter undoAdapter(&undoStore, 0);
+
+    QBENCHMARK {
+        KisPaintDeviceSP temporaryTarget = new KisPaintDevice(cs);
+        temporaryTarget->fill(image->bounds(), KoColor(Qt::red, cs));
+
+        layer->setTemporaryTarget(temporaryTarget);
+        layer->setTemporaryCompositeOp(COMPOSITE_OVER);
+        layer->setTemporaryOpacity(OPACITY_OPAQUE_U8 / 2);
+
+        layer->mergeToLayer(layer, &undoAdapter, kundo2_noi18n("merge"));
+    }
+}
+
+QTEST_MAIN(KisTransactionCommitBenchmark)
@@ -37,6 +37,11 @@
 #include <KoOptimizedCompositeOpAlphaDarken32.h>
 #endif
 
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
 #include "kis_composition_benchmark.h"
 #include <QTest>
 #include <QElapsedTimer>
@@ -158,6 +163,27 @@ struct RandomGenerator<double> : RandomGenerator<float>
 };
 
 
+#ifdef HAVE_OPENEXR
+template <>
+struct RandomGenerator<half>
+{
+    RandomGenerator(int seed)
+        : m_floatRnd(seed)
+    {
+    }
+
+    half operator() () {
+        return half(m_floatRnd());
+    }
+
+    half unit() {
+        return KoColorSpaceMathsTraits<half>::unitValue;
+    }
+
+    RandomGenerator<float> m_floatRnd;
+};
+#endif
+
 template <typename channel_type>
 void generateDataLine(uint seed, int numPixels, quint8 *srcPixels, quint8 *dstPixels, quint8 *mask, AlphaRange srcAlphaRange, AlphaRange dstAlphaRange)
 {
@@ -257,6 +283,10 @@ QVector<Tile> generateTiles(int size,
             generateDataLine<quint8>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
         } else if (pixelSize == 16) {
             generateDataLine<float>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
+#ifdef HAVE_OPENEXR
+        } else if (pixelSize == 8) {
+            generateDataLine<half>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
+#endif
         } else {
             qFatal("Pixel size %i is not implemented", pixelSize);
         }
@@ -322,6 +352,34 @@ bool compareTwoOpsPixels(QVector<Tile> &tiles, channel_type prec) {
     return true;
 }
 
+#ifdef HAVE_OPENEXR
+/**
+ * Half-float pixels are compared in floats, the optimized ops do
+ * their math in 32-bit floats, while the legacy ones round every
+ * intermediate value to half precision
+ */
+bool compareTwoOpsPixelsF16(QVector<Tile> &tiles, float prec) {
+    QVector<QVector<float>> buffers(4, QVector<float>(numPixels * 4));
+    QVector<Tile> floatTiles(2);
+
+    for (int t = 0; t < 2; t++) {
+        const half *src = reinterpret_cast<const half*>(tiles[t].src);
+        const half *dst = reinterpret_cast<const half*>(tiles[t].dst);
+
+        for (int i = 0; i < numPixels * 4; i++) {
+            buffers[2 * t][i] = src[i];
+            buffers[2 * t + 1][i] = dst[i];
+        }
+
+        floatTiles[t].src = reinterpret_cast<quint8*>(buffers[2 * t].data());
+        floatTiles[t].dst = reinterpret_cast<quint8*>(buffers[2 * t + 1].data());
+        floatTiles[t].mask = tiles[t].mask;
+    }
+
+    return compareTwoOpsPixels<float>(floatTiles, prec);
+}
+#endif
+
 bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp *op2)
 {
     Q_ASSERT(op1->colorSpace()->pixelSize() == op2->colorSpace()->pixelSize());
@@ -357,6 +415,11 @@ bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp
     else if (pixelSize == 16) {
         compareResult = compareTwoOpsPixels<float>(tiles, 2e-7);
     }
+#ifdef HAVE_OPENEXR
+    else if (pixelSize == 8) {
+        compareResult = compareTwoOpsPixelsF16(tiles, 2e-3);
+    }
+#endif
     else {
         qFatal("Pixel size %i is not implemented", pixelSize);
     }
@@ -662,6 +725,22 @@ void KisCompositionBenchmark::compareRgbF32AlphaDarkenOps()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareRgbF16AlphaDarkenOps()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamy64(cs);
+    KoCompositeOp *opExp = new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperCreamy>(cs);
+
+    QVERIFY(compareTwoOps(true, opAct, opExp));
+
+    delete opExp;
+    delete opAct;
+#else
+    QSKIP("Half-float color spaces are not available without OpenEXR");
+#endif
+}
+
 void KisCompositionBenchmark::compareAlphaDarkenOpsNoMask()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -710,6 +789,23 @@ void KisCompositionBenchmark::compareRgbF32OverOps()
     delete opAct;
 }
 
+void KisCompositionBenchmark::compareRgbF16OverOps()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *opAct = KoOptimizedCompositeOpFactory::createOverOp64(cs);
+    KoCompositeOp *opExp = new KoCompositeOpOver<KoRgbF16Traits>(cs);
+
+    QVERIFY(compareTwoOps(false, opAct, opExp));
+    QVERIFY(compareTwoOps(true, opAct, opExp));
+
+    delete opExp;
+    delete opAct;
+#else
+    QSKIP("Half-float color spaces are not available without OpenEXR");
+#endif
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenLegacy()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -774,6 +870,46 @@ void KisCompositionBenchmark::testRgbF32CompositeOverOptimized()
     delete op;
 }
 
+void KisCompositionBenchmark::testRgbF16CompositeAlphaDarkenLegacy()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperCreamy>(cs);
+    benchmarkCompositeOp(op, "RGBF16 Legacy");
+    delete op;
+#endif
+}
+
+void KisCompositionBenchmark::testRgbF16CompositeAlphaDarkenOptimized()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamy64(cs);
+    benchmarkCompositeOp(op, "RGBF16 Optimized");
+    delete op;
+#endif
+}
+
+void KisCompositionBenchmark::testRgbF16CompositeOverLegacy()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = new KoCompositeOpOver<KoRgbF16Traits>(cs);
+    benchmarkCompositeOp(op, "RGBF16 Legacy");
+    delete op;
+#endif
+}
+
+void KisCompositionBenchmark::testRgbF16CompositeOverOptimized()
+{
+#ifdef HAVE_OPENEXR
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    KoCompositeOp *op = KoOptimizedCompositeOpFactory::createOverOp64(cs);
+    benchmarkCompositeOp(op, "RGBF16 Optimized");
+    delete op;
+#endif
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenReal_Aligned()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -42,9 +42,11 @@ private Q_SLOTS:
     void compareAlphaDarkenOps();
     void compareAlphaDarkenOpsNoMask();
     void compareRgbF32AlphaDarkenOps();
+    void compareRgbF16AlphaDarkenOps();
     void compareOverOps();
     void compareOverOpsNoMask();
     void compareRgbF32OverOps();
+    void compareRgbF16OverOps();
 
     void testRgb8CompositeAlphaDarkenLegacy();
     void testRgb8CompositeAlphaDarkenOptimized();
@@ -58,6 +60,12 @@ private Q_SLOTS:
     void testRgbF32CompositeOverLegacy();
     void testRgbF32CompositeOverOptimized();
 
+    void testRgbF16CompositeAlphaDarkenLegacy();
+    void testRgbF16CompositeAlphaDarkenOptimized();
+
+    void testRgbF16CompositeOverLegacy();
+    void testRgbF16CompositeOverOptimized();
+
     void testRgb8CompositeAlphaDarkenReal_Aligned();
     void testRgb8CompositeOverReal_Aligned();
 
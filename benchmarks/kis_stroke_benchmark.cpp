@@ -26,6 +26,7 @@ inline double drand48()
 }
 #endif
 
+#include <QPainter>
 #include <QPainterPath>
 #include <QTest>
 
@@ -51,6 +52,10 @@ inline double drand48()
 #include <brushengine/kis_paintop_registry.h>
 
 #include <KisGlobalResourcesInterface.h>
+#include <KisLocalStrokeResources.h>
+
+#include <kis_fixed_paint_device.h>
+#include <kis_gbr_brush.h>
 
 //#define SAVE_OUTPUT
 
@@ -58,6 +63,18 @@ static const int LINES = 20;
 static const int RECTANGLES = 20;
 const QString OUTPUT_FORMAT = ".png";
 
+/**
+ * The patterns embedded into the benchmark presets are not present in the
+ * resource database, so pass them to the paintop directly
+ */
+static void attachEmbeddedResources(KisPaintOpPresetSP preset)
+{
+    KisResourcesInterfaceSP globalResources = KisGlobalResourcesInterface::instance();
+    KisResourcesInterfaceSP localResources(
+        new KisLocalStrokeResources(preset->embeddedResources(globalResources)));
+    preset->setResourcesInterface(localResources);
+}
+
 void KisStrokeBenchmark::initTestCase()
 {
     m_dataPath = QString(FILES_DATA_DIR) + '/';
@@ -404,6 +421,39 @@ void KisStrokeBenchmark::roundMarkerRectangleHalfPixel()
 }
 
 
+void KisStrokeBenchmark::predefinedBrushDabs50px()
+{
+    benchmarkPredefinedBrushDabs(50);
+}
+
+void KisStrokeBenchmark::predefinedBrushDabs100px()
+{
+    benchmarkPredefinedBrushDabs(100);
+}
+
+void KisStrokeBenchmark::predefinedBrushDabs300px()
+{
+    benchmarkPredefinedBrushDabs(300);
+}
+
+void KisStrokeBenchmark::predefinedBrushDabs1000px()
+{
+    benchmarkPredefinedBrushDabs(1000);
+}
+
+void KisStrokeBenchmark::textureMaskingBrush()
+{
+    // Pixel brush engine, 100px, subtract texture and a masking brush in multiply mode
+    QString presetFileName = "texture_masking_100px.kpp";
+    benchmarkStroke(presetFileName, true);
+}
+
+void KisStrokeBenchmark::textureMaskingBrushRL()
+{
+    QString presetFileName = "texture_masking_100px.kpp";
+    benchmarkRandomLines(presetFileName, true);
+}
+
 
 /*
 void KisStrokeBenchmark::predefinedBrush()
@@ -513,7 +563,7 @@ QBENCHMARK{
 
 
 
-void KisStrokeBenchmark::benchmarkRandomLines(QString presetFileName)
+void KisStrokeBenchmark::benchmarkRandomLines(QString presetFileName, bool useEmbeddedResources)
 {
     KisPaintOpPresetSP preset(new KisPaintOpPreset(m_dataPath + presetFileName));
     bool loadedOk = preset->load(KisGlobalResourcesInterface::instance());
@@ -524,6 +574,10 @@ void KisStrokeBenchmark::benchmarkRandomLines(QString presetFileName)
         dbgKrita << "preset : " << presetFileName;
     }
 
+    if (useEmbeddedResources) {
+        attachEmbeddedResources(preset);
+    }
+
     m_painter->setPaintOpPreset(preset, m_layer, m_image);
 
     QBENCHMARK{
@@ -542,6 +596,47 @@ void KisStrokeBenchmark::benchmarkRandomLines(QString presetFileName)
 
 
 
+void KisStrokeBenchmark::benchmarkPredefinedBrushDabs(int size)
+{
+    /**
+     * The presets cannot reference brush tips from the resource
+     * database here, so just measure the generation of the dabs of an
+     * image brush, rotated and shifted as they would be in a stroke
+     */
+    QImage tip(512, 512, QImage::Format_ARGB32);
+    tip.fill(0);
+    {
+        QPainter gc(&tip);
+        gc.setRenderHints(QPainter::Antialiasing);
+        QRadialGradient gradient(QPointF(256, 256), 256);
+        gradient.setColorAt(0.0, Qt::black);
+        gradient.setColorAt(1.0, Qt::transparent);
+        gc.setBrush(gradient);
+        gc.setPen(Qt::NoPen);
+        gc.drawEllipse(QPointF(256, 256), 256, 180);
+
+        gc.setPen(QPen(Qt::black, 8));
+        for (int i = 0; i < 8; i++) {
+            gc.drawLine(QPointF(64 * i, 0), QPointF(512 - 64 * i, 512));
+        }
+    }
+
+    KisBrushSP brush(new KisGbrBrush(tip, "benchmark tip"));
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(m_colorSpace);
+    KisPaintInformation info(QPointF(), 1.0);
+
+    const qreal scale = qreal(size) / tip.width();
+    const int numDabs = 100;
+
+    QBENCHMARK {
+        for (int i = 0; i < numDabs; i++) {
+            const qreal subPixel = 0.25 * (i % 4);
+            const KisDabShape shape(scale, 1.0, 2.0 * M_PI * i / numDabs);
+            brush->mask(dab, m_color, shape, info, subPixel, subPixel);
+        }
+    }
+}
+
 void KisStrokeBenchmark::benchmarkRectangle(QString presetFileName)
 {
     KisPaintOpPresetSP preset(new KisPaintOpPreset(m_dataPath + presetFileName));
@@ -571,7 +666,7 @@ void KisStrokeBenchmark::benchmarkRectangle(QString presetFileName)
 #endif
 }
 
-void KisStrokeBenchmark::benchmarkStroke(QString presetFileName)
+void KisStrokeBenchmark::benchmarkStroke(QString presetFileName, bool useEmbeddedResources)
 {
     KisPaintOpPresetSP preset(new KisPaintOpPreset(m_dataPath + presetFileName));
     bool loadedOk = preset->load(KisGlobalResourcesInterface::instance());
@@ -582,6 +677,10 @@ void KisStrokeBenchmark::benchmarkStroke(QString presetFileName)
         dbgKrita << "preset : " << presetFileName;
     }
 
+    if (useEmbeddedResources) {
+        attachEmbeddedResources(preset);
+    }
+
     m_painter->setPaintOpPreset(preset, m_layer, m_image);
 
     QBENCHMARK{
@@ -63,11 +63,12 @@ private:
     QString m_outputPath;
 
     private:
-        inline void benchmarkRandomLines(QString presetFileName);
-        inline void benchmarkStroke(QString presetFileName);
+        inline void benchmarkRandomLines(QString presetFileName, bool useEmbeddedResources = false);
+        inline void benchmarkStroke(QString presetFileName, bool useEmbeddedResources = false);
         inline void benchmarkLine(QString presetFileName);
         inline void benchmarkCircle(QString presetFileName);
         inline void benchmarkRectangle(QString presetFileName);
+        inline void benchmarkPredefinedBrushDabs(int size);
 
 private Q_SLOTS:
     void initTestCase();
@@ -135,6 +136,14 @@ private Q_SLOTS:
     void roundMarkerRandomLinesHalfPixel();
     void roundMarkerRectangleHalfPixel();
 
+    void predefinedBrushDabs50px();
+    void predefinedBrushDabs100px();
+    void predefinedBrushDabs300px();
+    void predefinedBrushDabs1000px();
+
+    void textureMaskingBrush();
+    void textureMaskingBrushRL();
+
 /*
     void predefinedBrush();
     void predefinedBrushRL();
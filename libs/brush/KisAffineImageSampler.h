@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KISAFFINEIMAGESAMPLER_H
+#define KISAFFINEIMAGESAMPLER_H
+
+#include <QImage>
+
+#include "kritabrush_export.h"
+
+/**
+ * Resamples a QImage::Format_ARGB32 image along a straight line of
+ * source coordinates. Used by KisQImagePyramid to generate transformed
+ * brush tips without going through QPainter.
+ *
+ * Coordinates are expressed in pixel indexes of \p src, that is, (0, 0)
+ * is the center of the top-left pixel. Everything outside the image is
+ * considered fully transparent. Interpolation is done on premultiplied
+ * values, the result is written as non-premultiplied ARGB32.
+ */
+class BRUSH_EXPORT KisAffineImageSampler
+{
+public:
+    enum Interpolation {
+        Bilinear,
+        Bicubic ///< Catmull-Rom spline, used for upscaling beyond the biggest pyramid level
+    };
+
+public:
+    virtual ~KisAffineImageSampler();
+
+    /**
+     * Samples \p numPixels pixels into \p dst. The first sample is taken
+     * at (\p srcX, \p srcY), every next one is offset by (\p dx, \p dy).
+     */
+    virtual void sampleRow(const QImage &src,
+                           float srcX, float srcY,
+                           float dx, float dy,
+                           int numPixels, QRgb *dst) const = 0;
+
+    /**
+     * Creates a sampler optimized for the current CPU
+     */
+    static KisAffineImageSampler* create(Interpolation interpolation);
+};
+
+#endif // KISAFFINEIMAGESAMPLER_H
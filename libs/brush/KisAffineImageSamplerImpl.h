@@ -0,0 +1,249 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KISAFFINEIMAGESAMPLERIMPL_H
+#define KISAFFINEIMAGESAMPLERIMPL_H
+
+#include <cmath>
+
+#include <QtGlobal>
+
+#include "KisAffineImageSampler.h"
+#include <compositeops/KoVcMultiArchBuildSupport.h>
+
+/**
+ * Common code of the samplers. All the methods are templated by the
+ * Vc implementation to avoid ODR violations between the per-arch
+ * object files.
+ */
+template<Vc::Implementation _impl>
+struct KisAffineImageSamplerOps
+{
+    struct Source {
+        Source(const QImage &image)
+            : bits(reinterpret_cast<const QRgb*>(image.constBits())),
+              stride(image.bytesPerLine() / int(sizeof(QRgb))),
+              width(image.width()),
+              height(image.height())
+        {
+        }
+
+        const QRgb *bits;
+        int stride;
+        int width;
+        int height;
+    };
+
+    static inline void accumulate(const Source &src, int x, int y, float weight, float *acc) {
+        if (x < 0 || y < 0 || x >= src.width || y >= src.height) return;
+
+        const QRgb pixel = src.bits[y * src.stride + x];
+        const float alpha = qAlpha(pixel) * weight;
+
+        acc[0] += qRed(pixel) * alpha;
+        acc[1] += qGreen(pixel) * alpha;
+        acc[2] += qBlue(pixel) * alpha;
+        acc[3] += alpha;
+    }
+
+    static inline QRgb pack(const float *acc) {
+        const int alpha = qBound(0, qRound(acc[3]), 255);
+        if (!alpha) return 0;
+
+        const float k = 1.0f / acc[3];
+        return qRgba(qBound(0, qRound(acc[0] * k), 255),
+                     qBound(0, qRound(acc[1] * k), 255),
+                     qBound(0, qRound(acc[2] * k), 255),
+                     alpha);
+    }
+
+    static inline QRgb sampleBilinear(const Source &src, float x, float y) {
+        const float fx = std::floor(x);
+        const float fy = std::floor(y);
+        const int x0 = int(fx);
+        const int y0 = int(fy);
+
+        if (x0 < -1 || y0 < -1 || x0 >= src.width || y0 >= src.height) return 0;
+
+        const float tx = x - fx;
+        const float ty = y - fy;
+
+        float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        accumulate(src, x0,     y0,     (1.0f - tx) * (1.0f - ty), acc);
+        accumulate(src, x0 + 1, y0,     tx * (1.0f - ty), acc);
+        accumulate(src, x0,     y0 + 1, (1.0f - tx) * ty, acc);
+        accumulate(src, x0 + 1, y0 + 1, tx * ty, acc);
+
+        return pack(acc);
+    }
+
+    static inline void catmullRomWeights(float t, float *w) {
+        w[0] = ((-0.5f * t + 1.0f) * t - 0.5f) * t;
+        w[1] = (1.5f * t - 2.5f) * t * t + 1.0f;
+        w[2] = ((-1.5f * t + 2.0f) * t + 0.5f) * t;
+        w[3] = (0.5f * t - 0.5f) * t * t;
+    }
+
+    static inline QRgb sampleBicubic(const Source &src, float x, float y) {
+        const float fx = std::floor(x);
+        const float fy = std::floor(y);
+        const int x0 = int(fx);
+        const int y0 = int(fy);
+
+        if (x0 < -2 || y0 < -2 || x0 > src.width || y0 > src.height) return 0;
+
+        float wx[4];
+        float wy[4];
+        catmullRomWeights(x - fx, wx);
+        catmullRomWeights(y - fy, wy);
+
+        float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (int j = 0; j < 4; j++) {
+            for (int i = 0; i < 4; i++) {
+                accumulate(src, x0 - 1 + i, y0 - 1 + j, wx[i] * wy[j], acc);
+            }
+        }
+
+        return pack(acc);
+    }
+};
+
+template<Vc::Implementation _impl>
+class KisBilinearImageSampler : public KisAffineImageSampler
+{
+    typedef KisAffineImageSamplerOps<_impl> Ops;
+
+public:
+    void sampleRow(const QImage &image,
+                   float srcX, float srcY,
+                   float dx, float dy,
+                   int numPixels, QRgb *dst) const override
+    {
+        const typename Ops::Source src(image);
+        int i = 0;
+
+#ifdef HAVE_VC
+        using float_v = Vc::float_v;
+        using float_m = Vc::float_m;
+        using int_v = Vc::SimdArray<int, float_v::size()>;
+
+        const float_v zero(Vc::Zero);
+        const float_v one(Vc::One);
+        const float_v width(float(src.width));
+        const float_v height(float(src.height));
+        const float_v maxX(float(src.width - 1));
+        const float_v maxY(float(src.height - 1));
+        const float_v stride(float(src.stride));
+        const int *bits = reinterpret_cast<const int*>(src.bits);
+
+        for (; i + int(float_v::size()) <= numPixels; i += float_v::size()) {
+            const float_v index = float_v(float(i)) + float_v::IndexesFromZero();
+            const float_v x = float_v(srcX) + index * float_v(dx);
+            const float_v y = float_v(srcY) + index * float_v(dy);
+
+            const float_v fx = Vc::floor(x);
+            const float_v fy = Vc::floor(y);
+            const float_v tx = x - fx;
+            const float_v ty = y - fy;
+
+            // the taps outside the image get zero weight...
+            float_v wx0 = one - tx;
+            float_v wx1 = tx;
+            float_v wy0 = one - ty;
+            float_v wy1 = ty;
+            wx0.setZero(fx < zero || fx >= width);
+            wx1.setZero(fx < -one || fx >= width - one);
+            wy0.setZero(fy < zero || fy >= height);
+            wy1.setZero(fy < -one || fy >= height - one);
+
+            const float_m empty = (wx0 + wx1 == zero) || (wy0 + wy1 == zero);
+            if (empty.isFull()) {
+                int_v(0).store(reinterpret_cast<int*>(dst + i), Vc::Unaligned);
+                continue;
+            }
+
+            // ... and their indexes are clamped to stay inside the image
+            const int_v x0(Vc::max(Vc::min(fx, maxX), zero));
+            const int_v x1(Vc::max(Vc::min(fx + one, maxX), zero));
+            const int_v y0(Vc::max(Vc::min(fy, maxY), zero) * stride);
+            const int_v y1(Vc::max(Vc::min(fy + one, maxY), zero) * stride);
+
+            float_v acc[4] = {zero, zero, zero, zero};
+            accumulate(int_v(bits, y0 + x0), wx0 * wy0, acc);
+            accumulate(int_v(bits, y0 + x1), wx1 * wy0, acc);
+            accumulate(int_v(bits, y1 + x0), wx0 * wy1, acc);
+            accumulate(int_v(bits, y1 + x1), wx1 * wy1, acc);
+
+            const float_v alpha = Vc::min(acc[3], float_v(255.0f));
+            float_v k = one / acc[3];
+            k.setZero(alpha < float_v(0.5f));
+
+            const int_v result =
+                (int_v(Vc::round(alpha)) << 24) |
+                (int_v(Vc::round(Vc::min(acc[0] * k, float_v(255.0f)))) << 16) |
+                (int_v(Vc::round(Vc::min(acc[1] * k, float_v(255.0f)))) << 8) |
+                int_v(Vc::round(Vc::min(acc[2] * k, float_v(255.0f))));
+
+            result.store(reinterpret_cast<int*>(dst + i), Vc::Unaligned);
+        }
+#endif
+
+        for (; i < numPixels; i++) {
+            dst[i] = Ops::sampleBilinear(src, srcX + i * dx, srcY + i * dy);
+        }
+    }
+
+private:
+#ifdef HAVE_VC
+    template<class int_v, class float_v>
+    static inline void accumulate(const int_v &pixels, const float_v &weight, float_v *acc) {
+        const float_v alpha = Vc::simd_cast<float_v>((pixels >> 24) & 0xff) * weight;
+
+        acc[0] += Vc::simd_cast<float_v>((pixels >> 16) & 0xff) * alpha;
+        acc[1] += Vc::simd_cast<float_v>((pixels >> 8) & 0xff) * alpha;
+        acc[2] += Vc::simd_cast<float_v>(pixels & 0xff) * alpha;
+        acc[3] += alpha;
+    }
+#endif
+};
+
+/**
+ * Bicubic sampling is used only when the dab is bigger than the biggest
+ * level of the pyramid, which is rare for brush tips (the pyramid has
+ * levels up to MAX_MIPMAP_SCALE), so it is not vectorized explicitly.
+ */
+template<Vc::Implementation _impl>
+class KisBicubicImageSampler : public KisAffineImageSampler
+{
+    typedef KisAffineImageSamplerOps<_impl> Ops;
+
+public:
+    void sampleRow(const QImage &image,
+                   float srcX, float srcY,
+                   float dx, float dy,
+                   int numPixels, QRgb *dst) const override
+    {
+        const typename Ops::Source src(image);
+
+        for (int i = 0; i < numPixels; i++) {
+            dst[i] = Ops::sampleBicubic(src, srcX + i * dx, srcY + i * dy);
+        }
+    }
+};
+
+#endif // KISAFFINEIMAGESAMPLERIMPL_H
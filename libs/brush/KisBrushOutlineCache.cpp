@@ -0,0 +1,247 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisBrushOutlineCache.h"
+
+#include <QFutureSynchronizer>
+#include <QGlobalStatic>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QTransform>
+#include <QtConcurrent>
+#include <QtMath>
+
+#include <cmath>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_auto_brush.h"
+#include "kis_fixed_paint_device.h"
+#include "kis_outline_generator.h"
+
+Q_GLOBAL_STATIC(KisBrushOutlineCache, s_instance)
+
+namespace {
+
+const int MAX_CACHED_BRUSHES = 16;
+const int MAX_PYRAMID_LEVELS = 6;
+const int MIN_PYRAMID_LEVEL_SIZE = 32;
+
+QPainterPath generateOutline(quint8 *alpha, int width, int height, int levelScale)
+{
+    KisOutlineGenerator generator(KoColorSpaceRegistry::instance()->alpha8(), OPACITY_TRANSPARENT_U8);
+    generator.setSimpleOutline(true);
+
+    QPainterPath path;
+    Q_FOREACH (const QPolygon &polygon, generator.outline(alpha, 0, 0, width, height)) {
+        path.addPolygon(polygon);
+        path.closeSubpath();
+    }
+
+    return levelScale > 1 ? QTransform::fromScale(levelScale, levelScale).map(path) : path;
+}
+
+QVector<QPainterPath> generateOutlinePyramid(KisBrushSP brush)
+{
+    KisFixedPaintDeviceSP dev = brush->outlineSourceDevice();
+    const KoColorSpace *cs = dev->colorSpace();
+    const int pixelSize = cs->pixelSize();
+
+    int width = dev->bounds().width();
+    int height = dev->bounds().height();
+
+    QVector<quint8> alpha(width * height);
+    const quint8 *src = dev->data();
+    for (int i = 0; i < alpha.size(); i++) {
+        alpha[i] = cs->opacityU8(src);
+        src += pixelSize;
+    }
+
+    QVector<QPainterPath> levels;
+    int levelScale = 1;
+
+    while (true) {
+        levels << generateOutline(alpha.data(), width, height, levelScale);
+
+        if (levels.size() >= MAX_PYRAMID_LEVELS ||
+            qMax(width, height) < 2 * MIN_PYRAMID_LEVEL_SIZE) {
+
+            break;
+        }
+
+        /**
+         * Downscale the mask by taking the maximum of every 2x2 block,
+         * so that every painted pixel of the brush is still inside
+         * the outline
+         */
+        const int newWidth = (width + 1) / 2;
+        const int newHeight = (height + 1) / 2;
+        QVector<quint8> newAlpha(newWidth * newHeight);
+
+        for (int y = 0; y < newHeight; y++) {
+            const int y0 = 2 * y;
+            const int y1 = qMin(y0 + 1, height - 1);
+
+            for (int x = 0; x < newWidth; x++) {
+                const int x0 = 2 * x;
+                const int x1 = qMin(x0 + 1, width - 1);
+
+                newAlpha[y * newWidth + x] =
+                    qMax(qMax(alpha[y0 * width + x0], alpha[y0 * width + x1]),
+                         qMax(alpha[y1 * width + x0], alpha[y1 * width + x1]));
+            }
+        }
+
+        alpha.swap(newAlpha);
+        width = newWidth;
+        height = newHeight;
+        levelScale *= 2;
+    }
+
+    return levels;
+}
+
+QString cacheKey(KisBrushSP brush)
+{
+    // auto brushes generate their outlines from the mask generator
+    if (dynamic_cast<const KisAutoBrush*>(brush.data()) ||
+        (brush->brushType() != MASK && brush->brushType() != IMAGE)) {
+
+        return QString();
+    }
+
+    const QByteArray md5 = brush->md5();
+    if (md5.isEmpty()) {
+        return QString();
+    }
+
+    return QString("%1:%2:%3x%4")
+        .arg(QString::fromLatin1(md5.toHex()))
+        .arg(brush->brushApplication())
+        .arg(brush->width())
+        .arg(brush->height());
+}
+
+QPainterPath placeholderOutline(KisBrushSP brush)
+{
+    QPainterPath path;
+    path.addRect(QRectF(0, 0, brush->width(), brush->height()));
+    return path;
+}
+
+}
+
+struct KisBrushOutlineCache::Private
+{
+    struct Entry {
+        QVector<QPainterPath> levels;
+    };
+    typedef QSharedPointer<Entry> EntrySP;
+
+    QMutex mutex;
+    QHash<QString, EntrySP> entries;
+    QStringList recentlyUsed;
+    QFutureSynchronizer<void> jobs;
+
+    void touch(const QString &key) {
+        recentlyUsed.removeOne(key);
+        recentlyUsed.append(key);
+
+        while (recentlyUsed.size() > MAX_CACHED_BRUSHES) {
+            entries.remove(recentlyUsed.takeFirst());
+        }
+    }
+};
+
+KisBrushOutlineCache::KisBrushOutlineCache()
+    : m_d(new Private)
+{
+}
+
+KisBrushOutlineCache::~KisBrushOutlineCache()
+{
+    m_d->jobs.waitForFinished();
+}
+
+KisBrushOutlineCache *KisBrushOutlineCache::instance()
+{
+    return s_instance;
+}
+
+QPainterPath KisBrushOutlineCache::outline(KisBrushSP brush, qreal displayScale)
+{
+    if (!brush) return QPainterPath();
+
+    const QString key = cacheKey(brush);
+    if (key.isEmpty()) {
+        return brush->outline();
+    }
+
+    QMutexLocker l(&m_d->mutex);
+
+    Private::EntrySP entry = m_d->entries.value(key);
+    m_d->touch(key);
+
+    if (!entry) {
+        entry.reset(new Private::Entry());
+        m_d->entries.insert(key, entry);
+
+        // the brush may be used by the GUI meanwhile, so work on a copy
+        KisBrushSP clone = brush->clone().dynamicCast<KisBrush>();
+
+        m_d->jobs.addFuture(QtConcurrent::run(
+            [this, key, clone] () {
+                const QVector<QPainterPath> levels = generateOutlinePyramid(clone);
+
+                {
+                    QMutexLocker l(&m_d->mutex);
+                    Private::EntrySP entry = m_d->entries.value(key);
+                    if (!entry) return;
+
+                    entry->levels = levels;
+                }
+
+                emit sigOutlineReady();
+            }));
+    }
+
+    if (entry->levels.isEmpty()) {
+        return placeholderOutline(brush);
+    }
+
+    /**
+     * Select the coarsest level whose pixel is still not bigger than
+     * a pixel of the screen
+     */
+    int level = 0;
+    if (displayScale > 0.0 && displayScale < 1.0) {
+        level = qFloor(std::log2(1.0 / displayScale));
+    }
+    level = qBound(0, level, entry->levels.size() - 1);
+
+    return entry->levels[level];
+}
+
+void KisBrushOutlineCache::clear()
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->entries.clear();
+    m_d->recentlyUsed.clear();
+}
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KISBRUSHOUTLINECACHE_H
+#define KISBRUSHOUTLINECACHE_H
+
+#include <QObject>
+#include <QPainterPath>
+#include <QScopedPointer>
+
+#include "kis_brush.h"
+#include "kritabrush_export.h"
+
+/**
+ * Generating the outline of a big predefined brush (KisBoundary over
+ * the full resolution mask) may take hundreds of milliseconds, which
+ * is too much for the GUI thread, which requests the outline on every
+ * cursor move and every change of the preset.
+ *
+ * KisBrushOutlineCache generates the outlines in a background thread
+ * and keeps them for a few recently used brushes. The outlines are
+ * stored in brush coordinates (before scaling and rotation), so they
+ * are reused for any size and angle of the brush. For every brush a
+ * pyramid of outlines is generated: level N is built over the mask
+ * downscaled by 2^N, so small zoom levels get a simpler path, which is
+ * much faster to transform and paint.
+ *
+ * The cache entries are keyed by the contents of the brush (md5, size
+ * and application), so switching the presets or changing their
+ * options picks the correct outline automatically, while the brush
+ * objects recreated for the same tip reuse it.
+ *
+ * Auto brushes, pipe brushes and the brushes that don't have md5
+ * (e.g. text brushes) are not cached, their outline is returned by
+ * KisBrush::outline() directly.
+ */
+class BRUSH_EXPORT KisBrushOutlineCache : public QObject
+{
+    Q_OBJECT
+public:
+    KisBrushOutlineCache();
+    ~KisBrushOutlineCache() override;
+
+    static KisBrushOutlineCache* instance();
+
+    /**
+     * Returns the outline of \p brush in brush coordinates, the same
+     * ones KisBrush::outline() uses.
+     *
+     * \p displayScale is the size of one pixel of the brush on screen,
+     * i.e. the brush scale multiplied by the canvas zoom. It is used
+     * for selecting the level of the pyramid.
+     *
+     * If the outline is not ready yet, its generation is started in
+     * background and the bounding rectangle of the brush is returned.
+     * sigOutlineReady() is emitted when the generation is completed.
+     */
+    QPainterPath outline(KisBrushSP brush, qreal displayScale);
+
+    /**
+     * Drops all the cached outlines
+     */
+    void clear();
+
+Q_SIGNALS:
+    void sigOutlineReady();
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISBRUSHOUTLINECACHE_H
@@ -543,13 +543,13 @@ void KisBrush::generateMaskAndApplyMaskOrCreateDab(KisFixedPaintDeviceSP dst,
     Q_UNUSED(info_);
     Q_UNUSED(softnessFactor);
 
-    QImage outputImage = d->brushPyramid->pyramid(this)->createImage(KisDabShape(
-                                                                         shape.scale() * d->scale, shape.ratio(),
-                                                                         -normalizeAngle(shape.rotation() + d->angle)),
-                                                                     subPixelX, subPixelY);
+    const KisQImagePyramid *pyramid = d->brushPyramid->pyramid(this);
+    const KisDabShape pyramidShape(shape.scale() * d->scale, shape.ratio(),
+                                   -normalizeAngle(shape.rotation() + d->angle));
 
-    qint32 maskWidth = outputImage.width();
-    qint32 maskHeight = outputImage.height();
+    const QSize maskSize = pyramid->dabSize(pyramidShape, subPixelX, subPixelY);
+    qint32 maskWidth = maskSize.width();
+    qint32 maskHeight = maskSize.height();
 
     dst->setRect(QRect(0, 0, maskWidth, maskHeight));
     dst->lazyGrowBufferWithoutInitialization();
@@ -582,11 +582,20 @@ void KisBrush::generateMaskAndApplyMaskOrCreateDab(KisFixedPaintDeviceSP dst,
     }
 
     KoColor gradientcolor(Qt::blue, cs);
-    for (int y = 0; y < maskHeight; y++) {
-        const quint8* maskPointer = outputImage.constScanLine(y);
+    QScopedArrayPointer<quint8> alphaArray(!color ? new quint8[maskWidth] : 0);
+
+    /**
+     * The mask is sampled from the pyramid row by row, so we don't
+     * have to allocate and paint an intermediate QImage for every dab
+     */
+    pyramid->sampleImage(pyramidShape, subPixelX, subPixelY,
+                         [&] (int, const QRgb *maskRow) {
+
+        const quint8* maskPointer = reinterpret_cast<const quint8*>(maskRow);
+
         if (color) {
             if (preserveLightness) {
-                cs->fillGrayBrushWithColorAndLightnessWithStrength(rowPointer, reinterpret_cast<const QRgb*>(maskPointer), color, lightnessStrength, maskWidth);
+                cs->fillGrayBrushWithColorAndLightnessWithStrength(rowPointer, maskRow, color, lightnessStrength, maskWidth);
             }
             else if (applyGradient) {
                 quint8* pixel = rowPointer;
@@ -607,7 +616,7 @@ void KisBrush::generateMaskAndApplyMaskOrCreateDab(KisFixedPaintDeviceSP dst,
                 }
             }
             else {
-                cs->fillGrayBrushWithColor(rowPointer, reinterpret_cast<const QRgb*>(maskPointer), color, maskWidth);
+                cs->fillGrayBrushWithColor(rowPointer, maskRow, color, maskWidth);
             }
         }
         else {
@@ -620,8 +629,7 @@ void KisBrush::generateMaskAndApplyMaskOrCreateDab(KisFixedPaintDeviceSP dst,
                 }
             }
 
-            QScopedArrayPointer<quint8> alphaArray(new quint8[maskWidth]);
-            fetchPremultipliedRed(reinterpret_cast<const QRgb*>(maskPointer), alphaArray.data(), maskWidth);
+            fetchPremultipliedRed(maskRow, alphaArray.data(), maskWidth);
             cs->applyAlphaU8Mask(rowPointer, alphaArray.data(), maskWidth);
         }
 
@@ -630,9 +638,7 @@ void KisBrush::generateMaskAndApplyMaskOrCreateDab(KisFixedPaintDeviceSP dst,
         if (!color) {
             coloringInformation->nextRow();
         }
-    }
-
-
+    });
 }
 
 KisFixedPaintDeviceSP KisBrush::paintDevice(const KoColorSpace * colorSpace,
@@ -660,7 +666,7 @@ void KisBrush::resetBoundary()
     d->boundary.reset();
 }
 
-void KisBrush::generateBoundary() const
+KisFixedPaintDeviceSP KisBrush::outlineSourceDevice() const
 {
     KisFixedPaintDeviceSP dev;
     KisDabShape inverseTransform(1.0 / scale(), 1.0, -angle());
@@ -675,7 +681,12 @@ void KisBrush::generateBoundary() const
         mask(dev, KoColor(Qt::black, cs), inverseTransform, KisPaintInformation());
     }
 
-    d->boundary.reset(new KisBoundary(dev));
+    return dev;
+}
+
+void KisBrush::generateBoundary() const
+{
+    d->boundary.reset(new KisBoundary(outlineSourceDevice()));
     d->boundary->generateBoundary();
 }
 
@@ -345,6 +345,15 @@ public:
     virtual const KisBoundary* boundary() const;
     virtual QPainterPath outline() const;
 
+    /**
+     * Returns the device the outline of the brush is generated from,
+     * i.e. the mask (or the image stamp) of the brush without scaling
+     * and rotation applied.
+     *
+     * \see KisBrushOutlineCache
+     */
+    KisFixedPaintDeviceSP outlineSourceDevice() const;
+
     virtual void setScale(qreal _scale);
     qreal scale() const;
     virtual void setAngle(qreal _angle);
@@ -20,8 +20,11 @@
 
 #include <limits>
 #include <QPainter>
+#include <QScopedPointer>
 #include <kis_debug.h>
 
+#include "KisAffineImageSampler.h"
+
 #define MIPMAP_SIZE_THRESHOLD 512
 #define MAX_MIPMAP_SCALE 8.0
 
@@ -318,6 +321,90 @@ QImage KisQImagePyramid::createImage(KisDabShape const& shape,
     return dstImage;
 }
 
+QSize KisQImagePyramid::dabSize(KisDabShape const& shape,
+                                qreal subPixelX, qreal subPixelY) const
+{
+    if (m_levels.isEmpty()) return QSize();
+
+    return imageSize(m_originalSize, shape, subPixelX, subPixelY);
+}
+
+void KisQImagePyramid::sampleImage(KisDabShape const& shape,
+                                   qreal subPixelX, qreal subPixelY,
+                                   const std::function<void(int, const QRgb*)> &processRow) const
+{
+    if (m_levels.isEmpty()) return;
+
+    qreal baseScale = -1.0;
+    int level = findNearestLevel(shape.scale(), &baseScale);
+
+    const QImage &srcImage = m_levels[level].image;
+
+    QTransform transform;
+    QSize dstSize;
+
+    calculateParams(shape, subPixelX, subPixelY,
+                    m_originalSize, baseScale, m_levels[level].size,
+                    &transform, &dstSize);
+
+    if (transform.isIdentity() && dstSize == m_levels[level].size) {
+        for (int y = 0; y < dstSize.height(); y++) {
+            const QRgb *srcRow =
+                reinterpret_cast<const QRgb*>(srcImage.constScanLine(y + QPAINTER_WORKAROUND_BORDER));
+            processRow(y, srcRow + QPAINTER_WORKAROUND_BORDER);
+        }
+        return;
+    }
+
+    QVector<QRgb> dstRow(dstSize.width(), 0);
+
+    if (!transform.isInvertible()) {
+        for (int y = 0; y < dstSize.height(); y++) {
+            processRow(y, dstRow.constData());
+        }
+        return;
+    }
+
+    static const QScopedPointer<KisAffineImageSampler> bilinearSampler(
+        KisAffineImageSampler::create(KisAffineImageSampler::Bilinear));
+    static const QScopedPointer<KisAffineImageSampler> bicubicSampler(
+        KisAffineImageSampler::create(KisAffineImageSampler::Bicubic));
+
+    /**
+     * Bilinear filtering gives blocky results when a pixel of the level
+     * covers more than one pixel of the dab. findNearestLevel() never
+     * selects a level smaller than the dab, so it happens only when the
+     * dab is bigger than the biggest level of the pyramid. Small upscales
+     * caused by rounding of the dab size are left to the bilinear sampler.
+     */
+    const qreal scale_epsilon = 1e-6;
+    const bool upscaledBeyondBiggestLevel =
+        level == 0 && shape.scale() > baseScale + scale_epsilon;
+
+    const KisAffineImageSampler *sampler =
+        upscaledBeyondBiggestLevel ?
+            bicubicSampler.data() : bilinearSampler.data();
+
+    /**
+     * The sampler addresses the pixels by their centers, so we should map
+     * the centers of the destination pixels and take the border of the
+     * level into account.
+     */
+    const QTransform inverted = transform.inverted();
+    const QPointF offset(QPAINTER_WORKAROUND_BORDER - 0.5, QPAINTER_WORKAROUND_BORDER - 0.5);
+
+    for (int y = 0; y < dstSize.height(); y++) {
+        const QPointF start = inverted.map(QPointF(0.5, y + 0.5)) + offset;
+
+        sampler->sampleRow(srcImage,
+                           start.x(), start.y(),
+                           inverted.m11(), inverted.m12(),
+                           dstSize.width(), dstRow.data());
+
+        processRow(y, dstRow.constData());
+    }
+}
+
 QImage KisQImagePyramid::getClosest(QTransform transform, qreal *scale) const
 {
     if (m_levels.isEmpty()) return QImage();
@@ -19,6 +19,8 @@
 #ifndef __KIS_QIMAGE_PYRAMID_H
 #define __KIS_QIMAGE_PYRAMID_H
 
+#include <functional>
+
 #include <QImage>
 #include <QVector>
 #include <kis_dab_shape.h>
@@ -41,6 +43,23 @@ public:
     QImage createImage(KisDabShape const&,
                        qreal subPixelX, qreal subPixelY) const;
 
+    /**
+     * \return the size of the image generated by sampleImage()
+     */
+    QSize dabSize(KisDabShape const&,
+                  qreal subPixelX, qreal subPixelY) const;
+
+    /**
+     * A faster alternative to createImage(). The transformed image is
+     * not painted with QPainter, but its rows are resampled from the
+     * nearest pyramid level with a vectorized bilinear (or bicubic, when
+     * upscaling) sampler and passed to \p processRow one by one. The
+     * pointer passed to \p processRow is valid only during the call.
+     */
+    void sampleImage(KisDabShape const&,
+                     qreal subPixelX, qreal subPixelY,
+                     const std::function<void(int, const QRgb*)> &processRow) const;
+
     QImage getClosest(QTransform transform, qreal *scale) const;
 
 private:
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <compositeops/KoVcMultiArchBuildSupport.h> //MSVC requires that Vc come first
+#include "KisBrushOutlineCacheTest.h"
+
+#include <QTest>
+#include <QSignalSpy>
+
+#include <KisBrushOutlineCache.h>
+#include <KisGlobalResourcesInterface.h>
+#include "../kis_gbr_brush.h"
+#include "../kis_auto_brush.h"
+#include "kis_mask_generator.h"
+#include "kis_circle_mask_generator.h"
+
+
+void KisBrushOutlineCacheTest::testPredefinedBrush()
+{
+    KisBrushSP brush(new KisGbrBrush(QString(FILES_DATA_DIR) + '/' + "testing_brush_512_bars.gbr"));
+    QVERIFY(brush->load(KisGlobalResourcesInterface::instance()));
+    QVERIFY(brush->valid());
+
+    KisBrushOutlineCache cache;
+    QSignalSpy spy(&cache, SIGNAL(sigOutlineReady()));
+
+    // the first request returns the bounds of the brush
+    QPainterPath outline = cache.outline(brush, 1.0);
+    QCOMPARE(outline.boundingRect(), QRectF(0, 0, brush->width(), brush->height()));
+
+    QVERIFY(spy.count() > 0 || spy.wait(10000));
+
+    const QPainterPath fullOutline = cache.outline(brush, 1.0);
+    QCOMPARE(fullOutline, brush->outline());
+
+    // another brush object for the same tip reuses the outline
+    KisBrushSP clone = brush->clone().dynamicCast<KisBrush>();
+    QCOMPARE(cache.outline(clone, 1.0), fullOutline);
+
+    // small zoom levels get a simplified outline covering the same area
+    const QPainterPath coarseOutline = cache.outline(brush, 0.1);
+    QVERIFY(coarseOutline.elementCount() < fullOutline.elementCount());
+    QVERIFY(coarseOutline.boundingRect().adjusted(-1, -1, 1, 1).contains(fullOutline.boundingRect()));
+}
+
+void KisBrushOutlineCacheTest::testAutoBrushIsNotCached()
+{
+    KisCircleMaskGenerator* circle = new KisCircleMaskGenerator(100, 1.0, 0.5, 0.5, 2, true);
+    KisBrushSP brush(new KisAutoBrush(circle, 0.0, 0.0));
+
+    KisBrushOutlineCache cache;
+    QCOMPARE(cache.outline(brush, 1.0), brush->outline());
+}
+
+QTEST_MAIN(KisBrushOutlineCacheTest)
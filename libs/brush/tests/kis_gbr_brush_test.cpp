@@ -251,6 +251,61 @@ void KisGbrBrushTest::testPyramidDabTransform()
     QCOMPARE(dabTransformHelper(KisDabShape(1.0, 0.5, M_PI / 4)), QSize(160, 160));
 }
 
+void KisGbrBrushTest::testPyramidSampleImage_data()
+{
+    QTest::addColumn<qreal>("scale");
+    QTest::addColumn<qreal>("ratio");
+    QTest::addColumn<qreal>("rotation");
+    QTest::addColumn<qreal>("subPixel");
+
+    QTest::newRow("identity") << 1.0 << 1.0 << 0.0 << 0.0;
+    QTest::newRow("subpixel") << 1.0 << 1.0 << 0.0 << 0.3;
+    QTest::newRow("downscale") << 0.37 << 1.0 << 0.0 << 0.0;
+    QTest::newRow("rotate") << 1.0 << 1.0 << 0.7 << 0.5;
+    QTest::newRow("ratio") << 0.8 << 0.5 << 2.1 << 0.25;
+    QTest::newRow("upscale") << 12.0 << 1.0 << 0.3 << 0.0;
+}
+
+void KisGbrBrushTest::testPyramidSampleImage()
+{
+    QFETCH(qreal, scale);
+    QFETCH(qreal, ratio);
+    QFETCH(qreal, rotation);
+    QFETCH(qreal, subPixel);
+
+    QImage image(64, 48, QImage::Format_ARGB32);
+    image.fill(0);
+    {
+        QPainter gc(&image);
+        gc.setRenderHints(QPainter::Antialiasing);
+        QRadialGradient gradient(QPointF(32, 24), 24);
+        gradient.setColorAt(0.0, Qt::black);
+        gradient.setColorAt(1.0, Qt::transparent);
+        gc.setBrush(gradient);
+        gc.setPen(Qt::NoPen);
+        gc.drawEllipse(QPointF(32, 24), 24, 20);
+    }
+
+    KisQImagePyramid pyramid(image);
+    const KisDabShape shape(scale, ratio, rotation);
+
+    const QImage reference = pyramid.createImage(shape, subPixel, subPixel);
+    QCOMPARE(pyramid.dabSize(shape, subPixel, subPixel), reference.size());
+
+    QImage result(reference.size(), QImage::Format_ARGB32);
+    result.fill(0);
+
+    pyramid.sampleImage(shape, subPixel, subPixel,
+                        [&result] (int y, const QRgb *row) {
+        memcpy(result.scanLine(y), row, result.width() * sizeof(QRgb));
+    });
+
+    // QPainter uses fixed point math, so we cannot expect exact match
+    QPoint pt;
+    QVERIFY(TestUtil::compareQImagesPremultiplied(pt, reference, result, 8, 8,
+                                                  reference.width() * reference.height() / 50));
+}
+
 // see comment in KisQImagePyramid::appendPyramidLevel
 void KisGbrBrushTest::testQPainterTransformationBorder()
 {
@@ -40,6 +40,8 @@ private Q_SLOTS:
 
     void testPyramidLevelRounding();
     void testPyramidDabTransform();
+    void testPyramidSampleImage_data();
+    void testPyramidSampleImage();
 
     void testQPainterTransformationBorder();
 };
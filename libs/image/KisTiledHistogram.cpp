@@ -0,0 +1,248 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisTiledHistogram.h"
+
+#include <QVector>
+#include <QtConcurrent>
+
+#include <KoColorSpace.h>
+#include <KoHistogramProducer.h>
+
+#include "kis_assert.h"
+#include "kis_paint_device.h"
+#include "kis_iterator_ng.h"
+
+namespace {
+
+/**
+ * The size of the cell is chosen to cover a few tiles of the paint
+ * device. The cell size grows when the image is huge to keep the
+ * memory consumed by the partial bins bounded.
+ */
+const int defaultCellSize = 256;
+const int maxNumCells = 4096;
+
+void fillProducer(KoHistogramProducer *producer, KisPaintDeviceSP device, const QRect &rect)
+{
+    const KoColorSpace *cs = device->colorSpace();
+    KisSequentialConstIterator srcIt(device, rect);
+
+    int numConseqPixels = srcIt.nConseqPixels();
+    while (srcIt.nextPixels(numConseqPixels)) {
+        numConseqPixels = srcIt.nConseqPixels();
+        producer->addRegionToBin(srcIt.oldRawData(), 0, numConseqPixels, cs);
+    }
+}
+
+struct CellJob {
+    int index;
+    QRect rect;
+    KoHistogramProducer *producer;
+};
+
+struct CellJobWrapper {
+    CellJobWrapper(KisPaintDeviceSP device)
+        : m_device(device) {}
+
+    inline void operator() (CellJob &job) {
+        fillProducer(job.producer, m_device, job.rect);
+    }
+
+    KisPaintDeviceSP m_device;
+};
+
+int cellSizeForBounds(const QRect &bounds)
+{
+    int cellSize = defaultCellSize;
+
+    while (qint64(bounds.width() / cellSize + 1) *
+           qint64(bounds.height() / cellSize + 1) > maxNumCells) {
+
+        cellSize *= 2;
+    }
+
+    return cellSize;
+}
+
+}
+
+struct KisTiledHistogram::Private
+{
+    QScopedPointer<KoHistogramProducer> producer;
+
+    QRect bounds;
+    const KoColorSpace *colorSpace = 0;
+    int cellSize = defaultCellSize;
+    int numCellsX = 0;
+    int numCellsY = 0;
+    QVector<KoHistogramProducer*> cells;
+
+    void resetCells(const QRect &newBounds, const KoColorSpace *newColorSpace);
+    QRect cellRect(int index) const;
+    void calculateCells(QVector<CellJob> &jobs, KisPaintDeviceSP device);
+};
+
+void KisTiledHistogram::Private::resetCells(const QRect &newBounds, const KoColorSpace *newColorSpace)
+{
+    qDeleteAll(cells);
+    cells.clear();
+
+    bounds = newBounds;
+    colorSpace = newColorSpace;
+    cellSize = cellSizeForBounds(bounds);
+    numCellsX = (bounds.width() + cellSize - 1) / cellSize;
+    numCellsY = (bounds.height() + cellSize - 1) / cellSize;
+    cells.fill(0, numCellsX * numCellsY);
+}
+
+QRect KisTiledHistogram::Private::cellRect(int index) const
+{
+    const int col = index % numCellsX;
+    const int row = index / numCellsX;
+
+    return QRect(bounds.x() + col * cellSize,
+                 bounds.y() + row * cellSize,
+                 cellSize, cellSize) & bounds;
+}
+
+void KisTiledHistogram::Private::calculateCells(QVector<CellJob> &jobs, KisPaintDeviceSP device)
+{
+    for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+        it->producer = producer->createEmptyCopy();
+    }
+
+    if (jobs.size() > 1) {
+        QtConcurrent::blockingMap(jobs, CellJobWrapper(device));
+    } else if (!jobs.isEmpty()) {
+        fillProducer(jobs.first().producer, device, jobs.first().rect);
+    }
+}
+
+KisTiledHistogram::KisTiledHistogram(KoHistogramProducer *producer)
+    : m_d(new Private)
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(producer);
+    m_d->producer.reset(producer);
+}
+
+KisTiledHistogram::~KisTiledHistogram()
+{
+    qDeleteAll(m_d->cells);
+}
+
+KoHistogramProducer* KisTiledHistogram::producer() const
+{
+    return m_d->producer.data();
+}
+
+void KisTiledHistogram::reset(KisPaintDeviceSP device, const QRect &bounds)
+{
+    m_d->resetCells(bounds, device->colorSpace());
+    m_d->producer->clear();
+
+    QScopedPointer<KoHistogramProducer> probe(m_d->producer->createEmptyCopy());
+    if (!probe) {
+        // the producer doesn't support partial bins, so we cannot
+        // reuse anything on the next update
+        fillProducer(m_d->producer.data(), device, bounds);
+        return;
+    }
+
+    QVector<CellJob> jobs;
+    jobs.reserve(m_d->cells.size());
+
+    for (int i = 0; i < m_d->cells.size(); i++) {
+        jobs.append({i, m_d->cellRect(i), 0});
+    }
+
+    m_d->calculateCells(jobs, device);
+
+    Q_FOREACH (const CellJob &job, jobs) {
+        m_d->producer->addBins(job.producer);
+        m_d->cells[job.index] = job.producer;
+    }
+}
+
+void KisTiledHistogram::update(KisPaintDeviceSP device, const QRect &bounds, const QRect &dirtyRect)
+{
+    if (bounds != m_d->bounds ||
+        device->colorSpace() != m_d->colorSpace ||
+        m_d->cells.isEmpty() || !m_d->cells.first()) {
+
+        reset(device, bounds);
+        return;
+    }
+
+    const QRect rc = (dirtyRect & bounds).translated(-bounds.topLeft());
+    if (rc.isEmpty()) return;
+
+    const int firstCol = rc.left() / m_d->cellSize;
+    const int lastCol = rc.right() / m_d->cellSize;
+    const int firstRow = rc.top() / m_d->cellSize;
+    const int lastRow = rc.bottom() / m_d->cellSize;
+
+    QVector<CellJob> jobs;
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            const int index = row * m_d->numCellsX + col;
+            jobs.append({index, m_d->cellRect(index), 0});
+        }
+    }
+
+    m_d->calculateCells(jobs, device);
+
+    Q_FOREACH (const CellJob &job, jobs) {
+        KoHistogramProducer *oldCell = m_d->cells[job.index];
+
+        m_d->producer->addBins(oldCell, true);
+        m_d->producer->addBins(job.producer);
+
+        m_d->cells[job.index] = job.producer;
+        delete oldCell;
+    }
+}
+
+void KisTiledHistogram::calculate(KoHistogramProducer *producer, KisPaintDeviceSP device, const QRect &rect)
+{
+    producer->clear();
+
+    QScopedPointer<KoHistogramProducer> probe(producer->createEmptyCopy());
+    if (!probe || qint64(rect.width()) * rect.height() <= defaultCellSize * defaultCellSize) {
+        fillProducer(producer, device, rect);
+        return;
+    }
+
+    const int cellSize = cellSizeForBounds(rect);
+
+    QVector<CellJob> jobs;
+    for (int y = rect.y(); y <= rect.bottom(); y += cellSize) {
+        for (int x = rect.x(); x <= rect.right(); x += cellSize) {
+            jobs.append({0, QRect(x, y, cellSize, cellSize) & rect,
+                         producer->createEmptyCopy()});
+        }
+    }
+
+    QtConcurrent::blockingMap(jobs, CellJobWrapper(device));
+
+    Q_FOREACH (const CellJob &job, jobs) {
+        producer->addBins(job.producer);
+        delete job.producer;
+    }
+}
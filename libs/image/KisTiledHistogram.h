@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KISTILEDHISTOGRAM_H
+#define KISTILEDHISTOGRAM_H
+
+#include <QScopedPointer>
+#include <QRect>
+
+#include "kis_types.h"
+#include "kritaimage_export.h"
+
+class KoHistogramProducer;
+
+/**
+ * KisTiledHistogram splits the image into a grid of cells and keeps a
+ * partial histogram for every cell. The cells are calculated in parallel
+ * and then reduced into the main producer. When a part of the image
+ * changes, only the cells touched by the dirty rect are recalculated:
+ * their old bins are subtracted from the main producer and the new ones
+ * are added.
+ *
+ * The producer should support KoHistogramProducer::createEmptyCopy(),
+ * otherwise the histogram falls back to a sequential full recalculation
+ * on every update.
+ */
+class KRITAIMAGE_EXPORT KisTiledHistogram
+{
+public:
+    /**
+     * Creates the histogram for \p producer. The histogram takes
+     * ownership of the producer.
+     */
+    KisTiledHistogram(KoHistogramProducer *producer);
+    ~KisTiledHistogram();
+
+    /**
+     * The producer with the bins of the whole image
+     */
+    KoHistogramProducer* producer() const;
+
+    /**
+     * Recalculates the histogram of \p bounds area of \p device from scratch
+     */
+    void reset(KisPaintDeviceSP device, const QRect &bounds);
+
+    /**
+     * Recalculates only the cells intersecting \p dirtyRect. If \p bounds
+     * or the color space of the device has changed since the last update,
+     * the histogram is recalculated from scratch.
+     */
+    void update(KisPaintDeviceSP device, const QRect &bounds, const QRect &dirtyRect);
+
+    /**
+     * Clears \p producer and fills it with the bins of \p rect area of
+     * \p device. The area is split into cells that are processed in
+     * parallel. Nothing is cached between the calls.
+     */
+    static void calculate(KoHistogramProducer *producer, KisPaintDeviceSP device, const QRect &rect);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISTILEDHISTOGRAM_H
@@ -26,7 +26,7 @@
 #include "kis_paint_device.h"
 #include "KoColorSpace.h"
 #include "kis_debug.h"
-#include "kis_iterator_ng.h"
+#include "KisTiledHistogram.h"
 
 KisHistogram::KisHistogram(const KisPaintLayerSP layer,
                            KoHistogramProducer *producer,
@@ -85,24 +85,12 @@ void KisHistogram::updateHistogram()
         return;
     }
 
-    KisSequentialConstIterator srcIt(m_paintDevice, m_bounds);
-    const KoColorSpace* cs = m_paintDevice->colorSpace();
-
-    // Let the producer do it's work
-    m_producer->clear();
-
-
     // XXX: the original code depended on their being a selection mask in the iterator
     //      if the paint device had a selection. When we changed that to passing an
     //      explicit selection to the createRectIterator call, that broke because
     //      paint devices didn't know about their selections anymore.
     //      updateHistogram should get a selection parameter.
-    int numConseqPixels = srcIt.nConseqPixels();
-    while (srcIt.nextPixels(numConseqPixels)) {
-
-        numConseqPixels = srcIt.nConseqPixels();
-        m_producer->addRegionToBin(srcIt.oldRawData(), 0, numConseqPixels, cs);
-    }
+    KisTiledHistogram::calculate(m_producer, m_paintDevice, m_bounds);
 
     computeHistogram();
 }
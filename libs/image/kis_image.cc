@@ -857,6 +857,48 @@ void KisImage::purgeUnusedData(bool isCancellable)
     endStroke(id);
 }
 
+void KisImage::requestSnapshot(std::function<void (KisImageSP)> callback)
+{
+    struct SnapshotStroke : public KisSimpleStrokeStrategy {
+        SnapshotStroke(KisImageSP image, std::function<void (KisImageSP)> callback)
+            : KisSimpleStrokeStrategy(QLatin1String("image-snapshot"), kundo2_noi18n("image-snapshot")),
+              m_image(image),
+              m_callback(callback)
+        {
+            /**
+             * The job is sequential, but neither a barrier nor exclusive,
+             * so it doesn't wait for the merge jobs and the updates queue.
+             * Layers' pixel data is modified by strokes only, so it cannot
+             * change while the job is running.
+             */
+            this->enableJob(JOB_INIT, true, KisStrokeJobData::SEQUENTIAL, KisStrokeJobData::NORMAL);
+            this->enableJob(JOB_CANCEL, true, KisStrokeJobData::SEQUENTIAL, KisStrokeJobData::NORMAL);
+            setClearsRedoOnStart(false);
+            setRequestsOtherStrokesToEnd(false);
+        }
+
+        void initStrokeCallback() override {
+            KisImageSP snapshot = m_image->clone(true);
+            snapshot->moveToThread(m_image->thread());
+            m_snapshotTaken = true;
+            m_callback(snapshot);
+        }
+
+        void cancelStrokeCallback() override {
+            if (m_snapshotTaken) return;
+            m_callback(KisImageSP());
+        }
+
+    private:
+        KisImageSP m_image;
+        std::function<void (KisImageSP)> m_callback;
+        bool m_snapshotTaken = false;
+    };
+
+    KisStrokeId id = startStroke(new SnapshotStroke(this, callback));
+    endStroke(id);
+}
+
 void KisImage::cropNode(KisNodeSP node, const QRect& newRect)
 {
     bool isLayer = qobject_cast<KisLayer*>(node.data());
@@ -25,6 +25,8 @@
 #include <QRect>
 #include <QBitArray>
 
+#include <functional>
+
 #include <KoColorConversionTransformation.h>
 
 #include "kis_types.h"
@@ -125,6 +127,26 @@ public:
 
     void copyFromImage(const KisImage &rhs);
 
+    /**
+     * Takes a snapshot of the image, that is an exact copy of it (see
+     * clone()) sharing all the pixel data with the image in the
+     * copy-on-write manner, and passes it to \p callback.
+     *
+     * The snapshot is taken by a special stroke right after the currently
+     * running stroke is finished. Unlike barrierLock(), it doesn't wait for
+     * the queued projection updates, so the caller is never blocked by the
+     * user painting. The pixel data of the layers is consistent at the
+     * stroke boundary, but the projections are cloned while the merge jobs
+     * may still be writing into them, so they can be inconsistent. The
+     * caller should regenerate them on the snapshot, e.g. with
+     * refreshGraphAsync(), before using the merged image.
+     *
+     * \p callback is called from the context of a worker thread, either
+     * with the snapshot or with a null pointer if the stroke has been
+     * cancelled. The snapshot is moved to the thread of this image.
+     */
+    void requestSnapshot(std::function<void (KisImageSP)> callback);
+
 private:
 
     // must specify exactly one from CONSTRUCT or REPLACE.
@@ -23,6 +23,7 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <QReadWriteLock>
+#include <QtConcurrent>
 
 #include <KoCompositeOp.h>
 #include "kis_layer.h"
@@ -30,6 +31,7 @@
 #include "kis_paint_device.h"
 #include "kis_selection.h"
 #include "kis_painter.h"
+#include "krita_utils.h"
 
 
 struct Q_DECL_HIDDEN KisIndirectPaintingSupport::Private {
@@ -165,10 +167,40 @@ void KisIndirectPaintingSupport::mergeToLayerImpl(KisPaintDeviceSP dst, KisPostE
     }
 }
 
+struct MergePatchJob {
+    MergePatchJob(const KisIndirectPaintingSupport *support,
+                  KisPaintDeviceSP dst, KisPaintDeviceSP src)
+        : m_support(support), m_dst(dst), m_src(src) {}
+
+    inline void operator() (QRect &rc) {
+        KisPainter gc(m_dst);
+        m_support->setupTemporaryPainter(&gc);
+        gc.bitBlt(rc.topLeft(), m_src, rc);
+    }
+
+    const KisIndirectPaintingSupport *m_support;
+    KisPaintDeviceSP m_dst;
+    KisPaintDeviceSP m_src;
+};
+
 void KisIndirectPaintingSupport::writeMergeData(KisPainter *painter, KisPaintDeviceSP src)
 {
-    Q_FOREACH (const QRect &rc, src->region().rects()) {
-        painter->bitBlt(rc.topLeft(), src, rc);
+    /**
+     * Merging the temporary target of a long stroke into a huge layer
+     * is the most expensive part of the stroke end, so the region is
+     * split into tile-aligned patches that are merged concurrently.
+     * All the painters write into the same device, so the changes are
+     * still recorded by the transaction started on the passed painter.
+     */
+    QVector<QRect> patches =
+        KritaUtils::splitRegionIntoPatches(src->region(), KritaUtils::optimalPatchSize());
+
+    if (patches.size() > 1) {
+        QtConcurrent::blockingMap(patches, MergePatchJob(this, painter->device(), src));
+    } else {
+        Q_FOREACH (const QRect &rc, patches) {
+            painter->bitBlt(rc.topLeft(), src, rc);
+        }
     }
 }
 
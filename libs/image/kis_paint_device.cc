@@ -112,7 +112,7 @@ public:
     KisPaintDeviceStrategy* currentStrategy();
 
     void init(const KoColorSpace *cs, const quint8 *defaultPixel);
-    void convertColorSpace(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand);
+    void convertColorSpace(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand, KoDitherOp::Type ditherType);
     bool assignProfile(const KoColorProfile * profile, KUndo2Command *parentCommand);
 
     KUndo2Command* reincarnateWithDetachedHistory(bool copyContent);
@@ -373,11 +373,11 @@ public:
         return m_frames.keys();
     }
 
-    bool readFrame(QIODevice *stream, int frameId)
+    bool readFrame(QIODevice *stream, int frameId, bool lazy)
     {
         bool retval = false;
         DataSP data = m_frames[frameId];
-        retval = data->dataManager()->read(stream);
+        retval = data->dataManager()->read(stream, lazy);
         data->cache()->invalidate();
         return retval;
     }
@@ -960,7 +960,7 @@ public:
     }
 };
 
-void KisPaintDevice::Private::convertColorSpace(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand)
+void KisPaintDevice::Private::convertColorSpace(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand, KoDitherOp::Type ditherType)
 {
     QList<Data*> dataObjects = allDataObjects();
     if (dataObjects.isEmpty()) return;
@@ -971,7 +971,7 @@ void KisPaintDevice::Private::convertColorSpace(const KoColorSpace * dstColorSpa
     Q_FOREACH (Data *data, dataObjects) {
         if (!data) continue;
 
-        data->convertDataColorSpace(dstColorSpace, renderingIntent, conversionFlags, mainCommand);
+        data->convertDataColorSpace(dstColorSpace, renderingIntent, conversionFlags, mainCommand, ditherType);
     }
 
     q->emitColorSpaceChanged();
@@ -1525,11 +1525,11 @@ bool KisPaintDevice::write(KisPaintDeviceWriter &store)
     return m_d->dataManager()->write(store);
 }
 
-bool KisPaintDevice::read(QIODevice *stream)
+bool KisPaintDevice::read(QIODevice *stream, bool lazy)
 {
     bool retval;
 
-    retval = m_d->dataManager()->read(stream);
+    retval = m_d->dataManager()->read(stream, lazy);
     m_d->cache()->invalidate();
 
     return retval;
@@ -1545,9 +1545,9 @@ void KisPaintDevice::emitProfileChanged()
     emit profileChanged(m_d->colorSpace()->profile());
 }
 
-void KisPaintDevice::convertTo(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand)
+void KisPaintDevice::convertTo(const KoColorSpace * dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand, KoDitherOp::Type ditherType)
 {
-    m_d->convertColorSpace(dstColorSpace, renderingIntent, conversionFlags, parentCommand);
+    m_d->convertColorSpace(dstColorSpace, renderingIntent, conversionFlags, parentCommand, ditherType);
 }
 
 bool KisPaintDevice::setProfile(const KoColorProfile * profile, KUndo2Command *parentCommand)
@@ -2208,12 +2208,12 @@ bool KisPaintDeviceFramesInterface::writeFrame(KisPaintDeviceWriter &store, int
     return q->m_d->writeFrame(store, frameId);
 }
 
-bool KisPaintDeviceFramesInterface::readFrame(QIODevice *stream, int frameId)
+bool KisPaintDeviceFramesInterface::readFrame(QIODevice *stream, int frameId, bool lazy)
 {
     KIS_ASSERT_RECOVER(frameId >= 0) {
         return false;
     }
-    return q->m_d->readFrame(stream, frameId);
+    return q->m_d->readFrame(stream, frameId, lazy);
 }
 
 int KisPaintDeviceFramesInterface::currentFrameId() const
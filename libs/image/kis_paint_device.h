@@ -26,6 +26,7 @@
 #include "kis_debug.h"
 
 #include <KoColorConversionTransformation.h>
+#include <KoDitherOp.h>
 
 #include "kis_types.h"
 #include "kis_shared.h"
@@ -132,8 +133,11 @@ public:
 
     /**
      * Fill this paint device with the pixels from the specified file store.
+     *
+     * If \p lazy is true, the pixel data is kept compressed in the swap
+     * and is decompressed only when it is accessed for the first time.
      */
-    bool read(QIODevice *stream);
+    bool read(QIODevice *stream, bool lazy = false);
 
 public:
 
@@ -483,11 +487,16 @@ public:
 
     /**
      * Converts the paint device to a different colorspace
+     *
+     * If \p ditherType is not KoDitherOp::NoDither and \p dstColorSpace
+     * differs in the channel depth only, the channels are scaled directly
+     * and the precision loss is distributed with \p ditherType
      */
     void convertTo(const KoColorSpace * dstColorSpace,
                    KoColorConversionTransformation::Intent renderingIntent = KoColorConversionTransformation::internalRenderingIntent(),
                    KoColorConversionTransformation::ConversionFlags conversionFlags = KoColorConversionTransformation::internalConversionFlags(),
-                   KUndo2Command *parentCommand = 0);
+                   KUndo2Command *parentCommand = 0,
+                   KoDitherOp::Type ditherType = KoDitherOp::NoDither);
 
     /**
      * Changes the profile of the colorspace of this paint device to the given
@@ -168,7 +168,7 @@ public:
         }
     }
 
-    void convertDataColorSpace(const KoColorSpace *dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand) {
+    void convertDataColorSpace(const KoColorSpace *dstColorSpace, KoColorConversionTransformation::Intent renderingIntent, KoColorConversionTransformation::ConversionFlags conversionFlags, KUndo2Command *parentCommand, KoDitherOp::Type ditherType = KoDitherOp::NoDither) {
         typedef KisSequentialIteratorBase<ReadOnlyIteratorPolicy<DirectDataAccessPolicy>, DirectDataAccessPolicy> InternalSequentialConstIterator;
         typedef KisSequentialIteratorBase<WritableIteratorPolicy<DirectDataAccessPolicy>, DirectDataAccessPolicy> InternalSequentialIterator;
 
@@ -185,6 +185,12 @@ public:
 
         KisDataManagerSP dstDataManager = new KisDataManager(dstPixelSize, dstDefaultPixel.data());
 
+        // depth-only conversions with dithering are done by a vectorized
+        // dither op, all the rest goes through the normal color conversion
+        QScopedPointer<KoDitherOp> ditherOp;
+        if (ditherType != KoDitherOp::NoDither) {
+            ditherOp.reset(m_colorSpace->createDitherOp(dstColorSpace, ditherType));
+        }
 
         if (!rc.isEmpty()) {
             InternalSequentialConstIterator srcIt(DirectDataAccessPolicy(m_dataManager.data(), cacheInvalidator()), rc);
@@ -203,10 +209,15 @@ public:
                 const quint8 *srcData = srcIt.rawDataConst();
                 quint8 *dstData = dstIt.rawData();
 
-                m_colorSpace->convertPixelsTo(srcData, dstData,
-                                              dstColorSpace,
-                                              nConseqPixels,
-                                              renderingIntent, conversionFlags);
+                if (ditherOp) {
+                    ditherOp->dither(srcData, 0, dstData, 0,
+                                     srcIt.x(), srcIt.y(), nConseqPixels, 1);
+                } else {
+                    m_colorSpace->convertPixelsTo(srcData, dstData,
+                                                  dstColorSpace,
+                                                  nConseqPixels,
+                                                  renderingIntent, conversionFlags);
+                }
             }
         }
 
@@ -24,18 +24,39 @@
 #include "kis_random_accessor_ng.h"
 #include "KisRenderedDab.h"
 
-void KisPainter::Private::applyDevice(const QRect &applyRect,
-                                      const KisRenderedDab &dab,
-                                      KisRandomAccessorSP dstIt,
-                                      const KoColorSpace *srcColorSpace,
-                                      KoCompositeOp::ParameterInfo &localParamInfo)
+void KisPainter::Private::applyDevicesBatched(const QRect &rc,
+                                              const QList<KisRenderedDab> &devices,
+                                              KisRandomAccessorSP dstIt,
+                                              KisRandomConstAccessorSP maskIt,
+                                              const KoColorSpace *srcColorSpace)
 {
-    const QRect dabRect = dab.realBounds();
-    const QRect rc = applyRect & dabRect;
+    /**
+     * The pointers returned by the random accessors are valid only until the
+     * accessor is moved to another tile, so we cannot collect the jobs for the
+     * whole rect at once. Instead, we walk the destination in contiguous
+     * chunks and pass all the dabs covering the chunk to the composite op in
+     * one call. The chunks don't overlap, so the result is the same as if the
+     * dabs were applied one by one over the whole rect.
+     */
 
     const int srcPixelSize = srcColorSpace->pixelSize();
-    const int dabRowStride = srcPixelSize * dabRect.width();
+    const int dstPixelSize = colorSpace->pixelSize();
+    const int maskPixelSize = maskIt ? selection->projection()->pixelSize() : 0;
+
+    /**
+     * The jobs are filled field by field and keep their channel flags
+     * between the calls, so we don't copy the QBitArray for every dab.
+     * The flags are reassigned only when the painter's flags change.
+     */
+    if (batchJobs.size() < devices.size()) {
+        batchJobs.resize(devices.size());
+    }
 
+    for (auto it = batchJobs.begin(); it != batchJobs.end(); ++it) {
+        if (it->channelFlags != paramInfo.channelFlags) {
+            it->channelFlags = paramInfo.channelFlags;
+        }
+    }
 
     qint32 dstY = rc.y();
     qint32 rowsRemaining = rc.height();
@@ -43,99 +64,64 @@ void KisPainter::Private::applyDevice(const QRect &applyRect,
     while (rowsRemaining > 0) {
         qint32 dstX = rc.x();
 
-        qint32 numContiguousDstRows = dstIt->numContiguousRows(dstY);
-        qint32 rows = qMin(rowsRemaining, numContiguousDstRows);
+        qint32 rows = qMin(rowsRemaining, dstIt->numContiguousRows(dstY));
+        if (maskIt) {
+            rows = qMin(rows, maskIt->numContiguousRows(dstY));
+        }
 
         qint32 columnsRemaining = rc.width();
 
         while (columnsRemaining > 0) {
 
-            qint32 numContiguousDstColumns = dstIt->numContiguousColumns(dstX);
-            qint32 columns = qMin(numContiguousDstColumns, columnsRemaining);
+            qint32 columns = qMin(columnsRemaining, dstIt->numContiguousColumns(dstX));
+            if (maskIt) {
+                columns = qMin(columns, maskIt->numContiguousColumns(dstX));
+            }
+
+            const QRect chunkRect(dstX, dstY, columns, rows);
 
             qint32 dstRowStride = dstIt->rowStride(dstX, dstY);
             dstIt->moveTo(dstX, dstY);
+            quint8 *dstChunkStart = dstIt->rawData();
 
-            localParamInfo.dstRowStart   = dstIt->rawData();
-            localParamInfo.dstRowStride  = dstRowStride;
-            localParamInfo.maskRowStart  = 0;
-            localParamInfo.maskRowStride = 0;
-            localParamInfo.rows          = rows;
-            localParamInfo.cols          = columns;
-
-
-            const int dabX = dstX - dabRect.x();
-            const int dabY = dstY - dabRect.y();
-
-            localParamInfo.srcRowStart   = dab.device->constData() + dabX * srcPixelSize + dabY * dabRowStride;
-            localParamInfo.srcRowStride  = dabRowStride;
-            localParamInfo.setOpacityAndAverage(dab.opacity, dab.averageOpacity);
-            localParamInfo.flow = dab.flow;
-            colorSpace->bitBlt(srcColorSpace, localParamInfo, compositeOp, renderingIntent, conversionFlags);
-
-            dstX += columns;
-            columnsRemaining -= columns;
-        }
-
-        dstY += rows;
-        rowsRemaining -= rows;
-    }
-
-}
-
-void KisPainter::Private::applyDeviceWithSelection(const QRect &applyRect,
-                                                   const KisRenderedDab &dab,
-                                                   KisRandomAccessorSP dstIt,
-                                                   KisRandomConstAccessorSP maskIt,
-                                                   const KoColorSpace *srcColorSpace,
-                                                   KoCompositeOp::ParameterInfo &localParamInfo)
-{
-    const QRect dabRect = dab.realBounds();
-    const QRect rc = applyRect & dabRect;
+            qint32 maskRowStride = 0;
+            const quint8 *maskChunkStart = 0;
 
-    const int srcPixelSize = srcColorSpace->pixelSize();
-    const int dabRowStride = srcPixelSize * dabRect.width();
+            if (maskIt) {
+                maskRowStride = maskIt->rowStride(dstX, dstY);
+                maskIt->moveTo(dstX, dstY);
+                maskChunkStart = maskIt->rawDataConst();
+            }
 
+            int numJobs = 0;
 
-    qint32 dstY = rc.y();
-    qint32 rowsRemaining = rc.height();
+            Q_FOREACH (const KisRenderedDab &dab, devices) {
+                const QRect dabRect = dab.realBounds();
+                const QRect jobRect = chunkRect & dabRect;
+                if (jobRect.isEmpty()) continue;
 
-    while (rowsRemaining > 0) {
-        qint32 dstX = rc.x();
+                const int dabRowStride = srcPixelSize * dabRect.width();
+                const int chunkX = jobRect.x() - dstX;
+                const int chunkY = jobRect.y() - dstY;
+                const int dabX = jobRect.x() - dabRect.x();
+                const int dabY = jobRect.y() - dabRect.y();
 
-        qint32 numContiguousDstRows = dstIt->numContiguousRows(dstY);
-        qint32 numContiguousMaskRows = maskIt->numContiguousRows(dstY);
-        qint32 rows = qMin(rowsRemaining, qMin(numContiguousDstRows, numContiguousMaskRows));
+                KoCompositeOp::ParameterInfo &job = batchJobs[numJobs++];
 
-        qint32 columnsRemaining = rc.width();
+                job.dstRowStart   = dstChunkStart + chunkX * dstPixelSize + chunkY * dstRowStride;
+                job.dstRowStride  = dstRowStride;
+                job.maskRowStart  = maskChunkStart ? maskChunkStart + chunkX * maskPixelSize + chunkY * maskRowStride : 0;
+                job.maskRowStride = maskRowStride;
+                job.rows          = jobRect.height();
+                job.cols          = jobRect.width();
 
-        while (columnsRemaining > 0) {
+                job.srcRowStart   = dab.device->constData() + dabX * srcPixelSize + dabY * dabRowStride;
+                job.srcRowStride  = dabRowStride;
+                job.setOpacityAndAverage(dab.opacity, dab.averageOpacity);
+                job.flow = dab.flow;
+            }
 
-            qint32 numContiguousDstColumns = dstIt->numContiguousColumns(dstX);
-            qint32 numContiguousMaskColumns = maskIt->numContiguousColumns(dstX);
-            qint32 columns = qMin(columnsRemaining, qMin(numContiguousDstColumns, numContiguousMaskColumns));
-
-            qint32 dstRowStride = dstIt->rowStride(dstX, dstY);
-            qint32 maskRowStride = maskIt->rowStride(dstX, dstY);
-            dstIt->moveTo(dstX, dstY);
-            maskIt->moveTo(dstX, dstY);
-
-            localParamInfo.dstRowStart   = dstIt->rawData();
-            localParamInfo.dstRowStride  = dstRowStride;
-            localParamInfo.maskRowStart  = maskIt->rawDataConst();
-            localParamInfo.maskRowStride = maskRowStride;
-            localParamInfo.rows          = rows;
-            localParamInfo.cols          = columns;
-
-
-            const int dabX = dstX - dabRect.x();
-            const int dabY = dstY - dabRect.y();
-
-            localParamInfo.srcRowStart   = dab.device->constData() + dabX * srcPixelSize + dabY * dabRowStride;
-            localParamInfo.srcRowStride  = dabRowStride;
-            localParamInfo.setOpacityAndAverage(dab.opacity, dab.averageOpacity);
-            localParamInfo.flow = dab.flow;
-            colorSpace->bitBlt(srcColorSpace, localParamInfo, compositeOp, renderingIntent, conversionFlags);
+            colorSpace->bitBltBatch(srcColorSpace, batchJobs.constData(), numJobs, compositeOp, renderingIntent, conversionFlags);
 
             dstX += columns;
             columnsRemaining -= columns;
@@ -144,7 +130,6 @@ void KisPainter::Private::applyDeviceWithSelection(const QRect &applyRect,
         dstY += rows;
         rowsRemaining -= rows;
     }
-
 }
 
 void KisPainter::bltFixed(const QRect &applyRect, const QList<KisRenderedDab> allSrcDevices)
@@ -176,19 +161,10 @@ void KisPainter::bltFixed(const QRect &applyRect, const QList<KisRenderedDab> al
 
     if (devices.isEmpty() || rc.isEmpty()) return;
 
-    KoCompositeOp::ParameterInfo localParamInfo = d->paramInfo;
     KisRandomAccessorSP dstIt = d->device->createRandomAccessorNG();
     KisRandomConstAccessorSP maskIt = d->selection ? d->selection->projection()->createRandomConstAccessorNG() : 0;
 
-    if (maskIt) {
-        Q_FOREACH (const KisRenderedDab &dab, devices) {
-            d->applyDeviceWithSelection(rc, dab, dstIt, maskIt, srcColorSpace, localParamInfo);
-        }
-    } else {
-        Q_FOREACH (const KisRenderedDab &dab, devices) {
-            d->applyDevice(rc, dab, dstIt, srcColorSpace, localParamInfo);
-        }
-    }
+    d->applyDevicesBatched(rc, devices, dstIt, maskIt, srcColorSpace);
 
 
 #if 0
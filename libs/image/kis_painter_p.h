@@ -76,6 +76,7 @@ struct Q_DECL_HIDDEN KisPainter::Private {
     KisRunnableStrokeJobsInterface *runnableStrokeJobsInterface = 0;
     QScopedPointer<KisRunnableStrokeJobsInterface> fakeRunnableStrokeJobsInterface;
     QTransform                  patternTransform;
+    QVector<KoCompositeOp::ParameterInfo> batchJobs;
 
     bool tryReduceSourceRect(const KisPaintDevice *srcDev,
                              QRect *srcRect,
@@ -88,18 +89,11 @@ struct Q_DECL_HIDDEN KisPainter::Private {
 
     void fillPainterPathImpl(const QPainterPath& path, const QRect &requestedRect);
 
-    void applyDevice(const QRect &applyRect,
-                     const KisRenderedDab &dab,
-                     KisRandomAccessorSP dstIt,
-                     const KoColorSpace *srcColorSpace,
-                     KoCompositeOp::ParameterInfo &localParamInfo);
-
-    void applyDeviceWithSelection(const QRect &applyRect,
-                                  const KisRenderedDab &dab,
-                                  KisRandomAccessorSP dstIt,
-                                  KisRandomConstAccessorSP maskIt,
-                                  const KoColorSpace *srcColorSpace,
-                                  KoCompositeOp::ParameterInfo &localParamInfo);
+    void applyDevicesBatched(const QRect &rc,
+                             const QList<KisRenderedDab> &devices,
+                             KisRandomAccessorSP dstIt,
+                             KisRandomConstAccessorSP maskIt,
+                             const KoColorSpace *srcColorSpace);
 
     template<class T> QVector<T> calculateMirroredObjects(const T &object);
 
@@ -24,6 +24,8 @@
 #include <KoHistogramProducer.h>
 #include "kis_paint_device.h"
 #include "kis_histogram.h"
+#include "KisTiledHistogram.h"
+#include "kis_iterator_ng.h"
 #include "kis_paint_layer.h"
 #include "kis_types.h"
 #include "testimage.h"
@@ -46,5 +48,75 @@ void KisHistogramTest::testCreation()
     }
 }
 
+namespace {
+
+void fillPattern(KisPaintDeviceSP dev, const QRect &rc, int seed)
+{
+    KisSequentialIterator it(dev, rc);
+    while (it.nextPixel()) {
+        quint8 *pixel = it.rawData();
+        pixel[0] = quint8(it.x() * 7 + seed);
+        pixel[1] = quint8(it.y() * 3 + seed);
+        pixel[2] = quint8((it.x() ^ it.y()) + seed);
+        pixel[3] = quint8(255 - (it.x() + it.y() + seed) % 128);
+    }
+}
+
+KoHistogramProducer* createSequentialProducer(KisPaintDeviceSP dev, const QRect &rc, const QString &id)
+{
+    KoHistogramProducer *producer = KoHistogramProducerFactoryRegistry::instance()->get(id)->generate();
+
+    KisSequentialConstIterator it(dev, rc);
+    int numConseqPixels = it.nConseqPixels();
+    while (it.nextPixels(numConseqPixels)) {
+        numConseqPixels = it.nConseqPixels();
+        producer->addRegionToBin(it.rawDataConst(), 0, numConseqPixels, dev->colorSpace());
+    }
+
+    return producer;
+}
+
+void compareProducers(KoHistogramProducer *p1, KoHistogramProducer *p2)
+{
+    QCOMPARE(p1->count(), p2->count());
+    QCOMPARE(p1->numberOfBins(), p2->numberOfBins());
+
+    for (int chan = 0; chan < p1->channels().count(); chan++) {
+        for (int i = 0; i < p1->numberOfBins(); i++) {
+            QCOMPARE(p1->getBinAt(chan, i), p2->getBinAt(chan, i));
+        }
+    }
+}
+
+}
+
+void KisHistogramTest::testTiledHistogram()
+{
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    const QRect bounds(0, 0, 1000, 700);
+    fillPattern(dev, bounds, 0);
+
+    const QString id = KoHistogramProducerFactoryRegistry::instance()->keysCompatibleWith(cs).first();
+
+    KisTiledHistogram histogram(KoHistogramProducerFactoryRegistry::instance()->get(id)->generate());
+    histogram.update(dev, bounds, bounds);
+
+    QScopedPointer<KoHistogramProducer> reference(createSequentialProducer(dev, bounds, id));
+    compareProducers(histogram.producer(), reference.data());
+
+    // the update touches a few cells partially
+    const QRect dirtyRect(300, 200, 400, 130);
+    fillPattern(dev, dirtyRect, 17);
+    histogram.update(dev, bounds, dirtyRect);
+
+    reference.reset(createSequentialProducer(dev, bounds, id));
+    compareProducers(histogram.producer(), reference.data());
+
+    QScopedPointer<KoHistogramProducer> parallel(KoHistogramProducerFactoryRegistry::instance()->get(id)->generate());
+    KisTiledHistogram::calculate(parallel.data(), dev, bounds);
+    compareProducers(parallel.data(), reference.data());
+}
 
 KISTEST_MAIN(KisHistogramTest)
@@ -1292,4 +1292,30 @@ void KisImageTest::testPaintOverlayMask()
     KIS_DUMP_DEVICE_2(p.image->projection(), refRect, "03_deactivated", "dd");
 }
 
+void KisImageTest::testRequestSnapshot()
+{
+    QRect refRect(0, 0, 512, 512);
+    TestUtil::MaskParent p(refRect);
+
+    KisPaintLayerSP layer = p.layer;
+    layer->paintDevice()->fill(QRect(50, 50, 100, 100), KoColor(Qt::red, layer->colorSpace()));
+    p.image->initialRefreshGraph();
+
+    KisImageSP snapshot;
+    p.image->requestSnapshot([&snapshot] (KisImageSP image) { snapshot = image; });
+    p.image->waitForDone();
+
+    QVERIFY(snapshot);
+
+    KisNodeSP snapshotLayer = KisLayerUtils::findNodeByUuid(snapshot->root(), layer->uuid());
+    QVERIFY(snapshotLayer);
+    QCOMPARE(snapshotLayer->paintDevice()->exactBounds(), QRect(50, 50, 100, 100));
+
+    // the snapshot is not affected by the further changes of the image
+    layer->paintDevice()->fill(QRect(200, 200, 100, 100), KoColor(Qt::blue, layer->colorSpace()));
+
+    QCOMPARE(layer->paintDevice()->exactBounds(), QRect(50, 50, 250, 250));
+    QCOMPARE(snapshotLayer->paintDevice()->exactBounds(), QRect(50, 50, 100, 100));
+}
+
 KISTEST_MAIN(KisImageTest)
@@ -59,6 +59,8 @@ private Q_SLOTS:
     void testMergePassThroughOverPaintLayer();
 
     void testPaintOverlayMask();
+
+    void testRequestSnapshot();
 };
 
 #endif
@@ -621,6 +621,111 @@ void KisPainterTest::testMassiveBltFixedCornerCases()
     QVERIFY(dst->extent().isEmpty());
 }
 
+void testMassiveBltFixedMatchesBitBltImpl(const QString &compositeOpId, bool useSelection, bool lockAlpha)
+{
+    const KoColorSpace* cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QList<QColor> colors;
+    colors << QColor(255, 0, 0, 200);
+    colors << QColor(0, 255, 0, 128);
+    colors << QColor(0, 0, 255, 255);
+
+    QRect devicesRect;
+    QList<KisRenderedDab> devices;
+
+    // overlapping dabs that cross the tile borders
+    for (int i = 0; i < 8; i++) {
+        const QRect rc(7 + i * 23, 11 + i * 17, 80, 80);
+        KisFixedPaintDeviceSP dev = new KisFixedPaintDevice(cs);
+        dev->setRect(rc);
+        dev->initialize();
+        dev->fill(rc, KoColor(colors[i % 3], cs));
+        dev->fill(kisGrowRect(rc, -15), KoColor(QColor(255, 255, 255, 64), cs));
+
+        // the opacity is representable in quint8, so that
+        // the reference painter could get exactly the same value
+        const quint8 opacity = 255 - 20 * i;
+
+        KisRenderedDab dab;
+        dab.device = dev;
+        dab.offset = dev->bounds().topLeft();
+        dab.opacity = qreal(float(opacity) / 255.0f);
+        dab.averageOpacity = dab.opacity;
+        dab.flow = 1.0;
+
+        devices << dab;
+        devicesRect |= rc;
+    }
+
+    KisSelectionSP selection;
+
+    if (useSelection) {
+        selection = new KisSelection();
+        selection->pixelSelection()->select(kisGrowRect(devicesRect, -19));
+    }
+
+    QBitArray channelFlags;
+    if (lockAlpha) {
+        channelFlags = QBitArray(cs->channelCount(), true);
+        channelFlags.clearBit(3);
+    }
+
+    KisPaintDeviceSP batchDst = new KisPaintDevice(cs);
+    batchDst->fill(kisGrowRect(devicesRect, 10), KoColor(QColor(100, 150, 200, 180), cs));
+    KisPaintDeviceSP refDst = new KisPaintDevice(*batchDst);
+
+    {
+        KisPainter painter(batchDst);
+        painter.setCompositeOp(compositeOpId);
+        painter.setSelection(selection);
+        painter.setChannelFlags(channelFlags);
+        painter.bltFixed(kisGrowRect(devicesRect, 10), devices);
+        painter.end();
+    }
+
+    {
+        KisPainter painter(refDst);
+        painter.setCompositeOp(compositeOpId);
+        painter.setSelection(selection);
+        painter.setChannelFlags(channelFlags);
+
+        Q_FOREACH (const KisRenderedDab &dab, devices) {
+            const QRect rc = dab.realBounds();
+            painter.setOpacity(quint8(qRound(dab.opacity * 255.0)));
+            painter.setAverageOpacity(dab.averageOpacity);
+            painter.bltFixed(rc.x(), rc.y(), dab.device, rc.x(), rc.y(), rc.width(), rc.height());
+        }
+
+        painter.end();
+    }
+
+    QPoint errpoint;
+    if (!TestUtil::comparePaintDevices(errpoint, batchDst, refDst)) {
+        QFAIL(QString("Batched bltFixed differs from the per-dab one at %1,%2 (op %3)")
+              .arg(errpoint.x()).arg(errpoint.y()).arg(compositeOpId).toLatin1());
+    }
+}
+
+void KisPainterTest::testMassiveBltFixedMatchesBitBlt()
+{
+    testMassiveBltFixedMatchesBitBltImpl(COMPOSITE_OVER, false, false);
+    testMassiveBltFixedMatchesBitBltImpl(COMPOSITE_ALPHA_DARKEN, false, false);
+    testMassiveBltFixedMatchesBitBltImpl(COMPOSITE_MULT, false, false);
+}
+
+void KisPainterTest::testMassiveBltFixedMatchesBitBltWithSelection()
+{
+    testMassiveBltFixedMatchesBitBltImpl(COMPOSITE_OVER, true, false);
+    testMassiveBltFixedMatchesBitBltImpl(COMPOSITE_ALPHA_DARKEN, true, false);
+    testMassiveBltFixedMatchesBitBltImpl(COMPOSITE_MULT, true, false);
+}
+
+void KisPainterTest::testMassiveBltFixedMatchesBitBltWithChannelFlags()
+{
+    testMassiveBltFixedMatchesBitBltImpl(COMPOSITE_OVER, false, true);
+    testMassiveBltFixedMatchesBitBltImpl(COMPOSITE_MULT, true, true);
+}
+
 
 #include "kis_lod_transform.h"
 
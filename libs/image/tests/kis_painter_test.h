@@ -61,6 +61,10 @@ private Q_SLOTS:
 
     void testMassiveBltFixedCornerCases();
 
+    void testMassiveBltFixedMatchesBitBlt();
+    void testMassiveBltFixedMatchesBitBltWithSelection();
+    void testMassiveBltFixedMatchesBitBltWithChannelFlags();
+
 
     void testOptimizedCopying();
 };
@@ -95,6 +95,14 @@ KisMementoManager::KisMementoManager(const KisMementoManager& rhs)
     Q_ASSERT_X(!m_registrationBlocked,
                "KisMementoManager", "(impossible happened) "
                "The device has been copied while registration was blocked");
+
+    KisMementoItemSP mi;
+    KisMementoItemHashTableIteratorConst iter(&m_index);
+
+    while ((mi = iter.tile())) {
+        m_indexItems.push(mi);
+        iter.next();
+    }
 }
 
 KisMementoManager::~KisMementoManager()
@@ -134,6 +142,7 @@ void KisMementoManager::registerTileChange(KisTile *tile)
         mi = new KisMementoItem();
         mi->changeTile(tile);
         m_index.addTile(mi);
+        m_indexItems.push(mi);
 
         if(namedTransactionInProgress())
             m_currentMemento->updateExtent(mi->col(), mi->row());
@@ -156,6 +165,7 @@ void KisMementoManager::registerTileDeleted(KisTile *tile)
         mi = new KisMementoItem();
         mi->deleteTile(tile, m_headsHashTable.defaultTileData());
         m_index.addTile(mi);
+        m_indexItems.push(mi);
 
         if(namedTransactionInProgress())
             m_currentMemento->updateExtent(mi->col(), mi->row());
@@ -187,8 +197,7 @@ void KisMementoManager::commit()
     KisMementoItemSP parentMI;
     bool newTile;
 
-    KisMementoItemHashTableIterator iter(&m_index);
-    while ((mi = iter.tile())) {
+    while (m_indexItems.pop(mi)) {
         parentMI = m_headsHashTable.getTileLazy(mi->col(), mi->row(), newTile);
 
         mi->setParent(parentMI);
@@ -196,9 +205,9 @@ void KisMementoManager::commit()
         revisionList.append(mi);
 
         m_headsHashTable.deleteTile(mi->col(), mi->row());
+        m_headsHashTable.addTile(mi);
 
-        iter.moveCurrentToHashTable(&m_headsHashTable);
-        //iter.next(); // previous line does this for us
+        m_index.deleteTile(mi->col(), mi->row());
     }
 
     KisHistoryItem hItem;
@@ -344,6 +353,7 @@ void KisMementoManager::rollforward(KisTileHashTable *ht, KisMementoSP memento)
             ht->addTile(mi->tile(this));
 
         m_index.addTile(mi);
+        m_indexItems.push(mi);
     }
     // see comment in rollback()
 
@@ -22,6 +22,7 @@
 #include <QList>
 
 #include "kis_memento_item.h"
+#include "kis_lockless_stack.h"
 #include "config-hash-table-implementaion.h"
 
 typedef QList<KisMementoItemSP> KisMementoItemList;
@@ -138,6 +139,19 @@ protected:
      */
     KisMementoItemHashTable m_index;
 
+    /**
+     * The same items as in m_index, but stored in a plain list.
+     * The hash table is never shrunk, so walking through it takes
+     * the time proportional to the biggest transaction ever done
+     * on the device. Walking through this list instead makes
+     * commit() proportional to the number of tiles changed in the
+     * current transaction only.
+     *
+     * The tiles may be registered from several threads at once,
+     * hence the lockless stack.
+     */
+    KisLocklessStack<KisMementoItemSP> m_indexItems;
+
     /**
      * Main list that stores every commit ever done
      */
@@ -79,6 +79,18 @@ KisTileData::KisTileData(qint32 pixelSize, const quint8 *defPixel, KisTileDataSt
     fillWithPixel(defPixel);
 }
 
+KisTileData::KisTileData(qint32 pixelSize, KisTileDataStore *store)
+    : m_state(NORMAL),
+      m_mementoFlag(0),
+      m_age(0),
+      m_data(0),
+      m_usersCount(0),
+      m_refCount(0),
+      m_pixelSize(pixelSize),
+      m_store(store)
+{
+}
+
 
 /**
  * Duplicating tiledata
@@ -105,6 +105,14 @@ public:
 private:
     KisTileData(const KisTileData& rhs, bool checkFreeMemory = true);
 
+    /**
+     * Creates a tile data without any memory allocated. The caller
+     * must put the data into the swap right after that.
+     *
+     * \see KisTileDataStore::createSwappedTileData()
+     */
+    KisTileData(qint32 pixelSize, KisTileDataStore *store);
+
 public:
     ~KisTileData();
 
@@ -238,6 +246,7 @@ private:
 private:
     friend class KisTile;
     friend class KisTileDataStore;
+    friend class KisSwappedDataStore;
 
     friend class KisTileDataStoreIterator;
     friend class KisTileDataStoreReverseIterator;
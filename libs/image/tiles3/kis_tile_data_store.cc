@@ -178,6 +178,25 @@ KisTileData *KisTileDataStore::allocTileData(qint32 pixelSize, const quint8 *def
     return td;
 }
 
+KisTileData *KisTileDataStore::createSwappedTileData(qint32 pixelSize, const quint8 *defPixel,
+                                                    const quint8 *data, qint32 dataSize)
+{
+    /**
+     * The tile data is not registered in the store, exactly like
+     * the ones swapped out by trySwapTileData(). It will be registered
+     * by ensureTileDataLoaded() on the first access. No memory is
+     * allocated for it until then.
+     */
+    KisTileData *td = new KisTileData(pixelSize, this);
+
+    if (!m_swappedStore.trySwapOutCompressedTileData(td, defPixel, data, dataSize)) {
+        delete td;
+        td = 0;
+    }
+
+    return td;
+}
+
 KisTileData *KisTileDataStore::duplicateTileData(KisTileData *rhs)
 {
     KisTileData *td = 0;
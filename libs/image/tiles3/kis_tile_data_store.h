@@ -102,6 +102,16 @@ public:
         return allocTileData(pixelSize, defPixel);
     }
 
+    /**
+     * Creates a tile data that is kept in the swap in the compressed
+     * form \p data (as produced by KisTileCompressor2) until it is
+     * accessed for the first time. Returns null if the swap cannot
+     * accept the data. In such a case the caller should decompress
+     * the data itself.
+     */
+    KisTileData* createSwappedTileData(qint32 pixelSize, const quint8 *defPixel,
+                                       const quint8 *data, qint32 dataSize);
+
     // Called by The Memento Manager after every commit
     inline void kickPooler()
     {
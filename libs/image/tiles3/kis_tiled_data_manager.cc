@@ -20,6 +20,8 @@
 
 #include <QRect>
 #include <QVector>
+#include <QThread>
+#include <QtConcurrent>
 
 #include "kis_tile.h"
 #include "kis_tiled_data_manager.h"
@@ -33,6 +35,145 @@
 
 #include "kis_global.h"
 
+namespace {
+
+/**
+ * The number of tiles (de)compressed by a single job and the
+ * number of jobs in a batch per CPU core. The compressed data
+ * of one batch is kept in memory while it is being written
+ * into (or read from) the store, so the batch should not be
+ * too big.
+ */
+const int tilesPerCompressionJob = 32;
+const int compressionJobsPerCore = 4;
+
+/**
+ * Collects the output of a tile compressor in memory, so that
+ * the tiles could be compressed on worker threads and written
+ * into the real store afterwards
+ */
+class KisByteArrayPaintDeviceWriter : public KisPaintDeviceWriter
+{
+public:
+    KisByteArrayPaintDeviceWriter(QByteArray *data)
+        : m_data(data)
+    {
+    }
+
+    bool write(const QByteArray &data) override {
+        m_data->append(data);
+        return true;
+    }
+
+    bool write(const char* data, qint64 length) override {
+        m_data->append(data, length);
+        return true;
+    }
+
+private:
+    QByteArray *m_data;
+};
+
+struct TileCompressionJob {
+    const QVector<KisTileSP> *tiles = 0;
+    int begin = 0;
+    int end = 0;
+    QByteArray data;
+    bool result = true;
+};
+
+struct TileCompressionJobWrapper {
+    TileCompressionJobWrapper(qint32 version)
+        : m_version(version) {}
+
+    inline void operator() (TileCompressionJob &job) {
+        KisAbstractTileCompressorSP compressor =
+            KisTileCompressorFactory::create(m_version);
+        KisByteArrayPaintDeviceWriter writer(&job.data);
+
+        for (int i = job.begin; i < job.end; i++) {
+            if (!compressor->writeTile(job.tiles->at(i), writer)) {
+                job.result = false;
+                break;
+            }
+        }
+    }
+
+    qint32 m_version;
+};
+
+void prepareCompressionBatch(const QVector<KisTileSP> &tiles, int *nextTile,
+                             int numJobs, QVector<TileCompressionJob> *batch)
+{
+    batch->clear();
+
+    for (int i = 0; i < numJobs && *nextTile < tiles.size(); i++) {
+        TileCompressionJob job;
+        job.tiles = &tiles;
+        job.begin = *nextTile;
+        job.end = qMin(job.begin + tilesPerCompressionJob, tiles.size());
+        *batch << job;
+
+        *nextTile = job.end;
+    }
+}
+
+struct RawTile {
+    qint32 x = 0;
+    qint32 y = 0;
+    QByteArray data;
+};
+
+struct TileDecompressionJob {
+    QVector<RawTile> tiles;
+    bool result = true;
+};
+
+struct TileDecompressionJobWrapper {
+    TileDecompressionJobWrapper(KisTiledDataManager *dm)
+        : m_dm(dm) {}
+
+    inline void operator() (TileDecompressionJob &job) {
+        KisTileCompressor2 compressor;
+
+        for (auto it = job.tiles.constBegin(); it != job.tiles.constEnd(); ++it) {
+            if (!compressor.decompressRawTile(it->x, it->y, it->data, m_dm)) {
+                job.result = false;
+            }
+        }
+    }
+
+    KisTiledDataManager *m_dm;
+};
+
+bool readDecompressionBatch(KisTileCompressor2 *compressor, QIODevice *stream,
+                            quint32 *tilesLeft, int numJobs,
+                            QVector<TileDecompressionJob> *batch)
+{
+    bool result = true;
+    batch->clear();
+
+    for (int i = 0; i < numJobs && *tilesLeft > 0; i++) {
+        TileDecompressionJob job;
+
+        for (int j = 0; j < tilesPerCompressionJob && *tilesLeft > 0; j++) {
+            RawTile tile;
+            if (compressor->readRawTile(stream, &tile.x, &tile.y, &tile.data)) {
+                job.tiles << tile;
+            } else {
+                result = false;
+            }
+            (*tilesLeft)--;
+        }
+
+        *batch << job;
+    }
+
+    return result;
+}
+
+}
+
 
 /* The data area is divided into tiles each say 64x64 pixels (defined at compiletime)
  * The tiles are laid out in a matrix that can have negative indexes.
@@ -120,25 +261,81 @@ bool KisTiledDataManager::write(KisPaintDeviceWriter &store)
         retval = writeTilesHeader(store, m_hashTable->numTiles());
     }
 
+    if (!retval) return retval;
 
-    KisTileHashTableConstIterator iter(m_hashTable);
-    KisTileSP tile;
+    QVector<KisTileSP> tiles;
+    tiles.reserve(m_hashTable->numTiles());
+
+    {
+        KisTileHashTableConstIterator iter(m_hashTable);
+        KisTileSP tile;
 
-    KisAbstractTileCompressorSP compressor =
-        KisTileCompressorFactory::create(CURRENT_VERSION);
+        while ((tile = iter.tile())) {
+            tiles << tile;
+            iter.next();
+        }
+    }
 
-    while ((tile = iter.tile())) {
-        retval = compressor->writeTile(tile, store);
-        if (!retval) {
-            warnFile << "Failed to write tile";
-            break;
+    const int numJobs = compressionJobsPerCore * QThread::idealThreadCount();
+
+    if (tiles.size() <= tilesPerCompressionJob || numJobs <= compressionJobsPerCore) {
+        KisAbstractTileCompressorSP compressor =
+            KisTileCompressorFactory::create(CURRENT_VERSION);
+
+        Q_FOREACH (KisTileSP tile, tiles) {
+            retval = compressor->writeTile(tile, store);
+            if (!retval) {
+                warnFile << "Failed to write tile";
+                break;
+            }
         }
-        iter.next();
+
+        return retval;
+    }
+
+    /**
+     * The tiles are compressed on worker threads in batches. While
+     * the store consumes the compressed data of one batch (and,
+     * usually, deflates it once again), the workers are busy with
+     * the next one. The tiles are written in the same order as in
+     * the serial case, so the result is stable.
+     */
+    QVector<TileCompressionJob> batches[2];
+    QFuture<void> futures[2];
+    int nextTile = 0;
+    int current = 0;
+
+    prepareCompressionBatch(tiles, &nextTile, numJobs, &batches[current]);
+    futures[current] = QtConcurrent::map(batches[current], TileCompressionJobWrapper(CURRENT_VERSION));
+
+    while (!batches[current].isEmpty()) {
+        const int next = !current;
+
+        prepareCompressionBatch(tiles, &nextTile, numJobs, &batches[next]);
+
+        futures[current].waitForFinished();
+        futures[next] = QtConcurrent::map(batches[next], TileCompressionJobWrapper(CURRENT_VERSION));
+
+        for (auto it = batches[current].constBegin(); it != batches[current].constEnd(); ++it) {
+            retval = it->result && store.write(it->data);
+            if (!retval) {
+                warnFile << "Failed to write tile";
+                break;
+            }
+        }
+
+        batches[current].clear();
+        current = next;
+
+        if (!retval) break;
     }
 
+    futures[current].waitForFinished();
+
     return retval;
 }
-bool KisTiledDataManager::read(QIODevice *stream)
+
+bool KisTiledDataManager::read(QIODevice *stream, bool lazy)
 {
     clear();
 
@@ -172,13 +369,94 @@ bool KisTiledDataManager::read(QIODevice *stream)
         numTiles = line.toUInt();
     }
 
-    KisAbstractTileCompressorSP compressor =
-        KisTileCompressorFactory::create(tilesVersion);
-
     bool readSuccess = true;
-    for (quint32 i = 0; i < numTiles; i++) {
-        if (!compressor->readTile(stream, this)) {
-            readSuccess = false;
+    const int numJobs = compressionJobsPerCore * QThread::idealThreadCount();
+
+    if (tilesVersion == CURRENT_VERSION && lazy) {
+        /**
+         * The compressed data of the tiles has exactly the same format
+         * as the data in the swap, so we can put it there directly and
+         * let the swapper decompress it on demand. If the swap cannot
+         * accept the data, just decompress the tile right now.
+         */
+        KisTileCompressor2 compressor;
+        KisTileDataStore *store = KisTileDataStore::instance();
+        QByteArray data;
+
+        for (quint32 i = 0; i < numTiles; i++) {
+            qint32 x, y;
+
+            if (!compressor.readRawTile(stream, &x, &y, &data)) {
+                readSuccess = false;
+                continue;
+            }
+
+            if (!compressor.checkRawTileData(data, m_pixelSize)) {
+                warnTiles << "Broken tile data at" << x << y << "of size" << data.size();
+                readSuccess = false;
+                continue;
+            }
+
+            KisTileData *td =
+                store->createSwappedTileData(m_pixelSize, m_defaultPixel,
+                                             reinterpret_cast<const quint8*>(data.constData()),
+                                             data.size());
+
+            if (td) {
+                const qint32 col = xToCol(x);
+                const qint32 row = yToRow(y);
+
+                KisTileSP tile = KisTileSP(new KisTile(col, row, td, m_mementoManager));
+                m_hashTable->addTile(tile);
+                m_extentManager.notifyTileAdded(col, row);
+            } else if (!compressor.decompressRawTile(x, y, data, this)) {
+                readSuccess = false;
+            }
+        }
+    } else if (tilesVersion == CURRENT_VERSION &&
+               numTiles > quint32(tilesPerCompressionJob) &&
+               numJobs > compressionJobsPerCore) {
+
+        /**
+         * The stream can be read by one thread only, so the compressed
+         * data of the tiles is read here in batches, and decompressed
+         * by the worker threads while we are reading the next batch.
+         */
+        KisTileCompressor2 compressor;
+
+        QVector<TileDecompressionJob> batches[2];
+        QFuture<void> futures[2];
+        quint32 tilesLeft = numTiles;
+        int current = 0;
+
+        readSuccess &= readDecompressionBatch(&compressor, stream, &tilesLeft, numJobs, &batches[current]);
+        futures[current] = QtConcurrent::map(batches[current], TileDecompressionJobWrapper(this));
+
+        while (!batches[current].isEmpty()) {
+            const int next = !current;
+
+            readSuccess &= readDecompressionBatch(&compressor, stream, &tilesLeft, numJobs, &batches[next]);
+
+            futures[current].waitForFinished();
+            futures[next] = QtConcurrent::map(batches[next], TileDecompressionJobWrapper(this));
+
+            for (auto it = batches[current].constBegin(); it != batches[current].constEnd(); ++it) {
+                readSuccess &= it->result;
+            }
+
+            batches[current].clear();
+            current = next;
+        }
+
+        futures[current].waitForFinished();
+    } else {
+        KisAbstractTileCompressorSP compressor =
+            KisTileCompressorFactory::create(tilesVersion);
+
+        for (quint32 i = 0; i < numTiles; i++) {
+            if (!compressor->readTile(stream, this)) {
+                readSuccess = false;
+            }
         }
     }
 
@@ -207,9 +207,13 @@ public:
 protected:
     /**
      * Reads and writes the tiles 
+     *
+     * If \p lazy is true, the tiles are not decompressed on reading.
+     * Their compressed data is put directly into the swap and is
+     * decompressed only when the tile is accessed for the first time.
      */
     bool write(KisPaintDeviceWriter &store);
-    bool read(QIODevice *stream);
+    bool read(QIODevice *stream, bool lazy = false);
 
     void purge(const QRect& area);
 
@@ -357,6 +361,7 @@ private:
     // and pixel size
     friend class KisAbstractTileCompressor;
     friend class KisTileDataWrapper;
+    friend class KisTiledDataManagerTest;
     qint32 xToCol(qint32 x) const;
     qint32 yToRow(qint32 y) const;
 
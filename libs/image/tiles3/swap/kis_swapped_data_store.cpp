@@ -16,7 +16,7 @@
  *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
-//#include "kis_debug.h"
+#include "kis_debug.h"
 #include "kis_swapped_data_store.h"
 #include "kis_memory_window.h"
 #include "kis_image_config.h"
@@ -26,13 +26,15 @@
 //#define COMPRESSOR_VERSION 2
 
 KisSwappedDataStore::KisSwappedDataStore()
-    : m_memoryMetric(0)
+    : m_memoryMetric(0),
+      m_usedSwapSize(0)
 {
     KisImageConfig config(true);
     const quint64 maxSwapSize = config.maxSwapSize() * MiB;
     const quint64 swapSlabSize = config.swapSlabSize() * MiB;
     const quint64 swapWindowSize = config.swapWindowSize() * MiB;
 
+    m_maxSwapSize = maxSwapSize;
     m_allocator = new KisChunkAllocator(swapSlabSize, maxSwapSize);
     m_swapSpace = new KisMemoryWindow(config.swapDir(), swapWindowSize);
 
@@ -85,6 +87,37 @@ bool KisSwappedDataStore::trySwapOutTileData(KisTileData *td)
     td->setSwapChunk(chunk);
 
     m_memoryMetric += td->pixelSize();
+    m_usedSwapSize += chunk.size();
+
+    return true;
+}
+
+bool KisSwappedDataStore::trySwapOutCompressedTileData(KisTileData *td, const quint8 *defPixel,
+                                                       const quint8 *data, qint32 dataSize)
+{
+    Q_ASSERT(!td->data());
+    QMutexLocker locker(&m_lock);
+
+    if (dataSize <= 0 ||
+        dataSize > m_compressor->tileDataBufferSize(td) ||
+        m_usedSwapSize + dataSize > m_maxSwapSize / 2) {
+
+        return false;
+    }
+
+    KisChunk chunk = m_allocator->getChunk(dataSize);
+    quint8 *ptr = m_swapSpace->getWriteChunkPtr(chunk);
+    if (!ptr) {
+        m_allocator->freeChunk(chunk);
+        return false;
+    }
+    memcpy(ptr, data, dataSize);
+
+    td->setSwapChunk(chunk);
+    m_compressedTilesDefaultPixels.insert(td, QByteArray((const char*)defPixel, td->pixelSize()));
+
+    m_memoryMetric += td->pixelSize();
+    m_usedSwapSize += chunk.size();
 
     return true;
 }
@@ -103,20 +136,33 @@ void KisSwappedDataStore::swapInTileData(KisTileData *td)
 
     quint8 *ptr = m_swapSpace->getReadChunkPtr(chunk);
     Q_ASSERT(ptr);
-    m_compressor->decompressTileData(ptr, chunk.size(), td);
+    const quint64 chunkSize = chunk.size();
+    if (!m_compressor->decompressTileData(ptr, chunkSize, td)) {
+        warnTiles << "Failed to decompress the tile data from the swap, filling it with the default pixel";
+
+        const QByteArray defPixel =
+            m_compressedTilesDefaultPixels.value(td, QByteArray(td->pixelSize(), 0));
+        td->fillWithPixel((const quint8*)defPixel.constData());
+    }
+    m_compressedTilesDefaultPixels.remove(td);
     m_allocator->freeChunk(chunk);
 
     m_memoryMetric -= td->pixelSize();
+    m_usedSwapSize -= chunkSize;
 }
 
 void KisSwappedDataStore::forgetTileData(KisTileData *td)
 {
     QMutexLocker locker(&m_lock);
 
-    m_allocator->freeChunk(td->swapChunk());
+    KisChunk chunk = td->swapChunk();
+    const quint64 chunkSize = chunk.size();
+    m_allocator->freeChunk(chunk);
     td->setSwapChunk(KisChunk());
+    m_compressedTilesDefaultPixels.remove(td);
 
     m_memoryMetric -= td->pixelSize();
+    m_usedSwapSize -= chunkSize;
 }
 
 qint64 KisSwappedDataStore::totalMemoryMetric() const
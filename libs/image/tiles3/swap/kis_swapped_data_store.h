@@ -23,6 +23,7 @@
 
 #include <QMutex>
 #include <QByteArray>
+#include <QHash>
 
 
 class QMutex;
@@ -50,6 +51,20 @@ public:
      */
     bool trySwapOutTileData(KisTileData *td);
 
+    /**
+     * Put the data of a \a td that has no memory allocated into the
+     * swap file directly from its compressed form, as written by
+     * KisTileCompressor2. The data is decompressed on the first access
+     * to the tile, as if it has been swapped out before. If it cannot
+     * be decompressed then, the tile is filled with \p defPixel.
+     * Fails if the swap file is more than half full, so that the
+     * regular swapping still has some room to work.
+     * LOCKING: the tile data should not be accessible by
+     *          anyone else yet.
+     */
+    bool trySwapOutCompressedTileData(KisTileData *td, const quint8 *defPixel,
+                                      const quint8 *data, qint32 dataSize);
+
     /**
      * Restore the data of a \a td basing on information
      * stored in the swap file.
@@ -86,6 +101,16 @@ private:
     QMutex m_lock;
 
     qint64 m_memoryMetric;
+
+    quint64 m_maxSwapSize;
+    quint64 m_usedSwapSize;
+
+    /**
+     * Default pixels of the tiles put into the swap by
+     * trySwapOutCompressedTileData(). The data read from a file
+     * may be broken, so we need something to fill the tile with.
+     */
+    QHash<KisTileData*, QByteArray> m_compressedTilesDefaultPixels;
 };
 
 #endif /* __KIS_SWAPPED_DATA_STORE_H */
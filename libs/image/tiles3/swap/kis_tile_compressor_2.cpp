@@ -19,6 +19,7 @@
 #include "kis_tile_compressor_2.h"
 #include "kis_lzf_compression.h"
 #include <QIODevice>
+#include "kis_debug.h"
 #include "kis_paint_device_writer.h"
 #define TILE_DATA_SIZE(pixelSize) ((pixelSize) * KisTileData::WIDTH * KisTileData::HEIGHT)
 
@@ -62,36 +63,79 @@ bool KisTileCompressor2::writeTile(KisTileSP tile, KisPaintDeviceWriter &store)
 
 bool KisTileCompressor2::readTile(QIODevice *stream, KisTiledDataManager *dm)
 {
-    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize(dm));
-    prepareStreamingBuffer(tileDataSize);
+    qint32 x, y;
+
+    if (!readRawTile(stream, &x, &y, &m_streamingBuffer)) {
+        return false;
+    }
+
+    return decompressRawTile(x, y, m_streamingBuffer, dm);
+}
 
+bool KisTileCompressor2::readRawTile(QIODevice *stream, qint32 *x, qint32 *y, QByteArray *data)
+{
     QByteArray header = stream->readLine(maxHeaderLength());
 
     QList<QByteArray> headerItems = header.trimmed().split(',');
-    if (headerItems.size() == 4) {
-        qint32 x = headerItems.takeFirst().toInt();
-        qint32 y = headerItems.takeFirst().toInt();
-        QString compressionName = headerItems.takeFirst();
-        qint32 dataSize = headerItems.takeFirst().toInt();
+    if (headerItems.size() != 4) {
+        warnFile << "Wrong tile header:" << header;
+        return false;
+    }
+
+    bool xOk = false;
+    bool yOk = false;
+    bool sizeOk = false;
+
+    *x = headerItems.takeFirst().toInt(&xOk);
+    *y = headerItems.takeFirst().toInt(&yOk);
+    QString compressionName = headerItems.takeFirst();
+    qint32 dataSize = headerItems.takeFirst().toInt(&sizeOk);
+
+    if (!xOk || !yOk || !sizeOk ||
+        compressionName != m_compressionName ||
+        dataSize <= 0) {
+
+        warnFile << "Wrong tile header:" << header;
+        return false;
+    }
 
-        Q_ASSERT(headerItems.isEmpty());
-        Q_ASSERT(compressionName == m_compressionName);
+    data->resize(dataSize);
+    if (stream->read(data->data(), dataSize) != dataSize) {
+        warnFile << "Failed to read the tile data of size" << dataSize;
+        return false;
+    }
 
-        qint32 row = yToRow(dm, y);
-        qint32 col = xToCol(dm, x);
+    return true;
+}
 
-        KisTileSP tile = dm->getTile(col, row, true);
+bool KisTileCompressor2::checkRawTileData(const QByteArray &data, qint32 pixelSize) const
+{
+    const qint32 tileDataSize = TILE_DATA_SIZE(pixelSize);
 
-        stream->read(m_streamingBuffer.data(), dataSize);
+    if (data.isEmpty()) return false;
 
-        tile->lockForWrite();
-        bool res = decompressTileData((quint8*)m_streamingBuffer.data(), dataSize, tile->tileData());
-        tile->unlockForWrite();
-        return res;
+    if (data[0] == RAW_DATA_FLAG) {
+        return data.size() == tileDataSize + 1;
+    } else if (data[0] == COMPRESSED_DATA_FLAG) {
+        return data.size() > 1 && data.size() <= tileDataSize + 1;
     }
+
     return false;
 }
 
+bool KisTileCompressor2::decompressRawTile(qint32 x, qint32 y, const QByteArray &data, KisTiledDataManager *dm)
+{
+    qint32 row = yToRow(dm, y);
+    qint32 col = xToCol(dm, x);
+
+    KisTileSP tile = dm->getTile(col, row, true);
+
+    tile->lockForWrite();
+    bool res = decompressTileData((quint8*)data.data(), data.size(), tile->tileData());
+    tile->unlockForWrite();
+    return res;
+}
+
 void KisTileCompressor2::prepareStreamingBuffer(qint32 tileDataSize)
 {
     /**
@@ -162,7 +206,7 @@ bool KisTileCompressor2::decompressTileData(quint8 *buffer,
         }
         return false;
     }
-    else {
+    else if (bufferSize >= tileDataSize + 1) {
         memcpy(tileData->data(), buffer + 1, tileDataSize);
         return true;
     }
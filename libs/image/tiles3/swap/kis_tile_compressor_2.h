@@ -32,6 +32,34 @@ public:
     bool writeTile(KisTileSP tile, KisPaintDeviceWriter &store) override;
     bool readTile(QIODevice *io, KisTiledDataManager *dm) override;
 
+    /**
+     * Reads the header and the compressed data of a single tile
+     * from the \p stream, but does not decompress it. Together with
+     * decompressRawTile() it is equivalent to readTile(), but lets
+     * the caller decompress the tiles on a different thread.
+     *
+     * \see decompressRawTile()
+     */
+    bool readRawTile(QIODevice *stream, qint32 *x, qint32 *y, QByteArray *data);
+
+    /**
+     * Checks that the \p data read by readRawTile() looks like a valid
+     * compressed tile of \p pixelSize: the flag byte is known and the
+     * size fits the tile. It doesn't decompress the data, so the actual
+     * compressed stream may still be broken.
+     */
+    bool checkRawTileData(const QByteArray &data, qint32 pixelSize) const;
+
+    /**
+     * Decompresses the \p data read by readRawTile() into the tile
+     * of \p dm at position (\p x, \p y). It is safe to call this method
+     * from several threads as long as each thread uses its own
+     * compressor.
+     *
+     * \see readRawTile()
+     */
+    bool decompressRawTile(qint32 x, qint32 y, const QByteArray &data, KisTiledDataManager *dm);
+
 
     void compressTileData(KisTileData *tileData,quint8 *buffer,
                           qint32 bufferSize, qint32 &bytesWritten) override;
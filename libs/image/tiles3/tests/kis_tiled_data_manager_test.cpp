@@ -18,6 +18,7 @@
 
 #include "kis_tiled_data_manager_test.h"
 #include <QTest>
+#include <QBuffer>
 
 #include "tiles3/kis_tiled_data_manager.h"
 
@@ -539,6 +540,106 @@ void KisTiledDataManagerTest::testUndoSetDefaultPixel()
     QVERIFY(memoryIsFilled(oddPixel2, tile10->data(), TILESIZE));
 }
 
+void KisTiledDataManagerTest::testWriteReadManyTiles_data()
+{
+    QTest::addColumn<bool>("lazy");
+
+    QTest::newRow("normal") << false;
+    QTest::newRow("lazy") << true;
+}
+
+void KisTiledDataManagerTest::testWriteReadManyTiles()
+{
+    QFETCH(bool, lazy);
+
+    /**
+     * Big enough to make the datamanager compress
+     * the tiles on several threads
+     */
+    const QRect rc(-64, -64, 64 * 40, 64 * 40);
+
+    quint8 defaultPixel = 0;
+    KisTiledDataManager srcDM(1, &defaultPixel);
+
+    QByteArray data(rc.width() * rc.height(), 0);
+    for (int i = 0; i < data.size(); i++) {
+        data[i] = (i / 61 + i % 7) & 0xff;
+    }
+    srcDM.writeBytes((quint8*)data.data(), rc.x(), rc.y(), rc.width(), rc.height());
+
+    KoStoreFake fakeStore;
+    KisFakePaintDeviceWriter writer(&fakeStore);
+    QVERIFY(srcDM.write(writer));
+
+    fakeStore.startReading();
+
+    KisTiledDataManager dstDM(1, &defaultPixel);
+    QVERIFY(dstDM.read(fakeStore.device(), lazy));
+
+    QByteArray result(data.size(), 0);
+    dstDM.readBytes((quint8*)result.data(), rc.x(), rc.y(), rc.width(), rc.height());
+
+    QCOMPARE(dstDM.extent(), srcDM.extent());
+    QVERIFY(result == data);
+}
+
+void KisTiledDataManagerTest::testLazyReadBrokenTiles()
+{
+    quint8 defaultPixel = 7;
+    const QByteArray tilesHeader("VERSION 2\nTILEWIDTH 64\nTILEHEIGHT 64\nPIXELSIZE 1\n");
+
+    {
+        // the header is fine, but the compressed stream itself is
+        // broken, the tile should be filled with the default pixel
+        QByteArray stream = tilesHeader;
+        stream += "DATA 1\n";
+        stream += "0,0,LZF,3\n";
+        stream += QByteArray("\x01\xff\xff", 3);
+
+        QBuffer buffer(&stream);
+        buffer.open(QIODevice::ReadOnly);
+
+        KisTiledDataManager dm(1, &defaultPixel);
+        QVERIFY(dm.read(&buffer, true));
+        QCOMPARE(dm.extent(), QRect(0, 0, 64, 64));
+
+        QByteArray result(64 * 64, 0);
+        dm.readBytes((quint8*)result.data(), 0, 0, 64, 64);
+        QVERIFY(result == QByteArray(64 * 64, defaultPixel));
+    }
+
+    {
+        // the size of the raw data doesn't match the tile size, the
+        // data should not get into the swap
+        QByteArray stream = tilesHeader;
+        stream += "DATA 1\n";
+        stream += "0,0,LZF,3\n";
+        stream += QByteArray("\x00\x01\x02", 3);
+
+        QBuffer buffer(&stream);
+        buffer.open(QIODevice::ReadOnly);
+
+        KisTiledDataManager dm(1, &defaultPixel);
+        QVERIFY(!dm.read(&buffer, true));
+        QVERIFY(dm.extent().isEmpty());
+    }
+
+    {
+        // the header promises more data than there is in the stream
+        QByteArray stream = tilesHeader;
+        stream += "DATA 1\n";
+        stream += "0,0,LZF,100\n";
+        stream += QByteArray("\x01\x02", 2);
+
+        QBuffer buffer(&stream);
+        buffer.open(QIODevice::ReadOnly);
+
+        KisTiledDataManager dm(1, &defaultPixel);
+        QVERIFY(!dm.read(&buffer, true));
+        QVERIFY(dm.extent().isEmpty());
+    }
+}
+
 //#include <valgrind/callgrind.h>
 
 void KisTiledDataManagerTest::benchmarkReadOnlyTileLazy()
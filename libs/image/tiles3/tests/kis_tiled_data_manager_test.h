@@ -52,6 +52,9 @@ private Q_SLOTS:
     void testTransactions();
     void testPurgeHistory();
     void testUndoSetDefaultPixel();
+    void testWriteReadManyTiles_data();
+    void testWriteReadManyTiles();
+    void testLazyReadBrokenTiles();
 
     void benchmarkReadOnlyTileLazy();
     void benchmarkSharedPointers();
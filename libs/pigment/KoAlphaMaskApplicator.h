@@ -31,6 +31,26 @@ template<typename _channels_type_,
          typename EnableDummyType = void>
 struct KoAlphaMaskApplicator : public KoAlphaMaskApplicatorBase
 {
+    void applyAlphaU8Mask(quint8 *pixels,
+                          const quint8 *alpha,
+                          qint32 nPixels) const override {
+        KoColorSpaceTrait<
+                _channels_type_,
+                _channels_nb_,
+                _alpha_pos_>::
+                applyAlphaU8Mask(pixels, alpha, nPixels);
+    }
+
+    void subtractAlphaU8Mask(quint8 *pixels,
+                             const quint8 *alpha,
+                             qint32 nPixels) const override {
+        KoColorSpaceTrait<
+                _channels_type_,
+                _channels_nb_,
+                _alpha_pos_>::
+                subtractAlphaU8Mask(pixels, alpha, nPixels);
+    }
+
     void applyInverseNormedFloatMask(quint8 *pixels,
                                      const float *alpha,
                                      qint32 nPixels) const override {
@@ -77,6 +97,63 @@ struct KoAlphaMaskApplicator<
     static constexpr int numChannels = 4;
     static constexpr int alphaPos = 3;
 
+    void applyAlphaU8Mask(quint8 *pixels,
+                          const quint8 *alpha,
+                          qint32 nPixels) const override
+    {
+        const int block1 = nPixels / Vc::float_v::size();
+        const int block2 = nPixels % Vc::float_v::size();
+        const int vectorPixelStride = numChannels * Vc::float_v::size();
+        const quint32 colorChannelsMask = 0x00FFFFFF;
+
+        for (int i = 0; i < block1; i++) {
+            const uint_v maskAlpha(alpha, Vc::Unaligned);
+
+            uint_v data_i;
+            data_i.load((const quint32*)pixels, Vc::Unaligned);
+
+            const uint_v pixelAlpha_i = multiply(data_i >> 24, maskAlpha);
+            data_i = (data_i & colorChannelsMask) | (pixelAlpha_i << 24);
+            data_i.store((quint32*)pixels, Vc::Unaligned);
+
+            pixels += vectorPixelStride;
+            alpha += Vc::float_v::size();
+        }
+
+        KoColorSpaceTrait<quint8, 4, 3>::
+            applyAlphaU8Mask(pixels, alpha, block2);
+    }
+
+    void subtractAlphaU8Mask(quint8 *pixels,
+                             const quint8 *alpha,
+                             qint32 nPixels) const override
+    {
+        const int block1 = nPixels / Vc::float_v::size();
+        const int block2 = nPixels % Vc::float_v::size();
+        const int vectorPixelStride = numChannels * Vc::float_v::size();
+        const quint32 colorChannelsMask = 0x00FFFFFF;
+
+        for (int i = 0; i < block1; i++) {
+            const uint_v maskAlpha(alpha, Vc::Unaligned);
+
+            uint_v data_i;
+            data_i.load((const quint32*)pixels, Vc::Unaligned);
+
+            const uint_v pixelAlpha = data_i >> 24;
+            uint_v pixelAlpha_i = pixelAlpha - maskAlpha;
+            pixelAlpha_i.setZero(maskAlpha > pixelAlpha);
+
+            data_i = (data_i & colorChannelsMask) | (pixelAlpha_i << 24);
+            data_i.store((quint32*)pixels, Vc::Unaligned);
+
+            pixels += vectorPixelStride;
+            alpha += Vc::float_v::size();
+        }
+
+        KoColorSpaceTrait<quint8, 4, 3>::
+            subtractAlphaU8Mask(pixels, alpha, block2);
+    }
+
     void applyInverseNormedFloatMask(quint8 *pixels,
                                      const float *alpha,
                                      qint32 nPixels) const override
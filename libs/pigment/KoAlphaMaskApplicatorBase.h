@@ -29,6 +29,8 @@ class KRITAPIGMENT_EXPORT KoAlphaMaskApplicatorBase
 {
 public:
     virtual ~KoAlphaMaskApplicatorBase();
+    virtual void applyAlphaU8Mask(quint8 * pixels, const quint8 * alpha, qint32 nPixels) const = 0;
+    virtual void subtractAlphaU8Mask(quint8 * pixels, const quint8 * alpha, qint32 nPixels) const = 0;
     virtual void applyInverseNormedFloatMask(quint8 * pixels, const float * alpha, qint32 nPixels) const = 0;
     virtual void fillInverseAlphaNormedFloatMaskWithColor(quint8 * pixels,
                                                           const float * alpha,
@@ -29,6 +29,7 @@
 // #include "Ko_global.h"
 #include "KoIntegerMaths.h"
 #include "KoChannelInfo.h"
+#include "kis_assert.h"
 
 static const KoColorSpace* m_labCs = 0;
 
@@ -80,6 +81,39 @@ void KoBasicHistogramProducer::clear()
     }
 }
 
+void KoBasicHistogramProducer::addBins(const KoHistogramProducer *other, bool subtract)
+{
+    const KoBasicHistogramProducer *src = dynamic_cast<const KoBasicHistogramProducer*>(other);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(src);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(src->m_channels == m_channels);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(src->m_nrOfBins == m_nrOfBins);
+
+    // the bins are unsigned, subtraction relies on the modular arithmetic
+    const quint32 sign = subtract ? quint32(-1) : 1;
+
+    for (int i = 0; i < m_channels; i++) {
+        vBins &bins = m_bins[i];
+        const vBins &srcBins = src->m_bins[i];
+
+        for (int j = 0; j < m_nrOfBins; j++) {
+            bins[j] += sign * srcBins[j];
+        }
+
+        m_outLeft[i] += sign * src->m_outLeft[i];
+        m_outRight[i] += sign * src->m_outRight[i];
+    }
+
+    m_count += subtract ? -src->m_count : src->m_count;
+}
+
+KoHistogramProducer* KoBasicHistogramProducer::initEmptyCopy(KoBasicHistogramProducer *copy) const
+{
+    copy->setView(m_from, m_width);
+    copy->setSkipTransparent(m_skipTransparent);
+    copy->setSkipUnselected(m_skipUnselected);
+    return copy;
+}
+
 void KoBasicHistogramProducer::makeExternalToInternal()
 {
     // This function assumes that the pixel is has no 'gaps'. That is to say: if we start
@@ -114,6 +148,13 @@ QString KoBasicU8HistogramProducer::positionToString(qreal pos) const
 
 void KoBasicU8HistogramProducer::addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *cs)
 {
+    /**
+     * m_colorSpace is always an 8-bit color space, so the channel values
+     * are used as bin indexes directly, without virtual scaleToU8() calls
+     */
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_colorSpace->pixelSize() == m_colorSpace->channelCount());
+
+    const quint32 srcPixelSize = cs->pixelSize();
     quint32 dstPixelSize = m_colorSpace->pixelSize();
     quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
     cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
@@ -124,11 +165,12 @@ void KoBasicU8HistogramProducer::addRegionToBin(const quint8 * pixels, const qui
             if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
 
                 for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    m_bins[i][m_colorSpace->scaleToU8(dst,i)]++;
+                    m_bins[i][dst[i]]++;
                 }
                 m_count++;
             }
             dst += dstPixelSize;
+            pixels += srcPixelSize;
             selectionMask++;
             nPixels--;
         }
@@ -138,14 +180,17 @@ void KoBasicU8HistogramProducer::addRegionToBin(const quint8 * pixels, const qui
             if (!(m_skipTransparent && cs->opacityU8(pixels) == OPACITY_TRANSPARENT_U8)) {
 
                 for (int i = 0; i < (int)m_colorSpace->channelCount(); i++) {
-                    m_bins[i][m_colorSpace->scaleToU8(dst,i)]++;
+                    m_bins[i][dst[i]]++;
                 }
                 m_count++;
             }
             dst += dstPixelSize;
+            pixels += srcPixelSize;
             nPixels--;
         }
     }
+
+    delete[] dstPixels;
 }
 
 // ------------ U16 ---------------------
@@ -173,6 +218,7 @@ void KoBasicU16HistogramProducer::addRegionToBin(const quint8 * pixels, const qu
     quint16 to = from + width;
     qreal factor = 255.0 / width;
 
+    const quint32 srcPixelSize = cs->pixelSize();
     quint32 dstPixelSize = m_colorSpace->pixelSize();
     quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
     cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
@@ -195,6 +241,7 @@ void KoBasicU16HistogramProducer::addRegionToBin(const quint8 * pixels, const qu
                 m_count++;
             }
             dst += dstPixelSize;
+            pixels += srcPixelSize;
             selectionMask++;
             nPixels--;
         }
@@ -215,9 +262,12 @@ void KoBasicU16HistogramProducer::addRegionToBin(const quint8 * pixels, const qu
                 m_count++;
             }
             dst += dstPixelSize;
+            pixels += srcPixelSize;
             nPixels--;
         }
     }
+
+    delete[] dstPixels;
 }
 
 // ------------ Float32 ---------------------
@@ -245,6 +295,7 @@ void KoBasicF32HistogramProducer::addRegionToBin(const quint8 * pixels, const qu
     float to = from + width;
     float factor = 255.0 / width;
 
+    const quint32 srcPixelSize = cs->pixelSize();
     quint32 dstPixelSize = m_colorSpace->pixelSize();
     quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
     cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
@@ -267,6 +318,7 @@ void KoBasicF32HistogramProducer::addRegionToBin(const quint8 * pixels, const qu
                 m_count++;
             }
             dst += dstPixelSize;
+            pixels += srcPixelSize;
             selectionMask++;
             nPixels--;
 
@@ -287,10 +339,13 @@ void KoBasicF32HistogramProducer::addRegionToBin(const quint8 * pixels, const qu
                 m_count++;
             }
             dst += dstPixelSize;
+            pixels += srcPixelSize;
             nPixels--;
 
         }
     }
+
+    delete[] dstPixels;
 }
 
 #ifdef HAVE_OPENEXR
@@ -320,6 +375,7 @@ void KoBasicF16HalfHistogramProducer::addRegionToBin(const quint8 * pixels, cons
     float to = from + width;
     float factor = 255.0 / width;
 
+    const quint32 srcPixelSize = cs->pixelSize();
     quint32 dstPixelSize = m_colorSpace->pixelSize();
     quint8 *dstPixels = new quint8[nPixels * dstPixelSize];
     cs->convertPixelsTo(pixels, dstPixels, m_colorSpace, nPixels, KoColorConversionTransformation::IntentAbsoluteColorimetric, KoColorConversionTransformation::Empty);
@@ -342,6 +398,7 @@ void KoBasicF16HalfHistogramProducer::addRegionToBin(const quint8 * pixels, cons
                 m_count++;
             }
             dst += dstPixelSize;
+            pixels += srcPixelSize;
             selectionMask++;
             nPixels--;
         }
@@ -361,9 +418,12 @@ void KoBasicF16HalfHistogramProducer::addRegionToBin(const quint8 * pixels, cons
                 m_count++;
             }
             dst += dstPixelSize;
+            pixels += srcPixelSize;
             nPixels--;
         }
     }
+
+    delete[] dstPixels;
 }
 #endif
 
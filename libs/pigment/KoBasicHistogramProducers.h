@@ -38,6 +38,7 @@ public:
     ~KoBasicHistogramProducer() override {}
 
     void clear() override;
+    void addBins(const KoHistogramProducer *other, bool subtract = false) override;
 
     void setView(qreal from, qreal size) override {
         m_from = from; m_width = size;
@@ -76,6 +77,12 @@ public:
     }
 
 protected:
+    /**
+     * Copies the view and skip settings of this producer into \p copy
+     * and returns it. Used by createEmptyCopy() implementations.
+     */
+    KoHistogramProducer* initEmptyCopy(KoBasicHistogramProducer *copy) const;
+
     /**
      * The order in which channels() returns is not the same as the internal representation,
      * that of the pixel internally. This method converts external usage to internal usage.
@@ -107,6 +114,9 @@ public:
     KoBasicU8HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicU8HistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createEmptyCopy() const override {
+        return initEmptyCopy(new KoBasicU8HistogramProducer(m_id, m_colorSpace));
+    }
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override {
         return 1.0;
@@ -119,6 +129,9 @@ public:
     KoBasicU16HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicU16HistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createEmptyCopy() const override {
+        return initEmptyCopy(new KoBasicU16HistogramProducer(m_id, m_colorSpace));
+    }
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
 };
@@ -129,6 +142,9 @@ public:
     KoBasicF32HistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicF32HistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createEmptyCopy() const override {
+        return initEmptyCopy(new KoBasicF32HistogramProducer(m_id, m_colorSpace));
+    }
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
 };
@@ -141,6 +157,9 @@ public:
     KoBasicF16HalfHistogramProducer(const KoID& id, const KoColorSpace *colorSpace);
     ~KoBasicF16HalfHistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createEmptyCopy() const override {
+        return initEmptyCopy(new KoBasicF16HalfHistogramProducer(m_id, m_colorSpace));
+    }
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
 };
@@ -194,6 +213,9 @@ public:
     KoGenericRGBHistogramProducer();
     ~KoGenericRGBHistogramProducer() override {}
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createEmptyCopy() const override {
+        return initEmptyCopy(new KoGenericRGBHistogramProducer());
+    }
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
     QList<KoChannelInfo *> channels() override;
@@ -235,6 +257,9 @@ public:
     KoGenericLabHistogramProducer();
     ~KoGenericLabHistogramProducer() override;
     void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace *colorSpace) override;
+    KoHistogramProducer* createEmptyCopy() const override {
+        return initEmptyCopy(new KoGenericLabHistogramProducer());
+    }
     QString positionToString(qreal pos) const override;
     qreal maximalZoom() const override;
     QList<KoChannelInfo *> channels() override;
@@ -414,6 +414,13 @@ KoColorConversionTransformation* KoColorSpace::createColorConverter(const KoColo
     }
 }
 
+KoDitherOp* KoColorSpace::createDitherOp(const KoColorSpace *dstColorSpace, KoDitherOp::Type type) const
+{
+    Q_UNUSED(dstColorSpace);
+    Q_UNUSED(type);
+    return 0;
+}
+
 bool KoColorSpace::convertPixelsTo(const quint8 * src,
                                    quint8 * dst,
                                    const KoColorSpace * dstColorSpace,
@@ -512,6 +519,23 @@ void KoColorSpace::bitBlt(const KoColorSpace* srcSpace, const KoCompositeOp::Par
     }
 }
 
+void KoColorSpace::bitBltBatch(const KoColorSpace* srcSpace, const KoCompositeOp::ParameterInfo *jobs, int numJobs, const KoCompositeOp* op,
+                               KoColorConversionTransformation::Intent renderingIntent,
+                               KoColorConversionTransformation::ConversionFlags conversionFlags) const
+{
+    Q_ASSERT_X(*op->colorSpace() == *this, "KoColorSpace::bitBltBatch", QString("Composite op is for color space %1 (%2) while this is %3 (%4)").arg(op->colorSpace()->id()).arg(op->colorSpace()->profile()->name()).arg(id()).arg(profile()->name()).toLatin1());
+
+    if (numJobs <= 0) return;
+
+    if (*this == *srcSpace) {
+        op->compositeBatch(jobs, numJobs);
+    } else {
+        for (int i = 0; i < numJobs; i++) {
+            bitBlt(srcSpace, jobs[i], op, renderingIntent, conversionFlags);
+        }
+    }
+}
+
 
 QVector<quint8> * KoColorSpace::threadLocalConversionCache(quint32 size) const
 {
@@ -32,6 +32,7 @@
 #include "KoColorConversionTransformation.h"
 #include "KoColorProofingConversionTransformation.h"
 #include "KoCompositeOp.h"
+#include "KoDitherOp.h"
 #include <KoID.h>
 #include "kritapigment_export.h"
 
@@ -378,6 +379,17 @@ public:
                                  KoColorConversionTransformation::Intent renderingIntent,
                                  KoColorConversionTransformation::ConversionFlags conversionFlags) const;
 
+    /**
+     * Creates an op that converts the pixels into \p dstColorSpace, which
+     * differs from this color space in the channel depth only, with
+     * dithering of \p type. Returns null if the color spaces differ in
+     * anything else or the conversion doesn't reduce the depth into an
+     * integer channel type. The caller takes ownership of the op.
+     *
+     * The op is thread-safe, the same op can be used from several threads.
+     */
+    virtual KoDitherOp* createDitherOp(const KoColorSpace *dstColorSpace, KoDitherOp::Type type) const;
+
     virtual KoColorConversionTransformation *createProofingTransform(const KoColorSpace * dstColorSpace,
                                                              const KoColorSpace * proofingSpace,
                                                              KoColorConversionTransformation::Intent renderingIntent,
@@ -467,6 +479,14 @@ public:
      */
     virtual void applyAlphaU8Mask(quint8 * pixels, const quint8 * alpha, qint32 nPixels) const = 0;
 
+    /**
+     * Subtracts the specified 8-bit alpha mask from the alpha channel of the
+     * pixels, clamping the result to zero. We assume that there are just
+     * as many alpha values as pixels but we do not check this; the alpha values
+     * are assumed to be 8-bits.
+     */
+    virtual void subtractAlphaU8Mask(quint8 * pixels, const quint8 * alpha, qint32 nPixels) const = 0;
+
     /**
      * Applies the inverted 8-bit alpha mask to the pixels. We assume that there are just
      * as many alpha values as pixels but we do not check this; the alpha values
@@ -625,6 +645,17 @@ public:
                         KoColorConversionTransformation::Intent renderingIntent,
                         KoColorConversionTransformation::ConversionFlags conversionFlags) const;
 
+    /**
+     * Compose \p numJobs jobs from the \p jobs array onto "us" with the same
+     * composite op, in the order they are stored. All the jobs must share the
+     * same source color space. When no conversion is needed, the whole set is
+     * passed to the op in one call (see KoCompositeOp::compositeBatch()),
+     * otherwise every job goes through bitBlt() separately.
+     */
+    void bitBltBatch(const KoColorSpace* srcSpace, const KoCompositeOp::ParameterInfo *jobs, int numJobs, const KoCompositeOp* op,
+                     KoColorConversionTransformation::Intent renderingIntent,
+                     KoColorConversionTransformation::ConversionFlags conversionFlags) const;
+
     /**
      * Serialize this color following Create's swatch color specification available
      * at https://web.archive.org/web/20110826002520/http://create.freedesktop.org/wiki/Swatches_-_colour_file_format/Draft
@@ -35,6 +35,7 @@
 #include "KoConvolutionOpImpl.h"
 #include "KoInvertColorTransformation.h"
 #include "KoAlphaMaskApplicatorFactory.h"
+#include "KoDitherOpFactory.h"
 #include "KoColorModelStandardIdsUtils.h"
 
 /**
@@ -126,7 +127,11 @@ public:
     }
 
     void applyAlphaU8Mask(quint8 * pixels, const quint8 * alpha, qint32 nPixels) const override {
-        _CSTrait::applyAlphaU8Mask(pixels, alpha, nPixels);
+        m_alphaMaskApplicator->applyAlphaU8Mask(pixels, alpha, nPixels);
+    }
+
+    void subtractAlphaU8Mask(quint8 * pixels, const quint8 * alpha, qint32 nPixels) const override {
+        m_alphaMaskApplicator->subtractAlphaU8Mask(pixels, alpha, nPixels);
     }
 
     void applyInverseAlphaU8Mask(quint8 * pixels, const quint8 * alpha, qint32 nPixels) const override {
@@ -210,6 +215,25 @@ public:
         return KoColorSpace::convertPixelsTo(src, dst, dstColorSpace, numPixels, renderingIntent, conversionFlags);
     }
 
+    KoDitherOp* createDitherOp(const KoColorSpace *dstColorSpace, KoDitherOp::Type type) const override
+    {
+        // the same check as in convertPixelsTo(): only the bit depth may differ
+        const bool scaleOnly =
+            !(*this == *dstColorSpace) &&
+            dstColorSpace->colorModelId().id() == colorModelId().id() &&
+            dstColorSpace->colorDepthId().id() != colorDepthId().id() &&
+            dstColorSpace->profile()->name()   == profile()->name() &&
+            dstColorSpace->channelCount() == _CSTrait::channels_nb;
+
+        if (!scaleOnly) {
+            return 0;
+        }
+
+        return KoDitherOpFactory::create(colorDepthIdForChannelType<typename _CSTrait::channels_type>(),
+                                         dstColorSpace->colorDepthId(),
+                                         _CSTrait::channels_nb, type);
+    }
+
     void convertChannelToVisualRepresentation(const quint8 *src, quint8 *dst, quint32 nPixels, const qint32 selectedChannelIndex) const override
     {
         qint32 selectedChannelPos = this->channels()[selectedChannelIndex]->pos();
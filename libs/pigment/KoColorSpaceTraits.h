@@ -197,6 +197,16 @@ struct KoColorSpaceTrait {
         }
     }
 
+    inline static void subtractAlphaU8Mask(quint8 * pixels, const quint8 * alpha, qint32 nPixels) {
+        if (alpha_pos < 0) return;
+
+        for (; nPixels > 0; --nPixels, pixels += pixelSize, ++alpha) {
+            channels_type valpha =  KoColorSpaceMaths<quint8, channels_type>::scaleToA(*alpha);
+            channels_type* alphapixel = nativeArray(pixels) + alpha_pos;
+            *alphapixel = *alphapixel > valpha ? channels_type(*alphapixel - valpha) : KoColorSpaceMathsTraits<channels_type>::zeroValue;
+        }
+    }
+
     inline static void applyInverseAlphaU8Mask(quint8 * pixels, const quint8 * alpha, qint32 nPixels) {
         if (alpha_pos < 0) return;
 
@@ -50,3 +50,9 @@ void KoColorTransformation::setParameters(const QHash<QString, QVariant> & param
     }
 
 }
+
+bool KoColorTransformation::fetchPerChannelLookupTable(KoPerChannelLookupTable *lut) const
+{
+    Q_UNUSED(lut);
+    return false;
+}
@@ -26,6 +26,7 @@
 
 class QVariant;
 class QString;
+class KoPerChannelLookupTable;
 
 
 /**
@@ -77,6 +78,20 @@ public:
 
     /// @return true
     virtual bool isValid() const { return true; }
+
+    /**
+     * If the transformation is a pure per-channel mapping of an integer
+     * color space, that is, every output channel depends on the same
+     * input channel only, it can export itself as a set of lookup tables.
+     * KoCompositeColorTransformation uses that to collapse chains of
+     * such transformations into a single pass.
+     *
+     * @param lut the table to be filled
+     * @return true if \p lut has been filled
+     *
+     * The default implementation returns false.
+     */
+    virtual bool fetchPerChannelLookupTable(KoPerChannelLookupTable *lut) const;
 };
 
 #endif
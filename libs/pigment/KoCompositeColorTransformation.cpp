@@ -20,14 +20,46 @@
 
 #include <QVector>
 
+#include "KoPerChannelLookupTable.h"
+
 
 struct Q_DECL_HIDDEN KoCompositeColorTransformation::Private
 {
+    /**
+     * A stage is either a transformation that cannot be collapsed
+     * or a lookup table accumulating a run of sequential per-channel
+     * transformations
+     */
+    struct Stage {
+        Stage(KoColorTransformation *_transform = 0)
+            : transform(_transform)
+        {
+        }
+
+        Stage(const KoPerChannelLookupTable &_lut)
+            : transform(0),
+              lut(_lut)
+        {
+        }
+
+        void transformPixels(const quint8 *src, quint8 *dst, qint32 nPixels) const {
+            if (transform) {
+                transform->transform(src, dst, nPixels);
+            } else {
+                lut.apply(src, dst, nPixels);
+            }
+        }
+
+        KoColorTransformation *transform;
+        KoPerChannelLookupTable lut;
+    };
+
     ~Private() {
         qDeleteAll(transformations);
     }
 
     QVector<KoColorTransformation*> transformations;
+    QVector<Stage> stages;
 };
 
 
@@ -44,26 +76,52 @@ KoCompositeColorTransformation::~KoCompositeColorTransformation()
 
 void KoCompositeColorTransformation::appendTransform(KoColorTransformation *transform)
 {
-    if (transform) {
-        m_d->transformations.append(transform);
+    if (!transform) return;
+
+    m_d->transformations.append(transform);
+
+    KoPerChannelLookupTable lut;
+    if (transform->fetchPerChannelLookupTable(&lut)) {
+        if (!m_d->stages.isEmpty() &&
+            m_d->stages.last().lut.isCompatible(lut)) {
+
+            m_d->stages.last().lut.chain(lut);
+        } else {
+            m_d->stages.append(Private::Stage(lut));
+        }
+    } else {
+        m_d->stages.append(Private::Stage(transform));
     }
 }
 
 void KoCompositeColorTransformation::transform(const quint8 *src, quint8 *dst, qint32 nPixels) const
 {
-    QVector<KoColorTransformation*>::const_iterator begin = m_d->transformations.constBegin();
-    QVector<KoColorTransformation*>::const_iterator it = begin;
-    QVector<KoColorTransformation*>::const_iterator end = m_d->transformations.constEnd();
+    QVector<Private::Stage>::const_iterator begin = m_d->stages.constBegin();
+    QVector<Private::Stage>::const_iterator it = begin;
+    QVector<Private::Stage>::const_iterator end = m_d->stages.constEnd();
 
     for (; it != end; ++it) {
         if (it == begin) {
-            (*it)->transform(src, dst, nPixels);
+            it->transformPixels(src, dst, nPixels);
         } else {
-            (*it)->transform(dst, dst, nPixels);
+            it->transformPixels(dst, dst, nPixels);
         }
     }
 }
 
+bool KoCompositeColorTransformation::fetchPerChannelLookupTable(KoPerChannelLookupTable *lut) const
+{
+    if (m_d->stages.size() != 1 || m_d->stages.first().transform) return false;
+
+    *lut = m_d->stages.first().lut;
+    return true;
+}
+
+int KoCompositeColorTransformation::numPasses() const
+{
+    return m_d->stages.size();
+}
+
 KoColorTransformation* KoCompositeColorTransformation::createOptimizedCompositeTransform(const QVector<KoColorTransformation*> transforms)
 {
     KoColorTransformation *finalTransform = 0;
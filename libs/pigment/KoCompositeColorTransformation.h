@@ -40,6 +40,11 @@
  * src and dst buffers, which are created in temporary memory owned by
  * KoCompositeColorTransformation. Please note that this mode IS NOT
  * IMPLEMENTED YET!
+ *
+ * Sequential transformations that can export themselves as per-channel
+ * lookup tables (see KoColorTransformation::fetchPerChannelLookupTable())
+ * are collapsed into a single table, so a chain like levels -> curves ->
+ * invert costs only one lookup pass over the pixels.
  */
 class KRITAPIGMENT_EXPORT KoCompositeColorTransformation : public KoColorTransformation
 {
@@ -55,6 +60,18 @@ public:
 
     void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override;
 
+    /**
+     * The composite can be represented by a lookup table only when
+     * all the embedded transformations have been collapsed into one.
+     */
+    bool fetchPerChannelLookupTable(KoPerChannelLookupTable *lut) const override;
+
+    /**
+     * @return the number of passes over the pixel data done by
+     * transform() after collapsing the lookup tables
+     */
+    int numPasses() const;
+
     /**
      * Append a transform to a composite. If \p transform is null,
      * nothing happens.
@@ -169,6 +169,13 @@ void KoCompositeOp::composite(const KoCompositeOp::ParameterInfo& params) const
               scale<quint8>(params.opacity), params.channelFlags );
 }
 
+void KoCompositeOp::compositeBatch(const KoCompositeOp::ParameterInfo *jobs, int numJobs) const
+{
+    for (int i = 0; i < numJobs; i++) {
+        composite(jobs[i]);
+    }
+}
+
 
 QString KoCompositeOp::category() const
 {
@@ -142,6 +142,17 @@ public:
     */
     virtual void composite(const ParameterInfo& params) const;
 
+    /**
+     * Composites \p numJobs jobs from the \p jobs array one after another,
+     * in order, so the jobs may overlap. It is used for rendering a set of
+     * dabs in one go.
+     *
+     * The default implementation calls composite() for every job. The
+     * ops override it to call their implementation directly and avoid
+     * the virtual dispatch per job.
+     */
+    virtual void compositeBatch(const ParameterInfo *jobs, int numJobs) const;
+
 private:
     KoCompositeOp();
     struct Private;
@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KODITHEROP_H
+#define KODITHEROP_H
+
+#include <QtGlobal>
+
+#include "kritapigment_export.h"
+
+/**
+ * Converts pixels into a color space with the same color model and
+ * profile, but with lower channel depth, e.g. 16-bit integer into 8-bit
+ * integer or floating point into 16-bit integer. The rounding error is
+ * distributed with a threshold matrix, which hides banding in smooth
+ * gradients.
+ *
+ * The threshold depends on the position of the pixel in the image only,
+ * so the result doesn't depend on the way the image is split into
+ * chunks while converting.
+ *
+ * Dither ops are created by KoColorSpace::createDitherOp()
+ */
+class KRITAPIGMENT_EXPORT KoDitherOp
+{
+public:
+    enum Type {
+        NoDither,        ///< plain rounding to the nearest value
+        DitherOrdered,   ///< 8x8 Bayer matrix
+        DitherBlueNoise  ///< 64x64 blue noise texture
+    };
+
+    /**
+     * All the threshold matrices are tiled with this period
+     */
+    static const int matrixSize = 64;
+
+public:
+    virtual ~KoDitherOp();
+
+    /**
+     * Converts \p rows rows of \p columns pixels from \p src into \p dst.
+     * \p x and \p y are the image coordinates of the first pixel, they
+     * define the phase of the threshold matrix.
+     */
+    virtual void dither(const quint8 *src, int srcRowStride,
+                        quint8 *dst, int dstRowStride,
+                        int x, int y, int columns, int rows) const = 0;
+
+    virtual Type type() const = 0;
+
+    /**
+     * The threshold of the matrix of \p type at position (\p x, \p y).
+     * The value is in range (0, 1), the coordinates wrap around.
+     */
+    static float threshold(Type type, int x, int y);
+};
+
+#endif // KODITHEROP_H
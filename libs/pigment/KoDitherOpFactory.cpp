@@ -0,0 +1,47 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KoDitherOpFactory.h"
+
+#include <KoColorModelStandardIds.h>
+#include <KoConfig.h>
+
+#include "KoDitherOpFactoryImpl.h"
+
+KoDitherOp* KoDitherOpFactory::create(const KoID &srcDepthId, const KoID &dstDepthId,
+                                      int channelsNb, KoDitherOp::Type type)
+{
+    typedef KoDitherOpFactoryImpl<quint16, quint8> U16ToU8;
+    const U16ToU8::ParamType param(channelsNb, type);
+
+    if (srcDepthId == Integer16BitsColorDepthID && dstDepthId == Integer8BitsColorDepthID) {
+        return createOptimizedClass<U16ToU8>(param);
+    } else if (srcDepthId == Float32BitsColorDepthID && dstDepthId == Integer8BitsColorDepthID) {
+        return createOptimizedClass<KoDitherOpFactoryImpl<float, quint8>>(param);
+    } else if (srcDepthId == Float32BitsColorDepthID && dstDepthId == Integer16BitsColorDepthID) {
+        return createOptimizedClass<KoDitherOpFactoryImpl<float, quint16>>(param);
+#ifdef HAVE_OPENEXR
+    } else if (srcDepthId == Float16BitsColorDepthID && dstDepthId == Integer8BitsColorDepthID) {
+        return createOptimizedClass<KoDitherOpFactoryImpl<half, quint8>>(param);
+    } else if (srcDepthId == Float16BitsColorDepthID && dstDepthId == Integer16BitsColorDepthID) {
+        return createOptimizedClass<KoDitherOpFactoryImpl<half, quint16>>(param);
+#endif
+    }
+
+    return 0;
+}
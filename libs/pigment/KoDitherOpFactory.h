@@ -0,0 +1,39 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KODITHEROPFACTORY_H
+#define KODITHEROPFACTORY_H
+
+#include "kritapigment_export.h"
+
+#include <KoID.h>
+#include <KoDitherOp.h>
+
+class KRITAPIGMENT_EXPORT KoDitherOpFactory
+{
+public:
+    /**
+     * Creates the dither op converting channels of \p srcDepthId into
+     * \p dstDepthId, optimized for the current CPU. Returns null if
+     * the conversion doesn't reduce the depth into an integer type.
+     */
+    static KoDitherOp* create(const KoID &srcDepthId, const KoID &dstDepthId,
+                              int channelsNb, KoDitherOp::Type type);
+};
+
+#endif // KODITHEROPFACTORY_H
@@ -0,0 +1,36 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KoDitherOpFactoryImpl.h"
+#include "KoDitherOpImpl.h"
+
+template<typename src_channel_type, typename dst_channel_type>
+template<Vc::Implementation _impl>
+KoDitherOp*
+KoDitherOpFactoryImpl<src_channel_type, dst_channel_type>::create(ParamType param)
+{
+    return new KoDitherOpImpl<src_channel_type, dst_channel_type, _impl>(param.first, param.second);
+}
+
+template KoDitherOp* KoDitherOpFactoryImpl<quint16, quint8>::create<Vc::CurrentImplementation::current()>(ParamType);
+template KoDitherOp* KoDitherOpFactoryImpl<float,   quint8>::create<Vc::CurrentImplementation::current()>(ParamType);
+template KoDitherOp* KoDitherOpFactoryImpl<float,   quint16>::create<Vc::CurrentImplementation::current()>(ParamType);
+#ifdef HAVE_OPENEXR
+template KoDitherOp* KoDitherOpFactoryImpl<half,    quint8>::create<Vc::CurrentImplementation::current()>(ParamType);
+template KoDitherOp* KoDitherOpFactoryImpl<half,    quint16>::create<Vc::CurrentImplementation::current()>(ParamType);
+#endif
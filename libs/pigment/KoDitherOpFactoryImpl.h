@@ -0,0 +1,43 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KODITHEROPFACTORYIMPL_H
+#define KODITHEROPFACTORYIMPL_H
+
+#include <utility>
+
+#include <KoDitherOp.h>
+#include <KoVcMultiArchBuildSupport.h>
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
+template<typename src_channel_type, typename dst_channel_type>
+class KRITAPIGMENT_EXPORT KoDitherOpFactoryImpl
+{
+public:
+    typedef std::pair<int, KoDitherOp::Type> ParamType;
+    typedef KoDitherOp* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static KoDitherOp* create(ParamType param);
+};
+
+#endif // KODITHEROPFACTORYIMPL_H
@@ -0,0 +1,124 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KODITHEROPIMPL_H
+#define KODITHEROPIMPL_H
+
+#include <QVector>
+
+#include "KoDitherOp.h"
+#include "KoColorSpaceMaths.h"
+#include "KoVcMultiArchBuildSupport.h"
+
+/**
+ * The implementation is compiled for every supported architecture. The
+ * kernel is a plain loop over the channels of a span of pixels with
+ * contiguous thresholds, so the compiler vectorizes it with the
+ * instruction set of the current architecture.
+ *
+ * The thresholds are expanded per channel in advance, so the kernel
+ * doesn't depend on the number of channels of the color space.
+ */
+template<typename src_channel_type, typename dst_channel_type, Vc::Implementation _impl>
+class KoDitherOpImpl : public KoDitherOp
+{
+public:
+    KoDitherOpImpl(int channelsNb, Type type)
+        : m_channelsNb(channelsNb),
+          m_type(type)
+    {
+        const int rowLength = matrixSize * m_channelsNb;
+        m_thresholds.resize(matrixSize * rowLength);
+
+        for (int y = 0; y < matrixSize; y++) {
+            float *row = m_thresholds.data() + y * rowLength;
+
+            for (int x = 0; x < matrixSize; x++) {
+                const float threshold = KoDitherOp::threshold(type, x, y);
+
+                for (int ch = 0; ch < m_channelsNb; ch++) {
+                    *row++ = threshold;
+                }
+            }
+        }
+    }
+
+    void dither(const quint8 *src, int srcRowStride,
+                quint8 *dst, int dstRowStride,
+                int x, int y, int columns, int rows) const override {
+
+        const int rowLength = matrixSize * m_channelsNb;
+
+        for (int row = 0; row < rows; row++) {
+            const src_channel_type *srcPtr = reinterpret_cast<const src_channel_type*>(src);
+            dst_channel_type *dstPtr = reinterpret_cast<dst_channel_type*>(dst);
+
+            const float *thresholdsRow =
+                m_thresholds.constData() + ((y + row) & (matrixSize - 1)) * rowLength;
+
+            int column = 0;
+            while (column < columns) {
+                const int phase = (x + column) & (matrixSize - 1);
+                const int numPixels = qMin(columns - column, matrixSize - phase);
+                const int offset = column * m_channelsNb;
+
+                ditherSpan(srcPtr + offset, dstPtr + offset,
+                           thresholdsRow + phase * m_channelsNb,
+                           numPixels * m_channelsNb);
+
+                column += numPixels;
+            }
+
+            src += srcRowStride;
+            dst += dstRowStride;
+        }
+    }
+
+    Type type() const override {
+        return m_type;
+    }
+
+private:
+    static inline void ditherSpan(const src_channel_type *src, dst_channel_type *dst,
+                                  const float *thresholds, int numChannels) {
+
+        const float dstUnit = KoColorSpaceMathsTraits<dst_channel_type>::unitValue;
+        const float scale = dstUnit / float(KoColorSpaceMathsTraits<src_channel_type>::unitValue);
+
+        for (int i = 0; i < numChannels; i++) {
+            float value = float(src[i]) * scale + thresholds[i];
+
+            // floating point sources may contain NaN, which would
+            // pass through qBound() and make the cast undefined
+            if (value != value) {
+                value = 0.0f;
+            }
+
+            // the value is never negative after the clamp, so the
+            // truncation works as floor()
+            dst[i] = dst_channel_type(qBound(0.0f, value, dstUnit));
+        }
+    }
+
+private:
+    int m_channelsNb;
+    Type m_type;
+    QVector<float> m_thresholds;
+};
+
+#endif // KODITHEROPIMPL_H
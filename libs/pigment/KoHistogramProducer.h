@@ -70,6 +70,30 @@ public:
      */
     virtual void addRegionToBin(const quint8 * pixels, const quint8 * selectionMask, quint32 nPixels, const KoColorSpace* colorSpace) = 0;
 
+    // Methods for computing the histogram in parts (e.g. per tile in parallel)
+
+    /**
+     * Creates an empty producer with the same view and skip settings. Its
+     * bins can be merged into this producer with addBins() later.
+     *
+     * @return null if the producer doesn't support merging, which is
+     *         the default
+     */
+    virtual KoHistogramProducer* createEmptyCopy() const {
+        return 0;
+    }
+
+    /**
+     * Adds the bins collected by \p other to the bins of this producer.
+     * If \p subtract is true, the bins are subtracted instead, which
+     * allows updating the histogram incrementally when a part of the
+     * image changes. \p other must be created with createEmptyCopy().
+     */
+    virtual void addBins(const KoHistogramProducer *other, bool subtract = false) {
+        Q_UNUSED(other);
+        Q_UNUSED(subtract);
+    }
+
     // Methods to set what exactly is being added to the bins
     virtual void setView(qreal from, qreal width) = 0;
     virtual void setSkipTransparent(bool set) {
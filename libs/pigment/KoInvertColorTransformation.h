@@ -28,6 +28,7 @@
 #include "KoColorSpaceMaths.h"
 
 #include "KoColorModelStandardIds.h"
+#include "KoPerChannelLookupTable.h"
 
 #include <KoConfig.h>
 #ifdef HAVE_OPENEXR
@@ -97,6 +98,12 @@ public:
 //        }
 //    }
 
+    template<typename T>
+    bool fetchLookupTableI(KoPerChannelLookupTable *lut) const {
+        *lut = KoPerChannelLookupTable::fromTransformation(this, sizeof(T), m_chanCount);
+        return !lut->isNull();
+    }
+
 protected:
     QList<quint8> m_channels;
 private:
@@ -115,6 +122,10 @@ public:
     void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override {
         transformI<quint8>(src,dst,nPixels);
     }
+
+    bool fetchPerChannelLookupTable(KoPerChannelLookupTable *lut) const override {
+        return fetchLookupTableI<quint8>(lut);
+    }
 };
 
 class KoU16InvertColorTransformer : public KoInvertColorTransformationT {
@@ -127,6 +138,10 @@ public:
     void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override {
         transformI<quint16>(src,dst,nPixels);
     }
+
+    bool fetchPerChannelLookupTable(KoPerChannelLookupTable *lut) const override {
+        return fetchLookupTableI<quint16>(lut);
+    }
 };
 
 #ifdef HAVE_OPENEXR
@@ -0,0 +1,177 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KoPerChannelLookupTable.h"
+
+#include "KoColorTransformation.h"
+
+#include <kis_assert.h>
+
+
+KoPerChannelLookupTable::KoPerChannelLookupTable()
+    : m_channelSize(0),
+      m_channelCount(0)
+{
+}
+
+KoPerChannelLookupTable::KoPerChannelLookupTable(int channelSize, int channelCount)
+    : m_channelSize(channelSize),
+      m_channelCount(channelCount)
+{
+    KIS_SAFE_ASSERT_RECOVER(channelSize == 1 || channelSize == 2) {
+        m_channelSize = 0;
+        m_channelCount = 0;
+        return;
+    }
+
+    const int size = tableSize();
+    m_table.resize(size * m_channelCount);
+
+    for (int ch = 0; ch < m_channelCount; ch++) {
+        quint16 *table = channelTable(ch);
+        for (int i = 0; i < size; i++) {
+            table[i] = quint16(i);
+        }
+    }
+}
+
+KoPerChannelLookupTable KoPerChannelLookupTable::fromTransformation(const KoColorTransformation *transform, int channelSize, int channelCount)
+{
+    KoPerChannelLookupTable lut(channelSize, channelCount);
+    if (lut.isNull()) return lut;
+
+    const int size = lut.tableSize();
+    const int pixelSize = channelSize * channelCount;
+
+    /**
+     * Every sample pixel has all its channels set to the same value,
+     * so a single transformation call covers all the tables at once
+     */
+    QVector<quint8> src(size * pixelSize);
+
+    for (int i = 0; i < size; i++) {
+        quint8 *pixel = src.data() + i * pixelSize;
+        for (int ch = 0; ch < channelCount; ch++) {
+            if (channelSize == 1) {
+                pixel[ch] = quint8(i);
+            } else {
+                reinterpret_cast<quint16*>(pixel)[ch] = quint16(i);
+            }
+        }
+    }
+
+    /**
+     * Some transformations (e.g. inversion) don't touch the channels
+     * they are not interested in, so prefill the destination as if
+     * the transformation was done in place
+     */
+    QVector<quint8> dst = src;
+    transform->transform(src.constData(), dst.data(), size);
+
+    for (int i = 0; i < size; i++) {
+        const quint8 *pixel = dst.constData() + i * pixelSize;
+        for (int ch = 0; ch < channelCount; ch++) {
+            lut.channelTable(ch)[i] =
+                channelSize == 1 ?
+                    pixel[ch] :
+                    reinterpret_cast<const quint16*>(pixel)[ch];
+        }
+    }
+
+    return lut;
+}
+
+bool KoPerChannelLookupTable::isNull() const
+{
+    return m_table.isEmpty();
+}
+
+int KoPerChannelLookupTable::channelSize() const
+{
+    return m_channelSize;
+}
+
+int KoPerChannelLookupTable::channelCount() const
+{
+    return m_channelCount;
+}
+
+int KoPerChannelLookupTable::tableSize() const
+{
+    return m_channelSize ? 1 << (8 * m_channelSize) : 0;
+}
+
+quint16 *KoPerChannelLookupTable::channelTable(int channel)
+{
+    return m_table.data() + channel * tableSize();
+}
+
+const quint16 *KoPerChannelLookupTable::channelTable(int channel) const
+{
+    return m_table.constData() + channel * tableSize();
+}
+
+bool KoPerChannelLookupTable::isCompatible(const KoPerChannelLookupTable &rhs) const
+{
+    return !isNull() &&
+        m_channelSize == rhs.m_channelSize &&
+        m_channelCount == rhs.m_channelCount;
+}
+
+void KoPerChannelLookupTable::chain(const KoPerChannelLookupTable &next)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(isCompatible(next));
+
+    const int size = tableSize();
+
+    for (int ch = 0; ch < m_channelCount; ch++) {
+        quint16 *table = channelTable(ch);
+        const quint16 *nextTable = next.channelTable(ch);
+
+        for (int i = 0; i < size; i++) {
+            table[i] = nextTable[table[i]];
+        }
+    }
+}
+
+template <typename channel_type>
+void KoPerChannelLookupTable::applyImpl(const quint8 *src, quint8 *dst, qint32 nPixels) const
+{
+    const channel_type *s = reinterpret_cast<const channel_type*>(src);
+    channel_type *d = reinterpret_cast<channel_type*>(dst);
+
+    const int size = tableSize();
+    const quint16 *table = m_table.constData();
+
+    for (qint32 i = 0; i < nPixels; i++) {
+        for (int ch = 0; ch < m_channelCount; ch++) {
+            d[ch] = channel_type(table[ch * size + s[ch]]);
+        }
+        s += m_channelCount;
+        d += m_channelCount;
+    }
+}
+
+void KoPerChannelLookupTable::apply(const quint8 *src, quint8 *dst, qint32 nPixels) const
+{
+    if (m_channelSize == 1) {
+        applyImpl<quint8>(src, dst, nPixels);
+    } else if (m_channelSize == 2) {
+        applyImpl<quint16>(src, dst, nPixels);
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KO_PER_CHANNEL_LOOKUP_TABLE_H
+#define __KO_PER_CHANNEL_LOOKUP_TABLE_H
+
+#include <QtGlobal>
+#include <QVector>
+
+#include "kritapigment_export.h"
+
+class KoColorTransformation;
+
+/**
+ * A set of lookup tables describing a transformation, where every
+ * output channel depends on the value of the same input channel only
+ * (levels, curves, inversion and so on).
+ *
+ * Only integer color spaces with 8- and 16-bit channels are supported,
+ * so every channel has a table with 256 or 65536 entries. The tables are
+ * stored in the order of the channels in the pixel, not in the display
+ * order.
+ *
+ * The main user of the class is KoCompositeColorTransformation, which
+ * collapses chains of per-channel transformations into a single table
+ * with chain().
+ */
+class KRITAPIGMENT_EXPORT KoPerChannelLookupTable
+{
+public:
+    KoPerChannelLookupTable();
+
+    /**
+     * Creates an identity table for pixels of \p channelCount channels,
+     * each of \p channelSize bytes. \p channelSize should be either 1 or 2.
+     */
+    KoPerChannelLookupTable(int channelSize, int channelCount);
+
+    /**
+     * Creates a table by sampling \p transform over the whole range of the
+     * channel values. The caller is responsible for checking that \p transform
+     * is really a per-channel one, otherwise the result is undefined.
+     */
+    static KoPerChannelLookupTable fromTransformation(const KoColorTransformation *transform,
+                                                      int channelSize, int channelCount);
+
+    bool isNull() const;
+
+    int channelSize() const;
+    int channelCount() const;
+
+    /// @return the number of entries in the table of each channel
+    int tableSize() const;
+
+    quint16* channelTable(int channel);
+    const quint16* channelTable(int channel) const;
+
+    /**
+     * @return true if \p rhs describes pixels of the same layout, so
+     * the two tables can be chained
+     */
+    bool isCompatible(const KoPerChannelLookupTable &rhs) const;
+
+    /**
+     * Modifies the table so that it is equivalent to applying the
+     * current table first and \p next after it.
+     */
+    void chain(const KoPerChannelLookupTable &next);
+
+    void apply(const quint8 *src, quint8 *dst, qint32 nPixels) const;
+
+private:
+    template <typename channel_type>
+    void applyImpl(const quint8 *src, quint8 *dst, qint32 nPixels) const;
+
+private:
+    int m_channelSize;
+    int m_channelCount;
+    QVector<quint16> m_table;
+};
+
+#endif /* __KO_PER_CHANNEL_LOOKUP_TABLE_H */
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KoDitherOpBenchmark.h"
+
+#include <QTest>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
+#include <KoDitherOp.h>
+
+#define NB_COLUMNS 4096
+#define NB_ROWS 256
+
+void KoDitherOpBenchmark::createRowsColumns()
+{
+    QTest::addColumn<QString>("srcDepthID");
+    QTest::addColumn<QString>("dstDepthID");
+    QTest::addColumn<int>("ditherType");
+
+    QList<QPair<KoID, KoID>> conversions;
+    conversions << qMakePair(Integer16BitsColorDepthID, Integer8BitsColorDepthID)
+                << qMakePair(Float32BitsColorDepthID, Integer8BitsColorDepthID)
+                << qMakePair(Float32BitsColorDepthID, Integer16BitsColorDepthID);
+
+    QList<QPair<QString, KoDitherOp::Type>> types;
+    types << qMakePair(QString("none"), KoDitherOp::NoDither)
+          << qMakePair(QString("ordered"), KoDitherOp::DitherOrdered)
+          << qMakePair(QString("blue-noise"), KoDitherOp::DitherBlueNoise);
+
+    for (auto it = conversions.begin(); it != conversions.end(); ++it) {
+        for (auto typeIt = types.begin(); typeIt != types.end(); ++typeIt) {
+            const QString name = QString("%1 -> %2, %3").arg(it->first.id()).arg(it->second.id()).arg(typeIt->first);
+            QTest::newRow(name.toLatin1().data()) << it->first.id() << it->second.id() << int(typeIt->second);
+        }
+    }
+}
+
+#define START_BENCHMARK \
+    QFETCH(QString, srcDepthID); \
+    QFETCH(QString, dstDepthID); \
+    QFETCH(int, ditherType); \
+    \
+    const KoColorSpace* srcColorSpace = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), srcDepthID, 0); \
+    const KoColorSpace* dstColorSpace = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), dstDepthID, srcColorSpace->profile()); \
+    QVERIFY(dstColorSpace); \
+    const int srcRowStride = NB_COLUMNS * srcColorSpace->pixelSize(); \
+    const int dstRowStride = NB_COLUMNS * dstColorSpace->pixelSize(); \
+    QVector<quint8> srcData(NB_ROWS * srcRowStride); \
+    QVector<quint8> dstData(NB_ROWS * dstRowStride); \
+    if (srcDepthID == Float32BitsColorDepthID.id()) { \
+        float *srcFloat = reinterpret_cast<float*>(srcData.data()); \
+        for (int i = 0; i < srcData.size() / 4; i++) { \
+            srcFloat[i] = (i % 1000) / 999.0f; \
+        } \
+    } else { \
+        for (int i = 0; i < srcData.size(); i++) { \
+            srcData[i] = quint8(i * 13); \
+        } \
+    }
+
+void KoDitherOpBenchmark::benchmarkConvertPixels_data()
+{
+    createRowsColumns();
+}
+
+void KoDitherOpBenchmark::benchmarkConvertPixels()
+{
+    START_BENCHMARK
+    Q_UNUSED(ditherType);
+
+    QBENCHMARK {
+        srcColorSpace->convertPixelsTo(srcData.constData(), dstData.data(), dstColorSpace,
+                                       NB_COLUMNS * NB_ROWS,
+                                       KoColorConversionTransformation::internalRenderingIntent(),
+                                       KoColorConversionTransformation::internalConversionFlags());
+    }
+}
+
+void KoDitherOpBenchmark::benchmarkDither_data()
+{
+    createRowsColumns();
+}
+
+void KoDitherOpBenchmark::benchmarkDither()
+{
+    START_BENCHMARK
+
+    QScopedPointer<KoDitherOp> op(srcColorSpace->createDitherOp(dstColorSpace, KoDitherOp::Type(ditherType)));
+    QVERIFY(op);
+
+    QBENCHMARK {
+        op->dither(srcData.constData(), srcRowStride, dstData.data(), dstRowStride,
+                   0, 0, NB_COLUMNS, NB_ROWS);
+    }
+}
+
+QTEST_MAIN(KoDitherOpBenchmark)
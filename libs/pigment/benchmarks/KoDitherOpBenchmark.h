@@ -1,5 +1,5 @@
 /*
- *  Copyright (c) 2018 Dmitry Kazakov <dimula73@gmail.com>
+ *  Copyright (c) 2020 Krita Developers
  *
  *  This program is free software; you can redistribute it and/or modify
  *  it under the terms of the GNU General Public License as published by
@@ -15,31 +15,22 @@
  *  along with this program; if not, write to the Free Software
  *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
-#ifndef KISCLONEDOCUMENTSTROKE_H
-#define KISCLONEDOCUMENTSTROKE_H
 
-#include "kritaimage_export.h"
-#include <QScopedPointer>
-#include "kis_simple_stroke_strategy.h"
+#ifndef _KO_DITHER_OP_BENCHMARK_H_
+#define _KO_DITHER_OP_BENCHMARK_H_
 
-class KisDocument;
+#include <QObject>
 
-class KisCloneDocumentStroke : public QObject, public KisSimpleStrokeStrategy
+class KoDitherOpBenchmark : public QObject
 {
     Q_OBJECT
-public:
-    KisCloneDocumentStroke(KisDocument *document);
-    ~KisCloneDocumentStroke();
-
-    void initStrokeCallback() override;
-    void finishStrokeCallback() override;
-
-Q_SIGNALS:
-    void sigDocumentCloned(KisDocument *image);
-
 private:
-    struct Private;
-    const QScopedPointer<Private> m_d;
+    void createRowsColumns();
+private Q_SLOTS:
+    void benchmarkConvertPixels_data();
+    void benchmarkConvertPixels();
+    void benchmarkDither_data();
+    void benchmarkDither();
 };
 
-#endif // KISCLONEDOCUMENTSTROKE_H
+#endif
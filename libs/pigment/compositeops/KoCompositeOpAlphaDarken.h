@@ -50,6 +50,13 @@ public:
             genericComposite<false>(params);
     }
 
+    void compositeBatch(const KoCompositeOp::ParameterInfo *jobs, int numJobs) const override
+    {
+        for (int i = 0; i < numJobs; i++) {
+            KoCompositeOpAlphaDarken::composite(jobs[i]);
+        }
+    }
+
     template<bool useMask>
     void genericComposite(const KoCompositeOp::ParameterInfo& params) const
     {
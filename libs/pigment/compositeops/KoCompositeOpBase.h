@@ -84,6 +84,13 @@ public:
         }
     }
 
+    void compositeBatch(const KoCompositeOp::ParameterInfo *jobs, int numJobs) const override
+    {
+        for (int i = 0; i < numJobs; i++) {
+            KoCompositeOpBase::composite(jobs[i]);
+        }
+    }
+
 private:
     template<bool useMask, bool alphaLocked, bool allChannelFlags>
     void genericComposite(const KoCompositeOp::ParameterInfo& params, const QBitArray& channelFlags) const {
@@ -114,6 +114,21 @@ struct OptimizedOpsSelector<KoRgbF32Traits>
     }
 };
 
+#ifdef HAVE_OPENEXR
+template<>
+struct OptimizedOpsSelector<KoRgbF16Traits>
+{
+    static KoCompositeOp* createAlphaDarkenOp(const KoColorSpace *cs) {
+        return useCreamyAlphaDarken() ?
+            KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamy64(cs) :
+            KoOptimizedCompositeOpFactory::createAlphaDarkenOpHard64(cs);
+    }
+    static KoCompositeOp* createOverOp(const KoColorSpace *cs) {
+        return KoOptimizedCompositeOpFactory::createOverOp64(cs);
+    }
+};
+#endif
+
 template<class Traits>
 struct AddGeneralOps<Traits, true>
 {
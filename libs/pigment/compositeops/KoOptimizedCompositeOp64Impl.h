@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2020 Krita Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOP64IMPL_H_
+#define KOOPTIMIZEDCOMPOSITEOP64IMPL_H_
+
+#include <KoConfig.h>
+#include "KoCompositeOp.h"
+#include "KoStreamedMath.h"
+
+#ifdef HAVE_OPENEXR
+
+/**
+ * A base for the optimized composite ops for the use in 8 byte
+ * half-float colorspaces with alpha channel placed at the last
+ * channel of the pixel: C1_C2_C3_A.
+ *
+ * The pixels are unpacked into 32-bit floats in short strips,
+ * blended by the vectorized 16 byte op \p FloatOp and packed
+ * back into half-floats. Therefore F16 documents keep their memory
+ * footprint, but don't pay for the scalar half arithmetic.
+ */
+template<Vc::Implementation _impl, class FloatOp>
+class KoOptimizedCompositeOp64Impl : public KoCompositeOp
+{
+    static const int channelsPerPixel = 4;
+
+    /**
+     * The strip should be small enough for the unpacked source
+     * and destination to stay in L1 cache. The buffers are
+     * allocated on the stack, so they should stay small anyway.
+     */
+    static const int stripSize = 256;
+
+public:
+    KoOptimizedCompositeOp64Impl(const KoColorSpace* cs, const QString& id, const QString& description, const QString& category)
+        : KoCompositeOp(cs, id, description, category),
+          m_floatOp(cs) {}
+
+    using KoCompositeOp::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        typedef KoStreamedMath<_impl> Math;
+
+        // aligned for the widest vector type
+        alignas(64) float srcBuffer[stripSize * channelsPerPixel];
+        alignas(64) float dstBuffer[stripSize * channelsPerPixel];
+
+        KoCompositeOp::ParameterInfo floatParams(params);
+        floatParams.rows = 1;
+        floatParams.dstRowStart = reinterpret_cast<quint8*>(dstBuffer);
+        floatParams.srcRowStart = reinterpret_cast<quint8*>(srcBuffer);
+
+        if (!params.srcRowStride) {
+            Math::convert_f16_to_f32(reinterpret_cast<const half*>(params.srcRowStart),
+                                     srcBuffer, channelsPerPixel);
+        }
+
+        quint8 *dstRowStart = params.dstRowStart;
+        const quint8 *srcRowStart = params.srcRowStart;
+        const quint8 *maskRowStart = params.maskRowStart;
+
+        for (qint32 r = params.rows; r > 0; --r) {
+            for (qint32 col = 0; col < params.cols; col += stripSize) {
+                const int numPixels = qMin(stripSize, params.cols - col);
+                const int numValues = numPixels * channelsPerPixel;
+
+                half *dst = reinterpret_cast<half*>(dstRowStart) + col * channelsPerPixel;
+                Math::convert_f16_to_f32(dst, dstBuffer, numValues);
+                floatParams.dstRowStride = numValues * sizeof(float);
+
+                if (params.srcRowStride) {
+                    const half *src = reinterpret_cast<const half*>(srcRowStart) + col * channelsPerPixel;
+                    Math::convert_f16_to_f32(src, srcBuffer, numValues);
+                    floatParams.srcRowStride = numValues * sizeof(float);
+                }
+
+                floatParams.maskRowStart = maskRowStart ? maskRowStart + col : 0;
+                floatParams.cols = numPixels;
+
+                m_floatOp.composite(floatParams);
+
+                Math::convert_f32_to_f16(dstBuffer, dst, numValues);
+            }
+
+            dstRowStart += params.dstRowStride;
+            srcRowStart += params.srcRowStride;
+
+            if (maskRowStart) {
+                maskRowStart += params.maskRowStride;
+            }
+        }
+    }
+
+private:
+    FloatOp m_floatOp;
+};
+
+#endif /* HAVE_OPENEXR */
+
+#endif // KOOPTIMIZEDCOMPOSITEOP64IMPL_H_
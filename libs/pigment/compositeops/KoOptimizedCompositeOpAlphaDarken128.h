@@ -214,6 +214,13 @@ public:
             KoStreamedMath<_impl>::template genericComposite128<false, true, AlphaDarkenCompositor128<float, quint32, ParamsWrapper> >(params);
         }
     }
+
+    void compositeBatch(const KoCompositeOp::ParameterInfo *jobs, int numJobs) const override
+    {
+        for (int i = 0; i < numJobs; i++) {
+            KoOptimizedCompositeOpAlphaDarken128Impl::composite(jobs[i]);
+        }
+    }
 };
 
 template<Vc::Implementation _impl>
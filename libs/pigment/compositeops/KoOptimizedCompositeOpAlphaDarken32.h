@@ -254,6 +254,13 @@ public:
             KoStreamedMath<_impl>::template genericComposite32<false, true, AlphaDarkenCompositor32<quint8, quint32, ParamsWrapper> >(params);
         }
     }
+
+    void compositeBatch(const KoCompositeOp::ParameterInfo *jobs, int numJobs) const override
+    {
+        for (int i = 0; i < numJobs; i++) {
+            KoOptimizedCompositeOpAlphaDarken32Impl::composite(jobs[i]);
+        }
+    }
 };
 
 template<Vc::Implementation _impl>
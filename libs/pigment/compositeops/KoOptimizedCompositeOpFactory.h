@@ -22,6 +22,8 @@
 
 #include "kritapigment_export.h"
 
+#include <KoConfig.h>
+
 class KoCompositeOp;
 class KoColorSpace;
 
@@ -46,6 +48,12 @@ public:
     static KoCompositeOp* createAlphaDarkenOpHard128(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpCreamy128(const KoColorSpace *cs);
     static KoCompositeOp* createOverOp128(const KoColorSpace *cs);
+
+#ifdef HAVE_OPENEXR
+    static KoCompositeOp* createAlphaDarkenOpHard64(const KoColorSpace *cs);
+    static KoCompositeOp* createAlphaDarkenOpCreamy64(const KoColorSpace *cs);
+    static KoCompositeOp* createOverOp64(const KoColorSpace *cs);
+#endif
 };
 
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORY_H */
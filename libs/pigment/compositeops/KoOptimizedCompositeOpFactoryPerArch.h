@@ -46,6 +46,15 @@ class KoOptimizedCompositeOpAlphaDarkenCreamy128;
 template<Vc::Implementation _impl>
 class KoOptimizedCompositeOpOver128;
 
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpAlphaDarkenHard64;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpAlphaDarkenCreamy64;
+
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOver64;
+
 template<template<Vc::Implementation I> class CompositeOp>
 struct KoOptimizedCompositeOpFactoryPerArch
 {
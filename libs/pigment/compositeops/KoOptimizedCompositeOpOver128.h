@@ -261,6 +261,13 @@ public:
         }
     }
 
+    void compositeBatch(const KoCompositeOp::ParameterInfo *jobs, int numJobs) const override
+    {
+        for (int i = 0; i < numJobs; i++) {
+            KoOptimizedCompositeOpOver128::composite(jobs[i]);
+        }
+    }
+
     template <bool haveMask>
     inline void composite(const KoCompositeOp::ParameterInfo& params) const {
         if (params.channelFlags.isEmpty() ||
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2020 Krita Developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with this library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPOVER64_H_
+#define KOOPTIMIZEDCOMPOSITEOPOVER64_H_
+
+#include "KoOptimizedCompositeOpOver128.h"
+#include "KoOptimizedCompositeOp64Impl.h"
+
+#ifdef HAVE_OPENEXR
+
+/**
+ * An optimized version of the Over composite op for the use in 8 byte
+ * half-float colorspaces with alpha channel placed at the last
+ * channel of the pixel: C1_C2_C3_A.
+ *
+ * \see KoOptimizedCompositeOp64Impl
+ */
+template<Vc::Implementation _impl>
+class KoOptimizedCompositeOpOver64
+    : public KoOptimizedCompositeOp64Impl<_impl, KoOptimizedCompositeOpOver128<_impl>>
+{
+public:
+    KoOptimizedCompositeOpOver64(const KoColorSpace* cs)
+        : KoOptimizedCompositeOp64Impl<_impl, KoOptimizedCompositeOpOver128<_impl>>(
+              cs, COMPOSITE_OVER, i18n("Normal"), KoCompositeOp::categoryMix()) {}
+};
+
+#endif /* HAVE_OPENEXR */
+
+#endif // KOOPTIMIZEDCOMPOSITEOPOVER64_H_
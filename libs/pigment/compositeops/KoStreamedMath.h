@@ -37,12 +37,66 @@
 #include <iostream>
 #include <KoCompositeOp.h>
 
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KO_STREAMED_MATH_HAVE_F16C_TARGET 1
+#include <immintrin.h>
+#endif
+#endif
+
 #define BLOCKDEBUG 0
 
 #if !defined _MSC_VER
 #pragma GCC diagnostic ignored "-Wcast-align"
 #endif
 
+#ifdef KO_STREAMED_MATH_HAVE_F16C_TARGET
+
+/**
+ * Conversion of half-float values using F16C instructions. The functions
+ * are compiled with a per-function target, so they can be used from the
+ * translation units built for the architectures that don't define F16C
+ * officially. The caller is responsible for checking that the CPU
+ * supports the instructions (all AVX2-capable CPUs do).
+ */
+namespace KoStreamedMathF16C {
+
+__attribute__((target("avx,f16c")))
+inline void convertF16ToF32(const half *src, float *dst, int numValues)
+{
+    int i = 0;
+    for (; i + 8 <= numValues; i += 8) {
+        const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+
+    for (; i < numValues; i++) {
+        dst[i] = src[i];
+    }
+}
+
+__attribute__((target("avx,f16c")))
+inline void convertF32ToF16(const float *src, half *dst, int numValues)
+{
+    int i = 0;
+    for (; i + 8 <= numValues; i += 8) {
+        const __m256 f = _mm256_loadu_ps(src + i);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    for (; i < numValues; i++) {
+        dst[i] = half(src[i]);
+    }
+}
+
+}
+
+#endif /* KO_STREAMED_MATH_HAVE_F16C_TARGET */
+
 template<Vc::Implementation _impl>
 struct KoStreamedMath {
 
@@ -103,6 +157,45 @@ template<bool useMask, bool useFlow, class Compositor>
     genericComposite_novector<useMask, useFlow, Compositor, 16>(params);
 }
 
+#ifdef HAVE_OPENEXR
+
+/**
+ * Convert \p numValues half-float channel values into 32-bit floats.
+ * AVX2 implementation uses F16C instructions, others fall back to
+ * the lookup table of OpenEXR.
+ */
+static inline void convert_f16_to_f32(const half *src, float *dst, int numValues) {
+#ifdef KO_STREAMED_MATH_HAVE_F16C_TARGET
+    if (_impl == Vc::AVX2Impl) {
+        KoStreamedMathF16C::convertF16ToF32(src, dst, numValues);
+        return;
+    }
+#endif
+
+    for (int i = 0; i < numValues; i++) {
+        dst[i] = src[i];
+    }
+}
+
+/**
+ * Convert \p numValues 32-bit floats into half-float channel values
+ * with rounding to the nearest value.
+ */
+static inline void convert_f32_to_f16(const float *src, half *dst, int numValues) {
+#ifdef KO_STREAMED_MATH_HAVE_F16C_TARGET
+    if (_impl == Vc::AVX2Impl) {
+        KoStreamedMathF16C::convertF32ToF16(src, dst, numValues);
+        return;
+    }
+#endif
+
+    for (int i = 0; i < numValues; i++) {
+        dst[i] = half(src[i]);
+    }
+}
+
+#endif /* HAVE_OPENEXR */
+
 static inline quint8 round_float_to_uint(float value) {
     return quint8(value + float(0.5));
 }
@@ -0,0 +1,146 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "TestKoCompositeColorTransformation.h"
+
+#include <QTest>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorTransformation.h>
+#include <KoCompositeColorTransformation.h>
+#include <KoPerChannelLookupTable.h>
+
+
+namespace {
+
+/**
+ * A non-per-channel transformation: swaps the first two channels
+ */
+struct SwapChannelsTransformation : public KoColorTransformation
+{
+    void transform(const quint8 *src, quint8 *dst, qint32 nPixels) const override {
+        for (qint32 i = 0; i < nPixels; i++) {
+            const quint8 c0 = src[0];
+            const quint8 c1 = src[1];
+            dst[0] = c1;
+            dst[1] = c0;
+            dst[2] = src[2];
+            dst[3] = src[3];
+            src += 4;
+            dst += 4;
+        }
+    }
+};
+
+QVector<quint8> generatePixels8(int numPixels)
+{
+    QVector<quint8> pixels(numPixels * 4);
+    for (int i = 0; i < pixels.size(); i++) {
+        pixels[i] = quint8((i * 37 + 11) & 0xff);
+    }
+    return pixels;
+}
+
+}
+
+void TestKoCompositeColorTransformation::testCollapseLookupTables()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KoCompositeColorTransformation composite(KoCompositeColorTransformation::INPLACE);
+    composite.appendTransform(cs->createInvertTransformation());
+    composite.appendTransform(cs->createInvertTransformation());
+    composite.appendTransform(cs->createInvertTransformation());
+
+    QCOMPARE(composite.numPasses(), 1);
+
+    KoPerChannelLookupTable lut;
+    QVERIFY(composite.fetchPerChannelLookupTable(&lut));
+    QCOMPARE(lut.channelSize(), 1);
+    QCOMPARE(lut.channelCount(), 4);
+
+    const int numPixels = 1000;
+    QVector<quint8> src = generatePixels8(numPixels);
+    QVector<quint8> dst(src.size());
+    QVector<quint8> ref = src;
+
+    QScopedPointer<KoColorTransformation> invert(cs->createInvertTransformation());
+    invert->transform(ref.constData(), ref.data(), numPixels);
+
+    composite.transform(src.constData(), dst.data(), numPixels);
+
+    QCOMPARE(dst, ref);
+}
+
+void TestKoCompositeColorTransformation::testMixedStages()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KoCompositeColorTransformation composite(KoCompositeColorTransformation::INPLACE);
+    composite.appendTransform(cs->createInvertTransformation());
+    composite.appendTransform(cs->createInvertTransformation());
+    composite.appendTransform(new SwapChannelsTransformation());
+    composite.appendTransform(cs->createInvertTransformation());
+
+    QCOMPARE(composite.numPasses(), 3);
+
+    KoPerChannelLookupTable lut;
+    QVERIFY(!composite.fetchPerChannelLookupTable(&lut));
+
+    const int numPixels = 1000;
+    QVector<quint8> src = generatePixels8(numPixels);
+    QVector<quint8> dst(src.size());
+    QVector<quint8> ref = src;
+
+    QScopedPointer<KoColorTransformation> invert(cs->createInvertTransformation());
+    SwapChannelsTransformation swap;
+    swap.transform(ref.constData(), ref.data(), numPixels);
+    invert->transform(ref.constData(), ref.data(), numPixels);
+
+    composite.transform(src.constData(), dst.data(), numPixels);
+
+    QCOMPARE(dst, ref);
+}
+
+void TestKoCompositeColorTransformation::testLookupTable16()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+
+    QScopedPointer<KoColorTransformation> invert(cs->createInvertTransformation());
+
+    KoPerChannelLookupTable lut;
+    QVERIFY(invert->fetchPerChannelLookupTable(&lut));
+    QCOMPARE(lut.channelSize(), 2);
+    QCOMPARE(lut.tableSize(), 65536);
+
+    const quint16 pixel[4] = {0, 1000, 65535, 32768};
+    quint16 result[4];
+    quint16 reference[4];
+
+    lut.apply(reinterpret_cast<const quint8*>(pixel), reinterpret_cast<quint8*>(result), 1);
+
+    memcpy(reference, pixel, sizeof(pixel));
+    invert->transform(reinterpret_cast<const quint8*>(pixel), reinterpret_cast<quint8*>(reference), 1);
+
+    for (int i = 0; i < 4; i++) {
+        QCOMPARE(result[i], reference[i]);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestKoCompositeColorTransformation)
@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "TestKoDitherOp.h"
+
+#include <QTest>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+#include <KoDitherOp.h>
+#include <KoDitherOpFactory.h>
+
+#include <limits>
+
+
+namespace {
+
+const KoColorSpace* rgb16()
+{
+    return KoColorSpaceRegistry::instance()->rgb16();
+}
+
+const KoColorSpace* rgb8WithProfileOf(const KoColorSpace *cs)
+{
+    return KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(),
+                                                       Integer8BitsColorDepthID.id(),
+                                                       cs->profile());
+}
+
+QVector<quint16> generatePixels16(int numPixels)
+{
+    QVector<quint16> pixels(numPixels * 4);
+    for (int i = 0; i < pixels.size(); i++) {
+        pixels[i] = quint16(i * 977 + 13);
+    }
+    return pixels;
+}
+
+}
+
+void TestKoDitherOp::testNoDitherRounds()
+{
+    const KoColorSpace *srcCs = rgb16();
+    const KoColorSpace *dstCs = rgb8WithProfileOf(srcCs);
+    QVERIFY(dstCs);
+
+    QScopedPointer<KoDitherOp> op(srcCs->createDitherOp(dstCs, KoDitherOp::NoDither));
+    QVERIFY(op);
+
+    const int numPixels = 1000;
+    QVector<quint16> src = generatePixels16(numPixels);
+    QVector<quint8> dst(numPixels * 4);
+
+    op->dither(reinterpret_cast<const quint8*>(src.constData()), 0,
+               dst.data(), 0, 0, 0, numPixels, 1);
+
+    for (int i = 0; i < src.size(); i++) {
+        QCOMPARE(dst[i], quint8(qRound(src[i] / 257.0)));
+    }
+}
+
+void TestKoDitherOp::testDitherPreservesMean()
+{
+    const KoColorSpace *srcCs = rgb16();
+    const KoColorSpace *dstCs = rgb8WithProfileOf(srcCs);
+
+    const int size = KoDitherOp::matrixSize;
+
+    // a value exactly between two 8-bit levels
+    const quint16 value = 100 * 257 + 128;
+    QVector<quint16> src(size * size * 4, value);
+    QVector<quint8> dst(size * size * 4);
+
+    QList<KoDitherOp::Type> types;
+    types << KoDitherOp::DitherOrdered << KoDitherOp::DitherBlueNoise;
+
+    Q_FOREACH (KoDitherOp::Type type, types) {
+        QScopedPointer<KoDitherOp> op(srcCs->createDitherOp(dstCs, type));
+        QVERIFY(op);
+        QCOMPARE(op->type(), type);
+
+        op->dither(reinterpret_cast<const quint8*>(src.constData()), size * 8,
+                   dst.data(), size * 4, 0, 0, size, size);
+
+        qreal sum = 0;
+        for (int i = 0; i < dst.size(); i++) {
+            QVERIFY(dst[i] == 100 || dst[i] == 101);
+            sum += dst[i];
+        }
+
+        QVERIFY(qAbs(sum / dst.size() - value / 257.0) < 0.01);
+    }
+}
+
+void TestKoDitherOp::testPositionIndependence()
+{
+    const KoColorSpace *srcCs = rgb16();
+    const KoColorSpace *dstCs = rgb8WithProfileOf(srcCs);
+
+    QScopedPointer<KoDitherOp> op(srcCs->createDitherOp(dstCs, KoDitherOp::DitherBlueNoise));
+    QVERIFY(op);
+
+    const int width = 150;
+    const int height = 3;
+    QVector<quint16> src = generatePixels16(width * height);
+    QVector<quint8> whole(width * height * 4);
+    QVector<quint8> chunked(width * height * 4);
+
+    const quint8 *srcPtr = reinterpret_cast<const quint8*>(src.constData());
+
+    op->dither(srcPtr, width * 8, whole.data(), width * 4, -37, 11, width, height);
+
+    // the same area converted in chunks of arbitrary size
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x += 23) {
+            const int offset = y * width + x;
+            op->dither(srcPtr + offset * 8, 0, chunked.data() + offset * 4, 0,
+                       -37 + x, 11 + y, qMin(23, width - x), 1);
+        }
+    }
+
+    QCOMPARE(chunked, whole);
+}
+
+void TestKoDitherOp::testUnsupportedConversion()
+{
+    const KoColorSpace *rgb8 = KoColorSpaceRegistry::instance()->rgb8();
+
+    // depth increase is not a dithering conversion
+    QVERIFY(!rgb8->createDitherOp(rgb16(), KoDitherOp::DitherOrdered));
+
+    // different color model
+    QVERIFY(!rgb16()->createDitherOp(KoColorSpaceRegistry::instance()->lab16(), KoDitherOp::DitherOrdered));
+}
+
+void TestKoDitherOp::testNaNIsSanitized()
+{
+    QScopedPointer<KoDitherOp> op(
+        KoDitherOpFactory::create(Float32BitsColorDepthID, Integer16BitsColorDepthID,
+                                  4, KoDitherOp::DitherBlueNoise));
+    QVERIFY(op);
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float src[8] = {nan, 0.5f, -nan, 1.0f,
+                          2.0f, -1.0f, nan, nan};
+    quint16 dst[8];
+
+    op->dither(reinterpret_cast<const quint8*>(src), 0,
+               reinterpret_cast<quint8*>(dst), 0, 0, 0, 2, 1);
+
+    QCOMPARE(dst[0], quint16(0));
+    QCOMPARE(dst[2], quint16(0));
+    QCOMPARE(dst[3], quint16(0xffff));
+    QCOMPARE(dst[4], quint16(0xffff));
+    QCOMPARE(dst[5], quint16(0));
+    QCOMPARE(dst[6], quint16(0));
+    QCOMPARE(dst[7], quint16(0));
+}
+
+QTEST_GUILESS_MAIN(TestKoDitherOp)
@@ -24,14 +24,13 @@
 #include <QtEndian>
 
 // from gimp's psd-save.c
-static quint32 pack_pb_line (const QByteArray &src,
-                             QByteArray &dst)
+static quint32 pack_pb_line (const char *start,
+                             quint32 length,
+                             char *dst)
 {
-    quint32 length = src.size();
     quint32 remaining = length;
     quint8  i, j;
     quint32 dest_ptr = 0;
-    const char *start = src.constData();
 
     length = 0;
     while (remaining > 0)
@@ -89,7 +88,7 @@ static quint32 pack_pb_line (const QByteArray &src,
 
 
 // from gimp's psd-util.c
-quint32 decode_packbits(const char *src, char* dst, quint16 packed_len, quint32 unpacked_len)
+static quint32 decode_packbits(const char *src, char* dst, quint32 packed_len, quint32 unpacked_len)
 {
     /*
      *  Decode a PackBits chunk.
@@ -247,10 +246,9 @@ QByteArray Compression::compress(QByteArray bytes, Compression::CompressionType
         return bytes;
     case RLE:
     {
-        QByteArray dst;
-        int packed_len = pack_pb_line(bytes, dst);
-        Q_ASSERT(packed_len == dst.size());
-        Q_UNUSED(packed_len);
+        QByteArray dst(packBitsMaxSize(bytes.size()), Qt::Uninitialized);
+        const quint32 packed_len = pack_pb_line(bytes.constData(), bytes.size(), dst.data());
+        dst.truncate(packed_len);
         return dst;
     }
     case ZIP:
@@ -263,3 +261,20 @@ QByteArray Compression::compress(QByteArray bytes, Compression::CompressionType
     return QByteArray();
 }
 
+quint32 Compression::packBitsMaxSize(quint32 unpacked_len)
+{
+    // the worst case is a sequence of 128-byte literal runs, each of
+    // them prefixed with a single header byte, plus pack_pb_line()
+    // emitting the last byte of the line as a separate literal run
+    return unpacked_len + (unpacked_len + 127) / 128 + 1;
+}
+
+quint32 Compression::packBits(const char *src, quint32 unpacked_len, char *dst)
+{
+    return pack_pb_line(src, unpacked_len, dst);
+}
+
+void Compression::unpackBits(const char *src, quint32 packed_len, char *dst, quint32 unpacked_len)
+{
+    decode_packbits(src, dst, packed_len, unpacked_len);
+}
@@ -35,6 +35,20 @@ public:
 
     static QByteArray uncompress(quint32 unpacked_len, QByteArray bytes, CompressionType compressionType);
     static QByteArray compress(QByteArray bytes, CompressionType compressionType);
+
+    /**
+     * PackBits codec working on preallocated buffers. Unlike
+     * uncompress()/compress() these functions do no heap allocations,
+     * so they can be called for every row of a channel, possibly from
+     * several threads at once.
+     *
+     * \p dst passed to packBits() must be at least
+     * packBitsMaxSize(unpacked_len) bytes long. packBits() returns
+     * the number of bytes actually written.
+     */
+    static quint32 packBitsMaxSize(quint32 unpacked_len);
+    static quint32 packBits(const char *src, quint32 unpacked_len, char *dst);
+    static void unpackBits(const char *src, quint32 packed_len, char *dst, quint32 unpacked_len);
 };
 
 #endif // PSD_COMPRESSION_H
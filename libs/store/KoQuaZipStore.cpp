@@ -86,14 +86,18 @@ KoQuaZipStore::~KoQuaZipStore()
     delete dd->currentFile;
 }
 
-void KoQuaZipStore::setCompressionEnabled(bool enabled)
+void KoQuaZipStore::setCompression(Compression compression)
 {
-
-    if (enabled) {
-        dd->compressionLevel = Z_DEFAULT_COMPRESSION;
-    }
-    else {
+    switch (compression) {
+    case CompressionStored:
         dd->compressionLevel = Z_NO_COMPRESSION;
+        break;
+    case CompressionFast:
+        dd->compressionLevel = Z_BEST_SPEED;
+        break;
+    case CompressionDefault:
+        dd->compressionLevel = Z_DEFAULT_COMPRESSION;
+        break;
     }
 }
 
@@ -289,3 +293,79 @@ bool KoQuaZipStore::fileExists(const QString &absPath) const
 
     return dd->archive->getFileNameList().contains(fixedPath);
 }
+
+bool KoQuaZipStore::copyRawFile(KoStore *source, const QString &sourceName, const QString &name)
+{
+    Q_D(KoStore);
+
+    KoQuaZipStore *sourceStore = dynamic_cast<KoQuaZipStore*>(source);
+    if (!sourceStore) {
+        return false;
+    }
+
+    QString fixedSourcePath = sourceName;
+    fixedSourcePath.replace("//", "/");
+
+    QString fixedPath = name;
+    fixedPath.replace("//", "/");
+
+    if (!sourceStore->dd->archive->setCurrentFile(fixedSourcePath)) {
+        return false;
+    }
+
+    /**
+     * Open both files in raw mode, so that the compressed data is
+     * copied as it is, and the checksum and the sizes of the entry
+     * are taken from the source archive.
+     */
+    QuaZipFile sourceFile(sourceStore->dd->archive);
+    int method = Z_DEFLATED;
+    int level = Z_DEFAULT_COMPRESSION;
+    if (!sourceFile.open(QIODevice::ReadOnly, &method, &level, true)) {
+        qWarning() << "Could not open" << sourceName << "for copying" << sourceFile.getZipError();
+        return false;
+    }
+
+    QuaZipFileInfo64 info;
+    if (!sourceFile.getFileInfo(&info)) {
+        sourceFile.close();
+        return false;
+    }
+
+    QuaZipNewInfo newInfo(fixedPath);
+    newInfo.setPermissions(QFileDevice::ReadOwner | QFileDevice::ReadGroup | QFileDevice::ReadOther);
+    newInfo.uncompressedSize = info.uncompressedSize;
+
+    QuaZipFile file(dd->archive);
+    if (!file.open(QIODevice::WriteOnly, newInfo, 0, info.crc, method, level, true)) {
+        qWarning() << "Could not open" << name << "for copying" << file.getZipError();
+        sourceFile.close();
+        d->good = false;
+        return false;
+    }
+
+    const qint64 chunkSize = 1 << 20;
+    QByteArray buffer(chunkSize, Qt::Uninitialized);
+    bool result = true;
+
+    qint64 bytesLeft = info.compressedSize;
+
+    while (result && bytesLeft > 0) {
+        const qint64 bytesRead = sourceFile.read(buffer.data(), qMin(chunkSize, bytesLeft));
+        result = bytesRead > 0 && file.write(buffer.constData(), bytesRead) == bytesRead;
+        bytesLeft -= bytesRead;
+    }
+
+    file.close();
+    sourceFile.close();
+
+    result &= file.getZipError() == ZIP_OK;
+
+    if (!result) {
+        qWarning() << "Could not copy" << sourceName << "to" << name;
+        d->good = false;
+    }
+
+    return result;
+}
+
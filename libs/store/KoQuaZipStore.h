@@ -36,7 +36,7 @@ public:
 
     ~KoQuaZipStore() override;
 
-    void setCompressionEnabled(bool enabled) override;
+    void setCompression(Compression compression) override;
     qint64 write(const char* _data, qint64 _len) override;
 
     QStringList directoryList() const override;
@@ -51,6 +51,7 @@ protected:
     bool enterRelativeDirectory(const QString& dirName) override;
     bool enterAbsoluteDirectory(const QString& path) override;
     bool fileExists(const QString& absPath) const override;
+    bool copyRawFile(KoStore *source, const QString &sourceName, const QString &name) override;
 
 private:
     struct Private;
@@ -413,8 +413,40 @@ bool KoStore::finalize()
     return doFinalize();
 }
 
-void KoStore::setCompressionEnabled(bool /*e*/)
+void KoStore::setCompressionEnabled(bool e)
 {
+    setCompression(e ? CompressionDefault : CompressionStored);
+}
+
+void KoStore::setCompression(Compression /*compression*/)
+{
+}
+
+bool KoStore::copyFileFrom(KoStore *source, const QString &sourceName, const QString &name)
+{
+    Q_D(KoStore);
+
+    if (d->mode != Write || d->isOpen || !source || source->mode() != Read) {
+        return false;
+    }
+
+    const QString fileName = d->toExternalNaming(name);
+    if (d->filesList.contains(fileName)) {
+        warnStore << "KoStore: Duplicate filename" << fileName;
+        return false;
+    }
+
+    if (!copyRawFile(source, sourceName, fileName)) {
+        return false;
+    }
+
+    d->filesList.append(fileName);
+    return true;
+}
+
+bool KoStore::copyRawFile(KoStore * /*source*/, const QString & /*sourceName*/, const QString & /*name*/)
+{
+    return false;
 }
 
 void KoStore::setSubstitution(const QString &name, const QString &substitution)
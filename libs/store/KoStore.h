@@ -42,6 +42,17 @@ public:
     enum Mode { Read, Write };
     enum Backend { Auto, Zip, Directory };
 
+    /**
+     * How hard the backend should try to compress the files
+     *
+     * @see setCompression()
+     */
+    enum Compression {
+        CompressionStored,  ///< store the data as is, e.g. for already compressed data
+        CompressionFast,    ///< the fastest compression the backend supports
+        CompressionDefault  ///< the default (balanced) compression of the backend
+    };
+
     /**
      * Open a store (i.e. the representation on disk of a Krita document).
      *
@@ -227,8 +238,30 @@ public:
     /**
      * Allow to enable or disable compression of the files. Only supported by the
      * ZIP backend.
+     *
+     * Equivalent to setCompression(e ? CompressionDefault : CompressionStored)
+     */
+    void setCompressionEnabled(bool e);
+
+    /**
+     * Set the compression used for the files opened for writing after
+     * this call. It lets the caller choose the compression per file,
+     * e.g. avoid compressing the data that has already been compressed.
+     * Only supported by the ZIP backend.
      */
-    virtual void setCompressionEnabled(bool e);
+    virtual void setCompression(Compression compression);
+
+    /**
+     * Copy the file \p sourceName from \p source into this store as
+     * \p name without decompressing and compressing its data again.
+     * \p source should be a store of the same backend opened for
+     * reading. Only supported by the ZIP backend.
+     *
+     * @return true on success. If the copying failed, but the store is
+     *         still good, nothing has been written and the caller can
+     *         write the file in the usual way.
+     */
+    bool copyFileFrom(KoStore *source, const QString &sourceName, const QString &name);
 
     /// When reading, in the paths in the store where name occurs, substitution is used.
     void setSubstitution(const QString &name, const QString &substitution);
@@ -287,6 +320,15 @@ protected:
      */
     virtual bool fileExists(const QString &absPath) const = 0;
 
+    /**
+     * Copy the raw data of the file @p sourceName of @p source into
+     * the file @p name in the store. The default implementation does
+     * not support it.
+     * @param name "absolute path" (in the archive) to the file to write
+     * @return true on success
+     */
+    virtual bool copyRawFile(KoStore *source, const QString &sourceName, const QString &name);
+
 protected:
     KoStorePrivate *d_ptr;
 
@@ -0,0 +1,175 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "TestKoStoreCopyFile.h"
+
+#include <KoStore.h>
+
+#include <QBuffer>
+#include <QScopedPointer>
+#include <QTest>
+
+namespace {
+
+QByteArray compressibleData()
+{
+    QByteArray data;
+    for (int i = 0; i < 4096; i++) {
+        data += QByteArray::number(i % 17);
+        data += ' ';
+    }
+    return data;
+}
+
+QByteArray noisyData()
+{
+    QByteArray data(16384, 0);
+    quint32 seed = 12345;
+    for (int i = 0; i < data.size(); i++) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = char(seed >> 16);
+    }
+    return data;
+}
+
+bool writeFile(KoStore *store, const QString &name, const QByteArray &data)
+{
+    if (!store->open(name)) return false;
+    const bool result = store->write(data) == data.size();
+    return store->close() && result;
+}
+
+QByteArray readFile(KoStore *store, const QString &name)
+{
+    if (!store->open(name)) return QByteArray();
+    const QByteArray data = store->read(store->size());
+    store->close();
+    return data;
+}
+
+void writeSourceStore(QBuffer *buffer, KoStore::Compression compression)
+{
+    QScopedPointer<KoStore> store(
+        KoStore::createStore(buffer, KoStore::Write, "application/x-krita", KoStore::Zip));
+    store->setCompression(compression);
+
+    QVERIFY(writeFile(store.data(), "layers/layer1", compressibleData()));
+    QVERIFY(writeFile(store.data(), "layers/layer2", noisyData()));
+    QVERIFY(store->finalize());
+}
+
+}
+
+void TestKoStoreCopyFile::testCopyFile_data()
+{
+    QTest::addColumn<int>("compression");
+
+    QTest::newRow("stored") << int(KoStore::CompressionStored);
+    QTest::newRow("fast") << int(KoStore::CompressionFast);
+    QTest::newRow("default") << int(KoStore::CompressionDefault);
+}
+
+void TestKoStoreCopyFile::testCopyFile()
+{
+    QFETCH(int, compression);
+
+    QBuffer sourceBuffer;
+    writeSourceStore(&sourceBuffer, KoStore::Compression(compression));
+
+    QBuffer buffer;
+
+    {
+        QScopedPointer<KoStore> source(KoStore::createStore(&sourceBuffer, KoStore::Read, "", KoStore::Zip));
+        QVERIFY(!source->bad());
+
+        QScopedPointer<KoStore> store(
+            KoStore::createStore(&buffer, KoStore::Write, "application/x-krita", KoStore::Zip));
+
+        // the copied entries keep their compression, whatever is set for the new file
+        store->setCompression(KoStore::CompressionStored);
+
+        QVERIFY(writeFile(store.data(), "maindoc.xml", "<doc/>"));
+        QVERIFY(store->copyFileFrom(source.data(), "layers/layer1", "layers/copy1"));
+        QVERIFY(store->copyFileFrom(source.data(), "layers/layer2", "layers/copy2"));
+        QVERIFY(!store->bad());
+        QVERIFY(store->finalize());
+    }
+
+    QScopedPointer<KoStore> store(KoStore::createStore(&buffer, KoStore::Read, "", KoStore::Zip));
+    QVERIFY(!store->bad());
+
+    QCOMPARE(readFile(store.data(), "maindoc.xml"), QByteArray("<doc/>"));
+    QCOMPARE(readFile(store.data(), "layers/copy1"), compressibleData());
+    QCOMPARE(readFile(store.data(), "layers/copy2"), noisyData());
+    QVERIFY(!store->hasFile("layers/layer1"));
+
+    if (compression != KoStore::CompressionStored) {
+        // the compressed data was copied as it is, not stored uncompressed
+        QVERIFY(buffer.size() < compressibleData().size() + noisyData().size());
+    }
+}
+
+void TestKoStoreCopyFile::testCopyMissingFile()
+{
+    QBuffer sourceBuffer;
+    writeSourceStore(&sourceBuffer, KoStore::CompressionDefault);
+
+    QScopedPointer<KoStore> source(KoStore::createStore(&sourceBuffer, KoStore::Read, "", KoStore::Zip));
+
+    QBuffer buffer;
+    QScopedPointer<KoStore> store(
+        KoStore::createStore(&buffer, KoStore::Write, "application/x-krita", KoStore::Zip));
+
+    // a failed copy leaves the store usable for writing the file normally
+    QVERIFY(!store->copyFileFrom(source.data(), "layers/missing", "layers/copy1"));
+    QVERIFY(!store->bad());
+    QVERIFY(writeFile(store.data(), "layers/copy1", compressibleData()));
+    QVERIFY(store->finalize());
+}
+
+void TestKoStoreCopyFile::testCopyDuplicateFile()
+{
+    QBuffer sourceBuffer;
+    writeSourceStore(&sourceBuffer, KoStore::CompressionDefault);
+
+    QScopedPointer<KoStore> source(KoStore::createStore(&sourceBuffer, KoStore::Read, "", KoStore::Zip));
+
+    QBuffer buffer;
+    QScopedPointer<KoStore> store(
+        KoStore::createStore(&buffer, KoStore::Write, "application/x-krita", KoStore::Zip));
+
+    QVERIFY(store->copyFileFrom(source.data(), "layers/layer1", "layers/copy1"));
+    QVERIFY(!store->copyFileFrom(source.data(), "layers/layer2", "layers/copy1"));
+    QVERIFY(store->finalize());
+}
+
+void TestKoStoreCopyFile::testCopyIntoReadStore()
+{
+    QBuffer sourceBuffer;
+    writeSourceStore(&sourceBuffer, KoStore::CompressionDefault);
+
+    QBuffer buffer;
+    buffer.setData(sourceBuffer.data());
+
+    QScopedPointer<KoStore> source(KoStore::createStore(&sourceBuffer, KoStore::Read, "", KoStore::Zip));
+    QScopedPointer<KoStore> store(KoStore::createStore(&buffer, KoStore::Read, "", KoStore::Zip));
+
+    QVERIFY(!store->copyFileFrom(source.data(), "layers/layer1", "layers/copy1"));
+}
+
+QTEST_GUILESS_MAIN(TestKoStoreCopyFile)
@@ -84,6 +84,7 @@
 #include <QWidget>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QtConcurrent>
 #include <QUuid>
 
 // Krita Image
@@ -95,6 +96,7 @@
 #include <kis_layer.h>
 #include <kis_name_server.h>
 #include <kis_paint_layer.h>
+#include <kis_paint_device.h>
 #include <kis_painter.h>
 #include <kis_selection.h>
 #include <kis_fill_painter.h>
@@ -130,7 +132,6 @@
 #include <mutex>
 #include "kis_config_notifier.h"
 #include "kis_async_action_feedback.h"
-#include "KisCloneDocumentStroke.h"
 
 #include <KisMirrorAxisConfig.h>
 #include <KisDecorationsWrapperLayer.h>
@@ -343,11 +344,33 @@ public:
     QPointer<KoUpdater> savingUpdater;
     QFuture<KisImportExportErrorCode> childSavingFuture;
     KritaUtils::ExportFileJob backgroundSaveJob;
+    KisImageSP autoSaveImageSnapshot;
 
     bool isRecovered = false;
 
     bool batchMode { false };
 
+    /**
+     * The revision of a layer's device at the moment of saving and the
+     * location of its pixel data in the saved file
+     */
+    struct SavedDeviceRevision {
+        KisPaintDeviceWSP device;
+        int sequenceNumber = -1;
+        QString location;
+    };
+
+    // the file written by the last successful save and its layers
+    QString lastSavedFilePath;
+    qint64 lastSavedFileSize = -1;
+    QDateTime lastSavedFileModified;
+    QHash<QUuid, SavedDeviceRevision> lastSavedRevisions;
+
+    // the state of the clone used for saving the document
+    QHash<QUuid, SavedDeviceRevision> savingRevisions;
+    KritaUtils::IncrementalSaveSource incrementalSaveSource;
+    QHash<QUuid, QString> incrementallySavedEntries;
+
     QString documentStorageID {QUuid::createUuid().toString()};
     KisResourceStorageSP documentResourceStorage;
 
@@ -362,6 +385,9 @@ public:
     void copyFrom(const Private &rhs, KisDocument *q);
     void copyFromImpl(const Private &rhs, KisDocument *q, KisDocument::CopyPolicy policy);
 
+    void prepareIncrementalSave(KisDocument *clone);
+    void updateLastSavedFile(const QString &filePath, const Private &clone);
+
     /// clones the palette list oldList
     /// the ownership of the returned KoColorSet * belongs to the caller
     class StrippedSafeSavingLocker;
@@ -472,6 +498,68 @@ void KisDocument::Private::copyFromImpl(const Private &rhs, KisDocument *q, KisD
 
 }
 
+void KisDocument::Private::prepareIncrementalSave(KisDocument *clone)
+{
+    KisConfig cfg(true);
+    if (!cfg.incrementalKraSave() || cfg.trimKra()) return;
+
+    KritaUtils::IncrementalSaveSource source;
+    source.filePath = lastSavedFilePath;
+    source.fileSize = lastSavedFileSize;
+    source.lastModified = lastSavedFileModified;
+
+    /**
+     * The sequence number of the device changes on every modification
+     * of its pixels, so if neither the device nor its sequence number
+     * have changed since the last save, the pixel data in the saved
+     * file is still valid. Animated devices are always saved as usual.
+     */
+    KisLayerUtils::recursiveApplyNodes(image->root(),
+        [this, clone, &source] (KisNodeSP node) {
+            if (!dynamic_cast<KisPaintLayer*>(node.data())) return;
+
+            KisPaintDeviceSP device = node->paintDevice();
+            if (!device || device->keyframeChannel()) return;
+
+            SavedDeviceRevision revision;
+            revision.device = device;
+            revision.sequenceNumber = device->sequenceNumber();
+            clone->d->savingRevisions.insert(node->uuid(), revision);
+
+            auto it = lastSavedRevisions.constFind(node->uuid());
+            if (it != lastSavedRevisions.constEnd() &&
+                it->device.isValid() &&
+                it->device.data() == device.data() &&
+                it->sequenceNumber == revision.sequenceNumber) {
+
+                source.entries.insert(node->uuid(), it->location);
+            }
+        });
+
+    clone->d->incrementalSaveSource = source;
+}
+
+void KisDocument::Private::updateLastSavedFile(const QString &filePath, const Private &clone)
+{
+    const QFileInfo fileInfo(filePath);
+
+    lastSavedFilePath = fileInfo.absoluteFilePath();
+    lastSavedFileSize = fileInfo.size();
+    lastSavedFileModified = fileInfo.lastModified();
+    lastSavedRevisions.clear();
+
+    for (auto it = clone.incrementallySavedEntries.constBegin();
+         it != clone.incrementallySavedEntries.constEnd(); ++it) {
+
+        auto revisionIt = clone.savingRevisions.constFind(it.key());
+        if (revisionIt == clone.savingRevisions.constEnd()) continue;
+
+        SavedDeviceRevision revision = *revisionIt;
+        revision.location = it.value();
+        lastSavedRevisions.insert(it.key(), revision);
+    }
+}
+
 class KisDocument::Private::StrippedSafeSavingLocker {
 public:
     StrippedSafeSavingLocker(QMutex *savingMutex, KisImageSP image)
@@ -525,6 +613,8 @@ KisDocument::KisDocument(bool addStorage)
     connect(KisConfigNotifier::instance(), SIGNAL(configChanged()), SLOT(slotConfigChanged()));
     connect(d->undoStack, SIGNAL(cleanChanged(bool)), this, SLOT(slotUndoStackCleanChanged(bool)));
     connect(d->autoSaveTimer, SIGNAL(timeout()), this, SLOT(slotAutoSave()));
+    connect(this, SIGNAL(sigImageSnapshotForAutosaveTaken(KisImageSP)),
+            this, SLOT(slotInitiateAsyncAutosaving(KisImageSP)), Qt::QueuedConnection);
     setObjectName(newObjectName());
 
 
@@ -550,6 +640,13 @@ KisDocument::KisDocument(const KisDocument &rhs)
     copyFromDocumentImpl(rhs, CONSTRUCT);
 }
 
+KisDocument::KisDocument(const KisDocument &rhs, KisImageSP imageSnapshot)
+    : QObject(),
+      d(new Private(*rhs.d, this))
+{
+    copyFromDocumentImpl(rhs, CONSTRUCT, imageSnapshot);
+}
+
 KisDocument::~KisDocument()
 {
     // wait until all the pending operations are in progress
@@ -864,7 +961,10 @@ KisDocument* KisDocument::lockAndCloneForSaving()
         return 0;
     }
 
-    return new KisDocument(*this);
+    KisDocument *doc = new KisDocument(*this);
+    d->prepareIncrementalSave(doc);
+
+    return doc;
 }
 
 KisDocument *KisDocument::lockAndCreateSnapshot()
@@ -884,7 +984,7 @@ void KisDocument::copyFromDocument(const KisDocument &rhs)
     copyFromDocumentImpl(rhs, REPLACE);
 }
 
-void KisDocument::copyFromDocumentImpl(const KisDocument &rhs, CopyPolicy policy)
+void KisDocument::copyFromDocumentImpl(const KisDocument &rhs, CopyPolicy policy, KisImageSP imageSnapshot)
 {
     if (policy == REPLACE) {
         d->copyFrom(*(rhs.d), this);
@@ -895,6 +995,8 @@ void KisDocument::copyFromDocumentImpl(const KisDocument &rhs, CopyPolicy policy
         connect(KisConfigNotifier::instance(), SIGNAL(configChanged()), SLOT(slotConfigChanged()));
         connect(d->undoStack, SIGNAL(cleanChanged(bool)), this, SLOT(slotUndoStackCleanChanged(bool)));
         connect(d->autoSaveTimer, SIGNAL(timeout()), this, SLOT(slotAutoSave()));
+        connect(this, SIGNAL(sigImageSnapshotForAutosaveTaken(KisImageSP)),
+                this, SLOT(slotInitiateAsyncAutosaving(KisImageSP)), Qt::QueuedConnection);
 
         d->shapeController = new KisShapeController(this, d->nserver);
         d->koShapeController = new KoShapeController(0, d->shapeController);
@@ -914,6 +1016,9 @@ void KisDocument::copyFromDocumentImpl(const KisDocument &rhs, CopyPolicy policy
             rhs.d->image->unlock();
 
             setCurrentImage(d->image, /* forceInitialUpdate = */ true);
+        } else if (imageSnapshot) {
+            // the snapshot is already an exact copy of the image
+            setCurrentImage(imageSnapshot, /* forceInitialUpdate = */ false);
         } else {
             // clone the image with keeping the GUIDs of the layers intact
             // NOTE: we expect the image to be locked!
@@ -921,7 +1026,10 @@ void KisDocument::copyFromDocumentImpl(const KisDocument &rhs, CopyPolicy policy
         }
     }
 
-    if (rhs.d->preActivatedNode) {
+    if (rhs.d->preActivatedNode && imageSnapshot) {
+        // the graph might have changed since the snapshot has been taken
+        d->preActivatedNode = KisLayerUtils::findNodeByUuid(d->image->root(), rhs.d->preActivatedNode->uuid());
+    } else if (rhs.d->preActivatedNode) {
         QQueue<KisNodeSP> linearizedNodes;
         KisLayerUtils::recursiveApplyNodes(rhs.d->image->root(),
                                            [&linearizedNodes](KisNodeSP node) {
@@ -1099,6 +1207,12 @@ void KisDocument::slotChildCompletedSavingInBackground(KisImportExportErrorCode
         d->backgroundSaveDocument->d->isAutosaving = false;
     }
 
+    if (status.isOk() && d->backgroundSaveJob.isValid() &&
+        !(d->backgroundSaveJob.flags & (KritaUtils::SaveIsExporting | KritaUtils::SaveInAutosaveMode))) {
+
+        d->updateLastSavedFile(d->backgroundSaveJob.filePath, *d->backgroundSaveDocument->d);
+    }
+
     d->backgroundSaveDocument.take()->deleteLater();
 
     KIS_ASSERT_RECOVER(d->backgroundSaveJob.isValid()) {
@@ -1142,18 +1256,19 @@ void KisDocument::slotAutoSaveImpl(std::unique_ptr<KisDocument> &&optionalCloned
                                              KritaUtils::ExportFileJob(autoSaveFileName, nativeFormatMimeType(), KritaUtils::SaveIsExporting | KritaUtils::SaveInAutosaveMode),
                                              0,
                                              std::move(optionalClonedDocument));
-    } else {
-        emit statusBarMessage(i18n("Autosaving postponed: document is busy..."), errorMessageTimeout);
     }
 
-    if (!started && !hadClonedDocument && d->autoSaveFailureCount >= 3) {
-        KisCloneDocumentStroke *stroke = new KisCloneDocumentStroke(this);
-        connect(stroke, SIGNAL(sigDocumentCloned(KisDocument*)),
-                this, SLOT(slotInitiateAsyncAutosaving(KisDocument*)),
-                Qt::BlockingQueuedConnection);
-
-        KisStrokeId strokeId = d->image->startStroke(stroke);
-        d->image->endStroke(strokeId);
+    if (!started && !hadClonedDocument && !isSaving()) {
+        /**
+         * The image is busy, e.g. the user is painting. Instead of
+         * postponing the autosave, take a copy-on-write snapshot of the
+         * image at the next stroke boundary and save it in background.
+         * The timer is restarted when the autosave is completed.
+         */
+        d->image->requestSnapshot(
+            [this] (KisImageSP imageSnapshot) {
+                emit sigImageSnapshotForAutosaveTaken(imageSnapshot);
+            });
 
         setInfiniteAutoSaveInterval();
 
@@ -1169,9 +1284,51 @@ void KisDocument::slotAutoSave()
     slotAutoSaveImpl(std::unique_ptr<KisDocument>());
 }
 
-void KisDocument::slotInitiateAsyncAutosaving(KisDocument *clonedDocument)
+void KisDocument::slotInitiateAsyncAutosaving(KisImageSP imageSnapshot)
+{
+    if (!imageSnapshot) {
+        setEmergencyAutoSaveInterval();
+        return;
+    }
+
+    KIS_SAFE_ASSERT_RECOVER(!d->autoSaveImageSnapshot) {
+        setEmergencyAutoSaveInterval();
+        return;
+    }
+
+    /**
+     * The snapshot has been cloned while the merge jobs of the image
+     * could still be running, so its projections may be inconsistent.
+     * Regenerate them from the layers and let the delayed nodes update.
+     * The updates are only started here, and they are waited for in a
+     * separate thread, so neither the GUI nor the image the user is
+     * working with are blocked.
+     */
+    imageSnapshot->refreshGraphAsync(KisNodeSP(), imageSnapshot->bounds(), QRect());
+    KisLayerUtils::forceAllDelayedNodesUpdate(imageSnapshot->root());
+
+    d->autoSaveImageSnapshot = imageSnapshot;
+
+    QFutureWatcher<void> *watcher = new QFutureWatcher<void>();
+    connect(watcher, SIGNAL(finished()), SLOT(slotCompleteAutoSaveSnapshot()));
+    connect(watcher, SIGNAL(finished()), watcher, SLOT(deleteLater()));
+
+    watcher->setFuture(QtConcurrent::run([imageSnapshot] () {
+        imageSnapshot->waitForDone();
+    }));
+}
+
+void KisDocument::slotCompleteAutoSaveSnapshot()
 {
-    slotAutoSaveImpl(std::unique_ptr<KisDocument>(clonedDocument));
+    KisImageSP imageSnapshot = d->autoSaveImageSnapshot;
+    d->autoSaveImageSnapshot.clear();
+
+    KIS_SAFE_ASSERT_RECOVER(imageSnapshot) {
+        setEmergencyAutoSaveInterval();
+        return;
+    }
+
+    slotAutoSaveImpl(std::unique_ptr<KisDocument>(new KisDocument(*this, imageSnapshot)));
 }
 
 void KisDocument::slotPerformIdleRoutines()
@@ -2319,6 +2476,16 @@ bool KisDocument::isAutosaving() const
     return d->isAutosaving;
 }
 
+KritaUtils::IncrementalSaveSource KisDocument::incrementalSaveSource() const
+{
+    return d->incrementalSaveSource;
+}
+
+void KisDocument::setIncrementallySavedEntries(const QHash<QUuid, QString> &entries)
+{
+    d->incrementallySavedEntries = entries;
+}
+
 QString KisDocument::exportErrorToUserMessage(KisImportExportErrorCode status, const QString &errorMessage)
 {
     return errorMessage.isEmpty() ? status.errorMessage() : errorMessage;
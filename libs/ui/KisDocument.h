@@ -92,6 +92,13 @@ protected:
      */
     explicit KisDocument(const KisDocument &rhs);
 
+    /**
+     * Makes a copy of the document \p rhs, which uses \p imageSnapshot,
+     * taken by KisImage::requestSnapshot(), instead of cloning the image
+     * of \p rhs, so the image of \p rhs doesn't need to be locked.
+     */
+    KisDocument(const KisDocument &rhs, KisImageSP imageSnapshot);
+
 public:
     enum OpenFlag {
         None = 0,
@@ -467,6 +474,12 @@ Q_SIGNALS:
 
     void sigCompleteBackgroundSaving(const KritaUtils::ExportFileJob &job, KisImportExportErrorCode status, const QString &errorMessage);
 
+    /**
+     * Internal signal, emitted from a worker thread of the image when
+     * the snapshot for autosaving has been taken
+     */
+    void sigImageSnapshotForAutosaveTaken(KisImageSP imageSnapshot);
+
     void sigReferenceImagesChanged();
 
     void sigMirrorAxisConfigChanged();
@@ -490,7 +503,8 @@ private Q_SLOTS:
 
     void slotCompleteSavingDocument(const KritaUtils::ExportFileJob &job, KisImportExportErrorCode status, const QString &errorMessage);
 
-    void slotInitiateAsyncAutosaving(KisDocument *clonedDocument);
+    void slotInitiateAsyncAutosaving(KisImageSP imageSnapshot);
+    void slotCompleteAutoSaveSnapshot();
 
     void slotPerformIdleRoutines();
 
@@ -545,6 +559,21 @@ public:
 
     bool isAutosaving() const;
 
+    /**
+     * The file written by the previous save of the document and the
+     * pixel data entries in it that are still valid. It is set only
+     * for the document clones created for saving, so that the .kra
+     * saver could copy the unchanged layers from that file.
+     */
+    KritaUtils::IncrementalSaveSource incrementalSaveSource() const;
+
+    /**
+     * Called by the .kra saver to report the pixel data entries of
+     * the paint layers it has written, so that the next save of the
+     * document could reuse them
+     */
+    void setIncrementallySavedEntries(const QHash<QUuid, QString> &entries);
+
 public:
 
     QString localFilePath() const;
@@ -688,7 +717,7 @@ private:
         REPLACE ///< we are replacing the current KisDocument with another
     };
 
-    void copyFromDocumentImpl(const KisDocument &rhs, CopyPolicy policy);
+    void copyFromDocumentImpl(const KisDocument &rhs, CopyPolicy policy, KisImageSP imageSnapshot = KisImageSP());
 
     QString exportErrorToUserMessage(KisImportExportErrorCode status, const QString &errorMessage);
 
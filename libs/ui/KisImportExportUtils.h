@@ -21,6 +21,9 @@
 
 #include <QFlags>
 #include <QString>
+#include <QDateTime>
+#include <QHash>
+#include <QUuid>
 
 namespace KritaUtils {
 
@@ -54,6 +57,22 @@ struct ExportFileJob {
     SaveFlags flags;
 };
 
+/**
+ * The file written by the previous save of the document and the
+ * entries in it that can be copied into the new file as they are,
+ * because the corresponding layers have not changed since then.
+ */
+struct IncrementalSaveSource {
+    bool isValid() const {
+        return !filePath.isEmpty() && !entries.isEmpty();
+    }
+
+    QString filePath;
+    qint64 fileSize = -1;
+    QDateTime lastModified;
+    QHash<QUuid, QString> entries; ///< node uuid -> the entry in filePath
+};
+
 }
 
 #endif // KISIMPORTEXPORTUTILS_H
@@ -1857,6 +1857,26 @@ void KisConfig::setTrimKra(bool trim)
     m_cfg.writeEntry("TrimKra", trim);
 }
 
+bool KisConfig::lazyLoadKra(bool defaultValue) const
+{
+    return (defaultValue ? true : m_cfg.readEntry("LazyLoadKra", true));
+}
+
+void KisConfig::setLazyLoadKra(bool lazy)
+{
+    m_cfg.writeEntry("LazyLoadKra", lazy);
+}
+
+bool KisConfig::incrementalKraSave(bool defaultValue) const
+{
+    return (defaultValue ? true : m_cfg.readEntry("IncrementalKraSave", true));
+}
+
+void KisConfig::setIncrementalKraSave(bool incremental)
+{
+    m_cfg.writeEntry("IncrementalKraSave", incremental);
+}
+
 bool KisConfig::toolOptionsInDocker(bool defaultValue) const
 {
     return (defaultValue ? true : m_cfg.readEntry("ToolOptionsInDocker", true));
@@ -1966,6 +1986,29 @@ void KisConfig::setEnableBrushSpeedLogging(bool value) const
     m_cfg.writeEntry("enableBrushSpeedLogging", value);
 }
 
+bool KisConfig::enableStrokeRecording(bool defaultValue) const
+{
+    return (defaultValue ? false : m_cfg.readEntry("enableStrokeRecording", false));
+}
+
+void KisConfig::setEnableStrokeRecording(bool value) const
+{
+    m_cfg.writeEntry("enableStrokeRecording", value);
+}
+
+QString KisConfig::strokeRecordingLocation(bool defaultValue) const
+{
+    const QString defaultLocation =
+        QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/stroke-recordings";
+
+    return (defaultValue ? defaultLocation : m_cfg.readEntry("strokeRecordingLocation", defaultLocation));
+}
+
+void KisConfig::setStrokeRecordingLocation(const QString &value) const
+{
+    m_cfg.writeEntry("strokeRecordingLocation", value);
+}
+
 void KisConfig::setEnableAmdVectorizationWorkaround(bool value)
 {
     m_cfg.writeEntry("amdDisableVectorWorkaround", value);
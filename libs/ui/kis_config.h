@@ -533,6 +533,22 @@ public:
     bool trimKra(bool defaultValue = false) const;
     void setTrimKra(bool trim);
 
+    /**
+     * When loading a .kra file, keep the pixel data of hidden layers and
+     * of the non-current animation frames compressed in the swap until
+     * it is accessed for the first time
+     */
+    bool lazyLoadKra(bool defaultValue = false) const;
+    void setLazyLoadKra(bool lazy);
+
+    /**
+     * When saving a .kra file over the file written by the previous
+     * save, copy the pixel data of the unchanged paint layers from the
+     * old file instead of encoding it once again
+     */
+    bool incrementalKraSave(bool defaultValue = false) const;
+    void setIncrementalKraSave(bool incremental);
+
     bool toolOptionsInDocker(bool defaultValue = false) const;
     void setToolOptionsInDocker(bool inDocker);
 
@@ -554,6 +570,12 @@ public:
     void setEnableBrushSpeedLogging(bool value) const;
     bool enableBrushSpeedLogging(bool defaultValue = false) const;
 
+    void setEnableStrokeRecording(bool value) const;
+    bool enableStrokeRecording(bool defaultValue = false) const;
+
+    void setStrokeRecordingLocation(const QString &value) const;
+    QString strokeRecordingLocation(bool defaultValue = false) const;
+
     void setEnableAmdVectorizationWorkaround(bool value);
     bool enableAmdVectorizationWorkaround(bool defaultValue = false) const;
 
@@ -37,6 +37,8 @@
 #include <QBuffer>
 #include <QFile>
 #include <QApplication>
+#include <QThread>
+#include <QtConcurrent>
 
 #include <klocalizedstring.h>
 #include <QUrl>
@@ -421,6 +423,296 @@ void _flush_fn(png_structp png_ptr)
     Q_UNUSED(png_ptr);
 }
 
+namespace {
+
+/**
+ * The minimum size of the image data that is worth compressing in
+ * several threads
+ */
+const qint64 minBytesForParallelCompression = 4 * 1024 * 1024;
+
+/**
+ * The size of the deflate window, the groups of rows are primed with
+ * that many bytes of the previous group
+ */
+const int deflateDictionarySize = 32768;
+
+inline int paethPredictor(int a, int b, int c)
+{
+    const int p = a + b - c;
+    const int pa = qAbs(p - a);
+    const int pb = qAbs(p - b);
+    const int pc = qAbs(p - c);
+
+    return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+inline int filteredByteCost(quint8 value)
+{
+    return value < 128 ? value : 256 - value;
+}
+
+/**
+ * Filters the rows of a non-interlaced image into the format of the IDAT
+ * stream, that is, every row is prefixed with its filter type. The filter
+ * is chosen the same way libpng does by default: the one with the minimum
+ * sum of absolute values wins, unless the image is indexed or has less
+ * than 8 bits per channel.
+ *
+ * The 16-bit rows are stored in the native byte order, so on little
+ * endian machines the bytes of every sample are swapped on the fly.
+ */
+class PngRowsFilter
+{
+public:
+    PngRowsFilter(png_byte **rows, int rowSize, int bytesPerPixel, bool useFilters, bool swapBytes)
+        : m_rows(rows),
+          m_rowSize(rowSize),
+          m_bytesPerPixel(bytesPerPixel),
+          m_useFilters(useFilters),
+          m_swapMask(swapBytes ? 1 : 0),
+          m_scratch(5 * rowSize)
+    {
+    }
+
+    int filteredRowSize() const {
+        return m_rowSize + 1;
+    }
+
+    void filterRows(int firstRow, int numRows, quint8 *dst) {
+        for (int row = firstRow; row < firstRow + numRows; row++) {
+            filterRow(m_rows[row], row > 0 ? m_rows[row - 1] : 0, dst);
+            dst += filteredRowSize();
+        }
+    }
+
+private:
+    void filterRow(const quint8 *row, const quint8 *prevRow, quint8 *dst) {
+        const int mask = m_swapMask;
+        const int bpp = m_bytesPerPixel;
+
+        if (!m_useFilters) {
+            *dst++ = PNG_FILTER_VALUE_NONE;
+            for (int i = 0; i < m_rowSize; i++) {
+                dst[i] = row[i ^ mask];
+            }
+            return;
+        }
+
+        quint8 *candidates[5];
+        for (int filter = 0; filter < 5; filter++) {
+            candidates[filter] = m_scratch.data() + filter * m_rowSize;
+        }
+
+        qint64 costs[5] = {0, 0, 0, 0, 0};
+
+        for (int i = 0; i < m_rowSize; i++) {
+            const int x = row[i ^ mask];
+            const int a = i >= bpp ? row[(i - bpp) ^ mask] : 0;
+            const int b = prevRow ? prevRow[i ^ mask] : 0;
+            const int c = prevRow && i >= bpp ? prevRow[(i - bpp) ^ mask] : 0;
+
+            candidates[PNG_FILTER_VALUE_NONE][i] = quint8(x);
+            candidates[PNG_FILTER_VALUE_SUB][i] = quint8(x - a);
+            candidates[PNG_FILTER_VALUE_UP][i] = quint8(x - b);
+            candidates[PNG_FILTER_VALUE_AVG][i] = quint8(x - ((a + b) >> 1));
+            candidates[PNG_FILTER_VALUE_PAETH][i] = quint8(x - paethPredictor(a, b, c));
+
+            for (int filter = 0; filter < 5; filter++) {
+                costs[filter] += filteredByteCost(candidates[filter][i]);
+            }
+        }
+
+        int bestFilter = PNG_FILTER_VALUE_NONE;
+        for (int filter = 1; filter < 5; filter++) {
+            if (costs[filter] < costs[bestFilter]) {
+                bestFilter = filter;
+            }
+        }
+
+        *dst++ = quint8(bestFilter);
+        memcpy(dst, candidates[bestFilter], m_rowSize);
+    }
+
+private:
+    png_byte **m_rows;
+    int m_rowSize;
+    int m_bytesPerPixel;
+    bool m_useFilters;
+    int m_swapMask;
+    QVector<quint8> m_scratch;
+};
+
+struct DeflateRowsJob {
+    int firstRow;
+    int numRows;
+    QByteArray compressedData;
+    uLong adler;
+    uLong uncompressedSize;
+    bool result;
+};
+
+/**
+ * Compresses a group of rows into a raw deflate stream, the way pigz
+ * does. The stream is primed with the tail of the previous group and
+ * ends on a byte boundary (Z_SYNC_FLUSH), so the streams of all the
+ * groups can be concatenated into a single valid one. Only the last
+ * group finishes the stream.
+ */
+struct DeflateRowsJobWrapper {
+    DeflateRowsJobWrapper(png_byte **rows, int totalRows, int rowSize, int bytesPerPixel,
+                          bool useFilters, bool swapBytes, int compressionLevel)
+        : m_rows(rows),
+          m_totalRows(totalRows),
+          m_rowSize(rowSize),
+          m_bytesPerPixel(bytesPerPixel),
+          m_useFilters(useFilters),
+          m_swapBytes(swapBytes),
+          m_compressionLevel(compressionLevel)
+    {
+    }
+
+    inline void operator() (DeflateRowsJob &job) {
+        PngRowsFilter filter(m_rows, m_rowSize, m_bytesPerPixel, m_useFilters, m_swapBytes);
+        const int filteredRowSize = filter.filteredRowSize();
+
+        // the filtered data of the previous group is owned by another
+        // job, so just filter its last rows once more
+        const int dictionaryRows =
+            qMin(job.firstRow, (deflateDictionarySize + filteredRowSize - 1) / filteredRowSize);
+        QByteArray dictionary(dictionaryRows * filteredRowSize, 0);
+        filter.filterRows(job.firstRow - dictionaryRows, dictionaryRows, reinterpret_cast<quint8*>(dictionary.data()));
+
+        QByteArray filtered(job.numRows * filteredRowSize, 0);
+        filter.filterRows(job.firstRow, job.numRows, reinterpret_cast<quint8*>(filtered.data()));
+
+        job.uncompressedSize = filtered.size();
+        job.adler = adler32(adler32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(filtered.constData()), filtered.size());
+
+        z_stream stream;
+        memset(&stream, 0, sizeof(z_stream));
+
+        if (deflateInit2(&stream, m_compressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return;
+        }
+
+        if (!dictionary.isEmpty()) {
+            const int dictionarySize = qMin(dictionary.size(), deflateDictionarySize);
+            deflateSetDictionary(&stream,
+                                 reinterpret_cast<const Bytef*>(dictionary.constData()) + dictionary.size() - dictionarySize,
+                                 dictionarySize);
+        }
+
+        const bool isLastGroup = job.firstRow + job.numRows == m_totalRows;
+
+        // deflateBound() doesn't account for the sync flush marker
+        job.compressedData.resize(deflateBound(&stream, filtered.size()) + 64);
+
+        stream.next_in = reinterpret_cast<Bytef*>(filtered.data());
+        stream.avail_in = filtered.size();
+        stream.next_out = reinterpret_cast<Bytef*>(job.compressedData.data());
+        stream.avail_out = job.compressedData.size();
+
+        const int result = deflate(&stream, isLastGroup ? Z_FINISH : Z_SYNC_FLUSH);
+
+        job.result = isLastGroup ?
+            result == Z_STREAM_END :
+            result == Z_OK && stream.avail_in == 0 && stream.avail_out > 0;
+
+        job.compressedData.resize(stream.total_out);
+        deflateEnd(&stream);
+    }
+
+    png_byte **m_rows;
+    int m_totalRows;
+    int m_rowSize;
+    int m_bytesPerPixel;
+    bool m_useFilters;
+    bool m_swapBytes;
+    int m_compressionLevel;
+};
+
+/**
+ * Filters and compresses the rows of a non-interlaced image in parallel
+ * and writes them as IDAT chunks followed by IEND. It replaces
+ * png_write_image() and png_write_end(), so it should be called right
+ * after png_write_info().
+ */
+bool writeImageDataInParallel(png_structp png_ptr, png_infop info_ptr, png_byte **rows, int numRows,
+                              int compressionLevel, bool swapBytes)
+{
+    const int rowSize = png_get_rowbytes(png_ptr, info_ptr);
+    const int bitDepth = png_get_bit_depth(png_ptr, info_ptr);
+    const int bytesPerPixel = qMax(1, png_get_channels(png_ptr, info_ptr) * bitDepth / 8);
+    const bool useFilters = png_get_color_type(png_ptr, info_ptr) != PNG_COLOR_TYPE_PALETTE && bitDepth >= 8;
+
+    // the groups should be big enough for the dictionary overhead to be negligible
+    const int minRowsPerJob = qMax(1, 1024 * 1024 / (rowSize + 1));
+    const int rowsPerJob = qMax(minRowsPerJob, (numRows + 4 * QThread::idealThreadCount() - 1) / (4 * QThread::idealThreadCount()));
+
+    QVector<DeflateRowsJob> jobs;
+    for (int row = 0; row < numRows; row += rowsPerJob) {
+        DeflateRowsJob job;
+        job.firstRow = row;
+        job.numRows = qMin(rowsPerJob, numRows - row);
+        job.adler = 0;
+        job.uncompressedSize = 0;
+        job.result = false;
+        jobs.append(job);
+    }
+
+    DeflateRowsJobWrapper wrapper(rows, numRows, rowSize, bytesPerPixel, useFilters, swapBytes, compressionLevel);
+
+    if (jobs.size() > 1) {
+        QtConcurrent::blockingMap(jobs, wrapper);
+    } else {
+        std::for_each(jobs.begin(), jobs.end(), wrapper);
+    }
+
+    // zlib header: deflate with 32K window and the level hint as zlib writes it
+    const int levelFlags =
+        compressionLevel < 2 ? 0 :
+        compressionLevel < 6 ? 1 :
+        compressionLevel == 6 ? 2 : 3;
+
+    int header = (0x78 << 8) | (levelFlags << 6);
+    header += 31 - header % 31;
+
+    QByteArray zlibStream;
+    zlibStream.append(char(header >> 8));
+    zlibStream.append(char(header & 0xff));
+
+    uLong adler = adler32(0L, Z_NULL, 0);
+
+    Q_FOREACH (const DeflateRowsJob &job, jobs) {
+        if (!job.result) {
+            return false;
+        }
+
+        zlibStream.append(job.compressedData);
+        adler = adler32_combine(adler, job.adler, job.uncompressedSize);
+    }
+
+    zlibStream.append(char((adler >> 24) & 0xff));
+    zlibStream.append(char((adler >> 16) & 0xff));
+    zlibStream.append(char((adler >> 8) & 0xff));
+    zlibStream.append(char(adler & 0xff));
+
+    const int maxChunkSize = 1024 * 1024;
+
+    for (int offset = 0; offset < zlibStream.size(); offset += maxChunkSize) {
+        png_write_chunk(png_ptr, (png_bytep)"IDAT",
+                        reinterpret_cast<png_bytep>(zlibStream.data()) + offset,
+                        qMin(maxChunkSize, zlibStream.size() - offset));
+    }
+
+    png_write_chunk(png_ptr, (png_bytep)"IEND", 0, 0);
+
+    return true;
+}
+
+}
+
 KisImportExportErrorCode KisPNGConverter::buildImage(QIODevice* iod)
 {
     dbgFile << "Start decoding PNG File";
@@ -951,9 +1243,17 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
                         KoColorSpaceRegistry::instance()->p2020PQProfile());
         }
 
+        // the dithering is used only when the depth is the only thing
+        // that changes, the HDR conversion goes through the profiles
+        const KoDitherOp::Type ditherType =
+            options.dither && !options.saveAsHDR ? KoDitherOp::DitherBlueNoise : KoDitherOp::NoDither;
+
         KisPaintDeviceSP tmp = new KisPaintDevice(device->colorSpace());
         tmp->makeCloneFromRough(device, imageRect);
-        tmp->convertTo(dstCS);
+        tmp->convertTo(dstCS,
+                       KoColorConversionTransformation::internalRenderingIntent(),
+                       KoColorConversionTransformation::internalConversionFlags(),
+                       0, ditherType);
 
         device = tmp;
 
@@ -1386,10 +1686,30 @@ KisImportExportErrorCode KisPNGConverter::buildFile(QIODevice* iodevice, const Q
         }
     }
 
-    png_write_image(png_ptr, rowPointers.rows);
+    const bool useParallelCompression =
+        options.parallelCompression &&
+        interlacetype == PNG_INTERLACE_NONE &&
+        qint64(png_get_rowbytes(png_ptr, info_ptr)) * imageRect.height() >= minBytesForParallelCompression;
 
-    // Writing is over
-    png_write_end(png_ptr, info_ptr);
+    if (useParallelCompression) {
+#ifndef WORDS_BIGENDIAN
+        const bool swapBytes = color_nb_bits > 8;
+#else
+        const bool swapBytes = false;
+#endif
+
+        if (!writeImageDataInParallel(png_ptr, info_ptr, rowPointers.rows, imageRect.height(),
+                                      options.compression, swapBytes)) {
+
+            png_destroy_write_struct(&png_ptr, &info_ptr);
+            return ImportExportCodes::Failure;
+        }
+    } else {
+        png_write_image(png_ptr, rowPointers.rows);
+
+        // Writing is over
+        png_write_end(png_ptr, info_ptr);
+    }
 
     // Free memory
     png_destroy_write_struct(&png_ptr, &info_ptr);
@@ -56,6 +56,8 @@ struct KisPNGOptions {
         , storeMetaData(false)
         , storeAuthor(false)
         , saveAsHDR(false)
+        , parallelCompression(false)
+        , dither(false)
         , transparencyFillColor(Qt::white)
     {}
 
@@ -71,6 +73,8 @@ struct KisPNGOptions {
     bool storeMetaData;
     bool storeAuthor;
     bool saveAsHDR;
+    bool parallelCompression;
+    bool dither;
     QList<const KisMetaData::Filter*> filters;
     QColor transparencyFillColor;
 
@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisMaskingBrushCompositeOpTest.h"
+
+#include <QScopedPointer>
+
+#include <strokes/KisMaskingBrushCompositeOpFactory.h>
+#include <strokes/KisMaskingBrushCompositeOpBase.h>
+
+void KisMaskingBrushCompositeOpTest::testRgba8Ops_data()
+{
+    QTest::addColumn<QString>("id");
+
+    Q_FOREACH (const QString &id, KisMaskingBrushCompositeOpFactory::supportedCompositeOpIds()) {
+        QTest::newRow(id.toLatin1()) << id;
+    }
+}
+
+void KisMaskingBrushCompositeOpTest::testRgba8Ops()
+{
+    QFETCH(QString, id);
+
+    /**
+     * RGBA8 destination may be handled by a vectorized op, so compare
+     * it against the generic op, which is selected when the destination
+     * pixels have some padding in the end
+     */
+    const int columns = 67;
+    const int rows = 3;
+    const int paddedPixelSize = 6;
+
+    QScopedPointer<KisMaskingBrushCompositeOpBase> op(
+        KisMaskingBrushCompositeOpFactory::create(id, KoChannelInfo::UINT8, 4, 3));
+    QScopedPointer<KisMaskingBrushCompositeOpBase> refOp(
+        KisMaskingBrushCompositeOpFactory::create(id, KoChannelInfo::UINT8, paddedPixelSize, 3));
+
+    QVector<quint8> src(columns * rows * 2);
+    QVector<quint8> dst(columns * rows * 4);
+    QVector<quint8> refDst(columns * rows * paddedPixelSize);
+
+    for (int i = 0; i < columns * rows; i++) {
+        src[2 * i] = quint8(i * 37);
+        src[2 * i + 1] = quint8(255 - i * 13);
+
+        for (int ch = 0; ch < 4; ch++) {
+            dst[4 * i + ch] = quint8(i * 23 + ch * 71);
+            refDst[paddedPixelSize * i + ch] = dst[4 * i + ch];
+        }
+    }
+
+    // cover the corner values as well
+    src[0] = 255; src[1] = 255; dst[3] = 0; refDst[3] = 0;
+    src[2] = 0; src[3] = 0; dst[7] = 255; refDst[paddedPixelSize + 3] = 255;
+
+    op->composite(src.constData(), columns * 2, dst.data(), columns * 4, columns, rows);
+    refOp->composite(src.constData(), columns * 2, refDst.data(), columns * paddedPixelSize, columns, rows);
+
+    for (int i = 0; i < columns * rows; i++) {
+        for (int ch = 0; ch < 4; ch++) {
+            if (dst[4 * i + ch] != refDst[paddedPixelSize * i + ch]) {
+                qDebug() << "Failed pixel:" << i << "channel:" << ch
+                         << "result:" << dst[4 * i + ch]
+                         << "expected:" << refDst[paddedPixelSize * i + ch];
+                QFAIL("Masking op result is different from the reference");
+            }
+        }
+    }
+}
+
+QTEST_MAIN(KisMaskingBrushCompositeOpTest)
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisStrokeRecordingTest.h"
+
+#include <QTemporaryDir>
+
+#include "KisStrokeRecording.h"
+
+
+namespace {
+
+void compareInfos(const KisPaintInformation &pi, const KisPaintInformation &ref)
+{
+    QCOMPARE(pi.pos(), ref.pos());
+    QCOMPARE(pi.pressure(), ref.pressure());
+    QCOMPARE(pi.xTilt(), ref.xTilt());
+    QCOMPARE(pi.yTilt(), ref.yTilt());
+    QCOMPARE(pi.rotation(), ref.rotation());
+    QCOMPARE(pi.tangentialPressure(), ref.tangentialPressure());
+    QCOMPARE(pi.perspective(), ref.perspective());
+    QCOMPARE(pi.currentTime(), ref.currentTime());
+    QCOMPARE(pi.drawingSpeed(), ref.drawingSpeed());
+}
+
+}
+
+void KisStrokeRecordingTest::testSaveLoadRoundTrip()
+{
+    /**
+     * The values are not representable exactly in decimal form, so the
+     * recording should keep enough digits to read them back
+     */
+    KisPaintInformation pi1(QPointF(150.0 / 3.0, 500.0 / 7.0), 0.15 + 1e-9, -20.0 / 3.0, 15.0 / 7.0, 0.5, 0.25, 1.0, 0, 0);
+    KisPaintInformation pi2(QPointF(153.6111111, 515.5207447), 1.0 / 3.0, 10.5, -14.8333, 0, 0, 1.0, 5, 3.18705907891582);
+    KisPaintInformation pi3(QPointF(160.0 / 3.0, 546.0 / 7.0), 2.0 / 3.0, 11.0, -13.0, 0, 0, 1.0, 10.5, 2.5);
+
+    KisStrokeRecording ref("b) Basic-5 Size", QPointF(100.0 / 3.0, 50.5), 1.0 / 7.0);
+    ref.addPaintAt(0, 0, pi1);
+    ref.addPaintLine(5, 0, pi1, pi2);
+    ref.addPaintBezierCurve(10, 1, pi2, QPointF(154.0 / 3.0, 520.0 / 7.0), QPointF(-1.25, 1e-5), pi3);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath("stroke.kritastroke");
+
+    QVERIFY(ref.save(fileName));
+
+    KisStrokeRecording recording;
+    QVERIFY(recording.load(fileName));
+
+    QCOMPARE(recording.presetName(), ref.presetName());
+    QCOMPARE(recording.startPos(), ref.startPos());
+    QCOMPARE(recording.startAngle(), ref.startAngle());
+    QCOMPARE(recording.numStrokeInfos(), 2);
+    QCOMPARE(recording.jobs().size(), ref.jobs().size());
+
+    for (int i = 0; i < ref.jobs().size(); i++) {
+        const KisStrokeRecording::Job &job = recording.jobs()[i];
+        const KisStrokeRecording::Job &refJob = ref.jobs()[i];
+
+        QCOMPARE(job.type, refJob.type);
+        QCOMPARE(job.time, refJob.time);
+        QCOMPARE(job.strokeInfoId, refJob.strokeInfoId);
+
+        compareInfos(job.pi1, refJob.pi1);
+
+        if (job.type != KisStrokeRecording::PaintAt) {
+            compareInfos(job.pi2, refJob.pi2);
+        }
+
+        if (job.type == KisStrokeRecording::PaintBezierCurve) {
+            QCOMPARE(job.control1, refJob.control1);
+            QCOMPARE(job.control2, refJob.control2);
+        }
+    }
+
+    // saving the loaded recording again should not lose anything either
+    const QString secondFileName = dir.filePath("stroke2.kritastroke");
+    QVERIFY(recording.save(secondFileName));
+
+    KisStrokeRecording secondRecording;
+    QVERIFY(secondRecording.load(secondFileName));
+    QCOMPARE(secondRecording.jobs().size(), ref.jobs().size());
+    compareInfos(secondRecording.jobs().last().pi2, ref.jobs().last().pi2);
+}
+
+void KisStrokeRecordingTest::testLoadMissingFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    KisStrokeRecording recording;
+    QVERIFY(!recording.load(dir.filePath("missing.kritastroke")));
+    QVERIFY(recording.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(KisStrokeRecordingTest)
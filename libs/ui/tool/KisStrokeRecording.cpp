@@ -0,0 +1,252 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisStrokeRecording.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QDomDocument>
+#include <QFile>
+
+#include <kis_debug.h>
+#include <kis_dom_utils.h>
+
+#include "kis_config.h"
+
+
+namespace {
+
+const int RECORDING_VERSION = 1;
+
+QString jobTypeToString(KisStrokeRecording::JobType type)
+{
+    return type == KisStrokeRecording::PaintAt ? "at" :
+           type == KisStrokeRecording::PaintLine ? "line" : "bezier";
+}
+
+KisStrokeRecording::JobType jobTypeFromString(const QString &str)
+{
+    return str == "at" ? KisStrokeRecording::PaintAt :
+           str == "line" ? KisStrokeRecording::PaintLine :
+                           KisStrokeRecording::PaintBezierCurve;
+}
+
+void savePaintInfo(QDomDocument &doc, QDomElement &parent, const QString &tag, const KisPaintInformation &pi)
+{
+    QDomElement e = doc.createElement(tag);
+    pi.toXML(doc, e);
+    parent.appendChild(e);
+}
+
+}
+
+KisStrokeRecording::KisStrokeRecording()
+{
+}
+
+KisStrokeRecording::KisStrokeRecording(const QString &presetName, const QPointF &startPos, qreal startAngle)
+    : m_presetName(presetName),
+      m_startPos(startPos),
+      m_startAngle(startAngle)
+{
+}
+
+QString KisStrokeRecording::presetName() const
+{
+    return m_presetName;
+}
+
+QPointF KisStrokeRecording::startPos() const
+{
+    return m_startPos;
+}
+
+qreal KisStrokeRecording::startAngle() const
+{
+    return m_startAngle;
+}
+
+void KisStrokeRecording::addPaintAt(int time, int strokeInfoId, const KisPaintInformation &pi)
+{
+    Job job;
+    job.type = PaintAt;
+    job.time = time;
+    job.strokeInfoId = strokeInfoId;
+    job.pi1 = pi;
+    m_jobs.append(job);
+}
+
+void KisStrokeRecording::addPaintLine(int time, int strokeInfoId,
+                                      const KisPaintInformation &pi1,
+                                      const KisPaintInformation &pi2)
+{
+    Job job;
+    job.type = PaintLine;
+    job.time = time;
+    job.strokeInfoId = strokeInfoId;
+    job.pi1 = pi1;
+    job.pi2 = pi2;
+    m_jobs.append(job);
+}
+
+void KisStrokeRecording::addPaintBezierCurve(int time, int strokeInfoId,
+                                             const KisPaintInformation &pi1,
+                                             const QPointF &control1,
+                                             const QPointF &control2,
+                                             const KisPaintInformation &pi2)
+{
+    Job job;
+    job.type = PaintBezierCurve;
+    job.time = time;
+    job.strokeInfoId = strokeInfoId;
+    job.pi1 = pi1;
+    job.pi2 = pi2;
+    job.control1 = control1;
+    job.control2 = control2;
+    m_jobs.append(job);
+}
+
+const QVector<KisStrokeRecording::Job> &KisStrokeRecording::jobs() const
+{
+    return m_jobs;
+}
+
+int KisStrokeRecording::numStrokeInfos() const
+{
+    int maxId = 0;
+    Q_FOREACH (const Job &job, m_jobs) {
+        maxId = qMax(maxId, job.strokeInfoId);
+    }
+    return maxId + 1;
+}
+
+bool KisStrokeRecording::isEmpty() const
+{
+    return m_jobs.isEmpty();
+}
+
+bool KisStrokeRecording::save(const QString &fileName) const
+{
+    QDomDocument doc("kritastroke");
+    QDomElement root = doc.createElement("stroke");
+    root.setAttribute("version", RECORDING_VERSION);
+    root.setAttribute("preset", m_presetName);
+    root.setAttribute("startX", KisDomUtils::toString(m_startPos.x()));
+    root.setAttribute("startY", KisDomUtils::toString(m_startPos.y()));
+    root.setAttribute("startAngle", KisDomUtils::toString(m_startAngle));
+    doc.appendChild(root);
+
+    Q_FOREACH (const Job &job, m_jobs) {
+        QDomElement e = doc.createElement("job");
+        e.setAttribute("type", jobTypeToString(job.type));
+        e.setAttribute("time", job.time);
+        e.setAttribute("strokeInfoId", job.strokeInfoId);
+
+        savePaintInfo(doc, e, "pi1", job.pi1);
+
+        if (job.type != PaintAt) {
+            savePaintInfo(doc, e, "pi2", job.pi2);
+        }
+
+        if (job.type == PaintBezierCurve) {
+            KisDomUtils::saveValue(&e, "control1", job.control1);
+            KisDomUtils::saveValue(&e, "control2", job.control2);
+        }
+
+        root.appendChild(e);
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        warnKrita << "Failed to save stroke recording" << fileName;
+        return false;
+    }
+
+    file.write(doc.toByteArray());
+    return true;
+}
+
+bool KisStrokeRecording::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        warnKrita << "Failed to open stroke recording" << fileName;
+        return false;
+    }
+
+    QDomDocument doc;
+    if (!doc.setContent(&file)) {
+        warnKrita << "Failed to parse stroke recording" << fileName;
+        return false;
+    }
+
+    QDomElement root = doc.documentElement();
+    if (root.tagName() != "stroke" ||
+        KisDomUtils::toInt(root.attribute("version", "0")) > RECORDING_VERSION) {
+
+        warnKrita << "Unsupported stroke recording" << fileName;
+        return false;
+    }
+
+    m_presetName = root.attribute("preset");
+    m_startPos = QPointF(KisDomUtils::toDouble(root.attribute("startX", "0")),
+                         KisDomUtils::toDouble(root.attribute("startY", "0")));
+    m_startAngle = KisDomUtils::toDouble(root.attribute("startAngle", "0"));
+    m_jobs.clear();
+
+    for (QDomElement e = root.firstChildElement("job");
+         !e.isNull();
+         e = e.nextSiblingElement("job")) {
+
+        Job job;
+        job.type = jobTypeFromString(e.attribute("type"));
+        job.time = KisDomUtils::toInt(e.attribute("time", "0"));
+        job.strokeInfoId = KisDomUtils::toInt(e.attribute("strokeInfoId", "0"));
+        job.pi1 = KisPaintInformation::fromXML(e.firstChildElement("pi1"));
+
+        if (job.type != PaintAt) {
+            job.pi2 = KisPaintInformation::fromXML(e.firstChildElement("pi2"));
+        }
+
+        if (job.type == PaintBezierCurve) {
+            KisDomUtils::loadValue(e, "control1", &job.control1);
+            KisDomUtils::loadValue(e, "control2", &job.control2);
+        }
+
+        m_jobs.append(job);
+    }
+
+    return true;
+}
+
+bool KisStrokeRecording::saveToDefaultLocation() const
+{
+    KisConfig cfg(true);
+    QDir dir(cfg.strokeRecordingLocation());
+
+    if (!dir.mkpath(".")) {
+        warnKrita << "Failed to create stroke recording location" << dir.absolutePath();
+        return false;
+    }
+
+    const QString fileName =
+        QString("stroke-%1.kritastroke")
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss-zzz"));
+
+    return save(dir.absoluteFilePath(fileName));
+}
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KISSTROKERECORDING_H
+#define KISSTROKERECORDING_H
+
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+#include <brushengine/kis_paint_information.h>
+
+#include "kritaui_export.h"
+
+/**
+ * A sequence of painting jobs of a single freehand stroke as they were
+ * sent by KisToolFreehandHelper to the stroke strategy, i.e. after the
+ * smoothing and stabilization. Every job keeps the paint information
+ * of the tablet input (pressure, tilt, rotation, speed, time) and the
+ * moment it was issued, so the stroke can be replayed later without a
+ * tablet, e.g. by KisStrokeReplayBenchmark.
+ *
+ * The recording is enabled by KisConfig::enableStrokeRecording(). Every
+ * stroke is saved into a separate file in
+ * KisConfig::strokeRecordingLocation().
+ */
+class KRITAUI_EXPORT KisStrokeRecording
+{
+public:
+    enum JobType {
+        PaintAt,
+        PaintLine,
+        PaintBezierCurve
+    };
+
+    struct Job {
+        JobType type = PaintAt;
+        int strokeInfoId = 0;
+
+        /// the time when the job was issued, in ms since the stroke start
+        int time = 0;
+
+        KisPaintInformation pi1;
+        KisPaintInformation pi2;
+        QPointF control1;
+        QPointF control2;
+    };
+
+public:
+    KisStrokeRecording();
+    KisStrokeRecording(const QString &presetName, const QPointF &startPos, qreal startAngle);
+
+    QString presetName() const;
+    QPointF startPos() const;
+    qreal startAngle() const;
+
+    void addPaintAt(int time, int strokeInfoId, const KisPaintInformation &pi);
+    void addPaintLine(int time, int strokeInfoId,
+                      const KisPaintInformation &pi1,
+                      const KisPaintInformation &pi2);
+    void addPaintBezierCurve(int time, int strokeInfoId,
+                             const KisPaintInformation &pi1,
+                             const QPointF &control1,
+                             const QPointF &control2,
+                             const KisPaintInformation &pi2);
+
+    const QVector<Job>& jobs() const;
+
+    /**
+     * The number of stroke infos the stroke was painted with (more
+     * than one in case of the multihand tool)
+     */
+    int numStrokeInfos() const;
+
+    bool isEmpty() const;
+
+    bool save(const QString &fileName) const;
+    bool load(const QString &fileName);
+
+    /**
+     * Saves the recording into a new file in the location set in the
+     * config
+     */
+    bool saveToDefaultLocation() const;
+
+private:
+    QString m_presetName;
+    QPointF m_startPos;
+    qreal m_startAngle = 0.0;
+    QVector<Job> m_jobs;
+};
+
+#endif // KISSTROKERECORDING_H
@@ -59,6 +59,7 @@
 #include "kis_painting_information_builder.h"
 #include "kis_tool_freehand_helper.h"
 #include "strokes/freehand_stroke.h"
+#include <KisBrushOutlineCache.h>
 
 using namespace std::placeholders; // For _1 placeholder
 
@@ -154,10 +155,17 @@ int KisToolFreehand::flags() const
 void KisToolFreehand::activate(ToolActivation activation, const QSet<KoShape*> &shapes)
 {
     KisToolPaint::activate(activation, shapes);
+
+    // the outlines of big brushes are generated asynchronously
+    connect(KisBrushOutlineCache::instance(), SIGNAL(sigOutlineReady()),
+            SLOT(explicitUpdateOutline()), Qt::UniqueConnection);
 }
 
 void KisToolFreehand::deactivate()
 {
+    disconnect(KisBrushOutlineCache::instance(), SIGNAL(sigOutlineReady()),
+               this, SLOT(explicitUpdateOutline()));
+
     if (mode() == PAINT_MODE) {
         endStroke();
         setMode(KisTool::HOVER_MODE);
@@ -46,6 +46,7 @@
 #include "strokes/freehand_stroke.h"
 #include "strokes/KisFreehandStrokeInfo.h"
 #include "KisAsyncronousStrokeUpdateHelper.h"
+#include "KisStrokeRecording.h"
 #include "kis_canvas_resource_provider.h"
 
 #include <math.h>
@@ -114,6 +115,9 @@ struct KisToolFreehandHelper::Private
     KisStabilizedEventsSampler stabilizedSampler;
     KisStabilizerDelayedPaintHelper stabilizerDelayedPaintHelper;
 
+    // Recording of the stroke jobs, only when enabled in the config
+    QScopedPointer<KisStrokeRecording> recording;
+
     qreal effectiveSmoothnessDistance() const;
 };
 
@@ -309,6 +313,12 @@ void KisToolFreehandHelper::initPaintImpl(qreal startAngle,
 
     m_d->strokeId = m_d->strokesFacade->startStroke(stroke);
 
+    if (KisConfig(true).enableStrokeRecording()) {
+        KisPaintOpPresetSP preset = m_d->resources->currentPaintOpPreset();
+        m_d->recording.reset(new KisStrokeRecording(preset ? preset->name() : QString(),
+                                                    pi.pos(), startAngle));
+    }
+
     m_d->history.clear();
     m_d->distanceHistory.clear();
 
@@ -646,6 +656,13 @@ void KisToolFreehandHelper::endPaint()
 
     m_d->strokesFacade->endStroke(m_d->strokeId);
     m_d->strokeId.clear();
+
+    if (m_d->recording) {
+        if (!m_d->recording->isEmpty()) {
+            m_d->recording->saveToDefaultLocation();
+        }
+        m_d->recording.reset();
+    }
 }
 
 void KisToolFreehandHelper::cancelPaint()
@@ -676,6 +693,8 @@ void KisToolFreehandHelper::cancelPaint()
     m_d->strokesFacade->cancelStroke(m_d->strokeId);
     m_d->strokeId.clear();
 
+    m_d->recording.reset();
+
 }
 
 int KisToolFreehandHelper::elapsedStrokeTime() const
@@ -909,6 +928,10 @@ void KisToolFreehandHelper::paintAt(int strokeInfoId,
     m_d->strokesFacade->addJob(m_d->strokeId,
                                new FreehandStrokeStrategy::Data(strokeInfoId, pi));
 
+    if (m_d->recording) {
+        m_d->recording->addPaintAt(elapsedStrokeTime(), strokeInfoId, pi);
+    }
+
 }
 
 void KisToolFreehandHelper::paintLine(int strokeInfoId,
@@ -919,6 +942,10 @@ void KisToolFreehandHelper::paintLine(int strokeInfoId,
     m_d->strokesFacade->addJob(m_d->strokeId,
                                new FreehandStrokeStrategy::Data(strokeInfoId, pi1, pi2));
 
+    if (m_d->recording) {
+        m_d->recording->addPaintLine(elapsedStrokeTime(), strokeInfoId, pi1, pi2);
+    }
+
 }
 
 void KisToolFreehandHelper::paintBezierCurve(int strokeInfoId,
@@ -956,6 +983,11 @@ void KisToolFreehandHelper::paintBezierCurve(int strokeInfoId,
                                new FreehandStrokeStrategy::Data(strokeInfoId,
                                                                 pi1, control1, control2, pi2));
 
+    if (m_d->recording) {
+        m_d->recording->addPaintBezierCurve(elapsedStrokeTime(), strokeInfoId,
+                                            pi1, control1, control2, pi2);
+    }
+
 }
 
 void KisToolFreehandHelper::createPainters(QVector<KisFreehandStrokeInfo*> &strokeInfos,
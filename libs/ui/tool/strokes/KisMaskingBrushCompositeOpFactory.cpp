@@ -24,6 +24,7 @@
 #include <KoCompositeOpFunctions.h>
 
 #include "KisMaskingBrushCompositeOp.h"
+#include "KisMaskingBrushCompositeOpFactoryImpl.h"
 
 #include <KoConfig.h>
 #ifdef HAVE_OPENEXR
@@ -114,7 +115,13 @@ KisMaskingBrushCompositeOpBase *KisMaskingBrushCompositeOpFactory::create(const
 
     switch (channelType) {
     case KoChannelInfo::UINT8:
-        result = createTypedOp<quint8>(id, pixelSize, alphaOffset);
+        if (pixelSize == 4 && alphaOffset == 3) {
+            result = createOptimizedClass<KisMaskingBrushCompositeOpFactoryImpl>(id);
+        }
+
+        if (!result) {
+            result = createTypedOp<quint8>(id, pixelSize, alphaOffset);
+        }
         break;
     case KoChannelInfo::UINT16:
         result = createTypedOp<quint16>(id, pixelSize, alphaOffset);
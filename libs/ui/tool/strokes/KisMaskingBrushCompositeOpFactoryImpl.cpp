@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisMaskingBrushCompositeOpFactoryImpl.h"
+
+#include <KoCompositeOpRegistry.h>
+
+#include "KisMaskingBrushCompositeOpVector.h"
+
+template<Vc::Implementation _impl>
+KisMaskingBrushCompositeOpBase*
+KisMaskingBrushCompositeOpFactoryImpl::create(ParamType id)
+{
+    KisMaskingBrushCompositeOpBase *result = 0;
+
+#ifdef HAVE_VC
+    /**
+     * The scalar version is handled by the generic templated
+     * op, which supports all the channel types
+     */
+    if (_impl == Vc::ScalarImpl) {
+        return result;
+    }
+
+    if (id == COMPOSITE_MULT) {
+        result = new KisMaskingBrushCompositeOpVector<_impl, KisMaskingVectorOps::Multiply<_impl>>();
+    } else if (id == COMPOSITE_DARKEN) {
+        result = new KisMaskingBrushCompositeOpVector<_impl, KisMaskingVectorOps::Darken<_impl>>();
+    } else if (id == COMPOSITE_LINEAR_BURN) {
+        result = new KisMaskingBrushCompositeOpVector<_impl, KisMaskingVectorOps::LinearBurn<_impl>>();
+    } else if (id == COMPOSITE_LINEAR_DODGE) {
+        result = new KisMaskingBrushCompositeOpVector<_impl, KisMaskingVectorOps::LinearDodge<_impl>>();
+    } else if (id == COMPOSITE_SUBTRACT) {
+        result = new KisMaskingBrushCompositeOpVector<_impl, KisMaskingVectorOps::Subtract<_impl>>();
+    }
+#else
+    Q_UNUSED(id);
+#endif /* HAVE_VC */
+
+    return result;
+}
+
+template KisMaskingBrushCompositeOpBase* KisMaskingBrushCompositeOpFactoryImpl::create<Vc::CurrentImplementation::current()>(ParamType);
@@ -0,0 +1,45 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KISMASKINGBRUSHCOMPOSITEOPFACTORYIMPL_H
+#define KISMASKINGBRUSHCOMPOSITEOPFACTORYIMPL_H
+
+#include <QString>
+#include <compositeops/KoVcMultiArchBuildSupport.h>
+
+class KisMaskingBrushCompositeOpBase;
+
+/**
+ * Creates a vectorized masking op for 8-bit destination color spaces
+ * with four channels and alpha stored in the last one (that is, RGBA8).
+ *
+ * Returns null if there is no vectorized version of the requested op
+ * (or if the scalar implementation is requested), in which case the
+ * caller should fall back to the generic KisMaskingBrushCompositeOp.
+ */
+class KisMaskingBrushCompositeOpFactoryImpl
+{
+public:
+    typedef QString ParamType;
+    typedef KisMaskingBrushCompositeOpBase* ReturnType;
+
+    template<Vc::Implementation _impl>
+    static KisMaskingBrushCompositeOpBase* create(ParamType id);
+};
+
+#endif // KISMASKINGBRUSHCOMPOSITEOPFACTORYIMPL_H
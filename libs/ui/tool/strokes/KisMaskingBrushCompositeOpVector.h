@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KISMASKINGBRUSHCOMPOSITEOPVECTOR_H
+#define KISMASKINGBRUSHCOMPOSITEOPVECTOR_H
+
+#include <compositeops/KoVcMultiArchBuildSupport.h>
+
+#ifdef HAVE_VC
+
+#include <KoGrayColorSpaceTraits.h>
+#include <KoColorSpaceMaths.h>
+#include <KoStreamedMath.h>
+
+#include "KisMaskingBrushCompositeOpBase.h"
+
+/**
+ * Alpha-only versions of the composite functions used by the masking
+ * brush. Every op has a vector and a scalar version, the latter is used
+ * for the pixels that do not fill a full vector. Both versions must
+ * return exactly the same values as the corresponding function used in
+ * KisMaskingBrushCompositeOpFactory for quint8 channels.
+ *
+ * All the ops are templated by the Vc implementation to avoid ODR
+ * violations between the per-arch object files.
+ */
+namespace KisMaskingVectorOps {
+
+template<Vc::Implementation _impl>
+struct Multiply {
+    using uint_v = typename KoStreamedMath<_impl>::uint_v;
+
+    static inline uint_v vector(uint_v src, uint_v dst) {
+        uint_v c = src * dst + 0x80u;
+        return ((c >> 8) + c) >> 8;
+    }
+
+    static inline quint8 scalar(quint8 src, quint8 dst) {
+        return KoColorSpaceMaths<quint8>::multiply(src, dst);
+    }
+};
+
+template<Vc::Implementation _impl>
+struct Darken {
+    using uint_v = typename KoStreamedMath<_impl>::uint_v;
+
+    static inline uint_v vector(uint_v src, uint_v dst) {
+        return Vc::min(src, dst);
+    }
+
+    static inline quint8 scalar(quint8 src, quint8 dst) {
+        return qMin(src, dst);
+    }
+};
+
+template<Vc::Implementation _impl>
+struct LinearBurn {
+    using uint_v = typename KoStreamedMath<_impl>::uint_v;
+
+    static inline uint_v vector(uint_v src, uint_v dst) {
+        const uint_v sum = src + dst;
+        uint_v result = sum - 0xFFu;
+        result.setZero(sum < 0xFFu);
+        return result;
+    }
+
+    static inline quint8 scalar(quint8 src, quint8 dst) {
+        return quint8(qMax(0, int(src) + dst - 0xFF));
+    }
+};
+
+template<Vc::Implementation _impl>
+struct LinearDodge {
+    using uint_v = typename KoStreamedMath<_impl>::uint_v;
+
+    static inline uint_v vector(uint_v src, uint_v dst) {
+        uint_v result = Vc::min(src + dst, uint_v(0xFFu));
+        result.setZero(dst == 0u);
+        return result;
+    }
+
+    static inline quint8 scalar(quint8 src, quint8 dst) {
+        return dst ? quint8(qMin(0xFF, int(src) + dst)) : 0;
+    }
+};
+
+template<Vc::Implementation _impl>
+struct Subtract {
+    using uint_v = typename KoStreamedMath<_impl>::uint_v;
+
+    static inline uint_v vector(uint_v src, uint_v dst) {
+        uint_v result = dst - src;
+        result.setZero(src > dst);
+        return result;
+    }
+
+    static inline quint8 scalar(quint8 src, quint8 dst) {
+        return quint8(qMax(0, int(dst) - src));
+    }
+};
+
+}
+
+/**
+ * A vectorized version of KisMaskingBrushCompositeOp for RGBA8 destination
+ * devices. The mask is stored as GrayA8 pixels, the destination pixels are
+ * processed as 32-bit words with alpha in the highest byte.
+ */
+template<Vc::Implementation _impl, class AlphaOp>
+class KisMaskingBrushCompositeOpVector : public KisMaskingBrushCompositeOpBase
+{
+    using uint_v = typename KoStreamedMath<_impl>::uint_v;
+    using MaskPixel = KoGrayU8Traits::Pixel;
+
+public:
+    void composite(const quint8 *srcRowStart, int srcRowStride,
+                   quint8 *dstRowStart, int dstRowStride,
+                   int columns, int rows) override {
+
+        const int vectorSize = Vc::float_v::size();
+        const int block1 = columns / vectorSize;
+        const int block2 = columns % vectorSize;
+        const quint32 colorChannelsMask = 0x00FFFFFF;
+
+        for (int y = 0; y < rows; y++) {
+            const quint8 *srcPtr = srcRowStart;
+            quint8 *dstPtr = dstRowStart;
+
+            for (int i = 0; i < block1; i++) {
+                const uint_v maskPixels(reinterpret_cast<const quint16*>(srcPtr), Vc::Unaligned);
+                const uint_v mask = multiply(maskPixels & 0xFFu, maskPixels >> 8);
+
+                uint_v dstPixels;
+                dstPixels.load(reinterpret_cast<const quint32*>(dstPtr), Vc::Unaligned);
+
+                const uint_v dstAlpha = AlphaOp::vector(mask, dstPixels >> 24);
+                dstPixels = (dstPixels & colorChannelsMask) | (dstAlpha << 24);
+                dstPixels.store(reinterpret_cast<quint32*>(dstPtr), Vc::Unaligned);
+
+                srcPtr += vectorSize * sizeof(MaskPixel);
+                dstPtr += vectorSize * sizeof(quint32);
+            }
+
+            for (int i = 0; i < block2; i++) {
+                const MaskPixel *srcDataPtr = reinterpret_cast<const MaskPixel*>(srcPtr);
+                const quint8 mask = KoColorSpaceMaths<quint8>::multiply(srcDataPtr->gray, srcDataPtr->alpha);
+
+                quint8 *dstAlphaPtr = dstPtr + 3;
+                *dstAlphaPtr = AlphaOp::scalar(mask, *dstAlphaPtr);
+
+                srcPtr += sizeof(MaskPixel);
+                dstPtr += sizeof(quint32);
+            }
+
+            srcRowStart += srcRowStride;
+            dstRowStart += dstRowStride;
+        }
+    }
+
+private:
+    static inline uint_v multiply(uint_v a, uint_v b) {
+        return KisMaskingVectorOps::Multiply<_impl>::vector(a, b);
+    }
+};
+
+#endif /* HAVE_VC */
+
+#endif // KISMASKINGBRUSHCOMPOSITEOPVECTOR_H
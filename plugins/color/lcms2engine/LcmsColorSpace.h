@@ -24,8 +24,10 @@
 
 #include <colorprofiles/LcmsColorProfileContainer.h>
 #include <KoColorSpaceAbstract.h>
+#include <KoPerChannelLookupTable.h>
 #include <QMutex>
 #include <QMutexLocker>
+#include <type_traits>
 
 #include "kis_assert.h"
 
@@ -87,6 +89,7 @@ class LcmsColorSpace : public KoColorSpaceAbstract<_CSTraits>, public KoLcmsInfo
             : KoColorTransformation()
             , m_colorSpace(colorSpace)
         {
+            isPerChannel = false;
             csProfile = 0;
             cmstransform = 0;
             cmsAlphaTransform = 0;
@@ -149,7 +152,23 @@ class LcmsColorSpace : public KoColorSpaceAbstract<_CSTraits>, public KoLcmsInfo
             }
         }
 
+        bool fetchPerChannelLookupTable(KoPerChannelLookupTable *lut) const override
+        {
+            typedef typename _CSTraits::channels_type channels_type;
+
+            if (!isPerChannel ||
+                !std::is_integral<channels_type>::value ||
+                sizeof(channels_type) > 2) {
+
+                return false;
+            }
+
+            *lut = KoPerChannelLookupTable::fromTransformation(this, sizeof(channels_type), _CSTraits::channels_nb);
+            return !lut->isNull();
+        }
+
         const KoColorSpace *m_colorSpace;
+        bool isPerChannel;
         cmsHPROFILE csProfile;
         cmsHPROFILE profiles[3];
         cmsHTRANSFORM cmstransform;
@@ -347,6 +366,7 @@ public:
                                     cmsBuildGamma(0, 1.0);
 
         KoLcmsColorTransformation *adj = new KoLcmsColorTransformation(this);
+        adj->isPerChannel = true;
         adj->profiles[0] = cmsCreateLinearizationDeviceLink(this->colorSpaceSignature(), transferFunctions);
         adj->profiles[1] = cmsCreateLinearizationDeviceLink(cmsSigGrayData, alphaTransferFunctions);
         adj->profiles[2] = 0;
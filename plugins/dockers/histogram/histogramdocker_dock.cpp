@@ -68,7 +68,9 @@ void HistogramDockerDock::setCanvas(KoCanvasBase * canvas)
 
         m_imageIdleWatcher->setTrackedImage(m_canvas->image());
 
-        connect(m_canvas->image(), SIGNAL(sigImageUpdated(QRect)), this, SLOT(startUpdateCanvasProjection()), Qt::UniqueConnection);
+        m_dirtyRect = m_canvas->image()->bounds();
+
+        connect(m_canvas->image(), SIGNAL(sigImageUpdated(QRect)), this, SLOT(startUpdateCanvasProjection(QRect)), Qt::UniqueConnection);
         connect(m_canvas->image(), SIGNAL(sigColorSpaceChanged(const KoColorSpace*)), this, SLOT(sigColorSpaceChanged(const KoColorSpace*)), Qt::UniqueConnection);
         m_imageIdleWatcher->startCountdown();
     }
@@ -78,11 +80,16 @@ void HistogramDockerDock::unsetCanvas()
 {
     setEnabled(false);
     m_canvas = 0;
+    m_dirtyRect = QRect();
     m_imageIdleWatcher->startCountdown();
 }
 
-void HistogramDockerDock::startUpdateCanvasProjection()
+void HistogramDockerDock::startUpdateCanvasProjection(const QRect &rc)
 {
+    // collect the changes even when hidden, the histogram will
+    // be updated incrementally when the docker is shown again
+    m_dirtyRect |= rc;
+
     if (isVisible()) {
         m_imageIdleWatcher->startCountdown();
     }
@@ -105,6 +112,7 @@ void HistogramDockerDock::sigColorSpaceChanged(const KoColorSpace */*cs*/)
 void HistogramDockerDock::updateHistogram()
 {
     if (isVisible()) {
-        m_histogramWidget->updateHistogram(m_canvas);
+        m_histogramWidget->updateHistogram(m_canvas, m_dirtyRect);
+        m_dirtyRect = QRect();
     }
 }
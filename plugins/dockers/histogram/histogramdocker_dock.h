@@ -42,7 +42,7 @@ public:
     void unsetCanvas() override;
 
 public Q_SLOTS:
-    void startUpdateCanvasProjection();
+    void startUpdateCanvasProjection(const QRect &rc);
     void sigColorSpaceChanged(const KoColorSpace* cs);
     void updateHistogram();
 
@@ -54,6 +54,7 @@ private:
     KisIdleWatcher *m_imageIdleWatcher;
     HistogramDockerWidget *m_histogramWidget;
     QPointer<KisCanvas2> m_canvas;
+    QRect m_dirtyRect;
 };
 
 
@@ -28,13 +28,40 @@
 #include <functional>
 
 #include "KoChannelInfo.h"
+#include "KoHistogramProducer.h"
 #include "kis_paint_device.h"
 #include "KoColorSpace.h"
-#include "kis_iterator_ng.h"
+#include "KisTiledHistogram.h"
 #include "kis_canvas2.h"
 
+namespace {
+
+KisTiledHistogram* createHistogram(const KoColorSpace *cs)
+{
+    KoHistogramProducerFactoryRegistry *registry = KoHistogramProducerFactoryRegistry::instance();
+
+    Q_FOREACH (const QString &id, registry->keysCompatibleWith(cs)) {
+        KoHistogramProducer *producer = registry->get(id)->generate();
+
+        // the widget paints the bins in the order of the channels of the
+        // color space, so the producer must count exactly these channels
+        if (producer && producer->channels().count() == int(cs->channelCount())) {
+            return new KisTiledHistogram(producer);
+        }
+        delete producer;
+    }
+
+    return 0;
+}
+
+}
+
 HistogramDockerWidget::HistogramDockerWidget(QWidget *parent, const char *name, Qt::WindowFlags f)
-    : QLabel(parent, f), m_colorSpace(0), m_smoothHistogram(true)
+    : QLabel(parent, f),
+      m_colorSpace(0),
+      m_smoothHistogram(true),
+      m_computationRunning(false),
+      m_hasPendingUpdate(false)
 {
     setObjectName(name);
 }
@@ -44,33 +71,82 @@ HistogramDockerWidget::~HistogramDockerWidget()
 
 }
 
-void HistogramDockerWidget::updateHistogram(KisCanvas2* canvas)
+void HistogramDockerWidget::updateHistogram(KisCanvas2* canvas, const QRect &dirtyRect)
 {
+    m_canvas = canvas;
+
     if (canvas) {
-        KisPaintDeviceSP paintDevice = canvas->image()->projection();
-        QRect bounds = canvas->image()->bounds();
+        KisImageSP image = canvas->image();
 
-        // remember to save the color space to paint the histogram data!
-        m_colorSpace = paintDevice->colorSpace();
+        if (!m_image.isValid() || m_image != image.data()) {
+            m_image = image;
+            m_histogram.clear();
+        }
 
-        KisPaintDeviceSP m_devClone = new KisPaintDevice(paintDevice->colorSpace());
+        m_pendingDirtyRect |= dirtyRect;
 
-        m_devClone->makeCloneFrom(paintDevice, bounds);
+        if (m_computationRunning) {
+            m_hasPendingUpdate = true;
+            return;
+        }
 
-        HistogramComputationThread *workerThread = new HistogramComputationThread(m_devClone, bounds);
-        connect(workerThread, &HistogramComputationThread::resultReady, this, &HistogramDockerWidget::receiveNewHistogram);
-        connect(workerThread, &HistogramComputationThread::finished, workerThread, &QObject::deleteLater);
-        workerThread->start();
+        startComputation();
     } else {
+        m_image = 0;
+        m_histogram.clear();
+        m_pendingDirtyRect = QRect();
+        m_histogramData.clear();
+        update();
+    }
+}
+
+void HistogramDockerWidget::startComputation()
+{
+    KisImageSP image = m_canvas->image();
+    KisPaintDeviceSP paintDevice = image->projection();
+    QRect bounds = image->bounds();
+
+    if (!m_histogram || m_colorSpace != paintDevice->colorSpace()) {
+        // remember to save the color space to paint the histogram data!
+        m_colorSpace = paintDevice->colorSpace();
+        m_histogram.reset(createHistogram(m_colorSpace));
+        m_pendingDirtyRect = bounds;
+    }
+
+    if (!m_histogram || bounds.isEmpty()) {
         m_histogramData.clear();
         update();
+        return;
     }
+
+    KisPaintDeviceSP m_devClone = new KisPaintDevice(paintDevice->colorSpace());
+
+    m_devClone->makeCloneFrom(paintDevice, bounds);
+
+    HistogramComputationThread *workerThread =
+        new HistogramComputationThread(m_histogram, m_devClone, bounds, m_pendingDirtyRect);
+    connect(workerThread, &HistogramComputationThread::resultReady, this, &HistogramDockerWidget::receiveNewHistogram);
+    connect(workerThread, &HistogramComputationThread::finished, workerThread, &QObject::deleteLater);
+
+    m_pendingDirtyRect = QRect();
+    m_computationRunning = true;
+
+    workerThread->start();
 }
 
 void HistogramDockerWidget::receiveNewHistogram(HistVector *histogramData)
 {
+    m_computationRunning = false;
+
+    if (!m_canvas) return;
+
     m_histogramData = *histogramData;
     update();
+
+    if (m_hasPendingUpdate) {
+        m_hasPendingUpdate = false;
+        updateHistogram(m_canvas, QRect());
+    }
 }
 
 void HistogramDockerWidget::paintEvent(QPaintEvent *event)
@@ -153,40 +229,17 @@ void HistogramDockerWidget::paintEvent(QPaintEvent *event)
 
 void HistogramComputationThread::run()
 {
-    const KoColorSpace *cs = m_dev->colorSpace();
-    quint32 channelCount = m_dev->channelCount();
-    quint32 pixelSize = m_dev->pixelSize();
-
-    quint32 imageSize = m_bounds.width() * m_bounds.height();
-    quint32 nSkip = 1 + (imageSize >> 20); //for speed use about 1M pixels for computing histograms
+    m_histogram->update(m_dev, m_bounds, m_dirtyRect);
 
-    //allocate space for the histogram data
-    bins.resize((int)channelCount);
-    for (auto &bin : bins) {
-        bin.resize(std::numeric_limits<quint8>::max() + 1);
-    }
-
-    QRect bounds = m_dev->exactBounds();
-    if (bounds.isEmpty())
-        return;
+    KoHistogramProducer *producer = m_histogram->producer();
+    const int channelCount = producer->channels().count();
+    const int numberOfBins = producer->numberOfBins();
 
-    quint32 toSkip = nSkip;
-
-    KisSequentialConstIterator it(m_dev, m_dev->exactBounds());
-
-    int numConseqPixels = it.nConseqPixels();
-    while (it.nextPixels(numConseqPixels)) {
-
-        numConseqPixels = it.nConseqPixels();
-        const quint8* pixel = it.rawDataConst();
-        for (int k = 0; k < numConseqPixels; ++k) {
-            if (--toSkip == 0) {
-                for (int chan = 0; chan < (int)channelCount; ++chan) {
-                    bins[chan][cs->scaleToU8(pixel, chan)]++;
-                }
-                toSkip = nSkip;
-            }
-            pixel += pixelSize;
+    bins.resize(channelCount);
+    for (int chan = 0; chan < channelCount; ++chan) {
+        bins[chan].resize(numberOfBins);
+        for (int i = 0; i < numberOfBins; ++i) {
+            bins[chan][i] = producer->getBinAt(chan, i);
         }
     }
 
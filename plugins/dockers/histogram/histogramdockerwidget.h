@@ -24,11 +24,14 @@
 #include <QWidget>
 #include <QLabel>
 #include <QThread>
+#include <QPointer>
+#include <QSharedPointer>
 #include "kis_types.h"
 #include <vector>
 
 class KisCanvas2;
 class KoColorSpace;
+class KisTiledHistogram;
 
 typedef std::vector<std::vector<quint32> > HistVector; //Don't use QVector here - it's too slow for this purpose
 
@@ -37,7 +40,9 @@ class HistogramComputationThread : public QThread
 {
     Q_OBJECT
 public:
-    HistogramComputationThread(KisPaintDeviceSP _dev, const QRect& _bounds) : m_dev(_dev), m_bounds(_bounds)
+    HistogramComputationThread(QSharedPointer<KisTiledHistogram> _histogram,
+                               KisPaintDeviceSP _dev, const QRect& _bounds, const QRect& _dirtyRect)
+        : m_histogram(_histogram), m_dev(_dev), m_bounds(_bounds), m_dirtyRect(_dirtyRect)
     {}
 
     void run() override;
@@ -46,8 +51,10 @@ Q_SIGNALS:
     void resultReady(HistVector*);
 
 private:
+    QSharedPointer<KisTiledHistogram> m_histogram;
     KisPaintDeviceSP m_dev;
     QRect m_bounds;
+    QRect m_dirtyRect;
     HistVector bins;
 };
 
@@ -65,18 +72,31 @@ public Q_SLOTS:
     /**
      * @brief updateHistogram starts calculation of the histogram
      * @param canvas canvas that the calculations must be based on
+     * @param dirtyRect the area of the image that has changed since the
+     *        last update. Only the parts of the histogram covering this
+     *        area are recalculated.
      *
      * Note: don't try to save the paint device of the projection of the image.
      * Paint device of the projection changes in multiple cases, for example
      * Isolate Mode or when opening an image with a single layer.
      */
-    void updateHistogram(KisCanvas2* canvas);
+    void updateHistogram(KisCanvas2* canvas, const QRect &dirtyRect);
     void receiveNewHistogram(HistVector*);
 
+private:
+    void startComputation();
+
 private:
     HistVector m_histogramData;
     const KoColorSpace* m_colorSpace;
     bool m_smoothHistogram;
+
+    QPointer<KisCanvas2> m_canvas;
+    KisImageWSP m_image;
+    QSharedPointer<KisTiledHistogram> m_histogram;
+    QRect m_pendingDirtyRect;
+    bool m_computationRunning;
+    bool m_hasPendingUpdate;
 };
 
 #endif // HISTOGRAMDOCKERWIDGET_H
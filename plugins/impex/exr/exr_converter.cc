@@ -34,6 +34,7 @@
 #include <QMessageBox>
 #include <QDomDocument>
 #include <QThread>
+#include <QtConcurrent>
 
 #include <QFileInfo>
 
@@ -62,6 +63,7 @@
 #include "kis_kra_savexml_visitor.h"
 
 #include <KisImportExportAdditionalChecks.h>
+#include <kis_pointer_utils.h>
 
 // Do not translate!
 #define HDR_LAYER "HDR Layer"
@@ -149,16 +151,6 @@ struct EXRConverter::Private {
 
     QString errorMessage;
 
-    template <class WrapperType>
-    void unmultiplyAlpha(typename WrapperType::pixel_type *pixel);
-
-    template<typename _T_>
-    void decodeData4(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype);
-
-    template<typename _T_>
-    void decodeData1(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype);
-
-
     QDomDocument loadExtraLayersInfo(const Imf::Header &header);
     bool checkExtraLayersInfoConsistent(const QDomDocument &doc, std::set<std::string> exrLayerNames);
     void makeLayerNamesUnique(QList<ExrPaintLayerSaveInfo>& informationObjects);
@@ -173,9 +165,12 @@ EXRConverter::EXRConverter(KisDocument *doc, bool showNotifications)
     d->doc = doc;
     d->showNotifications = showNotifications;
 
-    // Set thread count for IlmImf library
-    Imf::setGlobalThreadCount(QThread::idealThreadCount());
-    dbgFile << "EXR Threadcount was set to: " << QThread::idealThreadCount();
+    // Set thread count for IlmImf library. Resetting it recreates the
+    // thread pool of OpenEXR, so do that only when it really changes
+    if (Imf::globalThreadCount() != QThread::idealThreadCount()) {
+        Imf::setGlobalThreadCount(QThread::idealThreadCount());
+        dbgFile << "EXR Threadcount was set to: " << QThread::idealThreadCount();
+    }
 }
 
 EXRConverter::~EXRConverter()
@@ -316,12 +311,17 @@ struct GrayPixelWrapper
     pixel_type &pixel;
 };
 
+/**
+ * \return true if the alpha channel of the pixel had to be modified
+ */
 template <class WrapperType>
-void EXRConverter::Private::unmultiplyAlpha(typename WrapperType::pixel_type *pixel)
+bool unmultiplyAlpha(typename WrapperType::pixel_type *pixel)
 {
     typedef typename WrapperType::pixel_type pixel_type;
     typedef typename WrapperType::channel_type channel_type;
 
+    bool alphaWasModified = false;
+
     WrapperType srcPixel(*pixel);
 
     if (!srcPixel.checkMultipliedColorsConsistent()) {
@@ -352,6 +352,8 @@ void EXRConverter::Private::unmultiplyAlpha(typename WrapperType::pixel_type *pi
     } else if (srcPixel.alpha() > 0.0) {
         srcPixel.setUnmultiplied(srcPixel.pixel, srcPixel.alpha());
     }
+
+    return alphaWasModified;
 }
 
 template <typename T, typename Pixel, int size, int alphaPos>
@@ -372,115 +374,215 @@ void multiplyAlpha(Pixel *pixel)
     }
 }
 
-template<typename _T_>
-void EXRConverter::Private::decodeData4(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype)
+/**
+ * The height of a tile of the paint devices
+ */
+const int exrTileHeight = 64;
+
+/**
+ * The height of the horizontal strips the EXR files are read and
+ * written in. OpenEXR (de)compresses up to 32 scanlines at once per
+ * thread, so the strip is big enough to give work to all the threads
+ * of its pool. The strip always covers whole rows of tiles and all
+ * the strips of all the layers together take at most 256 MiB.
+ */
+int exrStripHeight(qint64 bytesPerLine)
 {
-    typedef Rgba<_T_> Rgba;
-
-    QVector<Rgba> pixels(width * height);
-
-    bool hasAlpha = info.channelMap.contains("A");
-
-    Imf::FrameBuffer frameBuffer;
-    Rgba* frameBufferData = (pixels.data()) - xstart - ystart * width;
-    frameBuffer.insert(info.channelMap["R"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->r,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    frameBuffer.insert(info.channelMap["G"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->g,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    frameBuffer.insert(info.channelMap["B"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->b,
-                       sizeof(Rgba) * 1,
-                       sizeof(Rgba) * width));
-    if (hasAlpha) {
-        frameBuffer.insert(info.channelMap["A"].toLatin1().constData(),
-                Imf::Slice(ptype, (char *) &frameBufferData->a,
-                           sizeof(Rgba) * 1,
-                           sizeof(Rgba) * width));
-    }
+    const qint64 maxStripBytes = 256 * 1024 * 1024;
 
-    file.setFrameBuffer(frameBuffer);
-    file.readPixels(ystart, height + ystart - 1);
-    Rgba *rgba = pixels.data();
+    qint64 numLines = 32 * QThread::idealThreadCount();
+    numLines = qMin(numLines, maxStripBytes / qMax(bytesPerLine, qint64(1)));
+    numLines = numLines / exrTileHeight * exrTileHeight;
 
-    QRect paintRegion(xstart, ystart, width, height);
-    KisSequentialIterator it(layer->paintDevice(), paintRegion);
-    while (it.nextPixel()) {
-        if (hasAlpha) {
-            unmultiplyAlpha<RgbPixelWrapper<_T_> >(rgba);
-        }
+    return qMax(exrTileHeight, int(numLines));
+}
 
-        typename KoRgbTraits<_T_>::Pixel* dst = reinterpret_cast<typename KoRgbTraits<_T_>::Pixel*>(it.rawData());
+/**
+ * The end of the strip starting at \p ystart. The strips are aligned
+ * to the tile grid of the paint devices, so every tile is written by
+ * a single strip only.
+ */
+int exrStripEnd(int ystart, int yend, int stripHeight)
+{
+    const int tileStart = ystart - ((ystart % exrTileHeight) + exrTileHeight) % exrTileHeight;
+    return qMin(yend, tileStart + stripHeight);
+}
 
-        dst->red = rgba->r;
-        dst->green = rgba->g;
-        dst->blue = rgba->b;
-        if (hasAlpha) {
-            dst->alpha = rgba->a;
-        } else {
-            dst->alpha = 1.0;
-        }
+/**
+ * Decodes the pixels of a single paint layer. All the decoders add
+ * their slices into a common frame buffer, so OpenEXR decompresses
+ * every block of the file only once for all the layers. Then every
+ * decoder copies its strip into the paint device of its layer.
+ */
+class Decoder
+{
+public:
+    Decoder() : m_alphaWasModified(false) {}
+    virtual ~Decoder() {}
+    virtual void prepareFrameBuffer(Imf::FrameBuffer *frameBuffer, int ystart) = 0;
+    virtual void decodeData(int ystart, int numLines) = 0;
 
-        ++rgba;
+    bool alphaWasModified() const {
+        return m_alphaWasModified;
     }
-}
+
+protected:
+    bool m_alphaWasModified;
+};
 
 template<typename _T_>
-void EXRConverter::Private::decodeData1(Imf::InputFile& file, ExrPaintLayerInfo& info, KisPaintLayerSP layer, int width, int xstart, int ystart, int height, Imf::PixelType ptype)
+class RgbDecoder : public Decoder
 {
-    typedef typename GrayPixelWrapper<_T_>::channel_type channel_type;
-    typedef typename GrayPixelWrapper<_T_>::pixel_type pixel_type;
+public:
+    RgbDecoder(const ExrPaintLayerInfo *info, KisPaintDeviceSP device, Imf::PixelType ptype, int xstart, int width, int stripHeight)
+        : m_info(info),
+          m_device(device),
+          m_ptype(ptype),
+          m_xstart(xstart),
+          m_width(width),
+          m_hasAlpha(info->channelMap.contains("A")),
+          m_pixels(width * stripHeight)
+    {
+    }
 
-    KIS_ASSERT_RECOVER_RETURN(
-                layer->paintDevice()->colorSpace()->colorModelId() == GrayAColorModelID);
+    void prepareFrameBuffer(Imf::FrameBuffer *frameBuffer, int ystart) override
+    {
+        Pixel* frameBufferData = (m_pixels.data()) - m_xstart - ystart * m_width;
+        frameBuffer->insert(m_info->channelMap["R"].toLatin1().constData(),
+                Imf::Slice(m_ptype, (char *) &frameBufferData->r,
+                           sizeof(Pixel) * 1,
+                           sizeof(Pixel) * m_width));
+        frameBuffer->insert(m_info->channelMap["G"].toLatin1().constData(),
+                Imf::Slice(m_ptype, (char *) &frameBufferData->g,
+                           sizeof(Pixel) * 1,
+                           sizeof(Pixel) * m_width));
+        frameBuffer->insert(m_info->channelMap["B"].toLatin1().constData(),
+                Imf::Slice(m_ptype, (char *) &frameBufferData->b,
+                           sizeof(Pixel) * 1,
+                           sizeof(Pixel) * m_width));
+        if (m_hasAlpha) {
+            frameBuffer->insert(m_info->channelMap["A"].toLatin1().constData(),
+                    Imf::Slice(m_ptype, (char *) &frameBufferData->a,
+                               sizeof(Pixel) * 1,
+                               sizeof(Pixel) * m_width));
+        }
+    }
+
+    void decodeData(int ystart, int numLines) override
+    {
+        Pixel *rgba = m_pixels.data();
+
+        KisSequentialIterator it(m_device, QRect(m_xstart, ystart, m_width, numLines));
+        while (it.nextPixel()) {
+            if (m_hasAlpha) {
+                m_alphaWasModified |= unmultiplyAlpha<RgbPixelWrapper<_T_> >(rgba);
+            }
 
-    QVector<pixel_type> pixels(width * height);
+            typename KoRgbTraits<_T_>::Pixel* dst = reinterpret_cast<typename KoRgbTraits<_T_>::Pixel*>(it.rawData());
 
-    Q_ASSERT(info.channelMap.contains("G"));
-    dbgFile << "G -> " << info.channelMap["G"];
+            dst->red = rgba->r;
+            dst->green = rgba->g;
+            dst->blue = rgba->b;
+            if (m_hasAlpha) {
+                dst->alpha = rgba->a;
+            } else {
+                dst->alpha = 1.0;
+            }
 
-    bool hasAlpha = info.channelMap.contains("A");
-    dbgFile << "Has Alpha:" << hasAlpha;
+            ++rgba;
+        }
+    }
 
+private:
+    typedef Rgba<_T_> Pixel;
 
-    Imf::FrameBuffer frameBuffer;
-    pixel_type* frameBufferData = (pixels.data()) - xstart - ystart * width;
-    frameBuffer.insert(info.channelMap["G"].toLatin1().constData(),
-            Imf::Slice(ptype, (char *) &frameBufferData->gray,
-                       sizeof(pixel_type) * 1,
-                       sizeof(pixel_type) * width));
+    const ExrPaintLayerInfo *m_info;
+    KisPaintDeviceSP m_device;
+    Imf::PixelType m_ptype;
+    int m_xstart;
+    int m_width;
+    bool m_hasAlpha;
+    QVector<Pixel> m_pixels;
+};
 
-    if (hasAlpha) {
-        frameBuffer.insert(info.channelMap["A"].toLatin1().constData(),
-                Imf::Slice(ptype, (char *) &frameBufferData->alpha,
+template<typename _T_>
+class GrayDecoder : public Decoder
+{
+public:
+    GrayDecoder(const ExrPaintLayerInfo *info, KisPaintDeviceSP device, Imf::PixelType ptype, int xstart, int width, int stripHeight)
+        : m_info(info),
+          m_device(device),
+          m_ptype(ptype),
+          m_xstart(xstart),
+          m_width(width),
+          m_hasAlpha(info->channelMap.contains("A")),
+          m_pixels(width * stripHeight)
+    {
+        KIS_ASSERT_RECOVER_NOOP(device->colorSpace()->colorModelId() == GrayAColorModelID);
+
+        Q_ASSERT(info->channelMap.contains("G"));
+        dbgFile << "G -> " << info->channelMap["G"];
+        dbgFile << "Has Alpha:" << m_hasAlpha;
+    }
+
+    void prepareFrameBuffer(Imf::FrameBuffer *frameBuffer, int ystart) override
+    {
+        pixel_type* frameBufferData = (m_pixels.data()) - m_xstart - ystart * m_width;
+        frameBuffer->insert(m_info->channelMap["G"].toLatin1().constData(),
+                Imf::Slice(m_ptype, (char *) &frameBufferData->gray,
                            sizeof(pixel_type) * 1,
-                           sizeof(pixel_type) * width));
+                           sizeof(pixel_type) * m_width));
+
+        if (m_hasAlpha) {
+            frameBuffer->insert(m_info->channelMap["A"].toLatin1().constData(),
+                    Imf::Slice(m_ptype, (char *) &frameBufferData->alpha,
+                               sizeof(pixel_type) * 1,
+                               sizeof(pixel_type) * m_width));
+        }
     }
 
-    file.setFrameBuffer(frameBuffer);
-    file.readPixels(ystart, height + ystart - 1);
+    void decodeData(int ystart, int numLines) override
+    {
+        pixel_type *srcPtr = m_pixels.data();
+
+        KisSequentialIterator it(m_device, QRect(m_xstart, ystart, m_width, numLines));
+        while (it.nextPixel()) {
+            if (m_hasAlpha) {
+                m_alphaWasModified |= unmultiplyAlpha<GrayPixelWrapper<_T_> >(srcPtr);
+            }
 
-    pixel_type *srcPtr = pixels.data();
+            pixel_type* dstPtr = reinterpret_cast<pixel_type*>(it.rawData());
 
-    QRect paintRegion(xstart, ystart, width, height);
-    KisSequentialIterator it(layer->paintDevice(), paintRegion);
-    do {
+            dstPtr->gray = srcPtr->gray;
+            dstPtr->alpha = m_hasAlpha ? srcPtr->alpha : channel_type(1.0);
 
-        if (hasAlpha) {
-            unmultiplyAlpha<GrayPixelWrapper<_T_> >(srcPtr);
+            ++srcPtr;
         }
+    }
+
+private:
+    typedef typename GrayPixelWrapper<_T_>::channel_type channel_type;
+    typedef typename GrayPixelWrapper<_T_>::pixel_type pixel_type;
 
-        pixel_type* dstPtr = reinterpret_cast<pixel_type*>(it.rawData());
+    const ExrPaintLayerInfo *m_info;
+    KisPaintDeviceSP m_device;
+    Imf::PixelType m_ptype;
+    int m_xstart;
+    int m_width;
+    bool m_hasAlpha;
+    QVector<pixel_type> m_pixels;
+};
 
-        dstPtr->gray = srcPtr->gray;
-        dstPtr->alpha = hasAlpha ? srcPtr->alpha : channel_type(1.0);
+struct DecodeStripJob {
+    DecodeStripJob(int ystart, int numLines) : m_ystart(ystart), m_numLines(numLines) {}
 
-        ++srcPtr;
-    } while (it.nextPixel());
-}
+    inline void operator() (QSharedPointer<Decoder> &decoder) {
+        decoder->decodeData(m_ystart, m_numLines);
+    }
+
+    int m_ystart;
+    int m_numLines;
+};
 
 bool recCheckGroup(const ExrGroupLayerInfo& group, QStringList list, int idx1, int idx2)
 {
@@ -820,7 +922,11 @@ KisImportExportErrorCode EXRConverter::decode(const QString &filename)
             d->image->addNode(info.groupLayer, groupLayerParent);
         }
 
-        // Load the layers
+        // Create the layers and their decoders
+        QVector<QPair<ExrPaintLayerInfo*, KisPaintLayerSP>> layers;
+        QVector<ImageType> layerTypes;
+        qint64 bytesPerLine = 0;
+
         for (int i = informationObjects.size() - 1; i >= 0; --i) {
             ExrPaintLayerInfo& info = informationObjects[i];
             if (info.colorSpace) {
@@ -832,59 +938,105 @@ KisImportExportErrorCode EXRConverter::decode(const QString &filename)
                 }
 
                 layer->setCompositeOpId(COMPOSITE_OVER);
+                layers.append(qMakePair(&info, layer));
 
-                switch (info.channelMap.size()) {
-                case 1:
-                case 2:
-                    // Decode the data
-                    switch (info.imageType) {
-                    case IT_FLOAT16:
-                        d->decodeData1<half>(file, info, layer, width, dx, dy, height, Imf::HALF);
-                        break;
-                    case IT_FLOAT32:
-                        d->decodeData1<float>(file, info, layer, width, dx, dy, height, Imf::FLOAT);
-                        break;
-                    case IT_UNKNOWN:
-                    case IT_UNSUPPORTED:
-                        qFatal("Impossible error");
-                    }
+                const int pixelChannels = info.channelMap.size() <= 2 ? 2 : 4;
+                const int channelSize = info.imageType == IT_FLOAT16 ? 2 : 4;
+                bytesPerLine += qint64(width) * pixelChannels * channelSize;
+            } else {
+                dbgFile << "No decoding " << info.name << " with " << info.channelMap.size() << " channels, and lack of a color space";
+            }
+        }
+
+        const int stripHeight = exrStripHeight(bytesPerLine);
+
+        QVector<QSharedPointer<Decoder>> decoders;
+
+        for (int i = 0; i < layers.size(); i++) {
+            ExrPaintLayerInfo& info = *layers[i].first;
+            KisPaintDeviceSP device = layers[i].second->paintDevice();
+
+            switch (info.channelMap.size()) {
+            case 1:
+            case 2:
+                switch (info.imageType) {
+                case IT_FLOAT16:
+                    decoders.append(toQShared(new GrayDecoder<half>(&info, device, Imf::HALF, dx, width, stripHeight)));
                     break;
-                case 3:
-                case 4:
-                    // Decode the data
-                    switch (info.imageType) {
-                    case IT_FLOAT16:
-                        d->decodeData4<half>(file, info, layer, width, dx, dy, height, Imf::HALF);
-                        break;
-                    case IT_FLOAT32:
-                        d->decodeData4<float>(file, info, layer, width, dx, dy, height, Imf::FLOAT);
-                        break;
-                    case IT_UNKNOWN:
-                    case IT_UNSUPPORTED:
-                        qFatal("Impossible error");
-                    }
+                case IT_FLOAT32:
+                    decoders.append(toQShared(new GrayDecoder<float>(&info, device, Imf::FLOAT, dx, width, stripHeight)));
                     break;
-                default:
-                    qFatal("Invalid number of channels: %i", info.channelMap.size());
+                case IT_UNKNOWN:
+                case IT_UNSUPPORTED:
+                    qFatal("Impossible error");
                 }
-                // Check if should set the channels
-                if (!info.remappedChannels.isEmpty()) {
-                    QList<KisMetaData::Value> values;
-                    Q_FOREACH (const ExrPaintLayerInfo::Remap& remap, info.remappedChannels) {
-                        QMap<QString, KisMetaData::Value> map;
-                        map["original"] = KisMetaData::Value(remap.original);
-                        map["current"] = KisMetaData::Value(remap.current);
-                        values.append(map);
-                    }
-                    layer->metaData()->addEntry(KisMetaData::Entry(KisMetaData::SchemaRegistry::instance()->create("http://krita.org/exrchannels/1.0/" , "exrchannels"), "channelsmap", values));
+                break;
+            case 3:
+            case 4:
+                switch (info.imageType) {
+                case IT_FLOAT16:
+                    decoders.append(toQShared(new RgbDecoder<half>(&info, device, Imf::HALF, dx, width, stripHeight)));
+                    break;
+                case IT_FLOAT32:
+                    decoders.append(toQShared(new RgbDecoder<float>(&info, device, Imf::FLOAT, dx, width, stripHeight)));
+                    break;
+                case IT_UNKNOWN:
+                case IT_UNSUPPORTED:
+                    qFatal("Impossible error");
                 }
-                // Add the layer
-                KisGroupLayerSP groupLayerParent = (info.parent) ? info.parent->groupLayer : d->image->rootLayer();
-                d->image->addNode(layer, groupLayerParent);
-            } else {
-                dbgFile << "No decoding " << info.name << " with " << info.channelMap.size() << " channels, and lack of a color space";
+                break;
+            default:
+                qFatal("Invalid number of channels: %i", info.channelMap.size());
             }
         }
+
+        /**
+         * Decode the data strip by strip. OpenEXR decompresses the
+         * blocks of each strip on its own thread pool, then the
+         * strips of the layers are copied into the paint devices in
+         * parallel. Only one strip per layer is kept in memory.
+         */
+        if (!decoders.isEmpty()) {
+            for (int ystart = dy; ystart < dy + height;) {
+                const int yend = exrStripEnd(ystart, dy + height, stripHeight);
+
+                Imf::FrameBuffer frameBuffer;
+                Q_FOREACH (QSharedPointer<Decoder> decoder, decoders) {
+                    decoder->prepareFrameBuffer(&frameBuffer, ystart);
+                }
+                file.setFrameBuffer(frameBuffer);
+                file.readPixels(ystart, yend - 1);
+
+                QtConcurrent::blockingMap(decoders, DecodeStripJob(ystart, yend - ystart));
+
+                ystart = yend;
+            }
+
+            Q_FOREACH (QSharedPointer<Decoder> decoder, decoders) {
+                d->alphaWasModified |= decoder->alphaWasModified();
+            }
+        }
+
+        // Add the layers
+        for (int i = 0; i < layers.size(); i++) {
+            ExrPaintLayerInfo& info = *layers[i].first;
+            KisPaintLayerSP layer = layers[i].second;
+
+            // Check if should set the channels
+            if (!info.remappedChannels.isEmpty()) {
+                QList<KisMetaData::Value> values;
+                Q_FOREACH (const ExrPaintLayerInfo::Remap& remap, info.remappedChannels) {
+                    QMap<QString, KisMetaData::Value> map;
+                    map["original"] = KisMetaData::Value(remap.original);
+                    map["current"] = KisMetaData::Value(remap.current);
+                    values.append(map);
+                }
+                layer->metaData()->addEntry(KisMetaData::Entry(KisMetaData::SchemaRegistry::instance()->create("http://krita.org/exrchannels/1.0/" , "exrchannels"), "channelsmap", values));
+            }
+            // Add the layer
+            KisGroupLayerSP groupLayerParent = (info.parent) ? info.parent->groupLayer : d->image->rootLayer();
+            d->image->addNode(layer, groupLayerParent);
+        }
         // Set projectionColor to opaque
         d->image->setDefaultProjectionColor(KoColor(Qt::transparent, colorSpace));
 
@@ -953,7 +1105,7 @@ class Encoder
 public:
     virtual ~Encoder() {}
     virtual void prepareFrameBuffer(Imf::FrameBuffer*, int line) = 0;
-    virtual void encodeData(int line) = 0;
+    virtual void encodeData(int line, int numLines) = 0;
 
 };
 
@@ -961,10 +1113,10 @@ template<typename _T_, int size, int alphaPos>
 class EncoderImpl : public Encoder
 {
 public:
-    EncoderImpl(Imf::OutputFile* _file, const ExrPaintLayerSaveInfo* _info, int width) : file(_file), info(_info), pixels(width), m_width(width) {}
+    EncoderImpl(Imf::OutputFile* _file, const ExrPaintLayerSaveInfo* _info, int width, int stripHeight) : file(_file), info(_info), pixels(width * stripHeight), m_width(width) {}
     ~EncoderImpl() override {}
     void prepareFrameBuffer(Imf::FrameBuffer*, int line) override;
-    void encodeData(int line) override;
+    void encodeData(int line, int numLines) override;
 private:
     typedef ExrPixel_<_T_, size> ExrPixel;
     Imf::OutputFile* file;
@@ -988,12 +1140,12 @@ void EncoderImpl<_T_, size, alphaPos>::prepareFrameBuffer(Imf::FrameBuffer* fram
 }
 
 template<typename _T_, int size, int alphaPos>
-void EncoderImpl<_T_, size, alphaPos>::encodeData(int line)
+void EncoderImpl<_T_, size, alphaPos>::encodeData(int line, int numLines)
 {
     ExrPixel *rgba = pixels.data();
-    KisHLineConstIteratorSP it = info->layerDevice->createHLineConstIteratorNG(0, line, m_width);
-    do {
-        const _T_* dst = reinterpret_cast < const _T_* >(it->oldRawData());
+    KisSequentialConstIterator it(info->layerDevice, QRect(0, line, m_width, numLines));
+    while (it.nextPixel()) {
+        const _T_* dst = reinterpret_cast < const _T_* >(it.oldRawData());
 
         for (int i = 0; i < size; ++i) {
             rgba->data[i] = dst[i];
@@ -1004,40 +1156,40 @@ void EncoderImpl<_T_, size, alphaPos>::encodeData(int line)
         }
 
         ++rgba;
-    } while (it->nextPixel());
+    }
 }
 
-Encoder* encoder(Imf::OutputFile& file, const ExrPaintLayerSaveInfo& info, int width)
+Encoder* encoder(Imf::OutputFile& file, const ExrPaintLayerSaveInfo& info, int width, int stripHeight)
 {
     dbgFile << "Create encoder for" << info.name << info.channels << info.layerDevice->colorSpace()->channelCount();
     switch (info.layerDevice->colorSpace()->channelCount()) {
     case 1: {
         if (info.layerDevice->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::HALF);
-            return new EncoderImpl < half, 1, -1 > (&file, &info, width);
+            return new EncoderImpl < half, 1, -1 > (&file, &info, width, stripHeight);
         } else if (info.layerDevice->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::FLOAT);
-            return new EncoderImpl < float, 1, -1 > (&file, &info, width);
+            return new EncoderImpl < float, 1, -1 > (&file, &info, width, stripHeight);
         }
         break;
     }
     case 2: {
         if (info.layerDevice->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::HALF);
-            return new EncoderImpl<half, 2, 1>(&file, &info, width);
+            return new EncoderImpl<half, 2, 1>(&file, &info, width, stripHeight);
         } else if (info.layerDevice->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::FLOAT);
-            return new EncoderImpl<float, 2, 1>(&file, &info, width);
+            return new EncoderImpl<float, 2, 1>(&file, &info, width, stripHeight);
         }
         break;
     }
     case 4: {
         if (info.layerDevice->colorSpace()->colorDepthId() == Float16BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::HALF);
-            return new EncoderImpl<half, 4, 3>(&file, &info, width);
+            return new EncoderImpl<half, 4, 3>(&file, &info, width, stripHeight);
         } else if (info.layerDevice->colorSpace()->colorDepthId() == Float32BitsColorDepthID) {
             Q_ASSERT(info.pixelType == Imf::FLOAT);
-            return new EncoderImpl<float, 4, 3>(&file, &info, width);
+            return new EncoderImpl<float, 4, 3>(&file, &info, width, stripHeight);
         }
         break;
     }
@@ -1047,24 +1199,57 @@ Encoder* encoder(Imf::OutputFile& file, const ExrPaintLayerSaveInfo& info, int w
     return 0;
 }
 
+struct EncodeStripJob {
+    EncodeStripJob(int line, int numLines) : m_line(line), m_numLines(numLines) {}
+
+    inline void operator() (Encoder *encoder) {
+        encoder->encodeData(m_line, m_numLines);
+    }
+
+    int m_line;
+    int m_numLines;
+};
+
 void encodeData(Imf::OutputFile& file, const QList<ExrPaintLayerSaveInfo>& informationObjects, int width, int height)
 {
+    qint64 bytesPerLine = 0;
+    Q_FOREACH (const ExrPaintLayerSaveInfo& info, informationObjects) {
+        bytesPerLine += qint64(width) * info.channels.size() * (info.pixelType == Imf::HALF ? 2 : 4);
+    }
+
+    /**
+     * OpenEXR compresses the line buffers passed to a single
+     * writePixels() call in parallel, so the data is written in big
+     * strips instead of line by line. The strips of all the layers
+     * are filled in parallel as well.
+     */
+    const int stripHeight = exrStripHeight(bytesPerLine);
+
     QList<Encoder*> encoders;
     Q_FOREACH (const ExrPaintLayerSaveInfo& info, informationObjects) {
-        encoders.push_back(encoder(file, info, width));
+        encoders.push_back(encoder(file, info, width, stripHeight));
     }
 
-    for (int y = 0; y < height; ++y) {
-        Imf::FrameBuffer frameBuffer;
-        Q_FOREACH (Encoder* encoder, encoders) {
-            encoder->prepareFrameBuffer(&frameBuffer, y);
-        }
-        file.setFrameBuffer(frameBuffer);
-        Q_FOREACH (Encoder* encoder, encoders) {
-            encoder->encodeData(y);
+    try {
+        for (int y = 0; y < height;) {
+            const int yend = exrStripEnd(y, height, stripHeight);
+
+            Imf::FrameBuffer frameBuffer;
+            Q_FOREACH (Encoder* encoder, encoders) {
+                encoder->prepareFrameBuffer(&frameBuffer, y);
+            }
+            file.setFrameBuffer(frameBuffer);
+
+            QtConcurrent::blockingMap(encoders, EncodeStripJob(y, yend - y));
+
+            file.writePixels(yend - y);
+            y = yend;
         }
-        file.writePixels(1);
+    } catch (...) {
+        qDeleteAll(encoders);
+        throw;
     }
+
     qDeleteAll(encoders);
 }
 
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_exr_benchmark.h"
+
+#include <QTest>
+
+#include  <sdk/tests/testui.h>
+#include <synthetic_image_utils.h>
+
+#include <half.h>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpaceTraits.h>
+
+#include <kis_image.h>
+#include <kis_paint_device.h>
+#include <kis_paint_layer.h>
+#include <kis_sequential_iterator.h>
+#include <KisDocument.h>
+#include <KisPart.h>
+
+namespace {
+
+const QString ExrMimetype = "application/x-extension-exr";
+
+/**
+ * Fills the device with smooth HDR gradients plus some noise and
+ * a few semi-transparent areas, like in a rendered image. Unlike
+ * TestUtil::fillSyntheticContent(), the values go above 1.0 and use
+ * the whole precision of half floats.
+ */
+void fillHdrContent(KisPaintDeviceSP dev, const QRect &rc, int seed)
+{
+    typedef KoRgbTraits<half>::Pixel Pixel;
+    quint32 state = 0x7F4A7C15 ^ seed;
+
+    KisSequentialIterator it(dev, rc);
+    while (it.nextPixel()) {
+        state = state * 1664525 + 1013904223;
+        const float noise = float(state >> 24) / 2550.0f;
+
+        const int x = it.x();
+        const int y = it.y();
+
+        Pixel *pixel = reinterpret_cast<Pixel*>(it.rawData());
+        const float alpha = (x + seed * 512) % 2048 < 1024 ? 1.0f : 0.5f;
+
+        pixel->red = half((float(x) / rc.width() * 4.0f + noise) * alpha);
+        pixel->green = half((float(y) / rc.height() * 2.0f + noise) * alpha);
+        pixel->blue = half((seed * 0.25f + noise) * alpha);
+        pixel->alpha = half(alpha);
+    }
+}
+
+QString benchmarkFilePath(int numLayers)
+{
+    return QString(FILES_OUTPUT_DIR) + '/' + QString("exr_benchmark_%1.exr").arg(numLayers);
+}
+
+bool exportBenchmarkImage(int numLayers, const QString &filePath)
+{
+    const QRect imageRect(0, 0, 4096, 4096);
+
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float16BitsColorDepthID.id(), 0);
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "exr benchmark");
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer%1").arg(i), OPACITY_OPAQUE_U8, cs);
+        fillHdrContent(layer->paintDevice(), imageRect, i);
+        image->addNode(layer);
+    }
+    image->initialRefreshGraph();
+
+    return TestUtil::exportImageSync(image, filePath, ExrMimetype);
+}
+
+}
+
+void KisExrBenchmark::benchmarkExport_data()
+{
+    QTest::addColumn<int>("numLayers");
+
+    QTest::newRow("1 layer") << 1;
+    QTest::newRow("4 layers") << 4;
+}
+
+void KisExrBenchmark::benchmarkExport()
+{
+    QFETCH(int, numLayers);
+
+    QBENCHMARK_ONCE {
+        QVERIFY(exportBenchmarkImage(numLayers, benchmarkFilePath(numLayers)));
+    }
+}
+
+void KisExrBenchmark::benchmarkImport_data()
+{
+    benchmarkExport_data();
+}
+
+void KisExrBenchmark::benchmarkImport()
+{
+    QFETCH(int, numLayers);
+
+    const QString filePath = benchmarkFilePath(numLayers);
+    if (!QFileInfo(filePath).exists()) {
+        QVERIFY(exportBenchmarkImage(numLayers, filePath));
+    }
+
+    QBENCHMARK {
+        QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+        doc->setFileBatchMode(true);
+
+        QVERIFY(doc->importDocument(QUrl::fromLocalFile(filePath)));
+        QVERIFY(doc->image());
+        QCOMPARE(doc->image()->root()->childCount(), quint32(numLayers));
+    }
+}
+
+KISTEST_MAIN(KisExrBenchmark)
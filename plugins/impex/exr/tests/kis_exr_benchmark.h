@@ -0,0 +1,40 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_EXR_BENCHMARK_H
+#define __KIS_EXR_BENCHMARK_H
+
+#include <QtTest>
+
+/**
+ * Measures the export and import of big synthetic multilayered EXR
+ * files, which are streamed strip by strip through OpenEXR
+ */
+class KisExrBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkExport_data();
+    void benchmarkExport();
+
+    void benchmarkImport_data();
+    void benchmarkImport();
+};
+
+#endif /* __KIS_EXR_BENCHMARK_H */
@@ -633,6 +633,24 @@ KisImportExportErrorCode KisJPEGConverter::buildFile(QIODevice *io, KisPaintLaye
         gc.bitBlt(QPoint(0, 0), layer->paintDevice(), QRect(0, 0, width, height));
         gc.end();
 
+        int color_nb_bits = 8 * layer->paintDevice()->pixelSize() / layer->paintDevice()->channelCount();
+
+        if (color_nb_bits == 16 && options.dither) {
+            // reduce the depth of the whole device at once with dithering,
+            // JPEG is 8-bit only and plain rounding shows banding in gradients
+            const KoColorSpace *dstCs =
+                KoColorSpaceRegistry::instance()->colorSpace(cs->colorModelId().id(),
+                                                             Integer8BitsColorDepthID.id(),
+                                                             cs->profile());
+
+            if (dstCs) {
+                dev->convertTo(dstCs,
+                               KoColorConversionTransformation::internalRenderingIntent(),
+                               KoColorConversionTransformation::internalConversionFlags(),
+                               0, KoDitherOp::DitherBlueNoise);
+                color_nb_bits = 8;
+            }
+        }
 
         if (options.saveProfile) {
             const KoColorProfile* colorProfile = layer->colorSpace()->profile();
@@ -643,7 +661,6 @@ KisImportExportErrorCode KisJPEGConverter::buildFile(QIODevice *io, KisPaintLaye
         // Write data information
 
         JSAMPROW row_pointer = new JSAMPLE[width*cinfo.input_components];
-        int color_nb_bits = 8 * layer->paintDevice()->pixelSize() / layer->paintDevice()->channelCount();
 
         for (; cinfo.next_scanline < height;) {
             KisHLineConstIteratorSP it = dev->createHLineConstIteratorNG(0, cinfo.next_scanline, width);
@@ -53,6 +53,7 @@ struct KisJPEGOptions {
     QColor transparencyFillColor;
     bool forceSRGB;
     bool saveProfile;
+    bool dither; //dither 16-bit images when reducing them to 8-bit.
     bool storeDocumentMetaData; //this is for getting the metadata from the document info.
     bool storeAuthor; //this is for storing author data from the document info.
 };
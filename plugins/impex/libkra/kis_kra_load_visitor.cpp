@@ -50,6 +50,7 @@
 #include <kis_group_layer.h>
 #include <kis_adjustment_layer.h>
 #include <filter/kis_filter_configuration.h>
+#include "kis_config.h"
 #include <kis_datamanager.h>
 #include <generator/kis_generator_layer.h>
 #include <kis_pixel_selection.h>
@@ -110,6 +111,7 @@ KisKraLoadVisitor::KisKraLoadVisitor(KisImageSP image,
     , m_keyframeFilenames(keyframeFilenames)
     , m_name(name)
     , m_shapeController(shapeController)
+    , m_lazyLoading(KisConfig(true).lazyLoadKra())
 {
     m_store->pushDirectory();
 
@@ -195,7 +197,7 @@ bool KisKraLoadVisitor::visit(KisPaintLayer *layer)
 {
     loadNodeKeyframes(layer);
 
-    if (!loadPaintDevice(layer->paintDevice(), getLocation(layer))) {
+    if (!loadPaintDevice(layer->paintDevice(), getLocation(layer), !layer->visible())) {
         return false;
     }
     if (!loadProfile(layer->paintDevice(), getLocation(layer, DOT_ICC))) {
@@ -487,22 +489,28 @@ QStringList KisKraLoadVisitor::warningMessages() const
 
 struct SimpleDevicePolicy
 {
+    SimpleDevicePolicy(bool lazy = false)
+        : m_lazy(lazy) {}
+
     bool read(KisPaintDeviceSP dev, QIODevice *stream) {
-        return dev->read(stream);
+        return dev->read(stream, m_lazy);
     }
 
     void setDefaultPixel(KisPaintDeviceSP dev, const KoColor &defaultPixel) const {
         return dev->setDefaultPixel(defaultPixel);
     }
+
+    bool m_lazy;
 };
 
 struct FramedDevicePolicy
 {
-    FramedDevicePolicy(int frameId)
-        :  m_frameId(frameId) {}
+    FramedDevicePolicy(int frameId, bool lazy = false)
+        :  m_frameId(frameId),
+           m_lazy(lazy) {}
 
     bool read(KisPaintDeviceSP dev, QIODevice *stream) {
-        return dev->framesInterface()->readFrame(stream, m_frameId);
+        return dev->framesInterface()->readFrame(stream, m_frameId, m_lazy);
     }
 
     void setDefaultPixel(KisPaintDeviceSP dev, const KoColor &defaultPixel) const {
@@ -510,9 +518,10 @@ struct FramedDevicePolicy
     }
 
     int m_frameId;
+    bool m_lazy;
 };
 
-bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString& location)
+bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString& location, bool hidden)
 {
     // Layer data
     KisPaintDeviceFramesInterface *frameInterface = device->framesInterface();
@@ -523,9 +532,10 @@ bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString&
     }
 
     if (!frameInterface || frames.count() <= 1) {
-        return loadPaintDeviceFrame(device, location, SimpleDevicePolicy());
+        return loadPaintDeviceFrame(device, location, SimpleDevicePolicy(m_lazyLoading && hidden));
     } else {
         KisRasterKeyframeChannel *keyframeChannel = device->keyframeChannel();
+        const int currentFrameId = frameInterface->currentFrameId();
 
         for (int i = 0; i < frames.count(); i++) {
             int id = frames[i];
@@ -537,7 +547,9 @@ bool KisKraLoadVisitor::loadPaintDevice(KisPaintDeviceSP device, const QString&
                 QString frameFilename = getLocation(keyframeChannel->frameFilename(id));
                 Q_ASSERT(!frameFilename.isEmpty());
 
-                if (!loadPaintDeviceFrame(device, frameFilename, FramedDevicePolicy(id))) {
+                const bool lazy = m_lazyLoading && (hidden || id != currentFrameId);
+
+                if (!loadPaintDeviceFrame(device, frameFilename, FramedDevicePolicy(id, lazy))) {
                     m_warningMessages << i18n("Could not load keyframe pixel data for frame %1 in %2.", id, location);
                 }
             }
@@ -71,7 +71,13 @@ public:
 
 private:
 
-    bool loadPaintDevice(KisPaintDeviceSP device, const QString& location);
+    /**
+     * Loads the pixel data of the \p device. If \p hidden is true (the
+     * device belongs to a hidden layer), its data may be kept compressed
+     * until it is accessed for the first time, see KisConfig::lazyLoadKra().
+     * The same happens to all non-current frames of an animated device.
+     */
+    bool loadPaintDevice(KisPaintDeviceSP device, const QString& location, bool hidden = false);
 
     template<class DevicePolicy>
     bool loadPaintDeviceFrame(KisPaintDeviceSP device, const QString &location, DevicePolicy policy);
@@ -107,6 +113,7 @@ private:
     QStringList m_warningMessages;
     KoShapeControllerBase *m_shapeController;
     QMap<QByteArray, const KoColorProfile *> m_profileCache;
+    bool m_lazyLoading;
 };
 
 #endif // KIS_KRA_LOAD_VISITOR_H_
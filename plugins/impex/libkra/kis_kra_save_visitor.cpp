@@ -76,6 +76,7 @@ KisKraSaveVisitor::KisKraSaveVisitor(KoStore *store, const QString & name, QMap<
     , m_name(name)
     , m_nodeFileNames(nodeFileNames)
     , m_writer(new KisStorePaintDeviceWriter(store))
+    , m_previousStore(0)
 {
 }
 
@@ -90,6 +91,12 @@ void KisKraSaveVisitor::setExternalUri(const QString &uri)
     m_uri = uri;
 }
 
+void KisKraSaveVisitor::setIncrementalSource(KoStore *previousStore, const QHash<QUuid, QString> &entries)
+{
+    m_previousStore = previousStore;
+    m_previousEntries = entries;
+}
+
 bool KisKraSaveVisitor::visit(KisExternalLayer * layer)
 {
     bool result = false;
@@ -132,10 +139,29 @@ bool KisKraSaveVisitor::visit(KisExternalLayer * layer)
 
 bool KisKraSaveVisitor::visit(KisPaintLayer *layer)
 {
-    if (!savePaintDevice(layer->paintDevice(), getLocation(layer))) {
+    KisPaintDeviceSP device = layer->paintDevice();
+    const QString location = getLocation(layer);
+
+    bool saved = false;
+
+    if (m_previousStore && m_previousEntries.contains(layer->uuid())) {
+        saved = copyPaintDevice(device, m_previousEntries.value(layer->uuid()), location);
+
+        if (!saved && m_store->bad()) {
+            m_errorMessages << i18n("Failed to copy the pixel data for layer %1.", layer->name());
+            return false;
+        }
+    }
+
+    if (!saved && !savePaintDevice(device, location)) {
         m_errorMessages << i18n("Failed to save the pixel data for layer %1.", layer->name());
         return false;
     }
+
+    if (!device->keyframeChannel()) {
+        m_paintLayerEntries.insert(layer->uuid(), location);
+    }
+
     if (!saveAnnotations(layer)) {
         m_errorMessages << i18n("Failed to save the annotations for layer %1.", layer->name());
         return false;
@@ -317,6 +343,11 @@ QStringList KisKraSaveVisitor::errorMessages() const
     return m_errorMessages;
 }
 
+QHash<QUuid, QString> KisKraSaveVisitor::paintLayerEntries() const
+{
+    return m_paintLayerEntries;
+}
+
 struct SimpleDevicePolicy
 {
     bool write(KisPaintDeviceSP dev, KisPaintDeviceWriter &store) {
@@ -347,9 +378,14 @@ struct FramedDevicePolicy
 bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
                                         QString location)
 {
-    // Layer data
+    /**
+     * Layer data is already LZF-compressed by the tile compressor, so
+     * it is stored as is, unless the user asked for compressed layers
+     */
     KisConfig cfg(true);
-    m_store->setCompressionEnabled(cfg.compressKra());
+    m_store->setCompression(cfg.compressKra() ?
+                            KoStore::CompressionDefault :
+                            KoStore::CompressionStored);
 
     KisPaintDeviceFramesInterface *frameInterface = device->framesInterface();
     QList<int> frames;
@@ -375,11 +411,32 @@ bool KisKraSaveVisitor::savePaintDevice(KisPaintDeviceSP device,
         }
     }
 
-    m_store->setCompressionEnabled(true);
+    m_store->setCompression(KoStore::CompressionDefault);
     return true;
 }
 
 
+bool KisKraSaveVisitor::copyPaintDevice(KisPaintDeviceSP device,
+                                        const QString &sourceLocation,
+                                        const QString &location)
+{
+    /**
+     * The pixel data of the layer has not changed since the previous
+     * save, so just copy the compressed entry from the previous file.
+     * The default pixel is tiny, so we write it in the usual way.
+     */
+    if (!m_store->copyFileFrom(m_previousStore, sourceLocation, location)) {
+        return false;
+    }
+
+    if (m_store->open(location + ".defaultpixel")) {
+        m_store->write((char*)device->defaultPixel().data(), device->colorSpace()->pixelSize());
+        m_store->close();
+    }
+
+    return true;
+}
+
 template<class DevicePolicy>
 bool KisKraSaveVisitor::savePaintDeviceFrame(KisPaintDeviceSP device, QString location, DevicePolicy policy)
 {
@@ -22,6 +22,8 @@
 
 #include <QRect>
 #include <QStringList>
+#include <QHash>
+#include <QUuid>
 
 #include "kis_types.h"
 #include "kis_node_visitor.h"
@@ -41,6 +43,13 @@ public:
 public:
     void setExternalUri(const QString &uri);
 
+    /**
+     * Copy the pixel data of the paint layers listed in \p entries
+     * (node uuid -> entry name) from \p previousStore instead of
+     * encoding their devices once again
+     */
+    void setIncrementalSource(KoStore *previousStore, const QHash<QUuid, QString> &entries);
+
     bool visit(KisNode*) override {
         return true;
     }
@@ -70,9 +79,13 @@ public:
     /// @return a list with everything that went wrong while saving
     QStringList errorMessages() const;
 
+    /// @return the pixel data entries written for the non-animated paint layers
+    QHash<QUuid, QString> paintLayerEntries() const;
+
 private:
 
     bool savePaintDevice(KisPaintDeviceSP device, QString location);
+    bool copyPaintDevice(KisPaintDeviceSP device, const QString &sourceLocation, const QString &location);
 
     template<class DevicePolicy>
     bool savePaintDeviceFrame(KisPaintDeviceSP device, QString location, DevicePolicy policy);
@@ -93,6 +106,9 @@ private:
     QMap<const KisNode*, QString> m_nodeFileNames;
     KisPaintDeviceWriter *m_writer;
     QStringList m_errorMessages;
+    KoStore *m_previousStore;
+    QHash<QUuid, QString> m_previousEntries;
+    QHash<QUuid, QString> m_paintLayerEntries;
 };
 
 #endif // KIS_KRA_SAVE_VISITOR_H_
@@ -71,6 +71,38 @@
 
 using namespace KRA;
 
+namespace {
+
+/**
+ * Open the file written by the previous save of the document, but only
+ * if it is the file we are overwriting now and it has not been touched
+ * by anyone since then
+ */
+KoStore* openIncrementalSaveSource(const KritaUtils::IncrementalSaveSource &source, const QString &filename)
+{
+    if (!source.isValid()) return 0;
+
+    const QFileInfo fileInfo(source.filePath);
+
+    if (fileInfo.absoluteFilePath() != QFileInfo(filename).absoluteFilePath() ||
+        !fileInfo.exists() ||
+        fileInfo.size() != source.fileSize ||
+        fileInfo.lastModified() != source.lastModified) {
+
+        return 0;
+    }
+
+    KoStore *store = KoStore::createStore(source.filePath, KoStore::Read, "", KoStore::Zip);
+    if (store->bad()) {
+        delete store;
+        return 0;
+    }
+
+    return store;
+}
+
+}
+
 struct KisKraSaver::Private
 {
 public:
@@ -250,8 +282,18 @@ bool KisKraSaver::saveBinaryData(KoStore* store, KisImageSP image, const QString
     if (external)
         visitor.setExternalUri(uri);
 
+    const KritaUtils::IncrementalSaveSource incrementalSource = m_d->doc->incrementalSaveSource();
+    QScopedPointer<KoStore> previousStore(openIncrementalSaveSource(incrementalSource, m_d->filename));
+
+    if (previousStore) {
+        visitor.setIncrementalSource(previousStore.data(), incrementalSource.entries);
+    }
+
     image->rootLayer()->accept(visitor);
 
+    previousStore.reset();
+    m_d->doc->setIncrementallySavedEntries(visitor.paintLayerEntries());
+
     m_d->errorMessages.append(visitor.errorMessages());
     if (!m_d->errorMessages.isEmpty()) {
         return false;
@@ -550,4 +550,121 @@ void KisKraSaverTest::testExportToReadonly()
     TestUtil::testExportToReadonly(QString(FILES_DATA_DIR), KraMimetype);
 }
 
+#include <QSignalSpy>
+#include <QRegularExpression>
+#include <quazip.h>
+#include <quazipfileinfo.h>
+#include "kis_config.h"
+
+namespace {
+
+bool saveDocumentAndWait(KisDocument *doc, const QString &fileName)
+{
+    QSignalSpy spy(doc, SIGNAL(sigCompleteBackgroundSaving(KritaUtils::ExportFileJob, KisImportExportErrorCode, QString)));
+
+    if (!doc->saveAs(QUrl::fromLocalFile(fileName), doc->mimeType(), false)) {
+        return false;
+    }
+
+    return !spy.isEmpty() || spy.wait(30000);
+}
+
+/**
+ * Returns the zip compression method of every layer pixel data
+ * entry in \p fileName: 0 for stored, 8 for deflated
+ */
+QList<quint16> layerEntriesCompression(const QString &fileName)
+{
+    QList<quint16> result;
+
+    QuaZip zip(fileName);
+    if (!zip.open(QuaZip::mdUnzip)) return result;
+
+    const QRegularExpression layerEntry("/layers/layer\\d+$");
+
+    for (bool more = zip.goToFirstFile(); more; more = zip.goToNextFile()) {
+        QuaZipFileInfo64 info;
+        if (zip.getCurrentFileInfo(&info) && layerEntry.match(info.name).hasMatch()) {
+            result << info.method;
+        }
+    }
+
+    zip.close();
+    return result;
+}
+
+}
+
+void KisKraSaverTest::testIncrementalSave()
+{
+    KisConfig cfg(false);
+    const bool oldCompressKra = cfg.compressKra();
+    const bool oldIncrementalKraSave = cfg.incrementalKraSave();
+    const bool oldBackupFile = cfg.backupFile();
+
+    cfg.setCompressKra(true);
+    cfg.setIncrementalKraSave(true);
+    cfg.setBackupFile(false);
+
+    QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+
+    const QRect imageRect(0, 0, 256, 256);
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(new KisSurrogateUndoStore(), imageRect.width(), imageRect.height(), cs, "test image");
+
+    QList<QColor> colors;
+    colors << Qt::red << Qt::green << Qt::blue;
+
+    for (int i = 0; i < colors.size(); i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("paint%1").arg(i), OPACITY_OPAQUE_U8);
+        layer->paintDevice()->fill(QRect(20 * i, 30 * i, 100, 100), KoColor(colors[i], cs));
+        image->addNode(layer);
+    }
+
+    doc->setCurrentImage(image);
+
+    const QString fileName = QFileInfo("incremental_save.kra").absoluteFilePath();
+    QFile::remove(fileName);
+
+    QVERIFY(saveDocumentAndWait(doc.data(), fileName));
+    QCOMPARE(layerEntriesCompression(fileName), QList<quint16>() << 8 << 8 << 8);
+
+    KisNodeSP changedNode = TestUtil::findNode(image->root(), "paint1");
+    QVERIFY(changedNode);
+    changedNode->paintDevice()->fill(QRect(150, 150, 50, 50), KoColor(Qt::yellow, cs));
+
+    /**
+     * The changed layer is encoded again with the new compression settings,
+     * while the unchanged ones are copied from the previous file as they are,
+     * so they keep the compression of the first save.
+     */
+    cfg.setCompressKra(false);
+    QVERIFY(saveDocumentAndWait(doc.data(), fileName));
+
+    QList<quint16> methods = layerEntriesCompression(fileName);
+    std::sort(methods.begin(), methods.end());
+    QCOMPARE(methods, QList<quint16>() << 0 << 8 << 8);
+
+    QScopedPointer<KisDocument> doc2(KisPart::instance()->createDocument());
+    QVERIFY(doc2->loadNativeFormat(fileName));
+
+    for (int i = 0; i < colors.size(); i++) {
+        const QString name = QString("paint%1").arg(i);
+
+        KisNodeSP node = TestUtil::findNode(image->root(), name);
+        KisNodeSP node2 = TestUtil::findNode(doc2->image()->root(), name);
+        QVERIFY(node);
+        QVERIFY(node2);
+
+        QPoint errpoint;
+        if (!TestUtil::comparePaintDevices(errpoint, node->paintDevice(), node2->paintDevice())) {
+            QFAIL(QString("Pixels of %1 differ at %2,%3").arg(name).arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+        }
+    }
+
+    cfg.setCompressKra(oldCompressKra);
+    cfg.setIncrementalKraSave(oldIncrementalKraSave);
+    cfg.setBackupFile(oldBackupFile);
+}
+
 KISTEST_MAIN(KisKraSaverTest)
@@ -48,6 +48,8 @@ private Q_SLOTS:
 
     void testExportToReadonly();
 
+    void testIncrementalSave();
+
 };
 
 #endif
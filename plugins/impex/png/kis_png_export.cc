@@ -75,6 +75,8 @@ KisImportExportErrorCode KisPNGExport::convert(KisDocument *document, QIODevice
     options.storeAuthor = configuration->getBool("storeAuthor", false);
     options.storeMetaData = configuration->getBool("storeMetaData", false);
     options.saveAsHDR = configuration->getBool("saveAsHDR", false);
+    options.parallelCompression = configuration->getBool("parallelCompression", true);
+    options.dither = configuration->getBool("dither", false);
 
     vKisAnnotationSP_it beginIt = image->beginAnnotations();
     vKisAnnotationSP_it endIt = image->endAnnotations();
@@ -118,6 +120,8 @@ KisPropertiesConfigurationSP KisPNGExport::defaultConfiguration(const QByteArray
     cfg->setProperty("saveAsHDR", false);
     cfg->setProperty("storeMetaData", false);
     cfg->setProperty("storeAuthor", false);
+    cfg->setProperty("parallelCompression", true);
+    cfg->setProperty("dither", false);
 
     return cfg;
 }
@@ -191,6 +195,8 @@ void KisWdgOptionsPNG::setConfiguration(const KisPropertiesConfigurationSP cfg)
 
     chkAuthor->setChecked(cfg->getBool("storeAuthor", false));
     chkMetaData->setChecked(cfg->getBool("storeMetaData", false));
+    chkParallelCompression->setChecked(cfg->getBool("parallelCompression", true));
+    chkDither->setChecked(cfg->getBool("dither", false));
 
     KoColor background(KoColorSpaceRegistry::instance()->rgb8());
     background.fromQColor(Qt::white);
@@ -212,6 +218,8 @@ KisPropertiesConfigurationSP KisWdgOptionsPNG::configuration() const
     bool forceSRGB = !saveAsHDR && chkForceSRGB->isChecked();
     bool storeAuthor = chkAuthor->isChecked();
     bool storeMetaData = chkMetaData->isChecked();
+    bool parallelCompression = chkParallelCompression->isChecked();
+    bool dither = !saveAsHDR && chkDither->isChecked();
 
 
     QVariant transparencyFillcolor;
@@ -227,6 +235,8 @@ KisPropertiesConfigurationSP KisWdgOptionsPNG::configuration() const
     cfg->setProperty("forceSRGB", forceSRGB);
     cfg->setProperty("storeAuthor", storeAuthor);
     cfg->setProperty("storeMetaData", storeMetaData);
+    cfg->setProperty("parallelCompression", parallelCompression);
+    cfg->setProperty("dither", dither);
 
     return cfg;
 }
@@ -241,6 +251,7 @@ void KisWdgOptionsPNG::slotUseHDRChanged(bool value)
     tryToSaveAsIndexed->setDisabled(value);
     chkForceSRGB->setDisabled(value);
     chkSRGB->setDisabled(value);
+    chkDither->setDisabled(value);
 }
 
 #include "kis_png_export.moc"
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_png_benchmark.h"
+
+#include <QTest>
+#include <QBuffer>
+
+#include  <sdk/tests/testui.h>
+#include <synthetic_image_utils.h>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+
+#include <kis_paint_device.h>
+#include <kis_png_converter.h>
+
+void KisPngBenchmark::benchmarkExport_data()
+{
+    QTest::addColumn<QString>("colorDepthId");
+    QTest::addColumn<bool>("parallelCompression");
+
+    QTest::newRow("8 bit, one thread") << Integer8BitsColorDepthID.id() << false;
+    QTest::newRow("8 bit, parallel") << Integer8BitsColorDepthID.id() << true;
+    QTest::newRow("16 bit, one thread") << Integer16BitsColorDepthID.id() << false;
+    QTest::newRow("16 bit, parallel") << Integer16BitsColorDepthID.id() << true;
+}
+
+void KisPngBenchmark::benchmarkExport()
+{
+    QFETCH(QString, colorDepthId);
+    QFETCH(bool, parallelCompression);
+
+    const QRect imageRect(0, 0, 4096, 4096);
+
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), colorDepthId, 0);
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    TestUtil::fillSyntheticContent(dev, imageRect, 0, 128);
+
+    KisPNGOptions options;
+    options.compression = 3;
+    options.tryToSaveAsIndexed = false;
+    options.parallelCompression = parallelCompression;
+
+    vKisAnnotationSP annotations;
+    QBuffer buffer;
+
+    QBENCHMARK {
+        buffer.setData(QByteArray());
+        buffer.open(QIODevice::WriteOnly);
+
+        KisPNGConverter converter(0, true);
+        QVERIFY(converter.buildFile(&buffer, imageRect, 1.0, 1.0, dev,
+                                    annotations.begin(), annotations.end(),
+                                    options, 0).isOk());
+        buffer.close();
+    }
+}
+
+KISTEST_MAIN(KisPngBenchmark)
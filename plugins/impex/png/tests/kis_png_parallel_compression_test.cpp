@@ -0,0 +1,154 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_png_parallel_compression_test.h"
+
+#include <QTest>
+#include <QBuffer>
+
+#include  <sdk/tests/testui.h>
+#include <synthetic_image_utils.h>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+
+#include <kis_image.h>
+#include <kis_paint_device.h>
+#include <kis_png_converter.h>
+#include <KisDocument.h>
+#include <KisPart.h>
+
+namespace {
+
+/**
+ * Fills the device with an opaque pattern of 16 colors, so that
+ * it is saved as a 4-bit indexed image
+ */
+void fillIndexedContent(KisPaintDeviceSP dev, const QRect &rc)
+{
+    const int pixelSize = dev->pixelSize();
+    QByteArray row(rc.width() * pixelSize, 0);
+
+    for (int y = rc.top(); y <= rc.bottom(); y++) {
+        quint8 *ptr = reinterpret_cast<quint8*>(row.data());
+
+        for (int x = rc.left(); x <= rc.right(); x++) {
+            const int index = (x / 7 + (y / 5) * 3) % 16;
+
+            ptr[0] = quint8(index * 16);
+            ptr[1] = quint8(255 - index * 16);
+            ptr[2] = quint8((index % 4) * 64);
+            ptr[3] = 255;
+            ptr += pixelSize;
+        }
+
+        dev->writeBytes(reinterpret_cast<quint8*>(row.data()), rc.left(), y, rc.width(), 1);
+    }
+}
+
+}
+
+void KisPngParallelCompressionTest::testRoundTrip_data()
+{
+    QTest::addColumn<QString>("colorDepthId");
+    QTest::addColumn<bool>("indexed");
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<int>("expectedBitDepth");
+    QTest::addColumn<int>("expectedColorType");
+
+    /**
+     * All the images have more than 4 MiB of row data, so that they are
+     * compressed in several threads. The 16-bit rows have their bytes
+     * swapped and the indexed rows are never filtered.
+     */
+    QTest::newRow("8 bit") << Integer8BitsColorDepthID.id() << false << QSize(1101, 1001) << 8 << int(PNG_COLOR_TYPE_RGB_ALPHA);
+    QTest::newRow("16 bit") << Integer16BitsColorDepthID.id() << false << QSize(1101, 1001) << 16 << int(PNG_COLOR_TYPE_RGB_ALPHA);
+    QTest::newRow("indexed 4 bit") << Integer8BitsColorDepthID.id() << true << QSize(4097, 2049) << 4 << int(PNG_COLOR_TYPE_PALETTE);
+}
+
+void KisPngParallelCompressionTest::testRoundTrip()
+{
+    QFETCH(QString, colorDepthId);
+    QFETCH(bool, indexed);
+    QFETCH(QSize, size);
+    QFETCH(int, expectedBitDepth);
+    QFETCH(int, expectedColorType);
+
+    const QRect imageRect(QPoint(), size);
+
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), colorDepthId, 0);
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    if (indexed) {
+        fillIndexedContent(dev, imageRect);
+    } else {
+        TestUtil::fillSyntheticContent(dev, imageRect, 0, 128);
+    }
+
+    KisPNGOptions options;
+    options.compression = 3;
+    options.alpha = !indexed;
+    options.tryToSaveAsIndexed = indexed;
+    options.parallelCompression = true;
+
+    vKisAnnotationSP annotations;
+    QBuffer buffer;
+
+    {
+        buffer.open(QIODevice::WriteOnly);
+
+        KisPNGConverter converter(0, true);
+        QVERIFY(converter.buildFile(&buffer, imageRect, 1.0, 1.0, dev,
+                                    annotations.begin(), annotations.end(),
+                                    options, 0).isOk());
+        buffer.close();
+    }
+
+    // the bit depth and the color type are stored right after the size in IHDR
+    const QByteArray data = buffer.data();
+    QVERIFY(data.size() > 26);
+    QCOMPARE(int(quint8(data[24])), expectedBitDepth);
+    QCOMPARE(int(quint8(data[25])), expectedColorType);
+
+    QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+    KisPNGConverter converter(doc.data(), true);
+
+    buffer.open(QIODevice::ReadOnly);
+    QVERIFY(converter.buildImage(&buffer).isOk());
+    buffer.close();
+
+    KisImageSP image = converter.image();
+    QVERIFY(image);
+    QCOMPARE(image->colorSpace()->id(), cs->id());
+    QCOMPARE(image->bounds(), imageRect);
+
+    KisPaintDeviceSP loadedDev = image->root()->firstChild()->paintDevice();
+
+    const int numBytes = imageRect.width() * imageRect.height() * cs->pixelSize();
+    QByteArray expectedBytes(numBytes, 0);
+    QByteArray loadedBytes(numBytes, 0);
+
+    dev->readBytes(reinterpret_cast<quint8*>(expectedBytes.data()), imageRect);
+    loadedDev->readBytes(reinterpret_cast<quint8*>(loadedBytes.data()), imageRect);
+
+    QVERIFY(expectedBytes == loadedBytes);
+}
+
+KISTEST_MAIN(KisPngParallelCompressionTest)
@@ -21,7 +21,11 @@
 #include <QtGlobal>
 #include <QMap>
 #include <QIODevice>
+#include <QThread>
+#include <QtConcurrent>
 
+#include <algorithm>
+#include <vector>
 
 #include <KoColorSpace.h>
 #include <KoColorSpaceMaths.h>
@@ -157,8 +161,12 @@ inline typename Traits::channels_type readChannelValue(const QMap<quint16, QByte
 {
     typedef typename Traits::channels_type channels_type;
 
-    if (channelBytes.contains(channelId)) {
-        const QByteArray &bytes = channelBytes[channelId];
+    // NOTE: operator[] of a const QMap returns a copy of the value,
+    //       which is too expensive to be done for every pixel
+    QMap<quint16, QByteArray>::const_iterator it = channelBytes.constFind(channelId);
+
+    if (it != channelBytes.constEnd()) {
+        const QByteArray &bytes = it.value();
         if (col < bytes.size()) {
             return convertByteOrder<Traits>(reinterpret_cast<const channels_type *>(bytes.constData())[col]);
         }
@@ -391,41 +399,281 @@ psd_status psd_unzip_with_prediction(psd_uchar *src_buf, psd_int src_len,
 /* End of third party block                                           */
 /**********************************************************************/
 
-QMap<quint16, QByteArray> fetchChannelsBytes(QIODevice *io, QVector<ChannelInfo*> channelInfoRecords,
-                                            int row, int width, int channelSize, bool processMasks)
+/**
+ * Decodes a range of rows of a single RLE-compressed channel directly
+ * into a preallocated plane. The compressed rows are stored one after
+ * another, starting at \p src.
+ */
+struct RleRowsDecodingJob {
+    const char *src;
+    const quint32 *rowLengths;
+    char *dst;
+    int numRows;
+    int rowStride;
+};
+
+struct RleRowsDecodingJobWrapper {
+    inline void operator() (const RleRowsDecodingJob &job) {
+        const char *src = job.src;
+        char *dst = job.dst;
+
+        for (int row = 0; row < job.numRows; row++) {
+            // the plane is reused for every strip, so a broken row
+            // should not show the data of the previous one
+            memset(dst, 0, job.rowStride);
+            Compression::unpackBits(src, job.rowLengths[row], dst, job.rowStride);
+
+            src += job.rowLengths[row];
+            dst += job.rowStride;
+        }
+    }
+};
+
+struct ZipChannelDecodingJob {
+    ChannelInfo *info;
+    QByteArray compressedBytes;
+    QByteArray uncompressedBytes;
+    bool result;
+};
+
+struct ZipChannelDecodingJobWrapper {
+    ZipChannelDecodingJobWrapper(Compression::CompressionType compressionType, int width, int channelSize)
+        : m_compressionType(compressionType),
+          m_width(width),
+          m_channelSize(channelSize)
+    {
+    }
+
+    inline void operator() (ZipChannelDecodingJob &job) {
+        if (m_compressionType == Compression::ZIP) {
+            job.result = psd_unzip_without_prediction((quint8*)job.compressedBytes.data(), job.compressedBytes.size(),
+                                                      (quint8*)job.uncompressedBytes.data(), job.uncompressedBytes.size());
+        } else {
+            job.result = psd_unzip_with_prediction((quint8*)job.compressedBytes.data(), job.compressedBytes.size(),
+                                                   (quint8*)job.uncompressedBytes.data(), job.uncompressedBytes.size(),
+                                                   m_width, m_channelSize * 8);
+        }
+
+        // free the compressed data as soon as possible
+        job.compressedBytes = QByteArray();
+    }
+
+    Compression::CompressionType m_compressionType;
+    int m_width;
+    int m_channelSize;
+};
+
+typedef boost::function<void(int, const QMap<quint16, QByteArray>&, int, quint8*)> PixelFunc;
+
+void readZipCommon(KisPaintDeviceSP dev,
+                   QIODevice *io,
+                   const QRect &layerRect,
+                   QVector<ChannelInfo*> infoRecords,
+                   int channelSize,
+                   PixelFunc pixelFunc,
+                   bool processMasks)
 {
-    const int uncompressedLength = width * channelSize;
+    const int numPixels = channelSize * layerRect.width() * layerRect.height();
+
+    QVector<ZipChannelDecodingJob> jobs;
+
+    Q_FOREACH (ChannelInfo *info, infoRecords) {
+        // user supplied masks are ignored here
+        if (!processMasks && info->channelId < -1) continue;
+
+        ZipChannelDecodingJob job;
+        job.info = info;
+        job.result = false;
+
+        io->seek(info->channelDataStart);
+        job.compressedBytes = io->read(info->channelDataLength);
+        job.uncompressedBytes = QByteArray(numPixels, 0);
+
+        jobs.append(job);
+    }
+
+    // the channels are independent zlib streams, so unzip them in parallel
+    ZipChannelDecodingJobWrapper wrapper(infoRecords.first()->compressionType,
+                                         layerRect.width(), channelSize);
+
+    if (jobs.size() > 1) {
+        QtConcurrent::blockingMap(jobs, wrapper);
+    } else {
+        std::for_each(jobs.begin(), jobs.end(), wrapper);
+    }
 
     QMap<quint16, QByteArray> channelBytes;
 
-    Q_FOREACH (ChannelInfo *channelInfo, channelInfoRecords) {
+    Q_FOREACH (const ZipChannelDecodingJob &job, jobs) {
+        ChannelInfo *info = job.info;
+
+        if (!job.result) {
+            QString error = QString("Failed to unzip channel data: id = %1, compression = %2").arg(info->channelId).arg(info->compressionType);
+            dbgFile << "ERROR:" << error;
+            dbgFile << "      " << ppVar(info->channelId);
+            dbgFile << "      " << ppVar(info->channelDataStart);
+            dbgFile << "      " << ppVar(info->channelDataLength);
+            dbgFile << "      " << ppVar(info->compressionType);
+            throw KisAslReaderUtils::ASLParseException(error);
+        }
+
+        channelBytes.insert(info->channelId, job.uncompressedBytes);
+    }
+
+    KisSequentialIterator it(dev, layerRect);
+    int col = 0;
+    while (it.nextPixel()) {
+        pixelFunc(channelSize, channelBytes, col, it.rawData());
+        col++;
+    }
+}
+
+void readRleCommon(KisPaintDeviceSP dev,
+                   QIODevice *io,
+                   const QRect &layerRect,
+                   QVector<ChannelInfo*> infoRecords,
+                   int channelSize,
+                   PixelFunc pixelFunc,
+                   bool processMasks)
+{
+    const int width = layerRect.width();
+    const int height = layerRect.height();
+    const int rowStride = width * channelSize;
+
+    /**
+     * The channels are decoded in horizontal strips, so that huge
+     * layers would not need the whole uncompressed image in memory.
+     * All the planes and compression buffers are allocated once and
+     * reused for every strip.
+     */
+    const int maxStripBytes = 4 * 1024 * 1024;
+    const int stripHeight = qBound(1, maxStripBytes / rowStride, height);
+
+    QVector<ChannelInfo*> channels;
+    Q_FOREACH (ChannelInfo *info, infoRecords) {
         // user supplied masks are ignored here
-        if (!processMasks && channelInfo->channelId < -1) continue;
+        if (!processMasks && info->channelId < -1) continue;
 
-        io->seek(channelInfo->channelDataStart + channelInfo->channelOffset);
+        if (info->compressionType != Compression::Uncompressed &&
+            info->compressionType != Compression::RLE) {
 
-        if (channelInfo->compressionType == Compression::Uncompressed) {
-            channelBytes[channelInfo->channelId] = io->read(uncompressedLength);
-            channelInfo->channelOffset += uncompressedLength;
+            QString error = QString("Unsupported Compression mode: %1").arg(info->compressionType);
+            dbgFile << "ERROR: readRleCommon:" << error;
+            throw KisAslReaderUtils::ASLParseException(error);
         }
-        else if (channelInfo->compressionType == Compression::RLE) {
-            int rleLength = channelInfo->rleRowLengths[row];
-            QByteArray compressedBytes = io->read(rleLength);
-            QByteArray uncompressedBytes = Compression::uncompress(uncompressedLength, compressedBytes, channelInfo->compressionType);
-            channelBytes.insert(channelInfo->channelId, uncompressedBytes);
-            channelInfo->channelOffset += rleLength;
+
+        if (info->compressionType == Compression::RLE &&
+            info->rleRowLengths.size() < height) {
+
+            QString error = QString("Not enough RLE row lengths for channel %1: %2 of %3")
+                .arg(info->channelId).arg(info->rleRowLengths.size()).arg(height);
+            dbgFile << "ERROR: readRleCommon:" << error;
+            throw KisAslReaderUtils::ASLParseException(error);
         }
-        else {
-            QString error = QString("Unsupported Compression mode: %1").arg(channelInfo->compressionType);
-            dbgFile << "ERROR: fetchChannelsBytes:" << error;
+
+        channels.append(info);
+    }
+
+    QMap<quint16, QByteArray> channelBytes;
+    QVector<char*> planes;
+
+    Q_FOREACH (ChannelInfo *info, channels) {
+        // a duplicated channel would overwrite the plane of the previous one
+        if (channelBytes.contains(info->channelId)) {
+            QString error = QString("Duplicated channel id: %1").arg(info->channelId);
+            dbgFile << "ERROR: readRleCommon:" << error;
             throw KisAslReaderUtils::ASLParseException(error);
         }
+
+        channelBytes.insert(info->channelId, QByteArray(stripHeight * rowStride, 0));
+        planes.append(channelBytes[info->channelId].data());
     }
 
-    return channelBytes;
-}
+    std::vector<std::vector<char>> compressedBuffers(channels.size());
 
-typedef boost::function<void(int, const QMap<quint16, QByteArray>&, int, quint8*)> PixelFunc;
+    const int numThreads = QThread::idealThreadCount();
+    const int jobsPerChannel = qMax(1, (2 * numThreads + channels.size() - 1) / qMax(1, channels.size()));
+
+    QVector<RleRowsDecodingJob> jobs;
+
+    KisHLineIteratorSP it = dev->createHLineIteratorNG(layerRect.left(), layerRect.top(), width);
+
+    for (int stripStart = 0; stripStart < height; stripStart += stripHeight) {
+        const int numRows = qMin(stripHeight, height - stripStart);
+        jobs.clear();
+
+        for (int i = 0; i < channels.size(); i++) {
+            ChannelInfo *info = channels[i];
+
+            io->seek(info->channelDataStart + info->channelOffset);
+
+            if (info->compressionType == Compression::Uncompressed) {
+                const qint64 stripLength = qint64(numRows) * rowStride;
+                const qint64 bytesRead = io->read(planes[i], stripLength);
+
+                if (bytesRead < stripLength) {
+                    memset(planes[i] + qMax(bytesRead, qint64(0)), 0, stripLength - qMax(bytesRead, qint64(0)));
+                }
+
+                info->channelOffset += stripLength;
+
+            } else {
+                const quint32 *rowLengths = info->rleRowLengths.constData() + stripStart;
+
+                qint64 stripLength = 0;
+                for (int row = 0; row < numRows; row++) {
+                    stripLength += rowLengths[row];
+                }
+
+                std::vector<char> &buffer = compressedBuffers[i];
+                if (qint64(buffer.size()) < stripLength) {
+                    buffer.resize(stripLength);
+                }
+
+                const qint64 bytesRead = io->read(buffer.data(), stripLength);
+                if (bytesRead < stripLength) {
+                    memset(buffer.data() + qMax(bytesRead, qint64(0)), 0, stripLength - qMax(bytesRead, qint64(0)));
+                }
+
+                info->channelOffset += stripLength;
+
+                // split the strip into jobs of several rows each
+                const int rowsPerJob = qMax(1, (numRows + jobsPerChannel - 1) / jobsPerChannel);
+                const char *src = buffer.data();
+
+                for (int row = 0; row < numRows; row += rowsPerJob) {
+                    RleRowsDecodingJob job;
+                    job.src = src;
+                    job.rowLengths = rowLengths + row;
+                    job.dst = planes[i] + row * rowStride;
+                    job.numRows = qMin(rowsPerJob, numRows - row);
+                    job.rowStride = rowStride;
+                    jobs.append(job);
+
+                    for (int j = 0; j < job.numRows; j++) {
+                        src += job.rowLengths[j];
+                    }
+                }
+            }
+        }
+
+        if (jobs.size() > 1) {
+            QtConcurrent::blockingMap(jobs, RleRowsDecodingJobWrapper());
+        } else {
+            std::for_each(jobs.begin(), jobs.end(), RleRowsDecodingJobWrapper());
+        }
+
+        for (int row = 0; row < numRows; row++) {
+            const int rowOffset = row * width;
+
+            for (int col = 0; col < width; col++) {
+                pixelFunc(channelSize, channelBytes, rowOffset + col, it->rawData());
+                it->nextPixel();
+            }
+            it->nextRow();
+        }
+    }
+}
 
 void readCommon(KisPaintDeviceSP dev,
                 QIODevice *io,
@@ -445,60 +693,9 @@ void readCommon(KisPaintDeviceSP dev,
     if (infoRecords.first()->compressionType == Compression::ZIP ||
         infoRecords.first()->compressionType == Compression::ZIPWithPrediction) {
 
-        const int numPixels = channelSize * layerRect.width() * layerRect.height();
-
-        QMap<quint16, QByteArray> channelBytes;
-
-        Q_FOREACH (ChannelInfo *info, infoRecords) {
-            io->seek(info->channelDataStart);
-            QByteArray compressedBytes = io->read(info->channelDataLength);
-            QByteArray uncompressedBytes(numPixels, 0);
-
-            bool status = false;
-            if (infoRecords.first()->compressionType == Compression::ZIP) {
-                status = psd_unzip_without_prediction((quint8*)compressedBytes.data(), compressedBytes.size(),
-                                                      (quint8*)uncompressedBytes.data(), uncompressedBytes.size());
-            } else {
-                status = psd_unzip_with_prediction((quint8*)compressedBytes.data(), compressedBytes.size(),
-                                                   (quint8*)uncompressedBytes.data(), uncompressedBytes.size(),
-                                                   layerRect.width(), channelSize * 8);
-            }
-
-            if (!status) {
-                QString error = QString("Failed to unzip channel data: id = %1, compression = %2").arg(info->channelId).arg(info->compressionType);
-                dbgFile << "ERROR:" << error;
-                dbgFile << "      " << ppVar(info->channelId);
-                dbgFile << "      " << ppVar(info->channelDataStart);
-                dbgFile << "      " << ppVar(info->channelDataLength);
-                dbgFile << "      " << ppVar(info->compressionType);
-                throw KisAslReaderUtils::ASLParseException(error);
-            }
-
-            channelBytes.insert(info->channelId, uncompressedBytes);
-        }
-
-        KisSequentialIterator it(dev, layerRect);
-        int col = 0;
-        while (it.nextPixel()) {
-            pixelFunc(channelSize, channelBytes, col, it.rawData());
-            col++;
-        }
-
+        readZipCommon(dev, io, layerRect, infoRecords, channelSize, pixelFunc, processMasks);
     } else {
-        KisHLineIteratorSP it = dev->createHLineIteratorNG(layerRect.left(), layerRect.top(), layerRect.width());
-        for (int i = 0 ; i < layerRect.height(); i++) {
-            QMap<quint16, QByteArray> channelBytes;
-
-            channelBytes = fetchChannelsBytes(io, infoRecords,
-                                              i, layerRect.width(),
-                                              channelSize, processMasks);
-
-            for (qint64 col = 0; col < layerRect.width(); col++){
-                pixelFunc(channelSize, channelBytes, col, it->rawData());
-                it->nextPixel();
-            }
-            it->nextRow();
-        }
+        readRleCommon(dev, io, layerRect, infoRecords, channelSize, pixelFunc, processMasks);
     }
 }
 
@@ -543,6 +740,30 @@ void readAlphaMaskChannels(QIODevice *io,
     readCommon(device, io, layerRect, infoRecords, channelSize, &readAlphaMaskPixelCommon, true);
 }
 
+/**
+ * Encodes a range of rows of a plane with PackBits. Every row gets its
+ * own preallocated slot of \p dstRowStride bytes in the destination
+ * buffer, so the jobs never touch each other's memory.
+ */
+struct RleRowsEncodingJob {
+    const char *src;
+    char *dst;
+    quint32 *rowLengths;
+    int numRows;
+    int rowStride;
+    int dstRowStride;
+};
+
+struct RleRowsEncodingJobWrapper {
+    inline void operator() (const RleRowsEncodingJob &job) {
+        for (int row = 0; row < job.numRows; row++) {
+            job.rowLengths[row] =
+                Compression::packBits(job.src + row * job.rowStride, job.rowStride,
+                                      job.dst + row * job.dstRowStride);
+        }
+    }
+};
+
 void writeChannelDataRLE(QIODevice *io, const quint8 *plane, const int channelSize, const QRect &rc, const qint64 sizeFieldOffset, const qint64 rleBlockOffset, const bool writeCompressionType)
 {
     typedef KisAslWriterUtils::OffsetStreamPusher<quint32> Pusher;
@@ -555,10 +776,41 @@ void writeChannelDataRLE(QIODevice *io, const quint8 *plane, const int channelSi
         SAFE_WRITE_EX(io, (quint16)Compression::RLE);
     }
 
-    const bool externalRleBlock = rleBlockOffset >= 0;
+    const int numRows = rc.height();
+    const int stride = channelSize * rc.width();
+    const int packedStride = Compression::packBitsMaxSize(stride);
+
+    /**
+     * Compress all the rows in parallel before writing anything, then
+     * the sizes block can be written in one go without seeking back
+     * and forth for every row.
+     */
+    QVector<quint32> rowLengths(numRows);
+    std::vector<char> packedRows(size_t(packedStride) * numRows);
+
+    {
+        const int rowsPerJob = qMax(1, numRows / (4 * QThread::idealThreadCount()));
+
+        QVector<RleRowsEncodingJob> jobs;
+        for (int row = 0; row < numRows; row += rowsPerJob) {
+            RleRowsEncodingJob job;
+            job.src = reinterpret_cast<const char*>(plane) + qint64(row) * stride;
+            job.dst = packedRows.data() + qint64(row) * packedStride;
+            job.rowLengths = rowLengths.data() + row;
+            job.numRows = qMin(rowsPerJob, numRows - row);
+            job.rowStride = stride;
+            job.dstRowStride = packedStride;
+            jobs.append(job);
+        }
 
-    // the start of RLE sizes block
-    const qint64 channelRLESizePos = externalRleBlock ? rleBlockOffset : io->pos();
+        if (jobs.size() > 1) {
+            QtConcurrent::blockingMap(jobs, RleRowsEncodingJobWrapper());
+        } else {
+            std::for_each(jobs.begin(), jobs.end(), RleRowsEncodingJobWrapper());
+        }
+    }
+
+    const bool externalRleBlock = rleBlockOffset >= 0;
 
     {
         QScopedPointer<KisOffsetKeeper> rleOffsetKeeper;
@@ -568,23 +820,18 @@ void writeChannelDataRLE(QIODevice *io, const quint8 *plane, const int channelSi
             io->seek(rleBlockOffset);
         }
 
-        // write zero's for the channel lengths block
-        for(int i = 0; i < rc.height(); ++i) {
+        // write the channel lengths block
+        for (int row = 0; row < numRows; ++row) {
             // XXX: choose size for PSB!
-            const quint16 fakeRLEBLockSize = 0;
-            SAFE_WRITE_EX(io, fakeRLEBLockSize);
+            const quint16 rleBlockSize = rowLengths[row];
+            SAFE_WRITE_EX(io, rleBlockSize);
         }
     }
 
-    quint32 stride = channelSize * rc.width();
-    for (qint32 row = 0; row < rc.height(); ++row) {
-
-        QByteArray uncompressed = QByteArray::fromRawData((const char*)plane + row * stride, stride);
-        QByteArray compressed = Compression::compress(uncompressed, Compression::RLE);
-
-        KisAslWriterUtils::OffsetStreamPusher<quint16> rleExternalTag(io, 0, channelRLESizePos + row * sizeof(quint16));
+    for (int row = 0; row < numRows; ++row) {
+        const char *compressed = packedRows.data() + qint64(row) * packedStride;
 
-        if (io->write(compressed) != compressed.size()) {
+        if (io->write(compressed, rowLengths[row]) != rowLengths[row]) {
             throw KisAslWriterUtils::ASLWriteException("Failed to write image data");
         }
     }
@@ -75,6 +75,36 @@ void CompressionTest::testCompressionZIP()
 }
 
 
+void CompressionTest::testPackBitsPreallocated()
+{
+    QVector<QByteArray> samples;
+    samples << QByteArray("Twee eeee aaaaa asdasda47892347981    wwwwwwwwwwwwWWWWWWWWWW");
+    samples << QByteArray(1000, 'a');
+    samples << QByteArray("a");
+    samples << QByteArray("ab");
+
+    // the worst case: no repeated bytes at all
+    QByteArray distinct;
+    for (int i = 0; i < 1000; ++i) {
+        distinct.append(char(i % 251));
+    }
+    samples << distinct;
+    samples << distinct.left(129) << distinct.left(130);
+
+    Q_FOREACH (const QByteArray &ba, samples) {
+        QByteArray packed(Compression::packBitsMaxSize(ba.size()), 0);
+        const quint32 packedLength = Compression::packBits(ba.constData(), ba.size(), packed.data());
+        QVERIFY(packedLength <= Compression::packBitsMaxSize(ba.size()));
+
+        // should be compatible with the allocating version of the codec
+        QCOMPARE(packed.left(packedLength), Compression::compress(ba, Compression::RLE));
+
+        QByteArray unpacked(ba.size(), 0);
+        Compression::unpackBits(packed.constData(), packedLength, unpacked.data(), ba.size());
+        QCOMPARE(unpacked, ba);
+    }
+}
+
 void CompressionTest::testCompressionUncompressed()
 {
     QByteArray ba("Twee eeee aaaaa asdasda47892347981    wwwwwwwwwwwwWWWWWWWWWW");
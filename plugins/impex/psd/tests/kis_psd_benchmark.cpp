@@ -0,0 +1,156 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_psd_benchmark.h"
+
+#include <QTest>
+
+#include  <sdk/tests/testui.h>
+#include <synthetic_image_utils.h>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+
+#include <compression.h>
+#include <kis_image.h>
+#include <kis_paint_device.h>
+#include <KisDocument.h>
+#include <KisPart.h>
+#include <KisImportExportManager.h>
+#include <KisImportExportErrorCode.h>
+
+namespace {
+
+const QString PSDMimetype = "image/vnd.adobe.photoshop";
+
+QString benchmarkFilePath(int channelDepth, int numLayers)
+{
+    return QString(FILES_OUTPUT_DIR) + '/' + QString("psd_benchmark_%1bit_%2.psd").arg(channelDepth).arg(numLayers);
+}
+
+bool exportBenchmarkImage(int channelDepth, int numLayers, const QString &filePath)
+{
+    const QRect imageRect(0, 0, 4096, 4096);
+
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(),
+                                                     channelDepth == 8 ? Integer8BitsColorDepthID.id() : Integer16BitsColorDepthID.id(),
+                                                     0);
+    KisImageSP image = TestUtil::createSyntheticImage(cs, imageRect, numLayers, OPACITY_TRANSPARENT_U8);
+
+    return TestUtil::exportImageSync(image, filePath, PSDMimetype);
+}
+
+}
+
+void KisPsdBenchmark::benchmarkRleCodec_data()
+{
+    QTest::addColumn<bool>("allocationFree");
+
+    QTest::newRow("qbytearray") << false;
+    QTest::newRow("preallocated") << true;
+}
+
+void KisPsdBenchmark::benchmarkRleCodec()
+{
+    QFETCH(bool, allocationFree);
+
+    const QRect rc(0, 0, 4096, 4096);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    TestUtil::fillSyntheticContent(dev, rc, 0, OPACITY_TRANSPARENT_U8);
+
+    // use a single channel of the device as a plane
+    QVector<quint8*> planes = dev->readPlanarBytes(rc.x(), rc.y(), rc.width(), rc.height());
+    const char *plane = reinterpret_cast<const char*>(planes[0]);
+    const int stride = rc.width();
+
+    QByteArray packed(Compression::packBitsMaxSize(stride), 0);
+    QByteArray unpacked(stride, 0);
+
+    QBENCHMARK {
+        for (int row = 0; row < rc.height(); row++) {
+            const char *src = plane + row * stride;
+
+            if (allocationFree) {
+                const quint32 packedLength = Compression::packBits(src, stride, packed.data());
+                Compression::unpackBits(packed.constData(), packedLength, unpacked.data(), stride);
+                QVERIFY(memcmp(src, unpacked.constData(), stride) == 0);
+            } else {
+                QByteArray compressed = Compression::compress(QByteArray::fromRawData(src, stride), Compression::RLE);
+                QByteArray uncompressed = Compression::uncompress(stride, compressed, Compression::RLE);
+                QVERIFY(memcmp(src, uncompressed.constData(), stride) == 0);
+            }
+        }
+    }
+
+    Q_FOREACH (quint8 *ptr, planes) {
+        delete[] ptr;
+    }
+}
+
+void KisPsdBenchmark::benchmarkExport_data()
+{
+    QTest::addColumn<int>("channelDepth");
+    QTest::addColumn<int>("numLayers");
+
+    QTest::newRow("8bit, 1 layer") << 8 << 1;
+    QTest::newRow("8bit, 8 layers") << 8 << 8;
+    QTest::newRow("16bit, 4 layers") << 16 << 4;
+}
+
+void KisPsdBenchmark::benchmarkExport()
+{
+    QFETCH(int, channelDepth);
+    QFETCH(int, numLayers);
+
+    QBENCHMARK_ONCE {
+        QVERIFY(exportBenchmarkImage(channelDepth, numLayers, benchmarkFilePath(channelDepth, numLayers)));
+    }
+}
+
+void KisPsdBenchmark::benchmarkImport_data()
+{
+    benchmarkExport_data();
+}
+
+void KisPsdBenchmark::benchmarkImport()
+{
+    QFETCH(int, channelDepth);
+    QFETCH(int, numLayers);
+
+    const QString filePath = benchmarkFilePath(channelDepth, numLayers);
+    if (!QFileInfo(filePath).exists()) {
+        QVERIFY(exportBenchmarkImage(channelDepth, numLayers, filePath));
+    }
+
+    QBENCHMARK {
+        QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+
+        KisImportExportManager manager(doc.data());
+        doc->setFileBatchMode(true);
+
+        KisImportExportErrorCode status = manager.importDocument(filePath, QString());
+        QVERIFY(status.isOk());
+        QVERIFY(doc->image());
+        QCOMPARE(doc->image()->root()->childCount(), quint32(numLayers));
+    }
+}
+
+KISTEST_MAIN(KisPsdBenchmark)
@@ -0,0 +1,43 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __KIS_PSD_BENCHMARK_H
+#define __KIS_PSD_BENCHMARK_H
+
+#include <QtTest>
+
+/**
+ * Measures the PackBits codec alone and the import/export of a big
+ * synthetic multilayered PSD file
+ */
+class KisPsdBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkRleCodec_data();
+    void benchmarkRleCodec();
+
+    void benchmarkExport_data();
+    void benchmarkExport();
+
+    void benchmarkImport_data();
+    void benchmarkImport();
+};
+
+#endif /* __KIS_PSD_BENCHMARK_H */
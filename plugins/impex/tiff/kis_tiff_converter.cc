@@ -25,6 +25,8 @@
 #include <QApplication>
 
 #include <QFileInfo>
+#include <QThread>
+#include <QtConcurrent>
 
 #include <KoDocumentInfo.h>
 #include <KoUnit.h>
@@ -199,6 +201,182 @@ QPair<QString, QString> getColorSpaceForColorType(uint16 sampletype, uint16 colo
     }
     return QPair<QString, QString>();
 }
+
+/**
+ * The geometry of the strips or tiles of a TIFF directory with
+ * contiguous (interleaved) samples. Both strips and tiles are called
+ * "chunks" here, strips are just chunks as wide as the image.
+ */
+struct ContiguousChunksLayout {
+    bool isTiled;
+    uint32 chunkWidth;
+    uint32 chunkHeight;
+    tsize_t lineSize;
+    tsize_t chunkSize;
+    quint32 chunksPerRow;
+    quint32 numChunks;
+};
+
+bool fetchContiguousChunksLayout(TIFF *image, uint32 width, uint32 height, ContiguousChunksLayout *layout)
+{
+    layout->isTiled = TIFFIsTiled(image);
+
+    if (layout->isTiled) {
+        TIFFGetField(image, TIFFTAG_TILEWIDTH, &layout->chunkWidth);
+        TIFFGetField(image, TIFFTAG_TILELENGTH, &layout->chunkHeight);
+        layout->lineSize = TIFFTileRowSize(image);
+        layout->chunkSize = TIFFTileSize(image);
+    } else {
+        layout->chunkWidth = width;
+        TIFFGetFieldDefaulted(image, TIFFTAG_ROWSPERSTRIP, &layout->chunkHeight);
+        layout->chunkHeight = qMin(layout->chunkHeight, height);
+        layout->lineSize = TIFFScanlineSize(image);
+        layout->chunkSize = TIFFStripSize(image);
+    }
+
+    if (!layout->chunkWidth || !layout->chunkHeight || layout->lineSize <= 0 || layout->chunkSize <= 0) {
+        return false;
+    }
+
+    layout->chunksPerRow = (width + layout->chunkWidth - 1) / layout->chunkWidth;
+    layout->numChunks = layout->chunksPerRow * ((height + layout->chunkHeight - 1) / layout->chunkHeight);
+
+    return layout->numChunks == (layout->isTiled ? TIFFNumberOfTiles(image) : TIFFNumberOfStrips(image));
+}
+
+/**
+ * Decodes the chunks in range [firstChunk, firstChunk + numChunks) and
+ * copies them into the paint device of \p reader. For contiguous data
+ * the index of a chunk is the index of the strip or tile in the file.
+ */
+void decodeContiguousChunks(TIFF *image, KisTIFFReaderBase *reader, const ContiguousChunksLayout &layout,
+                            uint32 width, uint32 height, quint32 firstChunk, quint32 numChunks)
+{
+    quint8 *buf = static_cast<quint8*>(_TIFFmalloc(layout.chunkSize));
+    KIS_SAFE_ASSERT_RECOVER_RETURN(buf);
+
+    for (quint32 chunk = firstChunk; chunk < firstChunk + numChunks; chunk++) {
+        const uint32 x = (chunk % layout.chunksPerRow) * layout.chunkWidth;
+        const uint32 y = (chunk / layout.chunksPerRow) * layout.chunkHeight;
+
+        const tsize_t bytesRead = layout.isTiled ?
+            TIFFReadEncodedTile(image, chunk, buf, layout.chunkSize) :
+            TIFFReadEncodedStrip(image, chunk, buf, layout.chunkSize);
+
+        if (bytesRead < 0) {
+            // the other readers are tolerant to broken chunks as well
+            dbgFile << "Failed to decode TIFF chunk" << chunk;
+            memset(buf, 0, layout.chunkSize);
+        }
+
+        const uint32 realWidth = qMin(layout.chunkWidth, width - x);
+        const uint32 realHeight = qMin(layout.chunkHeight, height - y);
+
+        for (uint32 row = 0; row < realHeight; row++) {
+            reader->copyContiguousDataToChannels(x, y + row, realWidth, buf + row * layout.lineSize);
+        }
+    }
+
+    _TIFFfree(buf);
+}
+
+struct ContiguousChunksDecodingJob {
+    quint32 firstChunk;
+    quint32 numChunks;
+    bool result;
+};
+
+/**
+ * A TIFF handle cannot be shared between threads, so every job opens
+ * its own one. The jobs write into different lines of the paint device.
+ */
+struct ContiguousChunksDecodingJobWrapper {
+    ContiguousChunksDecodingJobWrapper(const QString &filename, tdir_t directory,
+                                       KisTIFFReaderBase *reader, const ContiguousChunksLayout &layout,
+                                       uint32 width, uint32 height)
+        : m_filename(filename),
+          m_directory(directory),
+          m_reader(reader),
+          m_layout(layout),
+          m_width(width),
+          m_height(height)
+    {
+    }
+
+    inline void operator() (ContiguousChunksDecodingJob &job) {
+        TIFF *image = TIFFOpen(QFile::encodeName(m_filename), "r");
+        if (!image) return;
+
+        ContiguousChunksLayout layout;
+
+        if (TIFFSetDirectory(image, m_directory) &&
+            fetchContiguousChunksLayout(image, m_width, m_height, &layout) &&
+            layout.numChunks == m_layout.numChunks &&
+            layout.lineSize == m_layout.lineSize) {
+
+            decodeContiguousChunks(image, m_reader, m_layout, m_width, m_height, job.firstChunk, job.numChunks);
+            job.result = true;
+        }
+
+        TIFFClose(image);
+    }
+
+    QString m_filename;
+    tdir_t m_directory;
+    KisTIFFReaderBase *m_reader;
+    ContiguousChunksLayout m_layout;
+    uint32 m_width;
+    uint32 m_height;
+};
+
+/**
+ * Reads a TIFF directory with contiguous 8/16/32-bit samples directly into
+ * the paint device, bypassing KisBufferStreamBase. When \p allowThreading
+ * is set, the strips or tiles are decoded in parallel.
+ *
+ * @return false if the layout of the directory is not supported
+ */
+bool readContiguousData(TIFF *image, const QString &filename, KisTIFFReaderBase *reader,
+                        uint32 width, uint32 height, bool allowThreading)
+{
+    ContiguousChunksLayout layout;
+    if (!fetchContiguousChunksLayout(image, width, height, &layout)) {
+        return false;
+    }
+
+    const int minPixelsForThreading = 1024 * 1024;
+    const int numJobs =
+        allowThreading && qint64(width) * height >= minPixelsForThreading ?
+            qMin(layout.numChunks, quint32(2 * QThread::idealThreadCount())) : 1;
+
+    if (numJobs > 1) {
+        QVector<ContiguousChunksDecodingJob> jobs;
+        const quint32 chunksPerJob = (layout.numChunks + numJobs - 1) / numJobs;
+
+        for (quint32 chunk = 0; chunk < layout.numChunks; chunk += chunksPerJob) {
+            ContiguousChunksDecodingJob job;
+            job.firstChunk = chunk;
+            job.numChunks = qMin(chunksPerJob, layout.numChunks - chunk);
+            job.result = false;
+            jobs.append(job);
+        }
+
+        QtConcurrent::blockingMap(jobs,
+                                  ContiguousChunksDecodingJobWrapper(filename, TIFFCurrentDirectory(image),
+                                                                     reader, layout, width, height));
+
+        // if some job failed to open its own handle, read its chunks with the main one
+        Q_FOREACH (const ContiguousChunksDecodingJob &job, jobs) {
+            if (!job.result) {
+                decodeContiguousChunks(image, reader, layout, width, height, job.firstChunk, job.numChunks);
+            }
+        }
+    } else {
+        decodeContiguousChunks(image, reader, layout, width, height, 0, layout.numChunks);
+    }
+
+    return true;
+}
 }
 
 KisPropertiesConfigurationSP KisTIFFOptions::toProperties() const
@@ -283,7 +461,7 @@ KisImportExportErrorCode KisTIFFConverter::decode(const QString &filename)
     }
     do {
         dbgFile << "Read new sub-image";
-        KisImportExportErrorCode result = readTIFFDirectory(image);
+        KisImportExportErrorCode result = readTIFFDirectory(image, filename);
         if (!result.isOk()) {
             return result;
         }
@@ -293,7 +471,7 @@ KisImportExportErrorCode KisTIFFConverter::decode(const QString &filename)
     return ImportExportCodes::OK;
 }
 
-KisImportExportErrorCode KisTIFFConverter::readTIFFDirectory(TIFF* image)
+KisImportExportErrorCode KisTIFFConverter::readTIFFDirectory(TIFF* image, const QString &filename)
 {
     // Read information about the tiff
     uint32 width, height;
@@ -492,7 +670,7 @@ KisImportExportErrorCode KisTIFFConverter::readTIFFDirectory(TIFF* image)
     KisPaintLayer* layer = new KisPaintLayer(m_image.data(), m_image -> nextLayerName(), quint8_MAX);
     tdata_t buf = 0;
     tdata_t* ps_buf = 0; // used only for planar configuration separated
-    KisBufferStreamBase* tiffstream;
+    KisBufferStreamBase* tiffstream = 0;
 
     KisTIFFReaderBase* tiffReader = 0;
 
@@ -609,7 +787,14 @@ KisImportExportErrorCode KisTIFFConverter::readTIFFDirectory(TIFF* image)
         return ImportExportCodes::FileFormatIncorrect;
     }
 
-    if (TIFFIsTiled(image)) {
+    // the color transform is not thread-safe, so it disables threading
+    if (planarconfig == PLANARCONFIG_CONTIG &&
+        tiffReader->canCopyContiguousData() &&
+        readContiguousData(image, filename, tiffReader, width, height, !transform)) {
+
+        dbgFile << "contiguous" << depth << "bit image read without bit unpacking";
+    }
+    else if (TIFFIsTiled(image)) {
         dbgFile << "tiled image";
         uint32 tileWidth, tileHeight;
         uint32 x, y;
@@ -30,6 +30,38 @@
 #include <KoColorSpaceConstants.h>
 #include <KoColorSpaceTraits.h>
 
+namespace {
+
+/**
+ * Copies a line of interleaved samples, which already have the depth
+ * of the destination color space, into the paint device. No rescaling
+ * and no bit unpacking is needed, so the samples are read directly
+ * from the buffer decoded by libtiff (in the native byte order).
+ */
+template <typename T>
+void copyContiguousLine(KisPaintDeviceSP device, quint32 x, quint32 y, quint32 dataWidth, const T *src,
+                        const quint8 *poses, quint8 nbColorsSamples, quint8 nbExtraSamples, quint8 alphaPos,
+                        T alphaValue, KisTIFFPostProcessor *postProcessor, void (KisTIFFPostProcessor::*postProcess)(T*),
+                        KoColorTransformation *transform)
+{
+    const quint8 alphaIndex = poses[nbColorsSamples];
+    const int pixelStride = nbColorsSamples + nbExtraSamples;
+
+    KisHLineIteratorSP it = device->createHLineIteratorNG(x, y, dataWidth);
+    do {
+        T *d = reinterpret_cast<T *>(it->rawData());
+        for (quint8 i = 0; i < nbColorsSamples; i++) {
+            d[poses[i]] = src[i];
+        }
+        (postProcessor->*postProcess)(d);
+        if (transform) transform->transform((quint8*)d, (quint8*)d, 1);
+        d[alphaIndex] = alphaPos < nbExtraSamples ? src[nbColorsSamples + alphaPos] : alphaValue;
+        src += pixelStride;
+    } while (it->nextPixel());
+}
+
+}
+
 uint KisTIFFReaderTarget8bit::copyDataToChannels(quint32 x, quint32 y, quint32 dataWidth, KisBufferStreamBase* tiffstream)
 {
     KisHLineIteratorSP it = paintDevice()->createHLineIteratorNG(x, y, dataWidth);
@@ -54,6 +86,19 @@ uint KisTIFFReaderTarget8bit::copyDataToChannels(quint32 x, quint32 y, quint32 d
     } while (it->nextPixel());
     return 1;
 }
+
+bool KisTIFFReaderTarget8bit::canCopyContiguousData()
+{
+    return sourceDepth() == 8;
+}
+
+void KisTIFFReaderTarget8bit::copyContiguousDataToChannels(quint32 x, quint32 y, quint32 dataWidth, const quint8 *data)
+{
+    copyContiguousLine<quint8>(paintDevice(), x, y, dataWidth, data,
+                               poses(), nbColorsSamples(), nbExtraSamples(), alphaPos(),
+                               quint8_MAX, postProcessor(), &KisTIFFPostProcessor::postProcess8bit, transform());
+}
+
 uint KisTIFFReaderTarget16bit::copyDataToChannels(quint32 x, quint32 y, quint32 dataWidth, KisBufferStreamBase* tiffstream)
 {
     KisHLineIteratorSP it = paintDevice()->createHLineIteratorNG(x, y, dataWidth);
@@ -80,6 +125,18 @@ uint KisTIFFReaderTarget16bit::copyDataToChannels(quint32 x, quint32 y, quint32
     return 1;
 }
 
+bool KisTIFFReaderTarget16bit::canCopyContiguousData()
+{
+    return sourceDepth() == 16;
+}
+
+void KisTIFFReaderTarget16bit::copyContiguousDataToChannels(quint32 x, quint32 y, quint32 dataWidth, const quint8 *data)
+{
+    copyContiguousLine<quint16>(paintDevice(), x, y, dataWidth, reinterpret_cast<const quint16*>(data),
+                                poses(), nbColorsSamples(), nbExtraSamples(), alphaPos(),
+                                m_alphaValue, postProcessor(), &KisTIFFPostProcessor::postProcess16bit, transform());
+}
+
 uint KisTIFFReaderTarget32bit::copyDataToChannels(quint32 x, quint32 y, quint32 dataWidth, KisBufferStreamBase* tiffstream)
 {
     KisHLineIteratorSP it = paintDevice()->createHLineIteratorNG(x, y, dataWidth);
@@ -105,6 +162,19 @@ uint KisTIFFReaderTarget32bit::copyDataToChannels(quint32 x, quint32 y, quint32
     } while (it->nextPixel());
     return 1;
 }
+
+bool KisTIFFReaderTarget32bit::canCopyContiguousData()
+{
+    return sourceDepth() == 32;
+}
+
+void KisTIFFReaderTarget32bit::copyContiguousDataToChannels(quint32 x, quint32 y, quint32 dataWidth, const quint8 *data)
+{
+    copyContiguousLine<quint32>(paintDevice(), x, y, dataWidth, reinterpret_cast<const quint32*>(data),
+                                poses(), nbColorsSamples(), nbExtraSamples(), alphaPos(),
+                                m_alphaValue, postProcessor(), &KisTIFFPostProcessor::postProcess32bit, transform());
+}
+
 uint KisTIFFReaderFromPalette::copyDataToChannels(quint32 x, quint32 y, quint32 dataWidth,  KisBufferStreamBase* tiffstream)
 {
     KisHLineIteratorSP it = paintDevice()->createHLineIteratorNG(x, y, dataWidth);
@@ -135,6 +135,30 @@ public:
      * @return the number of line which were copied
      */
     virtual uint copyDataToChannels(quint32 x, quint32 y, quint32 dataWidth, KisBufferStreamBase* tiffstream) = 0;
+    /**
+     * @return true if the samples of the source can be copied with
+     * copyContiguousDataToChannels(), that is, if they are interleaved and
+     * have exactly the depth of the destination color space.
+     */
+    virtual bool canCopyContiguousData() {
+        return false;
+    }
+    /**
+     * A fast version of copyDataToChannels() for the contiguous data. It
+     * copies a single line of samples directly from \p data, without any
+     * bit unpacking of KisBufferStreamBase. The lines can be copied from
+     * several threads at once, as long as there is no color transform.
+     * @param x horizontal start position
+     * @param y vertical start position
+     * @param dataWidth width of the data to copy
+     * @param data the line of samples, as decoded by libtiff
+     */
+    virtual void copyContiguousDataToChannels(quint32 x, quint32 y, quint32 dataWidth, const quint8 *data) {
+        Q_UNUSED(x);
+        Q_UNUSED(y);
+        Q_UNUSED(dataWidth);
+        Q_UNUSED(data);
+    }
     /**
      * This function is called when all data has been read and should be used for any postprocessing.
      */
@@ -197,6 +221,8 @@ public:
     }
 public:
     uint copyDataToChannels(quint32 x, quint32 y, quint32 dataWidth, KisBufferStreamBase* tiffstream) override;
+    bool canCopyContiguousData() override;
+    void copyContiguousDataToChannels(quint32 x, quint32 y, quint32 dataWidth, const quint8 *data) override;
 };
 
 
@@ -210,6 +236,8 @@ public:
     }
 public:
     uint copyDataToChannels(quint32 x, quint32 y, quint32 dataWidth, KisBufferStreamBase* tiffstream) override ;
+    bool canCopyContiguousData() override;
+    void copyContiguousDataToChannels(quint32 x, quint32 y, quint32 dataWidth, const quint8 *data) override;
 private:
     uint16 m_alphaValue;
 };
@@ -224,6 +252,8 @@ public:
     }
 public:
     uint copyDataToChannels(quint32 x, quint32 y, quint32 dataWidth, KisBufferStreamBase* tiffstream) override ;
+    bool canCopyContiguousData() override;
+    void copyContiguousDataToChannels(quint32 x, quint32 y, quint32 dataWidth, const quint8 *data) override;
 private:
     uint32 m_alphaValue;
 };
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "kis_tiff_benchmark.h"
+
+#include <QTest>
+
+#include  <sdk/tests/testui.h>
+#include <synthetic_image_utils.h>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoColorModelStandardIds.h>
+
+#include <kis_image.h>
+#include <KisDocument.h>
+#include <KisPart.h>
+
+namespace {
+
+const QString TiffMimetype = "image/tiff";
+
+QString benchmarkFilePath(const QString &colorDepthId)
+{
+    return QString(FILES_OUTPUT_DIR) + '/' + QString("tiff_benchmark_%1.tif").arg(colorDepthId);
+}
+
+bool exportBenchmarkImage(const QString &colorDepthId, const QString &filePath)
+{
+    const QRect imageRect(0, 0, 4096, 4096);
+
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), colorDepthId, 0);
+    KisImageSP image = TestUtil::createSyntheticImage(cs, imageRect, 1);
+
+    return TestUtil::exportImageSync(image, filePath, TiffMimetype);
+}
+
+}
+
+void KisTiffBenchmark::benchmarkExport_data()
+{
+    QTest::addColumn<QString>("colorDepthId");
+
+    QTest::newRow("8 bit") << Integer8BitsColorDepthID.id();
+    QTest::newRow("16 bit") << Integer16BitsColorDepthID.id();
+    QTest::newRow("32 bit float") << Float32BitsColorDepthID.id();
+}
+
+void KisTiffBenchmark::benchmarkExport()
+{
+    QFETCH(QString, colorDepthId);
+
+    QBENCHMARK_ONCE {
+        QVERIFY(exportBenchmarkImage(colorDepthId, benchmarkFilePath(colorDepthId)));
+    }
+}
+
+void KisTiffBenchmark::benchmarkImport_data()
+{
+    benchmarkExport_data();
+}
+
+void KisTiffBenchmark::benchmarkImport()
+{
+    QFETCH(QString, colorDepthId);
+
+    const QString filePath = benchmarkFilePath(colorDepthId);
+    if (!QFileInfo(filePath).exists()) {
+        QVERIFY(exportBenchmarkImage(colorDepthId, filePath));
+    }
+
+    QBENCHMARK {
+        QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+        doc->setFileBatchMode(true);
+
+        QVERIFY(doc->importDocument(QUrl::fromLocalFile(filePath)));
+        QVERIFY(doc->image());
+        QCOMPARE(doc->image()->colorSpace()->colorDepthId().id(), colorDepthId);
+    }
+}
+
+KISTEST_MAIN(KisTiffBenchmark)
@@ -30,6 +30,15 @@
 #include "kisexiv2/kis_exiv2.h"
 #include  <sdk/tests/testui.h>
 #include <KoColorModelStandardIdsUtils.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoChannelInfo.h>
+
+#include <KisDocument.h>
+#include <KisPart.h>
+#include <kis_image.h>
+#include <kis_paint_device.h>
+
+#include <tiffio.h>
 
 #ifndef FILES_DATA_DIR
 #error "FILES_DATA_DIR not set. A directory with the data used for testing the importing of files in krita"
@@ -197,6 +206,178 @@ void KisTiffTest::testImportIncorrectFormat()
 }
 
 
+namespace {
+
+/**
+ * Generates the samples of an RGBA image in the order they are stored
+ * in a contiguous TIFF file
+ */
+QByteArray generateContiguousSamples(int width, int height, int channelSize)
+{
+    QByteArray samples(width * height * 4 * channelSize, 0);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            for (int i = 0; i < 4; i++) {
+                const int offset = ((y * width + x) * 4 + i) * channelSize;
+
+                if (channelSize == 1) {
+                    const quint8 value = i == 3 ? 128 + (x + y) % 128 : (x * 3 + y * 5 + i * 67) % 256;
+                    samples[offset] = char(value);
+                } else if (channelSize == 2) {
+                    const quint16 value = i == 3 ? 32768 + (x * y) % 32768 : (x * 37 + y * 101 + i * 4099) % 65536;
+                    memcpy(samples.data() + offset, &value, sizeof(value));
+                } else {
+                    const float value = i == 3 ? 1.0f - float((x + y) % 100) / 200.0f : float((x + y * 2 + i * 100) % 1000) / 999.0f;
+                    memcpy(samples.data() + offset, &value, sizeof(value));
+                }
+            }
+        }
+    }
+
+    return samples;
+}
+
+/**
+ * Writes an RGBA image with contiguous samples into strips of \p chunkHeight
+ * rows or into tiles of \p chunkWidth x \p chunkHeight pixels
+ */
+bool writeContiguousTiff(const QString &fileName, int width, int height, int channelSize,
+                         const QByteArray &samples, bool tiled, int chunkWidth, int chunkHeight)
+{
+    TIFF *image = TIFFOpen(QFile::encodeName(fileName), "w");
+    if (!image) return false;
+
+    uint16 extraSamples[] = {EXTRASAMPLE_UNASSALPHA};
+
+    TIFFSetField(image, TIFFTAG_IMAGEWIDTH, width);
+    TIFFSetField(image, TIFFTAG_IMAGELENGTH, height);
+    TIFFSetField(image, TIFFTAG_BITSPERSAMPLE, channelSize * 8);
+    TIFFSetField(image, TIFFTAG_SAMPLESPERPIXEL, 4);
+    TIFFSetField(image, TIFFTAG_EXTRASAMPLES, 1, extraSamples);
+    TIFFSetField(image, TIFFTAG_SAMPLEFORMAT, channelSize == 4 ? SAMPLEFORMAT_IEEEFP : SAMPLEFORMAT_UINT);
+    TIFFSetField(image, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
+    TIFFSetField(image, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+    TIFFSetField(image, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
+
+    const int pixelSize = 4 * channelSize;
+    bool result = true;
+
+    if (tiled) {
+        TIFFSetField(image, TIFFTAG_TILEWIDTH, chunkWidth);
+        TIFFSetField(image, TIFFTAG_TILELENGTH, chunkHeight);
+
+        QByteArray tile(chunkWidth * chunkHeight * pixelSize, 0);
+
+        for (int y = 0; y < height; y += chunkHeight) {
+            for (int x = 0; x < width; x += chunkWidth) {
+                tile.fill(0);
+
+                const int realWidth = qMin(chunkWidth, width - x);
+                const int realHeight = qMin(chunkHeight, height - y);
+
+                for (int row = 0; row < realHeight; row++) {
+                    memcpy(tile.data() + row * chunkWidth * pixelSize,
+                           samples.constData() + ((y + row) * width + x) * pixelSize,
+                           realWidth * pixelSize);
+                }
+
+                result &= TIFFWriteEncodedTile(image, TIFFComputeTile(image, x, y, 0, 0),
+                                               tile.data(), tile.size()) >= 0;
+            }
+        }
+    } else {
+        TIFFSetField(image, TIFFTAG_ROWSPERSTRIP, chunkHeight);
+
+        for (int y = 0; y < height; y += chunkHeight) {
+            const int realHeight = qMin(chunkHeight, height - y);
+
+            result &= TIFFWriteEncodedStrip(image, TIFFComputeStrip(image, y, 0),
+                                            const_cast<char*>(samples.constData()) + y * width * pixelSize,
+                                            realHeight * width * pixelSize) >= 0;
+        }
+    }
+
+    TIFFClose(image);
+    return result;
+}
+
+}
+
+void KisTiffTest::testReadContiguousData_data()
+{
+    QTest::addColumn<QString>("colorDepthId");
+    QTest::addColumn<bool>("tiled");
+
+    QTest::newRow("8 bit strips") << Integer8BitsColorDepthID.id() << false;
+    QTest::newRow("8 bit tiles") << Integer8BitsColorDepthID.id() << true;
+    QTest::newRow("16 bit strips") << Integer16BitsColorDepthID.id() << false;
+    QTest::newRow("16 bit tiles") << Integer16BitsColorDepthID.id() << true;
+    QTest::newRow("32 bit float strips") << Float32BitsColorDepthID.id() << false;
+    QTest::newRow("32 bit float tiles") << Float32BitsColorDepthID.id() << true;
+}
+
+void KisTiffTest::testReadContiguousData()
+{
+    QFETCH(QString, colorDepthId);
+    QFETCH(bool, tiled);
+
+    /**
+     * The image is bigger than 1 MP, so the chunks are decoded in several
+     * threads. Neither the strips nor the tiles are aligned to the image
+     * size, and the strip height is not a multiple of 64.
+     */
+    const int width = 1100;
+    const int height = 1000;
+    const int chunkWidth = 128;
+    const int chunkHeight = tiled ? 80 : 37;
+
+    const KoColorSpace *cs =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), colorDepthId, "sRGB-elle-V2-srgbtrc.icc");
+    QVERIFY(cs);
+
+    const int channelSize = cs->pixelSize() / 4;
+    const QByteArray samples = generateContiguousSamples(width, height, channelSize);
+
+    const QString fileName =
+        QString(FILES_OUTPUT_DIR) + '/' +
+        QString("tiff_contiguous_%1_%2.tif").arg(colorDepthId).arg(tiled ? "tiles" : "strips");
+
+    QVERIFY(writeContiguousTiff(fileName, width, height, channelSize, samples, tiled, chunkWidth, chunkHeight));
+
+    // the channels of the color space may be stored in another order than in the file
+    QByteArray pixels(samples.size(), 0);
+    const int numPixels = width * height;
+
+    Q_FOREACH (const KoChannelInfo *channel, cs->channels()) {
+        for (int i = 0; i < numPixels; i++) {
+            memcpy(pixels.data() + i * cs->pixelSize() + channel->pos(),
+                   samples.constData() + (i * 4 + channel->displayPosition()) * channelSize,
+                   channelSize);
+        }
+    }
+
+    KisPaintDeviceSP refDevice = new KisPaintDevice(cs);
+    refDevice->writeBytes(reinterpret_cast<const quint8*>(pixels.constData()), 0, 0, width, height);
+
+    QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+    doc->setFileBatchMode(true);
+
+    QVERIFY(doc->importDocument(QUrl::fromLocalFile(fileName)));
+    QVERIFY(doc->image());
+
+    KisNodeSP layer = doc->image()->root()->firstChild();
+    QVERIFY(layer);
+
+    KisPaintDeviceSP device = layer->paintDevice();
+    QCOMPARE(device->colorSpace()->id(), cs->id());
+    QCOMPARE(device->exactBounds(), refDevice->exactBounds());
+
+    QPoint errorPoint;
+    QVERIFY(TestUtil::comparePaintDevices(errorPoint, device, refDevice));
+}
+
+
 
 KISTEST_MAIN(KisTiffTest)
 
@@ -38,6 +38,9 @@ private Q_SLOTS:
     void testImportFromWriteonly();
     void testExportToReadonly();
     void testImportIncorrectFormat();
+
+    void testReadContiguousData_data();
+    void testReadContiguousData();
 };
 
 #endif
@@ -40,6 +40,65 @@
 #include <kis_spacing_information.h>
 #include <KoColorModelStandardIds.h>
 #include "kis_paintop_plugin_utils.h"
+#include "kis_image_config.h"
+
+#include <QtConcurrent>
+
+
+struct KisColorSmudgeOp::DabStripe
+{
+    DabStripe() {}
+    DabStripe(const QRect &_rect) : rect(_rect) {}
+
+    QRect rect;
+    QVector<QRect> dirtyRects;
+};
+
+struct KisColorSmudgeOp::DabRenderingData
+{
+    QRect dstDabRect;
+    QRect srcDabRect;
+    QRect tempDabRect;
+    KisFixedPaintDeviceSP maskDab;
+    KisPaintDeviceSP smudgeSource;
+
+    bool useDullingMode = false;
+    bool useOverlayMode = false;
+    bool useColorRate = false;
+
+    KoColor dullingFillColor;
+    KoColor colorRateColor;
+    quint8 colorRateOpacity = OPACITY_OPAQUE_U8;
+    quint8 finalOpacity = OPACITY_OPAQUE_U8;
+
+    QVector<QRect> dirtyRects;
+};
+
+struct KisColorSmudgeOp::SampleStripeWrapper
+{
+    SampleStripeWrapper(KisColorSmudgeOp *op, const DabRenderingData &data)
+        : m_op(op), m_data(data) {}
+
+    inline void operator() (DabStripe &stripe) {
+        m_op->sampleStripe(m_data, stripe);
+    }
+
+    KisColorSmudgeOp *m_op;
+    const DabRenderingData &m_data;
+};
+
+struct KisColorSmudgeOp::CompositeStripeWrapper
+{
+    CompositeStripeWrapper(KisColorSmudgeOp *op, const DabRenderingData &data)
+        : m_op(op), m_data(data) {}
+
+    inline void operator() (DabStripe &stripe) {
+        m_op->compositeStripe(m_data, stripe);
+    }
+
+    KisColorSmudgeOp *m_op;
+    const DabRenderingData &m_data;
+};
 
 
 KisColorSmudgeOp::KisColorSmudgeOp(const KisPaintOpSettingsSP settings, KisPainter* painter, KisNodeSP node, KisImageSP image)
@@ -48,13 +107,12 @@ KisColorSmudgeOp::KisColorSmudgeOp(const KisPaintOpSettingsSP settings, KisPaint
     , m_image(image)
     , m_precisePainterWrapper(painter->device())
     , m_tempDev(m_precisePainterWrapper.createPreciseCompositionSourceDevice())
-    , m_backgroundPainter(new KisPainter(m_tempDev))
-    , m_smudgePainter(new KisPainter(m_tempDev))
     , m_colorRatePainter(new KisPainter(m_tempDev))
     , m_finalPainter(new KisPainter(m_precisePainterWrapper.preciseDevice()))
     , m_smudgeRateOption()
     , m_colorRateOption("ColorRate", KisPaintOpOption::GENERAL, false)
     , m_smudgeRadiusOption()
+    , m_idealNumStripes(KisImageConfig(true).maxNumberOfThreads())
 {
     Q_UNUSED(node);
 
@@ -88,8 +146,6 @@ KisColorSmudgeOp::KisColorSmudgeOp(const KisPaintOpSettingsSP settings, KisPaint
 
     m_gradient = painter->gradient();
 
-    m_backgroundPainter->setCompositeOp(COMPOSITE_COPY);
-    // Smudge Painter works in default COMPOSITE_OVER mode
     m_colorRatePainter->setCompositeOp(painter->compositeOp()->id());
 
     m_finalPainter->setCompositeOp(m_smudgeRateOption.getSmearAlpha() ? COMPOSITE_COPY : COMPOSITE_OVER);
@@ -247,16 +303,14 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
 
     const qreal fpOpacity = (qreal(painter()->opacity()) / 255.0) * m_opacityOption.getOpacityf(info);
 
-    if (m_image && m_overlayModeOption.isChecked()) {
-        m_image->blockUpdates();
-        m_backgroundPainter->bitBlt(QPoint(), m_image->projection(), srcDabRect);
-        m_image->unblockUpdates();
-    }
-    else {
-        // IMPORTANT: Clear the temporary painting device to transparent black.
-        //            It will only clear the extents of the brush.
-        m_tempDev->clear(QRect(QPoint(), m_dstDabRect.size()));
-    }
+    DabRenderingData data;
+    data.dstDabRect = m_dstDabRect;
+    data.srcDabRect = srcDabRect;
+    data.maskDab = m_maskDab;
+    data.smudgeSource = activeWrapper.preciseDevice();
+    data.useDullingMode = useDullingMode;
+    data.useOverlayMode = m_image && m_overlayModeOption.isChecked();
+    data.useColorRate = m_colorRateOption.isChecked();
 
     // stored in the color space of the paintColor
     KoColor dullingFillColor = m_paintColor;
@@ -265,7 +319,6 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
 
     if (!useDullingMode) {
         activeWrapper.readRect(srcDabRect);
-        m_smudgePainter->bitBlt(QPoint(), activeWrapper.preciseDevice(), srcDabRect);
     } else {
         if (m_smudgeRadiusOption.isChecked()) {
             const qreal effectiveSize = 0.5 * (m_dstDabRect.width() + m_dstDabRect.height());
@@ -311,7 +364,8 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
                 color.convertTo(m_colorRatePainter->device()->colorSpace());
             }
 
-            m_colorRatePainter->fill(0, 0, m_dstDabRect.width(), m_dstDabRect.height(), color);
+            data.colorRateColor = color;
+            data.colorRateOpacity = m_colorRatePainter->opacity();
         } else {
             KIS_SAFE_ASSERT_RECOVER(*dullingFillColor.colorSpace() == *color.colorSpace()) {
                 color.convertTo(dullingFillColor.colorSpace());
@@ -327,38 +381,145 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
 
     if (useDullingMode) {
         KIS_SAFE_ASSERT_RECOVER_NOOP(*dullingFillColor.colorSpace() == *m_tempDev->colorSpace());
-        m_tempDev->fill(QRect(0, 0, m_dstDabRect.width(), m_dstDabRect.height()), dullingFillColor);
+        data.dullingFillColor = dullingFillColor;
     }
 
     m_precisePainterWrapper.readRects(m_finalPainter->calculateAllMirroredRects(m_dstDabRect));
 
+    // set opacity calculated by the rate option
+    m_smudgeRateOption.apply(*m_finalPainter, info, 0.0, 1.0, fpOpacity);
+    data.finalOpacity = m_finalPainter->opacity();
+
+    if (data.useOverlayMode) {
+        m_image->blockUpdates();
+    }
+
+    renderDab(data);
+
+    if (data.useOverlayMode) {
+        m_image->unblockUpdates();
+    }
+
+    // the mirrored dabs are rendered after the main one, exactly as
+    // in the sequential case
+    m_finalPainter->renderMirrorMaskSafe(m_dstDabRect, m_tempDev, data.tempDabRect.x(), data.tempDabRect.y(), m_maskDab, !m_dabCache->needSeparateOriginal());
+
+    const QVector<QRect> mirrorDirtyRects = m_finalPainter->takeDirtyRegion();
+    m_precisePainterWrapper.writeRects(mirrorDirtyRects);
+
+    QVector<QRect> dirtyRects = data.dirtyRects;
+    dirtyRects.append(mirrorDirtyRects);
+    painter()->addDirtyRects(dirtyRects);
+
+    return spacingInfo;
+}
+
+void KisColorSmudgeOp::renderDab(DabRenderingData &data)
+{
+    /**
+     * The stripes are aligned to the tile grid of the canvas, so that
+     * no tile of the canvas is written by two jobs at the same time.
+     * The dab is placed into m_tempDev with the same vertical offset
+     * from the tile grid, so its tiles are split in the same way.
+     */
+    const int tileHeight = 64;
+
+    const int tileOffset = (data.dstDabRect.y() % tileHeight + tileHeight) % tileHeight;
+    data.tempDabRect = QRect(QPoint(0, tileOffset), data.dstDabRect.size());
+
+    const int top = data.tempDabRect.top();
+    const int bottom = data.tempDabRect.bottom() + 1;
+    const int numTileRows = (bottom + tileHeight - 1) / tileHeight;
+    const int tileRowsPerStripe = qMax(1, (numTileRows + m_idealNumStripes - 1) / m_idealNumStripes);
+
+    QVector<DabStripe> stripes;
+    for (int y = top; y < bottom;) {
+        const int nextY = qMin(bottom, (y / tileHeight + tileRowsPerStripe) * tileHeight);
+        stripes.append(DabStripe(QRect(0, y, data.tempDabRect.width(), nextY - y)));
+        y = nextY;
+    }
+
+    if (stripes.size() > 1) {
+        QtConcurrent::blockingMap(stripes, SampleStripeWrapper(this, data));
+        QtConcurrent::blockingMap(stripes, CompositeStripeWrapper(this, data));
+    } else {
+        sampleStripe(data, stripes.first());
+        compositeStripe(data, stripes.first());
+    }
+
+    Q_FOREACH (const DabStripe &stripe, stripes) {
+        data.dirtyRects.append(stripe.dirtyRects);
+    }
+
+    // the wrapper is not thread-safe, so the precise device is
+    // written back only after all the stripes are done
+    m_precisePainterWrapper.writeRects(data.dirtyRects);
+}
+
+void KisColorSmudgeOp::sampleStripe(const DabRenderingData &data, DabStripe &stripe)
+{
+    const QRect &rc = stripe.rect;
+    const QRect srcRect = rc.translated(data.srcDabRect.topLeft() - data.tempDabRect.topLeft());
+
+    if (data.useOverlayMode) {
+        KisPainter gc(m_tempDev);
+        gc.setCompositeOp(COMPOSITE_COPY);
+        gc.bitBlt(rc.topLeft(), m_image->projection(), srcRect);
+    } else {
+        // IMPORTANT: Clear the temporary painting device to transparent black.
+        //            It will only clear the extents of the brush.
+        m_tempDev->clear(rc);
+    }
+
+    if (!data.useDullingMode) {
+        // Smudge Painter works in default COMPOSITE_OVER mode
+        KisPainter gc(m_tempDev);
+        gc.bitBlt(rc.topLeft(), data.smudgeSource, srcRect);
+
+        if (data.useColorRate) {
+            gc.setCompositeOp(m_colorRatePainter->compositeOp()->id());
+            gc.setOpacity(data.colorRateOpacity);
+            gc.fill(rc.x(), rc.y(), rc.width(), rc.height(), data.colorRateColor);
+        }
+    } else {
+        m_tempDev->fill(rc, data.dullingFillColor);
+    }
+}
+
+void KisColorSmudgeOp::compositeStripe(const DabRenderingData &data, DabStripe &stripe)
+{
+    const QRect &rc = stripe.rect;
+    const QRect dstRect = rc.translated(data.dstDabRect.topLeft() - data.tempDabRect.topLeft());
+    const QPoint maskPos = rc.topLeft() - data.tempDabRect.topLeft();
+
+    KisPainter gc(m_precisePainterWrapper.preciseDevice());
+    gc.setCompositeOp(m_finalPainter->compositeOp()->id());
+    gc.setSelection(m_finalPainter->selection());
+    gc.setChannelFlags(m_finalPainter->channelFlags());
+
     // if color is disabled (only smudge) and "overlay mode" is enabled
     // then first blit the region under the brush from the image projection
     // to the painting device to prevent a rapid build up of alpha value
     // if the color to be smudged is semi transparent.
-    if (m_image && m_overlayModeOption.isChecked() && !m_colorRateOption.isChecked()) {
-        m_finalPainter->setOpacity(OPACITY_OPAQUE_U8);
-        m_image->blockUpdates();
+    if (data.useOverlayMode && !data.useColorRate) {
+        gc.setOpacity(OPACITY_OPAQUE_U8);
         // TODO: check if this code is correct in mirrored mode! Technically, the
         //       painter renders the mirrored dab only, so we should also prepare
         //       the overlay for it in all the places.
-        m_finalPainter->bitBlt(m_dstDabRect.topLeft(), m_image->projection(), m_dstDabRect);
-        m_image->unblockUpdates();
+        gc.bitBlt(dstRect.topLeft(), m_image->projection(), dstRect);
     }
 
-    // set opacity calculated by the rate option
-    m_smudgeRateOption.apply(*m_finalPainter, info, 0.0, 1.0, fpOpacity);
+    gc.setOpacity(data.finalOpacity);
 
     // then blit the temporary painting device on the canvas at the current brush position
     // the alpha mask (maskDab) will be used here to only blit the pixels that are in the area (shape) of the brush
-    m_finalPainter->bitBltWithFixedSelection(m_dstDabRect.x(), m_dstDabRect.y(), m_tempDev, m_maskDab, m_dstDabRect.width(), m_dstDabRect.height());
-    m_finalPainter->renderMirrorMaskSafe(m_dstDabRect, m_tempDev, 0, 0, m_maskDab, !m_dabCache->needSeparateOriginal());
+    gc.bitBltWithFixedSelection(dstRect.x(), dstRect.y(),
+                                m_tempDev, data.maskDab,
+                                maskPos.x(), maskPos.y(),
+                                rc.x(), rc.y(),
+                                rc.width(), rc.height());
 
-    const QVector<QRect> dirtyRects = m_finalPainter->takeDirtyRegion();
-    m_precisePainterWrapper.writeRects(dirtyRects);
-    painter()->addDirtyRects(dirtyRects);
-
-    return spacingInfo;
+    stripe.dirtyRects = gc.takeDirtyRegion();
 }
 
 KisSpacingInformation KisColorSmudgeOp::updateSpacingImpl(const KisPaintInformation &info) const
@@ -67,6 +67,25 @@ private:
 
     inline void getTopLeftAligned(const QPointF &pos, const QPointF &hotSpot, qint32 *x, qint32 *y);
 
+    struct DabStripe;
+    struct DabRenderingData;
+    struct SampleStripeWrapper;
+    struct CompositeStripeWrapper;
+
+    /**
+     * The canvas part of the dab rendering is split into horizontal stripes.
+     * First, all the stripes of m_tempDev are filled with the smudged color,
+     * and only after that the stripes are composited onto the canvas, because
+     * the source and destination rects of a dab usually overlap. The stripes
+     * never overlap and all the operations are per-pixel, so the result does
+     * not depend on the number of stripes or the order they are processed in.
+     * The changed rects are written back to the original device by renderDab()
+     * only after all the stripes are finished.
+     */
+    void sampleStripe(const DabRenderingData &data, DabStripe &stripe);
+    void compositeStripe(const DabRenderingData &data, DabStripe &stripe);
+    void renderDab(DabRenderingData &data);
+
 private:
     bool                      m_firstRun;
     KisImageWSP               m_image;
@@ -74,8 +93,6 @@ private:
     KoColor                   m_paintColor;
     KisPaintDeviceSP          m_tempDev;
     QScopedPointer<KisPrecisePaintDeviceWrapper> m_preciseImageDeviceWrapper;
-    QScopedPointer<KisPainter> m_backgroundPainter;
-    QScopedPointer<KisPainter> m_smudgePainter;
     QScopedPointer<KisPainter> m_colorRatePainter;
     QScopedPointer<KisPainter> m_finalPainter;
     KoAbstractGradientSP      m_gradient;
@@ -99,6 +116,8 @@ private:
 
     KoColorTransformation *m_hsvTransform {0};
     const KoCompositeOp *m_preciseColorRateCompositeOp {0};
+
+    const int m_idealNumStripes;
 };
 
 #endif // _KIS_COLORSMUDGEOP_H_
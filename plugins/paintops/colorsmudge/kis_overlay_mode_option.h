@@ -22,9 +22,6 @@
 
 #include <kis_paintop_option.h>
 
-#include <brushengine/kis_paintop_lod_limitations.h>
-
-
 class KisOverlayModeOption : public KisPaintOpOption
 {
 public:
@@ -46,11 +43,6 @@ public:
         bool enabled = setting->getBool("MergedPaint");
         setChecked(enabled);
     }
-
-    void lodLimitations(KisPaintopLodLimitations *l) const override {
-        l->blockers << KoID("colorsmudge-overlay", i18nc("PaintOp instant preview limitation", "Overlay Option"));
-    }
-
 };
 
 class KisOverlayModeOptionWidget: public KisOverlayModeOption
@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisColorSmudgeOpTest.h"
+
+#include <QTest>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_paint_device.h>
+#include <kis_painter.h>
+#include <kis_image_config.h>
+#include <kis_auto_brush.h>
+#include <kis_circle_mask_generator.h>
+#include <kis_brush_option.h>
+#include <kis_distance_information.h>
+#include <brushengine/kis_paint_information.h>
+#include <KisGlobalResourcesInterface.h>
+
+#include "kis_colorsmudgeop.h"
+#include "kis_colorsmudgeop_settings.h"
+#include "kis_smudge_option.h"
+
+namespace {
+
+KisPaintDeviceSP createCanvas()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    // a few bands of color, so that the smudging has something to mix
+    const QList<QColor> colors = {Qt::red, Qt::green, Qt::blue, Qt::yellow, Qt::cyan};
+    for (int i = 0; i < colors.size(); i++) {
+        dev->fill(QRect(0, i * 70, 600, 70), KoColor(colors[i], cs));
+    }
+
+    return dev;
+}
+
+KisPaintDeviceSP paintStroke(KisSmudgeOption::Mode mode, int numThreads)
+{
+    KisImageConfig(false).setMaxNumberOfThreads(numThreads);
+
+    KisPaintOpSettingsSP settings =
+        new KisColorSmudgeOpSettings(KisGlobalResourcesInterface::instance());
+
+    KisBrushOptionProperties brushOption;
+    brushOption.setBrush(new KisAutoBrush(new KisCircleMaskGenerator(250, 1.0, 0.5, 0.5, 2, true), 0.0, 0.0));
+    brushOption.writeOptionSetting(settings.data());
+
+    KisSmudgeOption smudgeOption;
+    smudgeOption.readOptionSetting(settings);
+    smudgeOption.setMode(mode);
+    smudgeOption.writeOptionSetting(settings);
+
+    KisPaintDeviceSP dev = createCanvas();
+
+    KisPainter gc(dev);
+    gc.setPaintColor(KoColor(Qt::magenta, dev->colorSpace()));
+
+    // the op is created after the thread count is changed,
+    // so that it would split the dabs accordingly
+    QScopedPointer<KisColorSmudgeOp> op(new KisColorSmudgeOp(settings, &gc, 0, 0));
+
+    KisDistanceInformation distance;
+
+    // the dab is not aligned to the tile grid on purpose
+    for (int i = 0; i < 10; i++) {
+        KisPaintInformation info(QPointF(150 + 20 * i, 117 + 13 * i), 1.0);
+        op->paintAt(info, &distance);
+    }
+
+    return dev;
+}
+
+QByteArray deviceBytes(KisPaintDeviceSP dev, const QRect &rc)
+{
+    QByteArray bytes(rc.width() * rc.height() * dev->pixelSize(), 0);
+    dev->readBytes(reinterpret_cast<quint8*>(bytes.data()), rc);
+    return bytes;
+}
+
+}
+
+void KisColorSmudgeOpTest::testStripesDoNotChangeResult_data()
+{
+    QTest::addColumn<int>("mode");
+
+    QTest::newRow("smearing") << int(KisSmudgeOption::SMEARING_MODE);
+    QTest::newRow("dulling") << int(KisSmudgeOption::DULLING_MODE);
+}
+
+void KisColorSmudgeOpTest::testStripesDoNotChangeResult()
+{
+    QFETCH(int, mode);
+
+    const int savedNumThreads = KisImageConfig(true).maxNumberOfThreads();
+    const QRect rc(0, 0, 600, 600);
+
+    KisPaintDeviceSP serial = paintStroke(KisSmudgeOption::Mode(mode), 1);
+    KisPaintDeviceSP parallel = paintStroke(KisSmudgeOption::Mode(mode), 8);
+
+    KisImageConfig(false).setMaxNumberOfThreads(savedNumThreads);
+
+    QVERIFY(deviceBytes(serial, rc) != deviceBytes(createCanvas(), rc));
+    QVERIFY(deviceBytes(parallel, rc) == deviceBytes(serial, rc));
+}
+
+QTEST_MAIN(KisColorSmudgeOpTest)
@@ -58,6 +58,7 @@
 #include <kis_paint_action_type_option.h>
 #include <kis_random_sub_accessor.h>
 #include <kis_fixed_paint_device.h>
+#include <kis_lod_transform.h>
 #include <kis_iterator_ng.h>
 #include <kis_spacing_information.h>
 
@@ -133,7 +134,14 @@ KisSpacingInformation KisDuplicateOp::paintAt(const KisPaintInformation& info)
 
     qreal opacity = m_opacityOption.apply(painter(),info);
 
-    qreal scale = m_sizeOption.apply(info);
+    /**
+     * The source point and the offset are stored in the coordinates of
+     * the full-resolution image, so in the instant preview mode they
+     * should be scaled down together with the brush.
+     */
+    const qreal lodScale = KisLodTransform::lodToScale(painter()->device());
+
+    qreal scale = m_sizeOption.apply(info) * lodScale;
 
     if (checkSizeTooSmall(scale)) return KisSpacingInformation();
     KisDabShape shape(scale, 1.0, rotation);
@@ -155,11 +163,11 @@ KisSpacingInformation KisDuplicateOp::paintAt(const KisPaintInformation& info)
     QPoint srcPoint;
 
     if (m_moveSourcePoint) {
-        srcPoint = (dstRect.topLeft() - m_settings->offset()).toPoint();
+        srcPoint = (dstRect.topLeft() - lodScale * m_settings->offset()).toPoint();
     }
     else {
         QPointF hotSpot = brush->hotSpot(shape, info);
-        srcPoint = (m_settings->position() - hotSpot).toPoint();
+        srcPoint = (lodScale * m_settings->position() - hotSpot).toPoint();
     }
 
     qint32 sw = dstRect.width();
@@ -298,5 +306,5 @@ KisSpacingInformation KisDuplicateOp::paintAt(const KisPaintInformation& info)
 
 KisSpacingInformation KisDuplicateOp::updateSpacingImpl(const KisPaintInformation &info) const
 {
-    return effectiveSpacing(m_sizeOption.apply(info));
+    return effectiveSpacing(m_sizeOption.apply(info) * KisLodTransform::lodToScale(painter()->device()));
 }
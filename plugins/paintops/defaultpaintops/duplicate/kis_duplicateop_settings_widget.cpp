@@ -35,7 +35,6 @@
 #include "kis_texture_option.h"
 #include <kis_pressure_mirror_option_widget.h>
 #include "kis_pressure_texture_strength_option.h"
-#include <brushengine/kis_paintop_lod_limitations.h>
 
 KisDuplicateOpSettingsWidget::KisDuplicateOpSettingsWidget(QWidget* parent)
     : KisBrushBasedPaintopOptionWidget(parent)
@@ -66,10 +65,3 @@ KisPropertiesConfigurationSP KisDuplicateOpSettingsWidget::configuration() const
     writeConfiguration(config);
     return config;
 }
-
-KisPaintopLodLimitations KisDuplicateOpSettingsWidget::lodLimitations() const
-{
-    KisPaintopLodLimitations l = KisBrushBasedPaintopOptionWidget::lodLimitations();
-    l.blockers << KoID("clone-brush", i18nc("PaintOp instant preview limitation", "Clone Brush (temporarily disabled)"));
-    return l;
-}
@@ -27,7 +27,6 @@
 #include <kis_image.h>
 
 class KisDuplicateOpOption;
-class KisPaintopLodLimitations;
 
 class KisDuplicateOpSettingsWidget : public KisBrushBasedPaintopOptionWidget
 {
@@ -41,7 +40,6 @@ public:
     ~KisDuplicateOpSettingsWidget() override;
 
     KisPropertiesConfigurationSP configuration() const override;
-    KisPaintopLodLimitations lodLimitations() const override;
 
     bool supportScratchBox() override {
         return false;
@@ -34,6 +34,8 @@
 #include <ctime>
 #include <KoColorSpaceRegistry.h>
 
+#include <KisParallelDabRenderingUtils.h>
+
 const qreal degToRad = M_PI / 180.0;
 
 
@@ -142,7 +144,8 @@ bool DeformBrush::setupAction(
     }
     case LENS_IN:
     case LENS_OUT: {
-        static_cast<DeformLens*>(m_deformAction)->setMaxDistance(m_sizeProperties->brush_diameter * 0.5, m_sizeProperties->brush_diameter * 0.5);
+        const qreal maxDistance = m_sizeProperties->brush_diameter * 0.5 * m_lodScale;
+        static_cast<DeformLens*>(m_deformAction)->setMaxDistance(maxDistance, maxDistance);
         break;
     }
     case DEFORM_COLOR: {
@@ -164,7 +167,6 @@ KisFixedPaintDeviceSP DeformBrush::paintMask(KisFixedPaintDeviceSP dab,
         QPointF pos, qreal subPixelX, qreal subPixelY, int dabX, int dabY)
 {
     KisFixedPaintDeviceSP mask = new KisFixedPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
-    KisCrossDeviceColorPicker colorPicker(layer, dab);
 
     qreal fWidth = maskWidth(scale);
     qreal fHeight = maskHeight(scale);
@@ -184,8 +186,6 @@ KisFixedPaintDeviceSP DeformBrush::paintMask(KisFixedPaintDeviceSP dab,
     qreal const majorAxis = 2.0 / fWidth;
     qreal const minorAxis = 2.0 / fHeight;
 
-    qreal distance;
-
     QTransform forwardRotationMatrix;
     forwardRotationMatrix.rotateRadians(-rotation);
     QTransform reverseRotationMatrix;
@@ -200,64 +200,86 @@ KisFixedPaintDeviceSP DeformBrush::paintMask(KisFixedPaintDeviceSP dab,
 
     mask->setRect(dab->bounds());
     mask->lazyGrowBufferWithoutInitialization();
-    quint8* maskPointer = mask->data();
-    qint8 maskPixelSize = mask->pixelSize();
 
-    quint8* dabPointer = dab->data();
-    int dabPixelSize = dab->colorSpace()->pixelSize();
+    const int maskPixelSize = mask->pixelSize();
+    const int dabPixelSize = dab->colorSpace()->pixelSize();
 
-    for (int y = 0; y <  dstHeight; y++) {
-        for (int x = 0; x < dstWidth; x++) {
-            qreal maskX = x - centerX;
-            qreal maskY = y - centerY;
-            forwardRotationMatrix.map(maskX, maskY, &maskX, &maskY);
-            distance = norme(maskX * majorAxis, maskY * minorAxis);
+    /**
+     * Every pixel of the dab is independent from the others, so the
+     * dab is rendered in stripes. Each stripe has its own color picker
+     * and its own random source seeded from the stroke.
+     */
+    QVector<KisParallelDabRenderingUtils::StripeJob> stripes =
+        KisParallelDabRenderingUtils::splitIntoStripes(
+            QRect(0, 0, dstWidth, dstHeight),
+            KisParallelDabRenderingUtils::generateDabSeed(randomSource));
 
-            if (distance > 1.0) {
-                // leave there OPACITY TRANSPARENT pixel (default pixel)
+    auto renderStripe = [&] (KisParallelDabRenderingUtils::StripeJob &stripe) {
+        KisCrossDeviceColorPicker colorPicker(layer, dab);
+        KisRandomSourceSP jobRandomSource = stripe.randomSource;
 
-                colorPicker.pickOldColor(x + dabX, y + dabY, dabPointer);
-                dabPointer += dabPixelSize;
+        const QRect &rc = stripe.rect;
+        quint8* maskPointer = mask->data() + rc.y() * dstWidth * maskPixelSize;
+        quint8* dabPointer = dab->data() + rc.y() * dstWidth * dabPixelSize;
 
-                *maskPointer = OPACITY_TRANSPARENT_U8;
-                maskPointer += maskPixelSize;
-                continue;
-            }
+        qreal distance;
+
+        for (int y = rc.top(); y <= rc.bottom(); y++) {
+            for (int x = 0; x < dstWidth; x++) {
+                qreal maskX = x - centerX;
+                qreal maskY = y - centerY;
+                forwardRotationMatrix.map(maskX, maskY, &maskX, &maskY);
+                distance = norme(maskX * majorAxis, maskY * minorAxis);
 
-            if (m_sizeProperties->brush_density != 1.0) {
-                if (m_sizeProperties->brush_density < randomSource->generateNormalized()) {
+                if (distance > 1.0) {
+                    // leave there OPACITY TRANSPARENT pixel (default pixel)
+
+                    colorPicker.pickOldColor(x + dabX, y + dabY, dabPointer);
                     dabPointer += dabPixelSize;
+
                     *maskPointer = OPACITY_TRANSPARENT_U8;
                     maskPointer += maskPixelSize;
                     continue;
                 }
-            }
 
-            m_deformAction->transform(&maskX, &maskY, distance, randomSource);
-            reverseRotationMatrix.map(maskX, maskY, &maskX, &maskY);
+                if (m_sizeProperties->brush_density != 1.0) {
+                    if (m_sizeProperties->brush_density < jobRandomSource->generateNormalized()) {
+                        dabPointer += dabPixelSize;
+                        *maskPointer = OPACITY_TRANSPARENT_U8;
+                        maskPointer += maskPixelSize;
+                        continue;
+                    }
+                }
 
-            maskX += pos.x();
-            maskY += pos.y();
+                m_deformAction->transform(&maskX, &maskY, distance, jobRandomSource);
+                reverseRotationMatrix.map(maskX, maskY, &maskX, &maskY);
 
-            if (!m_properties->deform_use_bilinear) {
-                maskX = qRound(maskX);
-                maskY = qRound(maskY);
-            }
+                maskX += pos.x();
+                maskY += pos.y();
 
-            if (m_properties->deform_use_old_data) {
-                colorPicker.pickOldColor(maskX, maskY, dabPointer);
-            }
-            else {
-                colorPicker.pickColor(maskX, maskY, dabPointer);
-            }
+                if (!m_properties->deform_use_bilinear) {
+                    maskX = qRound(maskX);
+                    maskY = qRound(maskY);
+                }
 
-            dabPointer += dabPixelSize;
+                if (m_properties->deform_use_old_data) {
+                    colorPicker.pickOldColor(maskX, maskY, dabPointer);
+                }
+                else {
+                    colorPicker.pickColor(maskX, maskY, dabPointer);
+                }
 
-            *maskPointer = OPACITY_OPAQUE_U8;
-            maskPointer += maskPixelSize;
+                dabPointer += dabPixelSize;
 
+                *maskPointer = OPACITY_OPAQUE_U8;
+                maskPointer += maskPixelSize;
+
+            }
         }
-    }
+    };
+
+    KisParallelDabRenderingUtils::runJobs(stripes, renderStripe);
+
     m_counter++;
 
     return mask;
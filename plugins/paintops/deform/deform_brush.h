@@ -217,6 +217,15 @@ public:
     void setProperties(DeformOption * properties) {
         m_properties = properties;
     }
+
+    /**
+     * The lens radius is defined in the pixels of the full-resolution
+     * image, so in the instant preview mode it should be scaled down
+     * together with the dab.
+     */
+    void setLevelOfDetailScale(qreal scale) {
+        m_lodScale = scale;
+    }
     void initDeformAction();
     QPointF hotSpot(qreal scale, qreal rotation);
 
@@ -251,6 +260,7 @@ private:
 
     DeformOption * m_properties;
     KisBrushSizeOptionProperties * m_sizeProperties;
+    qreal m_lodScale {1.0};
 };
 
 
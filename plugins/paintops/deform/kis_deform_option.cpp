@@ -18,7 +18,6 @@
 #include "kis_deform_option.h"
 #include "ui_wdgdeformoptions.h"
 
-#include <brushengine/kis_paintop_lod_limitations.h>
 
 
 class KisDeformOptionsWidget: public QWidget, public Ui::WdgDeformOptions
@@ -115,11 +114,6 @@ void KisDeformOption::writeOptionSetting(KisPropertiesConfigurationSP setting) c
     op.writeOptionSetting(setting);
 }
 
-void KisDeformOption::lodLimitations(KisPaintopLodLimitations *l) const
-{
-    l->blockers << KoID("deform-brush", i18nc("PaintOp instant preview limitation", "Deform Brush (unsupported)"));
-}
-
 int  KisDeformOption::deformAction() const
 {
     //TODO: make it nicer using enums or something
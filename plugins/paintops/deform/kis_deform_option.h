@@ -21,7 +21,6 @@
 #include <kis_paintop_option.h>
 
 class KisDeformOptionsWidget;
-class KisPaintopLodLimitations;
 
 const QString DEFORM_AMOUNT = "Deform/deformAmount";
 const QString DEFORM_ACTION = "Deform/deformAction";
@@ -46,7 +45,6 @@ public:
     void writeOptionSetting(KisPropertiesConfigurationSP setting) const override;
     void readOptionSetting(const KisPropertiesConfigurationSP setting) override;
 
-    void lodLimitations(KisPaintopLodLimitations *l) const override;
 
 private:
     KisDeformOptionsWidget * m_options;
@@ -105,10 +105,13 @@ KisSpacingInformation KisDeformPaintOp::paintAt(const KisPaintInformation& info)
     qint32 y;
     qreal subPixelY;
 
+    const qreal lodScale = KisLodTransform::lodToScale(painter()->device());
+    const qreal diameter = m_sizeProperties.brush_diameter * lodScale;
+
     QPointF pt = info.pos();
     if (m_sizeProperties.brush_jitter_movement_enabled) {
-        pt.setX(pt.x() + ((m_sizeProperties.brush_diameter * info.randomSource()->generateNormalized()) - m_sizeProperties.brush_diameter * 0.5) * m_sizeProperties.brush_jitter_movement);
-        pt.setY(pt.y() + ((m_sizeProperties.brush_diameter * info.randomSource()->generateNormalized()) - m_sizeProperties.brush_diameter * 0.5) * m_sizeProperties.brush_jitter_movement);
+        pt.setX(pt.x() + ((diameter * info.randomSource()->generateNormalized()) - diameter * 0.5) * m_sizeProperties.brush_jitter_movement);
+        pt.setY(pt.y() + ((diameter * info.randomSource()->generateNormalized()) - diameter * 0.5) * m_sizeProperties.brush_jitter_movement);
     }
 
     qreal rotation = m_rotationOption.apply(info);
@@ -119,7 +122,9 @@ KisSpacingInformation KisDeformPaintOp::paintAt(const KisPaintInformation& info)
 
 
     rotation += m_sizeProperties.brush_rotation;
-    scale *= m_sizeProperties.brush_scale;
+    scale *= m_sizeProperties.brush_scale * lodScale;
+
+    m_deformBrush.setLevelOfDetailScale(lodScale);
 
     QPointF pos = pt - m_deformBrush.hotSpot(scale, rotation);
 
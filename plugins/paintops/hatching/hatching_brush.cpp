@@ -54,19 +54,41 @@ void HatchingBrush::init()
 
 void HatchingBrush::hatch(KisPaintDeviceSP dev, qreal x, qreal y, double width, double height, double givenangle, const KoColor &color, qreal additionalScale)
 {
+    /**
+     * In the instant preview mode the lines are usually thinner than a
+     * pixel. Rounding them up to a full pixel and snapping them to the
+     * pixel grid makes the preview look very different from the final
+     * result, so in this mode the lines are always placed with subpixel
+     * precision, antialiased, and their subpixel thickness is emulated
+     * with the opacity of the ink.
+     */
+    const bool isLodPreview = additionalScale < 1.0;
+    subpixelPrecision = m_settings->subpixelprecision || isLodPreview;
+    antialias = m_settings->antialias || isLodPreview;
+
+    double tempthickness = m_settings->thickness * m_settings->thicknesssensorvalue;
+    const double scaledThickness = additionalScale * qMax(1, qRound(tempthickness));
+    thickness = qMax(1, qRound(scaledThickness));
+
+    KoColor inkColor(color);
+    if (isLodPreview && scaledThickness < 1.0) {
+        inkColor.setOpacity(inkColor.opacityF() * scaledThickness);
+    }
+
     m_painter.begin(dev);
     m_painter.setFillStyle(KisPainter::FillStyleForegroundColor);
-    m_painter.setPaintColor(color);
-    m_painter.setBackgroundColor(color);
+    m_painter.setPaintColor(inkColor);
+    m_painter.setBackgroundColor(inkColor);
 
     angle = givenangle;
-    double tempthickness = m_settings->thickness * m_settings->thicknesssensorvalue;
-    thickness = qMax(1, qRound(additionalScale * tempthickness));
     separation = additionalScale *
         (m_settings->enabledcurveseparation ?
          separationAsFunctionOfParameter(m_settings->separationsensorvalue, m_settings->separation, m_settings->separationintervals) :
          m_settings->separation);
 
+    const double originX = additionalScale * origin_x;
+    const double originY = additionalScale * origin_y;
+
     height_ = height;
     width_ = width;
 
@@ -77,12 +99,12 @@ void HatchingBrush::hatch(KisPaintDeviceSP dev, qreal x, qreal y, double width,
     dy = fabs(separation / cos(angle * M_PI / 180)); // sec = 1/cos(angle)
     // I took the absolute value to avoid confusions with negative numbers
 
-    if (!m_settings->subpixelprecision)
+    if (!subpixelPrecision)
         modf(dy, &dy);
 
     // Exception for vertical lines, for which a tangent does not exist
     if ((angle == 90) || (angle == -90)) {
-        verticalHotX = fmod((origin_x - x), separation);
+        verticalHotX = fmod((originX - x), separation);
 
         iterateVerticalLines(true, 1, false);    // Forward
         iterateVerticalLines(true, 0, true);     // In Between both
@@ -91,7 +113,7 @@ void HatchingBrush::hatch(KisPaintDeviceSP dev, qreal x, qreal y, double width,
     else {
         // Turn Angle + Point into Slope + Intercept
         slope = tan(angle * M_PI / 180);                // Angle into slope
-        baseLineIntercept = origin_y - slope * origin_x; // Slope and Point of the Base Line into Intercept
+        baseLineIntercept = originY - slope * originX; // Slope and Point of the Base Line into Intercept
         cursorLineIntercept = y - slope * x;
         hotIntercept = fmod((baseLineIntercept - cursorLineIntercept), dy);  // This hotIntercept belongs to a line that intersects with the hatching area
 
@@ -169,7 +191,7 @@ void HatchingBrush::iterateLines(bool forward, int lineindex, bool oneline)
         if (!remaininginnerlines)
             break;
 
-        if (!m_settings->subpixelprecision) {
+        if (!subpixelPrecision) {
             myround(&xdraw[0]);
             myround(&xdraw[1]);
             myround(&ydraw[0]);
@@ -184,7 +206,7 @@ void HatchingBrush::iterateLines(bool forward, int lineindex, bool oneline)
             B.setX(xdraw[1]);
             B.setY(ydraw[1]);
 
-            if (m_settings->antialias)
+            if (antialias)
                 m_painter.drawThickLine(A, B, thickness, thickness);
             else
                 m_painter.drawLine(A, B, thickness, false);    //testing no subpixel;
@@ -234,7 +256,7 @@ void HatchingBrush::iterateVerticalLines(bool forward, int lineindex, bool oneli
         if (!remaininginnerlines)
             break;
 
-        if (!m_settings->subpixelprecision) {
+        if (!subpixelPrecision) {
             myround(&xdraw);
             myround(&ydraw[1]);
         }
@@ -244,7 +266,7 @@ void HatchingBrush::iterateVerticalLines(bool forward, int lineindex, bool oneli
         B.setX(xdraw);
         B.setY(ydraw[1]);
 
-        if (m_settings->antialias)
+        if (antialias)
             m_painter.drawThickLine(A, B, thickness, thickness);
         else
             m_painter.drawLine(A, B, thickness, false);    //testing no subpixel;
@@ -55,6 +55,12 @@ private:
     /** Thickness in pixels of each hatch line */
     int thickness;
 
+    /** Whether the lines are placed with subpixel precision in the current pass */
+    bool subpixelPrecision {false};
+
+    /** Whether the lines are antialiased in the current pass */
+    bool antialias {false};
+
     /** Angle in degrees of all the lines in a single hatching pass*/
     double angle;
 
@@ -18,7 +18,6 @@
  */
 
 #include "kis_hatching_options.h"
-#include <brushengine/kis_paintop_lod_limitations.h>
 
 #include "ui_wdghatchingoptions.h"
 
@@ -123,9 +122,3 @@ void KisHatchingOptions::readOptionSetting(const KisPropertiesConfigurationSP se
 
     m_options->separationIntervalSpinBox->setValue(op.separationintervals);
 }
-
-void KisHatchingOptions::lodLimitations(KisPaintopLodLimitations *l) const
-{
-    l->limitations << KoID("hatching-brush", i18nc("PaintOp instant preview limitation", "Hatching Brush (heavy aliasing in preview mode)"));
-}
-
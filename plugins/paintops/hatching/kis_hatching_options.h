@@ -21,7 +21,6 @@
 
 #include <kis_paintop_option.h>
 
-class KisPaintopLodLimitations;
 class KisHatchingOptionsWidget;
 
 class KisHatchingOptions : public KisPaintOpOption
@@ -33,7 +32,6 @@ public:
 
     void writeOptionSetting(KisPropertiesConfigurationSP setting) const override;
     void readOptionSetting(const KisPropertiesConfigurationSP setting) override;
-    void lodLimitations(KisPaintopLodLimitations *l) const override;
 
 private:
     KisHatchingOptionsWidget *m_options;
@@ -23,6 +23,7 @@
 #include "kis_fixed_paint_device.h"
 #include "kis_color_source.h"
 
+#include <KoColorSpace.h>
 #include <kis_pressure_sharpness_option.h>
 #include <kis_texture_option.h>
 
@@ -44,6 +45,43 @@ void DabRenderingResources::syncResourcesToSeqNo(int seqNo, const KisPaintInform
     brush->prepareForSeqNo(info, seqNo);
 }
 
+bool DabCacheKey::operator==(const DabCacheKey &rhs) const
+{
+    return isValid == rhs.isValid &&
+        angle == rhs.angle &&
+        width == rhs.width &&
+        height == rhs.height &&
+        subPixelX == rhs.subPixelX &&
+        subPixelY == rhs.subPixelY &&
+        softnessFactor == rhs.softnessFactor &&
+        lightnessStrength == rhs.lightnessStrength &&
+        ratio == rhs.ratio &&
+        index == rhs.index &&
+        precisionLevel == rhs.precisionLevel &&
+        horizontalMirror == rhs.horizontalMirror &&
+        verticalMirror == rhs.verticalMirror &&
+        color == rhs.color;
+}
+
+uint qHash(const DabCacheKey &key, uint seed)
+{
+    const qint64 values[] = {
+        key.angle, key.width, key.height,
+        key.subPixelX, key.subPixelY,
+        key.softnessFactor, key.lightnessStrength, key.ratio,
+        key.index, key.precisionLevel,
+        int(key.horizontalMirror) | int(key.verticalMirror) << 1
+    };
+
+    seed = qHashBits(values, sizeof(values), seed);
+
+    if (key.color.colorSpace()) {
+        seed = qHashBits(key.color.data(), key.color.colorSpace()->pixelSize(), seed);
+    }
+
+    return seed;
+}
+
 QRect correctDabRectWhenFetchedFromCache(const QRect &dabRect,
                                          const QSize &realDabSize)
 {
@@ -24,6 +24,7 @@
 
 #include "kis_types.h"
 
+#include <KoColor.h>
 #include <kis_pressure_mirror_option.h>
 #include "kis_dab_shape.h"
 
@@ -90,6 +91,50 @@ private:
     DabRequestInfo(const DabRequestInfo &rhs);
 };
 
+/**
+ * Quantized parameters of a dab. The dabs with equal keys are considered
+ * interchangeable by the LRU cache of KisDabCacheBase. Invalid keys are
+ * never cached.
+ */
+struct PAINTOP_EXPORT DabCacheKey
+{
+    bool isValid = false;
+
+    KoColor color;
+    qint64 angle = 0;
+    qint64 width = 0;
+    qint64 height = 0;
+    qint64 subPixelX = 0;
+    qint64 subPixelY = 0;
+    qint64 softnessFactor = 0;
+    qint64 lightnessStrength = 0;
+    qint64 ratio = 0;
+    int index = 0;
+    int precisionLevel = 0;
+    bool horizontalMirror = false;
+    bool verticalMirror = false;
+
+    bool operator==(const DabCacheKey &rhs) const;
+};
+
+PAINTOP_EXPORT uint qHash(const DabCacheKey &key, uint seed = 0);
+
+/**
+ * The size of the quantization buckets of DabCacheKey. The size of the
+ * dab is quantized logarithmically, \p sizeFrac is the relative
+ * difference between the neighbouring buckets. Zero \p sizeFrac means
+ * that the size should match exactly.
+ */
+struct PAINTOP_EXPORT DabCacheQuantization
+{
+    qreal angle;
+    qreal sizeFrac;
+    qreal subPixel;
+    qreal softnessFactor;
+    qreal lightnessStrength;
+    qreal ratio;
+};
+
 struct PAINTOP_EXPORT DabGenerationInfo
 {
     MirrorProperties mirrorProperties;
@@ -103,6 +148,8 @@ struct PAINTOP_EXPORT DabGenerationInfo
     qreal lightnessStrength = 1.0;
 
     bool needsPostprocessing = false;
+
+    DabCacheKey cacheKey;
 };
 
 PAINTOP_EXPORT QRect correctDabRectWhenFetchedFromCache(const QRect &dabRect,
@@ -19,7 +19,7 @@
 #ifndef KISDABRENDERINGEXECUTOR_H
 #define KISDABRENDERINGEXECUTOR_H
 
-#include "kritadefaultpaintops_export.h"
+#include "kritapaintop_export.h"
 
 #include <QScopedPointer>
 
@@ -33,7 +33,7 @@ class KisPrecisionOption;
 class KisRunnableStrokeJobsInterface;
 
 
-class KRITADEFAULTPAINTOPS_EXPORT KisDabRenderingExecutor
+class PAINTOP_EXPORT KisDabRenderingExecutor
 {
 public:
     KisDabRenderingExecutor(const KoColorSpace *cs,
@@ -107,7 +107,8 @@ int KisDabRenderingJobRunner::executeOneJob(KisDabRenderingJob *job,
 
     resources->syncResourcesToSeqNo(job->seqNo, job->generationInfo.info);
 
-    if (job->type == KisDabRenderingJob::Dab) {
+    // the dab could have been fetched from the LRU cache
+    if (job->type == KisDabRenderingJob::Dab && !job->originalDevice) {
         // TODO: thing about better interface for the reverse queue link
         job->originalDevice = parentQueue->fetchCachedPaintDevce();
 
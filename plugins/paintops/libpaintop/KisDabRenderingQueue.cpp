@@ -54,6 +54,18 @@ struct KisDabRenderingQueue::Private
             return false;
         }
 
+        KisFixedPaintDeviceSP fetchDabFromLruCache(const KisDabCacheUtils::DabCacheKey &key) override
+        {
+            Q_UNUSED(key);
+            return 0;
+        }
+
+        void putDabToLruCache(const KisDabCacheUtils::DabCacheKey &key, KisFixedPaintDeviceSP dab) override
+        {
+            Q_UNUSED(key);
+            Q_UNUSED(dab);
+        }
+
     };
 
     Private(const KoColorSpace *_colorSpace,
@@ -161,6 +173,14 @@ KisDabRenderingJobSP KisDabRenderingQueue::addDab(const KisDabCacheUtils::DabReq
                                     &job->generationInfo,
                                     &shouldUseCache);
 
+    KisFixedPaintDeviceSP lruCachedDab;
+    if (!shouldUseCache) {
+        lruCachedDab = m_d->cacheInterface->fetchDabFromLruCache(job->generationInfo.cacheKey);
+        if (lruCachedDab) {
+            resources->brush->notifyCachedDabPainted(request.info);
+        }
+    }
+
     m_d->putResourcesToCache(resources);
     resources = 0;
 
@@ -175,7 +195,19 @@ KisDabRenderingJobSP KisDabRenderingQueue::addDab(const KisDabCacheUtils::DabReq
 
 
     if (job->type == KisDabRenderingJob::Dab) {
-        job->status = KisDabRenderingJob::Running;
+        /**
+         * A dab from the LRU cache needs no rendering, only
+         * postprocessing, if any
+         */
+        if (lruCachedDab && !job->generationInfo.needsPostprocessing) {
+            job->status = KisDabRenderingJob::Completed;
+            job->originalDevice = lruCachedDab;
+            job->postprocessedDevice = lruCachedDab;
+            m_d->avgExecutionTime(0);
+        } else {
+            job->status = KisDabRenderingJob::Running;
+            job->originalDevice = lruCachedDab;
+        }
     } else if (job->type == KisDabRenderingJob::Postprocess ||
                job->type == KisDabRenderingJob::Copy) {
 
@@ -239,6 +271,9 @@ QList<KisDabRenderingJobSP> KisDabRenderingQueue::notifyJobFinished(int seqNo, i
     finishedJob->status = KisDabRenderingJob::Completed;
 
     if (finishedJob->type == KisDabRenderingJob::Dab) {
+        m_d->cacheInterface->putDabToLruCache(finishedJob->generationInfo.cacheKey,
+                                              finishedJob->originalDevice);
+
         for (auto it = finishedJobIt + 1; it != m_d->jobs.end(); ++it) {
             KisDabRenderingJobSP j = *it;
 
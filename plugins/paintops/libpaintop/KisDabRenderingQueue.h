@@ -21,7 +21,7 @@
 
 #include <QScopedPointer>
 
-#include "kritadefaultpaintops_export.h"
+#include "kritapaintop_export.h"
 
 #include <QList>
 class KisDabRenderingJob;
@@ -29,7 +29,7 @@ struct KisRenderedDab;
 
 #include "KisDabCacheUtils.h"
 
-class KRITADEFAULTPAINTOPS_EXPORT KisDabRenderingQueue
+class PAINTOP_EXPORT KisDabRenderingQueue
 {
 public:
     struct CacheInterface {
@@ -42,6 +42,13 @@ public:
                                 bool *shouldUseCache) = 0;
 
         virtual bool hasSeparateOriginal(KisDabCacheUtils::DabRenderingResources *resources) const = 0;
+
+        /**
+         * Returns a copy of a previously rendered original dab with the
+         * same quantized parameters or null if there is no such dab
+         */
+        virtual KisFixedPaintDeviceSP fetchDabFromLruCache(const KisDabCacheUtils::DabCacheKey &key) = 0;
+        virtual void putDabToLruCache(const KisDabCacheUtils::DabCacheKey &key, KisFixedPaintDeviceSP dab) = 0;
     };
 
 
@@ -43,3 +43,13 @@ bool KisDabRenderingQueueCache::hasSeparateOriginal(KisDabCacheUtils::DabRenderi
 {
     return needSeparateOriginal(resources->textureOption.data(), resources->sharpnessOption.data());
 }
+
+KisFixedPaintDeviceSP KisDabRenderingQueueCache::fetchDabFromLruCache(const KisDabCacheUtils::DabCacheKey &key)
+{
+    return KisDabCacheBase::fetchDabFromLruCache(key);
+}
+
+void KisDabRenderingQueueCache::putDabToLruCache(const KisDabCacheUtils::DabCacheKey &key, KisFixedPaintDeviceSP dab)
+{
+    KisDabCacheBase::putDabToLruCache(key, dab);
+}
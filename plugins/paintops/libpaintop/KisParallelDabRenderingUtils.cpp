@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisParallelDabRenderingUtils.h"
+
+#include <kis_assert.h>
+
+
+namespace KisParallelDabRenderingUtils
+{
+
+int generateDabSeed(KisRandomSourceSP strokeRandomSource)
+{
+    return int(strokeRandomSource->generate());
+}
+
+KisRandomSourceSP createJobRandomSource(int dabSeed, int jobIndex)
+{
+    /**
+     * Taus88 does not like close seeds much, so spread the job
+     * indexes over the whole range of integers
+     */
+    const quint32 seed = quint32(dabSeed) ^ (quint32(jobIndex + 1) * 2654435761U);
+    return KisRandomSourceSP(new KisRandomSource(int(seed)));
+}
+
+QVector<StripeJob> splitIntoStripes(const QRect &rc, int dabSeed, int stripeHeight)
+{
+    KIS_SAFE_ASSERT_RECOVER(stripeHeight > 0) {
+        stripeHeight = rc.height();
+    }
+
+    QVector<StripeJob> jobs;
+
+    for (int y = rc.top(); y <= rc.bottom(); y += stripeHeight) {
+        StripeJob job;
+        job.index = jobs.size();
+        job.rect = QRect(rc.left(), y, rc.width(), qMin(stripeHeight, rc.bottom() - y + 1));
+        job.randomSource = createJobRandomSource(dabSeed, job.index);
+        jobs.append(job);
+    }
+
+    return jobs;
+}
+
+QVector<RangeJob> splitIntoRanges(int numElements, int minElementsPerJob, int maxJobs)
+{
+    QVector<RangeJob> jobs;
+    if (numElements <= 0) return jobs;
+
+    const int elementsPerJob =
+        qMax(qMax(1, minElementsPerJob),
+             (numElements + maxJobs - 1) / qMax(1, maxJobs));
+
+    for (int i = 0; i < numElements; i += elementsPerJob) {
+        RangeJob job;
+        job.index = jobs.size();
+        job.begin = i;
+        job.end = qMin(numElements, i + elementsPerJob);
+        jobs.append(job);
+    }
+
+    return jobs;
+}
+
+}
@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef KISPARALLELDABRENDERINGUTILS_H
+#define KISPARALLELDABRENDERINGUTILS_H
+
+#include <QRect>
+#include <QVector>
+#include <QtConcurrent>
+
+#include <brushengine/kis_random_source.h>
+
+#include "kritapaintop_export.h"
+
+/**
+ * Helpers for the paintops that render a single dab with several
+ * threads (e.g. spray or deform). The dab is split into a set of jobs
+ * that are independent from each other and the jobs are run via
+ * QtConcurrent.
+ *
+ * The way the dab is split into jobs depends on the size of the dab
+ * only, it never depends on the number of threads available. Together
+ * with the per-job random sources it guarantees that the dab looks
+ * exactly the same on every machine and in every run with the same
+ * stroke seed.
+ *
+ * For the brushes that generate a dab from a brush tip and do not need
+ * the layer data for that, see KisDabRenderingQueue and
+ * KisDabRenderingExecutor, which render the dabs asynchronously in the
+ * stroke jobs.
+ */
+namespace KisParallelDabRenderingUtils
+{
+
+/**
+ * A stripe of the dab rendered by a single thread
+ */
+struct StripeJob
+{
+    int index = 0;
+    QRect rect;
+    KisRandomSourceSP randomSource;
+};
+
+/**
+ * A range [begin, end) of the dab's elements (particles, bristles, etc.)
+ * rendered by a single thread
+ */
+struct RangeJob
+{
+    int index = 0;
+    int begin = 0;
+    int end = 0;
+};
+
+/**
+ * Takes a seed for all the jobs of the dab from the stroke's random
+ * source. Must be called on the stroke thread, once per dab.
+ */
+PAINTOP_EXPORT int generateDabSeed(KisRandomSourceSP strokeRandomSource);
+
+/**
+ * Creates a random source for job \p jobIndex of the dab. The sources of
+ * different jobs are independent from each other.
+ */
+PAINTOP_EXPORT KisRandomSourceSP createJobRandomSource(int dabSeed, int jobIndex);
+
+/**
+ * Splits \p rc into horizontal stripes of \p stripeHeight rows. Every stripe
+ * gets its own random source created from \p dabSeed.
+ */
+PAINTOP_EXPORT QVector<StripeJob> splitIntoStripes(const QRect &rc, int dabSeed, int stripeHeight = 32);
+
+/**
+ * Splits \p numElements into ranges of at least \p minElementsPerJob
+ * elements, but not more than \p maxJobs ranges.
+ */
+PAINTOP_EXPORT QVector<RangeJob> splitIntoRanges(int numElements, int minElementsPerJob, int maxJobs = 16);
+
+/**
+ * Runs \p func on every job in parallel. A single job is executed in the
+ * calling thread to avoid the overhead of the thread pool.
+ */
+template <typename Job, typename Func>
+void runJobs(QVector<Job> &jobs, Func func)
+{
+    if (jobs.size() > 1) {
+        QtConcurrent::blockingMap(jobs, func);
+    } else if (!jobs.isEmpty()) {
+        func(jobs.first());
+    }
+}
+
+}
+
+#endif // KISPARALLELDABRENDERINGUTILS_H
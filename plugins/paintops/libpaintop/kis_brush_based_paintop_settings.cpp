@@ -22,6 +22,7 @@
 #include <kis_airbrush_option_widget.h>
 #include "kis_brush_based_paintop_options_widget.h"
 #include <kis_boundary.h>
+#include <KisBrushOutlineCache.h>
 #include "KisBrushServerProvider.h"
 #include <QLineF>
 #include "kis_signals_blocker.h"
@@ -118,7 +119,8 @@ QPainterPath KisBrushBasedPaintOpSettings::brushOutlineImpl(const KisPaintInform
         if (!brush) return path;
         qreal finalScale = brush->scale() * additionalScale;
 
-        QPainterPath realOutline = brush->outline();
+        QPainterPath realOutline =
+            KisBrushOutlineCache::instance()->outline(brush, finalScale * alignForZoom);
 
         if (mode.forceCircle) {
 
@@ -74,6 +74,7 @@ KisCurveOption::KisCurveOption(const QString& name, KisPaintOpOption::PaintopCat
 
 
     m_commonCurve = defaultCurve();
+    updateCommonCurveTransfer();
 }
 
 KisCurveOption::~KisCurveOption()
@@ -184,6 +185,7 @@ void KisCurveOption::readNamedOptionSetting(const QString& prefix, const KisProp
     //dbgKrita << "\tPressure" + prefix << isChecked();
 
     m_sensorMap.clear();
+    m_sensorPlan.clear();
 
     // Replace all sensors with the inactive defaults
     Q_FOREACH (const DynamicSensorType sensorType, KisDynamicSensor::sensorsTypes()) {
@@ -242,6 +244,7 @@ void KisCurveOption::readNamedOptionSetting(const QString& prefix, const KisProp
 
     if (m_useSameCurve) {
         m_commonCurve = setting->getCubicCurve(prefix + "commonCurve", commonCurve);
+        updateCommonCurveTransfer();
     }
 
     // At least one sensor needs to be active
@@ -266,6 +269,26 @@ void KisCurveOption::replaceSensor(KisDynamicSensorSP s)
 {
     Q_ASSERT(s);
     m_sensorMap[s->sensorType()] = s;
+    rebuildSensorPlan();
+}
+
+void KisCurveOption::rebuildSensorPlan()
+{
+    m_sensorPlan.clear();
+    m_sensorPlan.reserve(m_sensorMap.size());
+
+    Q_FOREACH (KisDynamicSensorSP sensor, m_sensorMap) {
+        SensorPlanEntry entry;
+        entry.sensor = sensor.data();
+        entry.isAdditive = sensor->isAdditive();
+        entry.isAbsoluteRotation = sensor->isAbsoluteRotation();
+        m_sensorPlan.append(entry);
+    }
+}
+
+void KisCurveOption::updateCommonCurveTransfer()
+{
+    m_commonCurveTransfer = m_commonCurve.floatTransfer(256);
 }
 
 KisDynamicSensorSP KisCurveOption::sensor(DynamicSensorType sensorType, bool active) const
@@ -348,6 +371,7 @@ void KisCurveOption::setUseSameCurve(bool useSameCurve)
 void KisCurveOption::setCommonCurve(KisCubicCurve curve)
 {
     m_commonCurve = curve;
+    updateCommonCurveTransfer();
 }
 
 void KisCurveOption::setCurve(DynamicSensorType sensorType, bool useSameCurve, const KisCubicCurve &curve)
@@ -355,6 +379,7 @@ void KisCurveOption::setCurve(DynamicSensorType sensorType, bool useSameCurve, c
     if (useSameCurve == m_useSameCurve) {
         if (useSameCurve) {
             m_commonCurve = curve;
+            updateCommonCurveTransfer();
         }
         else {
             KisDynamicSensorSP s = sensor(sensorType, false);
@@ -367,6 +392,7 @@ void KisCurveOption::setCurve(DynamicSensorType sensorType, bool useSameCurve, c
     else {
         if (!m_useSameCurve && useSameCurve) {
             m_commonCurve = curve;
+            updateCommonCurveTransfer();
         }
         else { //if (m_useSameCurve && !useSameCurve)
             KisDynamicSensorSP s = 0;
@@ -401,52 +427,59 @@ KisCurveOption::ValueComponents KisCurveOption::computeValueComponents(const Kis
     ValueComponents components;
 
     if (m_useCurve) {
-        QMap<DynamicSensorType, KisDynamicSensorSP>::const_iterator i;
-        QList<double> sensorValues;
-        for (i = m_sensorMap.constBegin(); i != m_sensorMap.constEnd(); ++i) {
-            KisDynamicSensorSP s(i.value());
-
-            if (s->isActive()) {
-                qreal valueFromCurve = m_useSameCurve ? s->parameter(info, m_commonCurve, true) : s->parameter(info);
-                if (s->isAdditive()) {
-                    components.additive += valueFromCurve;
-                    components.hasAdditive = true;
-                } else if (s->isAbsoluteRotation()) {
-                    components.absoluteOffset = valueFromCurve;
-                    components.hasAbsoluteOffset =true;
+        /**
+         * The scaling values are combined on the fly to avoid
+         * allocating a temporary list for every dab
+         */
+        int numScalingValues = 0;
+        qreal scalingSum = 0.0;
+        qreal scalingProduct = 1.0;
+        qreal scalingMin = 0.0;
+        qreal scalingMax = 0.0;
+
+        for (auto it = m_sensorPlan.constBegin(); it != m_sensorPlan.constEnd(); ++it) {
+            KisDynamicSensor *s = it->sensor;
+            if (!s->isActive()) continue;
+
+            const qreal valueFromCurve =
+                m_useSameCurve ?
+                    s->parameter(info, m_commonCurveTransfer, true) :
+                    s->parameter(info);
+
+            if (it->isAdditive) {
+                components.additive += valueFromCurve;
+                components.hasAdditive = true;
+            } else if (it->isAbsoluteRotation) {
+                components.absoluteOffset = valueFromCurve;
+                components.hasAbsoluteOffset =true;
+            } else {
+                if (!numScalingValues) {
+                    scalingMin = scalingMax = valueFromCurve;
                 } else {
-                    sensorValues << valueFromCurve;
-                    components.hasScaling = true;
+                    scalingMin = qMin(scalingMin, valueFromCurve);
+                    scalingMax = qMax(scalingMax, valueFromCurve);
                 }
+                scalingSum += valueFromCurve;
+                scalingProduct *= valueFromCurve;
+                numScalingValues++;
+                components.hasScaling = true;
             }
         }
 
-        if (sensorValues.count() == 1) {
-            components.scaling = sensorValues.first();
-        } else {
+        if (numScalingValues == 1) {
+            components.scaling = scalingSum;
+        } else if (numScalingValues > 1) {
 
             if (m_curveMode == 1){           // add
-                components.scaling = 0;
-                double i;
-                foreach (i, sensorValues) {
-                    components.scaling += i;
-                }
+                components.scaling = scalingSum;
             } else if (m_curveMode == 2){    //max
-                components.scaling = *std::max_element(sensorValues.begin(), sensorValues.end());
-
+                components.scaling = scalingMax;
             } else if (m_curveMode == 3){    //min
-                components.scaling = *std::min_element(sensorValues.begin(), sensorValues.end());
-
+                components.scaling = scalingMin;
             } else if (m_curveMode == 4){    //difference
-                double max = *std::max_element(sensorValues.begin(), sensorValues.end());
-                double min = *std::min_element(sensorValues.begin(), sensorValues.end());
-                components.scaling = max-min;
-
+                components.scaling = scalingMax - scalingMin;
             } else {                         //multuply - default
-                double i;
-                foreach (i, sensorValues) {
-                    components.scaling *= i;
-                }
+                components.scaling = scalingProduct;
             }
         }
 
@@ -198,6 +198,29 @@ protected:
 
 private:
 
+    void rebuildSensorPlan();
+    void updateCommonCurveTransfer();
+
+    /**
+     * A flat copy of m_sensorMap that is walked for every dab in
+     * computeValueComponents(). It lets us avoid iterating the map,
+     * calling virtual type queries and allocating temporary lists
+     * in the hot path. The activity state of the sensors is still
+     * checked on every call, because the option widgets may toggle
+     * the sensors directly.
+     */
+    struct SensorPlanEntry {
+        KisDynamicSensor *sensor;
+        bool isAdditive;
+        bool isAbsoluteRotation;
+    };
+    QVector<SensorPlanEntry> m_sensorPlan;
+
+    /**
+     * Precomputed transfer table of m_commonCurve
+     */
+    QVector<qreal> m_commonCurveTransfer;
+
     qreal m_value;
     qreal m_minValue;
     qreal m_maxValue;
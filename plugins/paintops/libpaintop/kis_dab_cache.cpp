@@ -201,9 +201,17 @@ KisFixedPaintDeviceSP KisDabCache::fetchDabCommon(const KoColorSpace *cs,
         return fetchFromCache(&resources, info, dstDabRect);
     }
 
-    // 3. Generate new dab
-
-    generateDab(di, &resources, &m_d->dab);
+    // 3. Try to find a similar dab in the LRU cache or generate a new one
+
+    KisFixedPaintDeviceSP cachedDab = fetchDabFromLruCache(di.cacheKey);
+    if (cachedDab && *cachedDab->colorSpace() == *cs) {
+        m_d->dab = cachedDab;
+        *dstDabRect = correctDabRectWhenFetchedFromCache(*dstDabRect, m_d->dab->bounds().size());
+        resources.brush->notifyCachedDabPainted(info);
+    } else {
+        generateDab(di, &resources, &m_d->dab);
+        putDabToLruCache(di.cacheKey, m_d->dab);
+    }
 
     // 4. Do postprocessing
     if (di.needsPostprocessing) {
@@ -213,7 +221,7 @@ KisFixedPaintDeviceSP KisDabCache::fetchDabCommon(const KoColorSpace *cs,
 
         *m_d->dabOriginal = *m_d->dab;
 
-        postProcessDab(m_d->dab, di.dstDabRect.topLeft(), info, &resources);
+        postProcessDab(m_d->dab, dstDabRect->topLeft(), info, &resources);
     }
 
     return m_d->dab;
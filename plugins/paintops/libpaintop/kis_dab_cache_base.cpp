@@ -28,9 +28,13 @@
 #include <kis_precision_option.h>
 #include <kis_fixed_paint_device.h>
 #include <brushengine/kis_paintop.h>
+#include <kis_global.h>
 
 #include <kundo2command.h>
 
+#include <QCache>
+#include <cmath>
+
 struct PrecisionValues {
     qreal angle;
     qreal sizeFrac;
@@ -62,6 +66,26 @@ struct KisDabCacheBase::SavedDabParameters {
     int index;
     MirrorProperties mirrorProperties;
 
+    KisDabCacheUtils::DabCacheKey quantize(const KisDabCacheUtils::DabCacheQuantization &q) const {
+        KisDabCacheUtils::DabCacheKey key;
+
+        key.isValid = true;
+        key.color = color;
+        key.angle = qRound64(normalizeAngle(angle) / q.angle);
+        key.width = q.sizeFrac > 0 ? qRound64(std::log(qMax(1, width)) / std::log1p(q.sizeFrac)) : width;
+        key.height = q.sizeFrac > 0 ? qRound64(std::log(qMax(1, height)) / std::log1p(q.sizeFrac)) : height;
+        key.subPixelX = qRound64(subPixelX / q.subPixel);
+        key.subPixelY = qRound64(subPixelY / q.subPixel);
+        key.softnessFactor = qRound64(softnessFactor / q.softnessFactor);
+        key.lightnessStrength = qRound64(lightnessStrength / q.lightnessStrength);
+        key.ratio = qRound64(ratio / q.ratio);
+        key.index = index;
+        key.horizontalMirror = mirrorProperties.horizontalMirror;
+        key.verticalMirror = mirrorProperties.verticalMirror;
+
+        return key;
+    }
+
     bool compare(const SavedDabParameters &rhs, int precisionLevel) const {
         const PrecisionValues &prec = precisionLevels[precisionLevel];
 
@@ -85,7 +109,8 @@ struct KisDabCacheBase::Private {
     Private()
         : mirrorOption(0),
           precisionOption(0),
-          subPixelPrecisionDisabled(false)
+          subPixelPrecisionDisabled(false),
+          lruCache(defaultLruCacheLimit)
     {}
 
     KisPressureMirrorOption *mirrorOption;
@@ -94,6 +119,15 @@ struct KisDabCacheBase::Private {
 
     SavedDabParameters lastSavedDabParameters;
 
+    /**
+     * The cost of the items is measured in KiB
+     */
+    QCache<KisDabCacheUtils::DabCacheKey, KisFixedPaintDevice> lruCache;
+    bool hasQuantizationOverride = false;
+    KisDabCacheUtils::DabCacheQuantization quantizationOverride;
+
+    static const int defaultLruCacheLimit = 32 * 1024;
+
     static qreal positiveFraction(qreal x);
 };
 
@@ -119,6 +153,49 @@ void KisDabCacheBase::setPrecisionOption(KisPrecisionOption *option)
     m_d->precisionOption = option;
 }
 
+void KisDabCacheBase::setLruCacheLimit(int kibibytes)
+{
+    m_d->lruCache.setMaxCost(kibibytes);
+}
+
+void KisDabCacheBase::setLruCacheQuantization(const KisDabCacheUtils::DabCacheQuantization &value)
+{
+    /**
+     * The quanta are used as divisors in SavedDabParameters::quantize(),
+     * so they are clamped to the tolerances of the highest precision
+     * level. Zero size quantum is fine, it means the exact match.
+     */
+    KisDabCacheUtils::DabCacheQuantization q = value;
+    q.angle = qMax(eps, q.angle);
+    q.sizeFrac = qMax(qreal(0.0), q.sizeFrac);
+    q.subPixel = qMax(eps, q.subPixel);
+    q.softnessFactor = qMax(eps, q.softnessFactor);
+    q.lightnessStrength = qMax(eps, q.lightnessStrength);
+    q.ratio = qMax(eps, q.ratio);
+
+    m_d->quantizationOverride = q;
+    m_d->hasQuantizationOverride = true;
+}
+
+KisFixedPaintDeviceSP KisDabCacheBase::fetchDabFromLruCache(const KisDabCacheUtils::DabCacheKey &key)
+{
+    if (!key.isValid) return 0;
+
+    KisFixedPaintDevice *dab = m_d->lruCache.object(key);
+    return dab ? new KisFixedPaintDevice(*dab) : 0;
+}
+
+void KisDabCacheBase::putDabToLruCache(const KisDabCacheUtils::DabCacheKey &key, KisFixedPaintDeviceSP dab)
+{
+    if (!key.isValid || !dab || m_d->lruCache.contains(key)) return;
+
+    const QRect bounds = dab->bounds();
+    const int cost = qMax(1, bounds.width() * bounds.height() * int(dab->pixelSize()) / 1024);
+
+    // QCache takes the ownership over the copy
+    m_d->lruCache.insert(key, new KisFixedPaintDevice(*dab), cost);
+}
+
 void KisDabCacheBase::disableSubpixelPrecision()
 {
     m_d->subPixelPrecisionDisabled = true;
@@ -290,6 +367,26 @@ void KisDabCacheBase::fetchDabGenerationInfo(bool hasDabInCache,
         m_d->lastSavedDabParameters = newParams;
     }
 
+    /**
+     * The highest precision level has epsilon tolerances, so the
+     * cache would never be hit there
+     */
+    const int lastPrecisionLevel = sizeof(precisionLevels) / sizeof(precisionLevels[0]) - 1;
+
+    if (!*shouldUseCache && di->solidColorFill && m_d->lruCache.maxCost() > 0 &&
+        (m_d->hasQuantizationOverride || precisionLevel < lastPrecisionLevel)) {
+
+        const PrecisionValues &prec = precisionLevels[precisionLevel];
+        const KisDabCacheUtils::DabCacheQuantization quantization =
+            m_d->hasQuantizationOverride ? m_d->quantizationOverride :
+            KisDabCacheUtils::DabCacheQuantization{prec.angle, prec.sizeFrac, prec.subPixel,
+                                                   prec.softnessFactor, prec.lightnessStrength,
+                                                   prec.ratio};
+
+        di->cacheKey = newParams.quantize(quantization);
+        di->cacheKey.precisionLevel = m_d->hasQuantizationOverride ? -1 : precisionLevel;
+    }
+
     di->needsPostprocessing = needSeparateOriginal(resources->textureOption.data(), resources->sharpnessOption.data());
 }
 
@@ -68,6 +68,26 @@ public:
      */
     void disableSubpixelPrecision();
 
+    /**
+     * Sets the memory limit (in KiB) of the LRU cache of the recently
+     * rendered dabs. Zero limit disables the cache.
+     *
+     * When a dab falls into the same quantization bucket as one of the
+     * dabs in the cache, the cached dab is reused instead of rendering a
+     * new one. It helps a lot with the brushes having rotation or size
+     * jitter, which defeat comparison to the last dab only.
+     */
+    void setLruCacheLimit(int kibibytes);
+
+    /**
+     * Overrides the size of the quantization buckets of the LRU cache.
+     * By default, they are defined by the precision level of the brush,
+     * and the cache is not used on the highest precision level.
+     * Non-positive quanta are clamped to the tolerances of the highest
+     * precision level (the size quantum may be zero).
+     */
+    void setLruCacheQuantization(const KisDabCacheUtils::DabCacheQuantization &value);
+
     /**
      * Return true if the dab needs postprocessing by special options
      * like 'texture' or 'sharpness'
@@ -98,6 +118,19 @@ protected:
                                 KisDabCacheUtils::DabGenerationInfo *di,
                                 bool *shouldUseCache);
 
+    /**
+     * Returns a copy of the cached dab with the key \p key or null if
+     * there is no such dab in the LRU cache. The original (not
+     * postprocessed) dabs are stored in the cache.
+     */
+    KisFixedPaintDeviceSP fetchDabFromLruCache(const KisDabCacheUtils::DabCacheKey &key);
+
+    /**
+     * Stores a copy of the original (not postprocessed) \p dab in the LRU
+     * cache. Does nothing if the key is invalid or already cached.
+     */
+    void putDabToLruCache(const KisDabCacheUtils::DabCacheKey &key, KisFixedPaintDeviceSP dab);
+
 private:
     struct SavedDabParameters;
     struct DabPosition;
@@ -510,22 +510,27 @@ void KisDynamicSensor::fromXML(const QDomElement& e)
     if (!curve_elt.isNull()) {
         m_customCurve = true;
         m_curve.fromString(curve_elt.text());
+        m_transfer = m_curve.floatTransfer(256);
     }
 }
 
 qreal KisDynamicSensor::parameter(const KisPaintInformation& info)
 {
-    return parameter(info, m_curve, m_customCurve);
+    return parameter(info, m_transfer, m_customCurve);
 }
 
 qreal KisDynamicSensor::parameter(const KisPaintInformation& info, const KisCubicCurve curve, const bool customCurve)
+{
+    return parameter(info, curve.floatTransfer(256), customCurve);
+}
+
+qreal KisDynamicSensor::parameter(const KisPaintInformation& info, const QVector<qreal> &transfer, bool customCurve)
 {
     const qreal val = value(info);
     if (customCurve) {
         qreal scaledVal = isAdditive() ? additiveToScaling(val) :
                           isAbsoluteRotation() ? KisAlgebra2D::wrapValue(val + 0.5, 0.0, 1.0) : val;
 
-        const QVector<qreal> transfer = curve.floatTransfer(256);
         scaledVal = KisCubicCurve::interpolateLinear(scaledVal, transfer);
 
         return isAdditive() ? scalingToAdditive(scaledVal) :
@@ -540,6 +545,7 @@ void KisDynamicSensor::setCurve(const KisCubicCurve& curve)
 {
     m_customCurve = true;
     m_curve = curve;
+    m_transfer = m_curve.floatTransfer(256);
 }
 
 const KisCubicCurve& KisDynamicSensor::curve() const
@@ -547,6 +553,11 @@ const KisCubicCurve& KisDynamicSensor::curve() const
     return m_curve;
 }
 
+const QVector<qreal>& KisDynamicSensor::curveTransfer() const
+{
+    return m_transfer;
+}
+
 void KisDynamicSensor::removeCurve()
 {
     m_customCurve = false;
@@ -122,6 +122,13 @@ public:
      */
     qreal parameter(const KisPaintInformation& info, const KisCubicCurve curve, const bool customCurve);
 
+    /**
+     * Same as above, but uses a precomputed transfer table of the curve
+     * (see KisCubicCurve::floatTransfer()). Used in the hot paint path to
+     * avoid copying the curve and its transfer table for every dab.
+     */
+    qreal parameter(const KisPaintInformation& info, const QVector<qreal> &transfer, bool customCurve);
+
     /**
      * This function is call before beginning a stroke to reset the sensor.
      * Default implementation does nothing.
@@ -180,6 +187,12 @@ public:
 
     void setCurve(const KisCubicCurve& curve);
     const KisCubicCurve& curve() const;
+
+    /**
+     * @return the 256-entry transfer table of curve(), valid only
+     *         when hasCustomCurve() is true
+     */
+    const QVector<qreal>& curveTransfer() const;
     void removeCurve();
     bool hasCustomCurve() const;
 
@@ -222,6 +235,7 @@ private:
     DynamicSensorType m_type;
     bool m_customCurve;
     KisCubicCurve m_curve;
+    QVector<qreal> m_transfer;
     bool m_active;
 
 };
@@ -203,9 +203,15 @@ void KisFilterOption::lodLimitations(KisPaintopLodLimitations *l) const
     KisFilterConfigurationSP config = filterConfig();
 
     if (m_currentFilter && config) {
+        /**
+         * Non-linear filters can be used in the instant preview mode
+         * only if they know how to scale their kernel to the level
+         * of detail they are applied to.
+         */
         QRect testRect(0,0,100,100);
-        if (m_currentFilter->neededRect(testRect, config, 0) != testRect ||
-            m_currentFilter->changedRect(testRect, config, 0) != testRect) {
+        if ((m_currentFilter->neededRect(testRect, config, 0) != testRect ||
+             m_currentFilter->changedRect(testRect, config, 0) != testRect) &&
+            !m_currentFilter->supportsLevelOfDetail(config, 1)) {
 
             l->blockers << KoID("filter-nonlinear", i18nc("PaintOp instant preview limitation", "\"%1\" does not support scaled preview (non-linear filter)", config->name()));
         }
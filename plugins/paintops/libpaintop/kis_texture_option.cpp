@@ -384,28 +384,33 @@ void KisTextureProperties::apply(KisFixedPaintDeviceSP dab, const QPoint &offset
     fillPainter.fillRect(x - 1, y - 1, rect.width() + 2, rect.height() + 2, mask, maskBounds);
     fillPainter.end();
 
-    qreal pressure = m_strengthOption.apply(info);
-    quint8* dabData = dab->data();
-
-    KisHLineIteratorSP iter = fillDevice->createHLineIteratorNG(x, y, rect.width());
-    for (int row = 0; row < rect.height(); ++row) {
-        for (int col = 0; col < rect.width(); ++col) {
-            if (m_texturingMode == MULTIPLY) {
-                dab->colorSpace()->multiplyAlpha(dabData, quint8(*iter->oldRawData() * pressure), 1);
-            }
-            else {
-                int pressureOffset = (1.0 - pressure) * 255;
-
-                qint16 maskA = *iter->oldRawData() + pressureOffset;
-                quint8 dabA = dab->colorSpace()->opacityU8(dabData);
+    const qreal pressure = m_strengthOption.apply(info);
+    const int numPixels = rect.width() * rect.height();
+
+    /**
+     * Fetch the whole texture rect at once and convert it into a plain
+     * alpha mask, so that the dab itself could be processed by a single
+     * (vectorized) call to the color space
+     */
+    QVector<quint8> maskBytes(numPixels);
+    fillDevice->readBytes(maskBytes.data(), x, y, rect.width(), rect.height());
+
+    quint8 *maskPtr = maskBytes.data();
+
+    if (m_texturingMode == MULTIPLY) {
+        for (int i = 0; i < numPixels; i++) {
+            maskPtr[i] = quint8(maskPtr[i] * pressure);
+        }
 
-                dabA = qMax(0, (qint16)dabA - maskA);
-                dab->colorSpace()->setOpacity(dabData, dabA, 1);
-            }
+        dab->colorSpace()->applyAlphaU8Mask(dab->data(), maskPtr, numPixels);
+    }
+    else {
+        const int pressureOffset = (1.0 - pressure) * 255;
 
-            iter->nextPixel();
-            dabData += dab->pixelSize();
+        for (int i = 0; i < numPixels; i++) {
+            maskPtr[i] = quint8(qMin(255, maskPtr[i] + pressureOffset));
         }
-        iter->nextRow();
+
+        dab->colorSpace()->subtractAlphaU8Mask(dab->data(), maskPtr, numPixels);
     }
 }
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisCurveOptionBenchmark.h"
+
+#include <QTest>
+
+#include <brushengine/kis_paint_information.h>
+#include "kis_curve_option.h"
+#include "kis_dynamic_sensor.h"
+
+namespace {
+
+/**
+ * A typical heavy preset evaluates about ten curve options
+ * for every dab, each controlled by a few sensors
+ */
+const int numOptions = 10;
+const int numDabs = 100000;
+
+KisCubicCurve sCurve()
+{
+    QList<QPointF> points;
+    points << QPointF(0.0, 0.0) << QPointF(0.3, 0.1) << QPointF(0.7, 0.9) << QPointF(1.0, 1.0);
+    return KisCubicCurve(points);
+}
+
+void initOption(KisCurveOption *option, bool useSameCurve)
+{
+    const QList<DynamicSensorType> types =
+        {PRESSURE, SPEED, XTILT, ROTATION, TANGENTIAL_PRESSURE};
+
+    option->setUseSameCurve(useSameCurve);
+    option->setCommonCurve(sCurve());
+
+    Q_FOREACH (DynamicSensorType type, types) {
+        KisDynamicSensorSP sensor = option->sensor(type, false);
+        sensor->setActive(true);
+        sensor->setCurve(sCurve());
+    }
+}
+
+QVector<KisPaintInformation> generateDabs()
+{
+    QVector<KisPaintInformation> dabs;
+    dabs.reserve(1000);
+
+    for (int i = 0; i < 1000; i++) {
+        const qreal t = qreal(i) / 1000;
+        dabs << KisPaintInformation(QPointF(10.0 * i, 5.0 * i),
+                                    t, 60.0 * t - 30.0, 30.0 - 60.0 * t,
+                                    360.0 * t, t, 1.0, i, 0.5 * t);
+    }
+
+    return dabs;
+}
+
+void runBenchmark(bool useSameCurve)
+{
+    QVector<QSharedPointer<KisCurveOption>> options;
+    for (int i = 0; i < numOptions; i++) {
+        QSharedPointer<KisCurveOption> option(
+            new KisCurveOption(QString("Option%1").arg(i), KisPaintOpOption::GENERAL, true));
+        initOption(option.data(), useSameCurve);
+        options << option;
+    }
+
+    const QVector<KisPaintInformation> dabs = generateDabs();
+    qreal sum = 0.0;
+
+    QBENCHMARK_ONCE {
+        for (int i = 0; i < numDabs; i++) {
+            const KisPaintInformation &info = dabs[i % dabs.size()];
+            Q_FOREACH (const QSharedPointer<KisCurveOption> &option, options) {
+                sum += option->computeSizeLikeValue(info);
+            }
+        }
+    }
+
+    QVERIFY(sum > 0.0);
+}
+
+}
+
+void KisCurveOptionBenchmark::benchmarkSharedCurve()
+{
+    runBenchmark(true);
+}
+
+void KisCurveOptionBenchmark::benchmarkSeparateCurves()
+{
+    runBenchmark(false);
+}
+
+QTEST_MAIN(KisCurveOptionBenchmark)
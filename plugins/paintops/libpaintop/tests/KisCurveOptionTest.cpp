@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisCurveOptionTest.h"
+
+#include <QTest>
+
+#include <brushengine/kis_paint_information.h>
+#include "kis_curve_option.h"
+#include "kis_dynamic_sensor.h"
+
+void KisCurveOptionTest::testCombinedValues()
+{
+    KisCurveOption option("Test", KisPaintOpOption::GENERAL, true);
+    option.setUseSameCurve(true);
+    option.setCommonCurve(option.emptyCurve());
+
+    option.sensor(PRESSURE, false)->setActive(true);
+    option.sensor(TANGENTIAL_PRESSURE, false)->setActive(true);
+
+    KisPaintInformation info(QPointF(), 0.5, 0.0, 0.0, 0.0, 0.25, 1.0, 0.0, 0.0);
+
+    option.setCurveMode(0);
+    QCOMPARE(option.computeSizeLikeValue(info), 0.125);
+
+    option.setCurveMode(1);
+    QCOMPARE(option.computeSizeLikeValue(info), 0.75);
+
+    option.setCurveMode(2);
+    QCOMPARE(option.computeSizeLikeValue(info), 0.5);
+
+    option.setCurveMode(3);
+    QCOMPARE(option.computeSizeLikeValue(info), 0.25);
+
+    option.setCurveMode(4);
+    QCOMPARE(option.computeSizeLikeValue(info), 0.25);
+
+    option.sensor(TANGENTIAL_PRESSURE, false)->setActive(false);
+    QCOMPARE(option.computeSizeLikeValue(info), 0.5);
+}
+
+QTEST_MAIN(KisCurveOptionTest)
@@ -0,0 +1,237 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisDabCacheBaseTest.h"
+
+#include <QTest>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <kis_global.h>
+
+#include <kis_dab_cache_base.h>
+#include <kis_fixed_paint_device.h>
+#include <kis_mask_generator.h>
+#include "kis_auto_brush.h"
+
+/**
+ * Exposes the cache keys and the LRU cache of KisDabCacheBase
+ */
+class TestingDabCache : public KisDabCacheBase
+{
+public:
+    TestingDabCache() {
+        KisCircleMaskGenerator* circle = new KisCircleMaskGenerator(10, 1.0, 1.0, 1.0, 2, false);
+        m_resources.brush = KisBrushSP(new KisAutoBrush(circle, 0.0, 0.0));
+    }
+
+    KisDabCacheUtils::DabCacheKey cacheKey(const QPointF &pos, const KisDabShape &shape) {
+        KoColor color;
+        KisPaintInformation pi(pos);
+        KisDabCacheUtils::DabRequestInfo request(color, pos, shape, pi, 1.0);
+
+        KisDabCacheUtils::DabGenerationInfo di;
+        bool shouldUseCache = false;
+        fetchDabGenerationInfo(false, &m_resources, request, &di, &shouldUseCache);
+
+        return di.cacheKey;
+    }
+
+    using KisDabCacheBase::fetchDabFromLruCache;
+    using KisDabCacheBase::putDabToLruCache;
+
+private:
+    KisDabCacheUtils::DabRenderingResources m_resources;
+};
+
+namespace {
+
+KisDabCacheUtils::DabCacheQuantization uniformQuantization(qreal value)
+{
+    return KisDabCacheUtils::DabCacheQuantization{value, value, value, value, value, value};
+}
+
+}
+
+void KisDabCacheBaseTest::testNoKeyOnHighestPrecision()
+{
+    TestingDabCache cache;
+
+    // without a precision option the highest precision level is used
+    QVERIFY(!cache.cacheKey(QPointF(10, 10), KisDabShape()).isValid);
+
+    cache.setLruCacheQuantization(uniformQuantization(0.1));
+    QVERIFY(cache.cacheKey(QPointF(10, 10), KisDabShape()).isValid);
+}
+
+void KisDabCacheBaseTest::testQuantizeAngle()
+{
+    TestingDabCache cache;
+
+    KisDabCacheUtils::DabCacheQuantization q = uniformQuantization(0.1);
+    q.sizeFrac = 0.0;
+    cache.setLruCacheQuantization(q);
+
+    const QPointF pos(10, 10);
+
+    const KisDabCacheUtils::DabCacheKey key1 = cache.cacheKey(pos, KisDabShape(1.0, 1.0, 0.10));
+    const KisDabCacheUtils::DabCacheKey key2 = cache.cacheKey(pos, KisDabShape(1.0, 1.0, 0.12));
+    const KisDabCacheUtils::DabCacheKey key3 = cache.cacheKey(pos, KisDabShape(1.0, 1.0, 0.16));
+
+    QVERIFY(key1.isValid);
+    QCOMPARE(key1.angle, qint64(1));
+    QVERIFY(key1 == key2);
+    QCOMPARE(key3.angle, qint64(2));
+    QVERIFY(!(key1 == key3));
+
+    // the angle is normalized before quantization
+    const KisDabCacheUtils::DabCacheKey key4 = cache.cacheKey(pos, KisDabShape(1.0, 1.0, 0.10 + 2 * M_PI));
+    QVERIFY(key1 == key4);
+}
+
+void KisDabCacheBaseTest::testQuantizeSize()
+{
+    TestingDabCache cache;
+
+    const QPointF pos(10, 10);
+
+    KisDabCacheUtils::DabCacheQuantization q = uniformQuantization(0.1);
+
+    // zero size quantum means the exact match
+    q.sizeFrac = 0.0;
+    cache.setLruCacheQuantization(q);
+
+    KisDabCacheUtils::DabCacheKey key1 = cache.cacheKey(pos, KisDabShape(1.0, 1.0, 0.0));
+    KisDabCacheUtils::DabCacheKey key2 = cache.cacheKey(pos, KisDabShape(1.3, 1.0, 0.0));
+
+    QVERIFY(key1.width != key2.width);
+    QVERIFY(!(key1 == key2));
+
+    // the buckets are logarithmic, each one is 50% bigger than the previous
+    q.sizeFrac = 0.5;
+    cache.setLruCacheQuantization(q);
+
+    key1 = cache.cacheKey(pos, KisDabShape(1.0, 1.0, 0.0));
+    key2 = cache.cacheKey(pos, KisDabShape(1.05, 1.0, 0.0));
+    KisDabCacheUtils::DabCacheKey key3 = cache.cacheKey(pos, KisDabShape(2.0, 1.0, 0.0));
+
+    QCOMPARE(key1.width, qint64(6));
+    QVERIFY(key1 == key2);
+    QVERIFY(key3.width > key1.width);
+    QVERIFY(!(key1 == key3));
+}
+
+void KisDabCacheBaseTest::testQuantizeSubPixel()
+{
+    TestingDabCache cache;
+    cache.setLruCacheQuantization(uniformQuantization(0.5));
+
+    // dabs with the same subpixel offset share the key wherever they are
+    const KisDabCacheUtils::DabCacheKey key1 = cache.cacheKey(QPointF(10.3, 10.3), KisDabShape());
+    const KisDabCacheUtils::DabCacheKey key2 = cache.cacheKey(QPointF(130.3, 20.3), KisDabShape());
+    const KisDabCacheUtils::DabCacheKey key3 = cache.cacheKey(QPointF(10.3, 10.8), KisDabShape());
+
+    QVERIFY(key1.isValid);
+    QVERIFY(key1 == key2);
+    QVERIFY(key1.subPixelY != key3.subPixelY);
+    QVERIFY(!(key1 == key3));
+}
+
+void KisDabCacheBaseTest::testZeroQuantum()
+{
+    TestingDabCache cache;
+
+    // zero quanta must not be used as divisors
+    cache.setLruCacheQuantization(uniformQuantization(0.0));
+
+    const QPointF pos(10, 10);
+
+    const KisDabCacheUtils::DabCacheKey key1 = cache.cacheKey(pos, KisDabShape(1.0, 1.0, 0.1));
+    const KisDabCacheUtils::DabCacheKey key2 = cache.cacheKey(pos, KisDabShape(1.0, 1.0, 0.1));
+    const KisDabCacheUtils::DabCacheKey key3 = cache.cacheKey(pos, KisDabShape(1.0, 1.0, 0.1 + 1e-3));
+
+    QVERIFY(key1.isValid);
+    QVERIFY(key1 == key2);
+    QVERIFY(!(key1 == key3));
+
+    // negative quanta are clamped as well
+    cache.setLruCacheQuantization(uniformQuantization(-1.0));
+    QVERIFY(cache.cacheKey(pos, KisDabShape(1.0, 1.0, 0.1)) == key1);
+}
+
+void KisDabCacheBaseTest::testLruCacheHitsAndMisses()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    TestingDabCache cache;
+    cache.setLruCacheQuantization(uniformQuantization(0.1));
+
+    const QPointF pos(10, 10);
+    const KisDabCacheUtils::DabCacheKey key1 = cache.cacheKey(pos, KisDabShape(1.0, 1.0, 0.10));
+    const KisDabCacheUtils::DabCacheKey key2 = cache.cacheKey(pos, KisDabShape(1.0, 1.0, 0.12));
+    const KisDabCacheUtils::DabCacheKey key3 = cache.cacheKey(pos, KisDabShape(1.0, 1.0, 0.16));
+
+    // nothing is cached yet
+    QVERIFY(!cache.fetchDabFromLruCache(key1));
+
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(cs);
+    dab->setRect(QRect(0, 0, 7, 7));
+    dab->initialize();
+    cache.putDabToLruCache(key1, dab);
+
+    // the same bucket is a hit, the cache returns a separate copy
+    KisFixedPaintDeviceSP cachedDab = cache.fetchDabFromLruCache(key2);
+    QVERIFY(cachedDab);
+    QCOMPARE(cachedDab->bounds(), QRect(0, 0, 7, 7));
+    QVERIFY(cachedDab.data() != dab.data());
+
+    // the neighbouring bucket is a miss
+    QVERIFY(!cache.fetchDabFromLruCache(key3));
+
+    // invalid keys are never cached
+    KisDabCacheUtils::DabCacheKey invalidKey = key1;
+    invalidKey.isValid = false;
+    QVERIFY(!cache.fetchDabFromLruCache(invalidKey));
+
+    cache.putDabToLruCache(key3, dab);
+    QVERIFY(cache.fetchDabFromLruCache(key3));
+    QVERIFY(cache.fetchDabFromLruCache(key1));
+}
+
+void KisDabCacheBaseTest::testLruCacheDisabled()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    TestingDabCache cache;
+    cache.setLruCacheQuantization(uniformQuantization(0.1));
+
+    const KisDabCacheUtils::DabCacheKey key = cache.cacheKey(QPointF(10, 10), KisDabShape());
+    QVERIFY(key.isValid);
+
+    // zero limit disables the cache, no keys are generated anymore
+    cache.setLruCacheLimit(0);
+    QVERIFY(!cache.cacheKey(QPointF(10, 10), KisDabShape()).isValid);
+
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(cs);
+    dab->setRect(QRect(0, 0, 7, 7));
+    dab->initialize();
+    cache.putDabToLruCache(key, dab);
+
+    QVERIFY(!cache.fetchDabFromLruCache(key));
+}
+
+QTEST_MAIN(KisDabCacheBaseTest)
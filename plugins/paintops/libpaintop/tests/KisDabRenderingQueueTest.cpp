@@ -22,9 +22,9 @@
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 
-#include <../KisDabRenderingQueue.h>
-#include <../KisRenderedDab.h>
-#include <../KisDabRenderingJob.h>
+#include <KisDabRenderingQueue.h>
+#include <KisRenderedDab.h>
+#include <KisDabRenderingJob.h>
 
 struct SurrogateCacheInterface : public KisDabRenderingQueue::CacheInterface
 {
@@ -50,6 +50,7 @@ struct SurrogateCacheInterface : public KisDabRenderingQueue::CacheInterface
         }
 
         di->info = request.info;
+        di->cacheKey.isValid = useLruCache;
     }
 
     bool hasSeparateOriginal(KisDabCacheUtils::DabRenderingResources *resources) const override {
@@ -57,7 +58,19 @@ struct SurrogateCacheInterface : public KisDabRenderingQueue::CacheInterface
         return typeOverride == KisDabRenderingJob::Postprocess;
     }
 
+    KisFixedPaintDeviceSP fetchDabFromLruCache(const KisDabCacheUtils::DabCacheKey &key) override {
+        return key.isValid && lruCachedDab ? new KisFixedPaintDevice(*lruCachedDab) : 0;
+    }
+
+    void putDabToLruCache(const KisDabCacheUtils::DabCacheKey &key, KisFixedPaintDeviceSP dab) override {
+        if (key.isValid && !lruCachedDab) {
+            lruCachedDab = new KisFixedPaintDevice(*dab);
+        }
+    }
+
     KisDabRenderingJob::JobType typeOverride = KisDabRenderingJob::Dab;
+    bool useLruCache = false;
+    KisFixedPaintDeviceSP lruCachedDab;
 };
 
 #include <kis_mask_generator.h>
@@ -235,6 +248,66 @@ void KisDabRenderingQueueTest::testCachedDabs()
 
 }
 
+void KisDabRenderingQueueTest::testLruCachedDabs()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    SurrogateCacheInterface *cacheInterface = new SurrogateCacheInterface();
+    cacheInterface->useLruCache = true;
+
+    KisDabRenderingQueue queue(cs, testResourcesFactory);
+    queue.setCacheInterface(cacheInterface);
+
+    KoColor color;
+    QPointF pos1(10,10);
+    QPointF pos2(20,20);
+    KisDabShape shape;
+    KisPaintInformation pi1(pos1);
+    KisPaintInformation pi2(pos2);
+
+    KisDabCacheUtils::DabRequestInfo request1(color, pos1, shape, pi1, 1.0);
+    KisDabCacheUtils::DabRequestInfo request2(color, pos2, shape, pi2, 1.0);
+
+    QList<KisRenderedDab> renderedDabs;
+
+    {
+        // the cache is empty, so the dab should be rendered
+        KisDabRenderingJobSP job = queue.addDab(request1, OPACITY_OPAQUE_F, OPACITY_OPAQUE_F);
+
+        QVERIFY(job);
+        QCOMPARE(job->type, KisDabRenderingJob::Dab);
+        QVERIFY(!job->originalDevice);
+
+        job->originalDevice = new KisFixedPaintDevice(cs);
+        job->originalDevice->setRect(QRect(0, 0, 7, 7));
+        job->postprocessedDevice = job->originalDevice;
+
+        QVERIFY(queue.notifyJobFinished(job->seqNo).isEmpty());
+
+        // the rendered dab should have been put into the cache
+        QVERIFY(cacheInterface->lruCachedDab);
+        QCOMPARE(cacheInterface->lruCachedDab->bounds(), QRect(0, 0, 7, 7));
+
+        renderedDabs = queue.takeReadyDabs();
+        QCOMPARE(renderedDabs.size(), 1);
+    }
+
+    {
+        // the second dab is taken from the cache and needs no rendering
+        KisDabRenderingJobSP job = queue.addDab(request2, OPACITY_OPAQUE_F, OPACITY_OPAQUE_F);
+        QVERIFY(!job);
+
+        QVERIFY(queue.hasPreparedDabs());
+
+        renderedDabs = queue.takeReadyDabs();
+        QCOMPARE(renderedDabs.size(), 1);
+        QCOMPARE(renderedDabs[0].device->bounds(), QRect(0, 0, 7, 7));
+
+        // the cache owns its own copy of the dab
+        QVERIFY(renderedDabs[0].device.data() != cacheInterface->lruCachedDab.data());
+    }
+}
+
 void KisDabRenderingQueueTest::testPostprocessedDabs()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
@@ -443,7 +516,7 @@ void KisDabRenderingQueueTest::testPostprocessedDabs()
 
 }
 
-#include <../KisDabRenderingQueueCache.h>
+#include <KisDabRenderingQueueCache.h>
 
 void KisDabRenderingQueueTest::testRunningJobs()
 {
@@ -498,7 +571,7 @@ void KisDabRenderingQueueTest::testRunningJobs()
     QCOMPARE(renderedDabs[1].offset, QPoint(15,15));
 }
 
-#include "../KisDabRenderingExecutor.h"
+#include <KisDabRenderingExecutor.h>
 #include "KisFakeRunnableStrokeJobsExecutor.h"
 
 void KisDabRenderingQueueTest::testExecutor()
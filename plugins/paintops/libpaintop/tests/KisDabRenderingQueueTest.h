@@ -26,6 +26,7 @@ class KisDabRenderingQueueTest : public QObject
     Q_OBJECT
 private Q_SLOTS:
     void testCachedDabs();
+    void testLruCachedDabs();
     void testPostprocessedDabs();
     void testRunningJobs();
 
@@ -40,6 +40,8 @@
 #include <brushengine/kis_paint_information.h>
 #include <kis_fixed_paint_device.h>
 #include <kis_cross_device_color_picker.h>
+#include <KisParallelDabRenderingUtils.h>
+#include <kis_assert.h>
 
 #include "kis_spray_paintop_settings.h"
 
@@ -48,15 +50,24 @@
 
 #include <QtGlobal>
 
+struct SprayBrush::JobResources
+{
+    KisPaintDeviceSP device;
+    QScopedPointer<KisPainter> painter;
+    KisPaintDeviceSP imageDevice;
+    QScopedPointer<KoColorTransformation> transfo;
+    KisBrushSP brush;
+    KisFixedPaintDeviceSP fixedDab;
+};
+
 SprayBrush::SprayBrush()
 {
-    m_painter = 0;
+    m_painterOpacity = OPACITY_OPAQUE_U8;
     m_transfo = 0;
 }
 
 SprayBrush::~SprayBrush()
 {
-    delete m_painter;
     delete m_transfo;
 }
 
@@ -105,6 +116,41 @@ qreal SprayBrush::rotationAngle(KisRandomSourceSP randomSource)
 
 
 
+SprayBrush::JobResourcesSP SprayBrush::jobResources(int index, KisPaintDeviceSP dab)
+{
+    if (index < m_jobResources.size()) {
+        return m_jobResources[index];
+    }
+
+    KIS_SAFE_ASSERT_RECOVER_NOOP(index == m_jobResources.size());
+
+    JobResourcesSP resources(new JobResources());
+
+    resources->device = index == 0 ? dab : dab->createCompositionSourceDevice();
+    resources->painter.reset(new KisPainter(resources->device));
+    resources->painter->setFillStyle(KisPainter::FillStyleForegroundColor);
+    resources->painter->setMaskImageSize(m_shapeProperties->width, m_shapeProperties->height);
+    resources->imageDevice = new KisPaintDevice(dab->colorSpace());
+
+    if (m_colorProperties->useRandomHSV) {
+        resources->transfo.reset(dab->colorSpace()->createColorTransformation("hsv_adjustment", QHash<QString, QVariant>()));
+    }
+
+    if (m_brush) {
+        if (index == 0) {
+            resources->brush = m_brush;
+            resources->fixedDab = m_fixedDab;
+        } else {
+            resources->brush = m_brush->clone().dynamicCast<KisBrush>();
+            resources->brush->setThreadingAllowed(false);
+            resources->fixedDab = new KisFixedPaintDevice(m_fixedDab->colorSpace());
+        }
+    }
+
+    m_jobResources.append(resources);
+    return resources;
+}
+
 void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                        const KisPaintInformation& info,
                        qreal rotation, qreal scale,
@@ -114,10 +160,7 @@ void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
     KisRandomSourceSP randomSource = info.randomSource();
 
     // initializing painter
-    if (!m_painter) {
-        m_painter = new KisPainter(dab);
-        m_painter->setFillStyle(KisPainter::FillStyleForegroundColor);
-        m_painter->setMaskImageSize(m_shapeProperties->width, m_shapeProperties->height);
+    if (m_jobResources.isEmpty()) {
         m_dabPixelSize = dab->colorSpace()->pixelSize();
         if (m_colorProperties->useRandomHSV) {
             m_transfo = dab->colorSpace()->createColorTransformation("hsv_adjustment", QHash<QString, QVariant>());
@@ -127,17 +170,17 @@ void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
         if (!m_brushQImage.isNull()) {
             m_brushQImage = m_brushQImage.scaled(m_shapeProperties->width, m_shapeProperties->height);
         }
-        m_imageDevice = new KisPaintDevice(dab->colorSpace());
+
+        jobResources(0, dab);
     }
 
 
     qreal x = info.pos().x();
     qreal y = info.pos().y();
-    KisRandomAccessorSP accessor = dab->createRandomAccessorNG();
 
     Q_ASSERT(color.colorSpace()->pixelSize() == dab->pixelSize());
-    m_inkColor = color;
-    KisCrossDeviceColorPicker colorPicker(source, m_inkColor);
+    KoColor inkColor = color;
+    KisCrossDeviceColorPicker colorPicker(source, inkColor);
 
     // apply size sensor
     m_radius = m_properties->radius() * scale * additionalScale;
@@ -160,17 +203,21 @@ void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
     QHash<QString, QVariant> params;
     qreal nx, ny;
-    int ix, iy;
 
     qreal angle;
     qreal length;
     qreal rotationZ = 0.0;
     qreal particleScale = 1.0;
+    qreal hue = 0.0;
+    qreal saturation = 0.0;
+    qreal value = 0.0;
 
     bool shouldColor = true;
     if (m_colorProperties->fillBackground) {
-        m_painter->setPaintColor(bgColor);
-        paintCircle(m_painter, x, y, m_radius);
+        KisPainter *painter = m_jobResources[0]->painter.data();
+        painter->setOpacity(m_painterOpacity);
+        painter->setPaintColor(bgColor);
+        paintCircle(painter, x, y, m_radius);
     }
 
     QTransform m;
@@ -178,6 +225,8 @@ void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
     m.rotateRadians(-rotation + deg2rad(m_properties->brushRotation));
     m.scale(m_properties->scale, m_properties->scale);
 
+    QVector<Particle> particles(m_particlesCount);
+
     for (quint32 i = 0; i < m_particlesCount; i++) {
         // generate random angle
         angle = randomSource->generateNormalized() * M_PI * 2;
@@ -224,7 +273,7 @@ void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
         if (shouldColor) {
             if (m_colorProperties->sampleInputColor) {
-                colorPicker.pickOldColor(nx + x, ny + y, m_inkColor.data());
+                colorPicker.pickOldColor(nx + x, ny + y, inkColor.data());
             }
 
             // mix the color with background color
@@ -232,7 +281,7 @@ void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                 KoMixColorsOp * mixOp = dab->colorSpace()->mixColorsOp();
 
                 const quint8 *colors[2];
-                colors[0] = m_inkColor.data();
+                colors[0] = inkColor.data();
                 colors[1] = bgColor.data();
 
                 qint16 colorWeights[2];
@@ -241,31 +290,131 @@ void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
                 colorWeights[0] = static_cast<quint16>(blend * MAX_16BIT);
                 colorWeights[1] = static_cast<quint16>((1.0 - blend) * MAX_16BIT);
-                mixOp->mixColors(colors, colorWeights, 2, m_inkColor.data());
+                mixOp->mixColors(colors, colorWeights, 2, inkColor.data());
             }
 
             if (m_colorProperties->useRandomHSV && m_transfo) {
-                params["h"] = (m_colorProperties->hue / 180.0) * randomSource->generateNormalized();
-                params["s"] = (m_colorProperties->saturation / 100.0) * randomSource->generateNormalized();
-                params["v"] = (m_colorProperties->value / 100.0) * randomSource->generateNormalized();
+                hue = (m_colorProperties->hue / 180.0) * randomSource->generateNormalized();
+                saturation = (m_colorProperties->saturation / 100.0) * randomSource->generateNormalized();
+                value = (m_colorProperties->value / 100.0) * randomSource->generateNormalized();
+                params["h"] = hue;
+                params["s"] = saturation;
+                params["v"] = value;
                 m_transfo->setParameters(params);
                 m_transfo->setParameter(3, 1);//sets the type to HSV. For some reason 0 is not an option.
                 m_transfo->setParameter(4, false);//sets the colorize to false.
-                m_transfo->transform(m_inkColor.data(), m_inkColor.data() , 1);
+                m_transfo->transform(inkColor.data(), inkColor.data() , 1);
             }
 
             if (m_colorProperties->useRandomOpacity) {
                 quint8 alpha = qRound(randomSource->generateNormalized() * OPACITY_OPAQUE_U8);
-                m_inkColor.setOpacity(alpha);
-                m_painter->setOpacity(alpha);
+                inkColor.setOpacity(alpha);
+                m_painterOpacity = alpha;
             }
 
             if (!m_colorProperties->colorPerParticle) {
                 shouldColor = false;
             }
+        }
 
-            m_painter->setPaintColor(m_inkColor);
+        Particle &particle = particles[i];
+        particle.pos = QPointF(nx + x, ny + y);
+        particle.rotationZ = rotationZ;
+        particle.scale = particleScale;
+        particle.color = inkColor;
+        particle.opacity = m_painterOpacity;
+        particle.hue = hue;
+        particle.saturation = saturation;
+        particle.value = value;
+
+        if (m_colorProperties->colorPerParticle){
+            inkColor=color;//reset color//
         }
+    }
+
+    /**
+     * Cheap particles (pixels) are not worth spreading over the threads
+     * until there are really many of them
+     */
+    const bool cheapParticles =
+        m_shapeProperties->enabled &&
+        (m_shapeProperties->shape == 2 || m_shapeProperties->shape == 3);
+
+    QVector<KisParallelDabRenderingUtils::RangeJob> jobs =
+        KisParallelDabRenderingUtils::splitIntoRanges(particles.size(), cheapParticles ? 1024 : 64);
+
+    // resources are created in the stroke thread only
+    for (int i = 0; i < jobs.size(); i++) {
+        jobResources(i, dab);
+    }
+
+    if (jobs.size() > 1) {
+        /**
+         * Some brushes (e.g. the image pipe ones) take random values
+         * from the paint information, so every job should have its own
+         * random source
+         */
+        const int dabSeed = KisParallelDabRenderingUtils::generateDabSeed(randomSource);
+
+        KisParallelDabRenderingUtils::runJobs(jobs,
+            [&] (const KisParallelDabRenderingUtils::RangeJob &job) {
+                KisPaintInformation jobInfo(info);
+                jobInfo.setRandomSource(KisParallelDabRenderingUtils::createJobRandomSource(dabSeed, job.index));
+
+                renderParticles(m_jobResources[job.index].data(), particles,
+                                job.begin, job.end, jobInfo, additionalScale);
+            });
+    } else if (!jobs.isEmpty()) {
+        renderParticles(m_jobResources[0].data(), particles,
+                        0, particles.size(), info, additionalScale);
+    }
+
+    if (jobs.size() > 1) {
+        KisPainter gc(dab);
+
+        for (int i = 1; i < jobs.size(); i++) {
+            KisPaintDeviceSP device = m_jobResources[i]->device;
+            const QRect rc = device->extent();
+            gc.bitBlt(rc.topLeft(), device, rc);
+            device->clear();
+        }
+    }
+}
+
+void SprayBrush::renderParticles(JobResources *resources,
+                                 const QVector<Particle> &particles,
+                                 int begin, int end,
+                                 const KisPaintInformation &info,
+                                 qreal additionalScale)
+{
+    KisPainter *painter = resources->painter.data();
+    KoColorTransformation *transfo = resources->transfo.data();
+    /**
+     * The accessor keeps the recently used tiles locked, so it cannot
+     * outlive a single run: the devices are cleared between the dabs
+     */
+    KisRandomAccessorSP accessor = resources->device->createRandomAccessorNG();
+    QHash<QString, QVariant> params;
+    int ix, iy;
+
+    for (int i = begin; i < end; i++) {
+        const Particle &particle = particles[i];
+        const qreal px = particle.pos.x();
+        const qreal py = particle.pos.y();
+        const qreal rotationZ = particle.rotationZ;
+        const qreal particleScale = particle.scale;
+
+        if (transfo) {
+            params["h"] = particle.hue;
+            params["s"] = particle.saturation;
+            params["v"] = particle.value;
+            transfo->setParameters(params);
+            transfo->setParameter(3, 1);//sets the type to HSV. For some reason 0 is not an option.
+            transfo->setParameter(4, false);//sets the colorize to false.
+        }
+
+        painter->setOpacity(particle.opacity);
+        painter->setPaintColor(particle.color);
 
         qreal jitteredWidth = qMax(1.0 * additionalScale, m_shapeProperties->width * particleScale * additionalScale);
         qreal jitteredHeight = qMax(1.0 * additionalScale, m_shapeProperties->height * particleScale * additionalScale);
@@ -276,30 +425,30 @@ void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             case 0:
             {
                 if (m_shapeProperties->width == m_shapeProperties->height){
-                    paintCircle(m_painter, nx + x, ny + y, jitteredWidth * 0.5);
+                    paintCircle(painter, px, py, jitteredWidth * 0.5);
                 }
                 else {
-                    paintEllipse(m_painter, nx + x, ny + y, jitteredWidth * 0.5 , jitteredHeight * 0.5, rotationZ);
+                    paintEllipse(painter, px, py, jitteredWidth * 0.5 , jitteredHeight * 0.5, rotationZ);
                 }
                 break;
             }
             // rectangle
             case 1:
             {
-                paintRectangle(m_painter, nx + x, ny + y, qRound(jitteredWidth) , qRound(jitteredHeight), rotationZ);
+                paintRectangle(painter, px, py, qRound(jitteredWidth) , qRound(jitteredHeight), rotationZ);
                 break;
             }
             // wu-particle
             case 2: {
-                paintParticle(accessor, m_inkColor, nx + x, ny + y);
+                paintParticle(accessor, particle.color, px, py);
                 break;
             }
             // pixel
             case 3: {
-                ix = qRound(nx + x);
-                iy = qRound(ny + y);
+                ix = qRound(px);
+                iy = qRound(py);
                 accessor->moveTo(ix, iy);
-                memcpy(accessor->rawData(), m_inkColor.data(), m_dabPixelSize);
+                memcpy(accessor->rawData(), particle.color.data(), m_dabPixelSize);
                 break;
             }
             case 4: {
@@ -312,25 +461,25 @@ void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                     if (m_shapeDynamicsProperties->randomSize) {
                         m.scale(particleScale, particleScale);
                     }
-                    m_transformed = m_brushQImage.transformed(m, Qt::SmoothTransformation);
-                    m_imageDevice->convertFromQImage(m_transformed, 0);
-                    KisRandomAccessorSP ac = m_imageDevice->createRandomAccessorNG();
-                    QRect rc = m_transformed.rect();
+                    QImage transformed = m_brushQImage.transformed(m, Qt::SmoothTransformation);
+                    resources->imageDevice->convertFromQImage(transformed, 0);
+                    KisRandomAccessorSP ac = resources->imageDevice->createRandomAccessorNG();
+                    QRect rc = transformed.rect();
 
-                    if (m_colorProperties->useRandomHSV && m_transfo) {
+                    if (transfo) {
 
                         for (int y = rc.y(); y < rc.y() + rc.height(); y++) {
                             for (int x = rc.x(); x < rc.x() + rc.width(); x++) {
                                 ac->moveTo(x, y);
-                                m_transfo->transform(ac->rawData(), ac->rawData() , 1);
+                                transfo->transform(ac->rawData(), ac->rawData() , 1);
                             }
                         }
                     }
 
-                    ix = qRound(nx + x - rc.width() * 0.5);
-                    iy = qRound(ny + y - rc.height() * 0.5);
-                    m_painter->bitBlt(QPoint(ix, iy), m_imageDevice, rc);
-                    m_imageDevice->clear();
+                    ix = qRound(px - rc.width() * 0.5);
+                    iy = qRound(py - rc.height() * 0.5);
+                    painter->bitBlt(QPoint(ix, iy), resources->imageDevice, rc);
+                    resources->imageDevice->clear();
                     break;
                 }
             }
@@ -338,10 +487,11 @@ void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             // Auto-brush
         }
         else {
+            KisBrushSP brush = resources->brush;
+
             KisDabShape shape(particleScale * additionalScale, 1.0, -rotationZ);
-            QPointF hotSpot = m_brush->hotSpot(shape, info);
-            QPointF pos(nx + x, ny + y);
-            QPointF pt = pos - hotSpot;
+            QPointF hotSpot = brush->hotSpot(shape, info);
+            QPointF pt = particle.pos - hotSpot;
 
             qint32 ix;
             qreal xFraction;
@@ -352,29 +502,24 @@ void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             KisPaintOp::splitCoordinate(pt.y(), &iy, &yFraction);
 
             //KisFixedPaintDeviceSP dab;
-            if (m_brush->brushApplication() == IMAGESTAMP) {
-                m_fixedDab = m_brush->paintDevice(m_fixedDab->colorSpace(),
+            if (brush->brushApplication() == IMAGESTAMP) {
+                resources->fixedDab = brush->paintDevice(resources->fixedDab->colorSpace(),
                           shape, info, xFraction, yFraction);
 
-                if (m_colorProperties->useRandomHSV && m_transfo) {
-                    quint8 * dabPointer = m_fixedDab->data();
-                    int pixelCount = m_fixedDab->bounds().width() * m_fixedDab->bounds().height();
-                    m_transfo->transform(dabPointer, dabPointer, pixelCount);
+                if (transfo) {
+                    quint8 * dabPointer = resources->fixedDab->data();
+                    int pixelCount = resources->fixedDab->bounds().width() * resources->fixedDab->bounds().height();
+                    transfo->transform(dabPointer, dabPointer, pixelCount);
                 }
 
             }
             else {
-                m_brush->mask(m_fixedDab, m_inkColor, shape,
-                              info, xFraction, yFraction);
+                brush->mask(resources->fixedDab, particle.color, shape,
+                            info, xFraction, yFraction);
             }
-            m_painter->bltFixed(QPoint(ix, iy), m_fixedDab, m_fixedDab->bounds());
-        }
-        if (m_colorProperties->colorPerParticle){
-            m_inkColor=color;//reset color//
+            painter->bltFixed(QPoint(ix, iy), resources->fixedDab, resources->fixedDab->bounds());
         }
     }
-    // recover from jittering of color,
-    // m_inkColor.opacity is recovered with every paint
 }
 
 
@@ -32,6 +32,8 @@
 
 
 #include <QImage>
+#include <QSharedPointer>
+#include <QVector>
 #include <kis_brush.h>
 
 class KisPaintInformation;
@@ -53,15 +55,45 @@ public:
     void setFixedDab(KisFixedPaintDeviceSP dab);
 
 private:
-    KoColor m_inkColor;
+    /**
+     * All the random values of a particle are generated in the stroke
+     * thread before the rendering starts, so the particles look the
+     * same independently of how they are split between the threads
+     */
+    struct Particle {
+        QPointF pos;
+        qreal rotationZ = 0.0;
+        qreal scale = 1.0;
+        KoColor color;
+        quint8 opacity = OPACITY_OPAQUE_U8;
+        qreal hue = 0.0;
+        qreal saturation = 0.0;
+        qreal value = 0.0;
+    };
+
+    /**
+     * Painting resources owned by a single rendering job. The first
+     * job paints directly on the dab, the others paint on their own
+     * devices, which are merged into the dab afterwards.
+     */
+    struct JobResources;
+    typedef QSharedPointer<JobResources> JobResourcesSP;
+
+    JobResourcesSP jobResources(int index, KisPaintDeviceSP dab);
+    void renderParticles(JobResources *resources,
+                         const QVector<Particle> &particles,
+                         int begin, int end,
+                         const KisPaintInformation &info,
+                         qreal additionalScale);
+
+private:
     qreal m_radius;
     quint32 m_particlesCount;
     quint8 m_dabPixelSize;
+    quint8 m_painterOpacity;
 
-    KisPainter * m_painter;
-    KisPaintDeviceSP m_imageDevice;
+    QVector<JobResourcesSP> m_jobResources;
     QImage m_brushQImage;
-    QImage m_transformed;
 
     KoColorTransformation* m_transfo;
 
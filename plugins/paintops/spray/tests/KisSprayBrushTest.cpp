@@ -0,0 +1,150 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "KisSprayBrushTest.h"
+
+#include <QTest>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_paint_device.h>
+#include <brushengine/kis_paint_information.h>
+#include <brushengine/kis_random_source.h>
+
+#include "spray_brush.h"
+#include "kis_sprayop_option.h"
+
+namespace {
+
+struct SprayBrushTester
+{
+    SprayBrushTester(int shape, int particleCount)
+    {
+        properties.diameter = 200;
+        properties.particleCount = particleCount;
+        properties.aspect = 1.0;
+        properties.coverage = 0.1;
+        properties.amount = 1.0;
+        properties.spacing = 0.5;
+        properties.scale = 1.0;
+        properties.brushRotation = 0.0;
+        properties.jitterMovement = false;
+        properties.useDensity = false;
+        properties.gaussian = false;
+
+        colorProperties.useRandomHSV = false;
+        colorProperties.useRandomOpacity = false;
+        colorProperties.sampleInputColor = false;
+        colorProperties.fillBackground = false;
+        colorProperties.colorPerParticle = false;
+        colorProperties.mixBgColor = false;
+        colorProperties.hue = 0;
+        colorProperties.saturation = 0;
+        colorProperties.value = 0;
+
+        shapeProperties.shape = shape;
+        shapeProperties.width = 1;
+        shapeProperties.height = 1;
+        shapeProperties.enabled = true;
+        shapeProperties.proportional = false;
+
+        shapeDynamicsProperties.enabled = false;
+        shapeDynamicsProperties.randomSize = false;
+        shapeDynamicsProperties.fixedRotation = false;
+        shapeDynamicsProperties.randomRotation = false;
+        shapeDynamicsProperties.followCursor = false;
+        shapeDynamicsProperties.followDrawingAngle = false;
+        shapeDynamicsProperties.fixedAngle = 0;
+        shapeDynamicsProperties.randomRotationWeight = 0.0;
+        shapeDynamicsProperties.followCursorWeigth = 0.0;
+        shapeDynamicsProperties.followDrawingAngleWeight = 0.0;
+
+        brush.setProperties(&properties, &colorProperties,
+                            &shapeProperties, &shapeDynamicsProperties, KisBrushSP());
+    }
+
+    void paint(KisPaintDeviceSP dab, KisPaintDeviceSP source, int seed)
+    {
+        KisPaintInformation info(QPointF(150, 150), 1.0);
+        info.setRandomSource(new KisRandomSource(seed));
+
+        const KoColorSpace *cs = dab->colorSpace();
+        brush.paint(dab, source, info, 0.0, 1.0, 1.0,
+                    KoColor(Qt::red, cs), KoColor(Qt::white, cs));
+    }
+
+    KisSprayOptionProperties properties;
+    KisColorProperties colorProperties;
+    KisShapeProperties shapeProperties;
+    KisShapeDynamicsProperties shapeDynamicsProperties;
+    SprayBrush brush;
+};
+
+QByteArray dabBytes(KisPaintDeviceSP dab, const QRect &rc)
+{
+    QByteArray bytes(rc.width() * rc.height() * dab->pixelSize(), 0);
+    dab->readBytes(reinterpret_cast<quint8*>(bytes.data()), rc);
+    return bytes;
+}
+
+}
+
+void KisSprayBrushTest::testDeterministicDabs_data()
+{
+    QTest::addColumn<int>("shape");
+    QTest::addColumn<int>("particleCount");
+
+    // the big counts are split into several rendering jobs
+    QTest::newRow("wu, one job") << 2 << 500;
+    QTest::newRow("wu, many jobs") << 2 << 20000;
+    QTest::newRow("pixel, one job") << 3 << 500;
+    QTest::newRow("pixel, many jobs") << 3 << 20000;
+}
+
+void KisSprayBrushTest::testDeterministicDabs()
+{
+    QFETCH(int, shape);
+    QFETCH(int, particleCount);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP source = new KisPaintDevice(cs);
+    const QRect rc(0, 0, 300, 300);
+
+    SprayBrushTester tester(shape, particleCount);
+
+    KisPaintDeviceSP dab = new KisPaintDevice(cs);
+    tester.paint(dab, source, 1);
+    QVERIFY(!dab->exactBounds().isEmpty());
+    const QByteArray firstDab = dabBytes(dab, rc);
+
+    // the paintop reuses the same dab device for the whole stroke
+    dab->clear();
+    tester.paint(dab, source, 1);
+    QVERIFY(!dab->exactBounds().isEmpty());
+    QVERIFY(dabBytes(dab, rc) == firstDab);
+
+    // a fresh brush should render exactly the same dab
+    SprayBrushTester otherTester(shape, particleCount);
+    KisPaintDeviceSP otherDab = new KisPaintDevice(cs);
+    otherTester.paint(otherDab, source, 1);
+    QVERIFY(dabBytes(otherDab, rc) == firstDab);
+}
+
+QTEST_MAIN(KisSprayBrushTest)
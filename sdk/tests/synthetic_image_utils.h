@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2020 Krita Developers
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SYNTHETIC_IMAGE_UTILS_H
+#define __SYNTHETIC_IMAGE_UTILS_H
+
+#include <QScopedPointer>
+#include <QUrl>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_image.h>
+#include <kis_paint_device.h>
+#include <kis_paint_layer.h>
+#include <KisDocument.h>
+#include <KisPart.h>
+
+/**
+ * Helpers for the benchmarks of the file formats and of the saving
+ * code, which need big images with somewhat realistic content
+ */
+namespace TestUtil {
+
+/**
+ * Fills \p rc of \p dev with a smooth gradient plus some noise, so that
+ * the data is neither trivially compressible nor pure entropy, like in
+ * a real painting. Different \p seed values give different content, e.g.
+ * for different layers. Every other 1024 pixels wide column gets
+ * \p stripeOpacity alpha.
+ *
+ * The content is generated in 8-bit RGBA and converted into the color
+ * space of \p dev.
+ */
+inline void fillSyntheticContent(KisPaintDeviceSP dev, const QRect &rc,
+                                 int seed = 0, quint8 stripeOpacity = OPACITY_OPAQUE_U8)
+{
+    KisPaintDeviceSP tmp = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+
+    QByteArray row(rc.width() * 4, 0);
+    quint32 state = 0x9E3779B9 ^ quint32(seed);
+
+    for (int y = rc.top(); y <= rc.bottom(); y++) {
+        quint8 *ptr = reinterpret_cast<quint8*>(row.data());
+
+        for (int x = rc.left(); x <= rc.right(); x++) {
+            state = state * 1664525 + 1013904223;
+            const int noise = (state >> 29) - 4;
+
+            ptr[0] = quint8(qBound(0, (x >> 4) + noise, 255));
+            ptr[1] = quint8(qBound(0, (y >> 4) + noise, 255));
+            ptr[2] = quint8(qBound(0, ((x + y) >> 5) + seed * 32 + noise, 255));
+            ptr[3] = (x + seed * 512) % 2048 < 1024 ? OPACITY_OPAQUE_U8 : stripeOpacity;
+            ptr += 4;
+        }
+
+        tmp->writeBytes(reinterpret_cast<quint8*>(row.data()), rc.left(), y, rc.width(), 1);
+    }
+
+    if (dev->colorSpace() != tmp->colorSpace()) {
+        tmp->convertTo(dev->colorSpace());
+    }
+
+    dev->makeCloneFrom(tmp, rc);
+}
+
+/**
+ * Creates an image of the size of \p rc with \p numLayers paint
+ * layers filled by fillSyntheticContent()
+ */
+inline KisImageSP createSyntheticImage(const KoColorSpace *cs, const QRect &rc, int numLayers,
+                                       quint8 stripeOpacity = OPACITY_OPAQUE_U8)
+{
+    KisImageSP image = new KisImage(0, rc.width(), rc.height(), cs, "synthetic image");
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8, cs);
+        fillSyntheticContent(layer->paintDevice(), rc, i, stripeOpacity);
+        image->addNode(layer);
+    }
+    image->initialRefreshGraph();
+
+    return image;
+}
+
+/**
+ * Saves \p image into \p filePath without showing any dialogs and
+ * waits until the saving is finished
+ */
+inline bool exportImageSync(KisImageSP image, const QString &filePath, const QString &mimeType)
+{
+    QScopedPointer<KisDocument> doc(KisPart::instance()->createDocument());
+    doc->setCurrentImage(image);
+    doc->setFileBatchMode(true);
+
+    return doc->exportDocumentSync(QUrl::fromLocalFile(filePath), mimeType.toLatin1());
+}
+
+}
+
+#endif /* __SYNTHETIC_IMAGE_UTILS_H */